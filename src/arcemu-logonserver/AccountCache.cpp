@@ -333,6 +333,9 @@ InformationCore::~InformationCore()
 {
 	for(map<uint32, Realm*>::iterator itr = m_realms.begin(); itr != m_realms.end(); ++itr)
 		delete itr->second;
+
+	if(m_realmList != NULL)
+		m_realmList->DecRef();
 }
 
 bool IPBanner::Remove(const char* ip)
@@ -406,6 +409,7 @@ Realm* InformationCore::AddRealm(uint32 realm_id, Realm* rlm)
 		delete itr->second;
 		itr->second = rlm;
 	}
+	InvalidateRealmList();
 	realmLock.Release();
 	return rlm;
 }
@@ -443,6 +447,7 @@ void InformationCore::RemoveRealm(uint32 realm_id)
 	{
 		delete itr->second;
 		m_realms.erase(itr);
+		InvalidateRealmList();
 	}
 	realmLock.Release();
 }
@@ -451,9 +456,10 @@ void InformationCore::UpdateRealmStatus(uint32 realm_id, uint8 flags)
 {
 	realmLock.Acquire();
 	map<uint32, Realm*>::iterator itr = m_realms.find(realm_id);
-	if(itr != m_realms.end())
+	if(itr != m_realms.end() && itr->second->flags != flags)
 	{
 		itr->second->flags = flags;
+		InvalidateRealmList();
 	}
 	realmLock.Release();
 }
@@ -474,34 +480,73 @@ void InformationCore::UpdateRealmPop(uint32 realm_id, float pop)
 		else
 			flags = REALM_FLAG_NEW_PLAYERS; // recommended
 
-		itr->second->Population = (pop > 0) ? (pop >= 1) ? (pop >= 2) ? 2.0f : 1.0f : 0.0f : 0.0f;
-		itr->second->flags = flags;
+		float population = (pop > 0) ? (pop >= 1) ? (pop >= 2) ? 2.0f : 1.0f : 0.0f : 0.0f;
+
+		// the realms report their population every time the list is sent, it rarely changes
+		if(itr->second->Population != population || itr->second->flags != flags)
+		{
+			itr->second->Population = population;
+			itr->second->flags = flags;
+			InvalidateRealmList();
+		}
 	}
 	realmLock.Release();
 }
-void InformationCore::SendRealms(AuthSocket* Socket)
+void InformationCore::InvalidateRealmList()
+{
+	// called with realmLock held, so nobody is building a list from the old data right now
+	realmListLock.Acquire();
+	++m_realmListVersion;
+	if(m_realmList != NULL)
+	{
+		m_realmList->DecRef();
+		m_realmList = NULL;
+	}
+	realmListLock.Release();
+}
+
+RealmListPacket* InformationCore::GetRealmList()
 {
+	realmListLock.Acquire();
+	RealmListPacket* list = m_realmList;
+	if(list != NULL)
+		list->AddRef();
+	realmListLock.Release();
+
+	if(list != NULL)
+		return list;
+
 	realmLock.Acquire();
 
+	// someone else may have built it while we were waiting
+	realmListLock.Acquire();
+	list = m_realmList;
+	if(list != NULL)
+	{
+		list->AddRef();
+		realmListLock.Release();
+		realmLock.Release();
+		return list;
+	}
+	uint32 version = m_realmListVersion;
+	realmListLock.Release();
+
+	list = new RealmListPacket(version);
+	ByteBuffer & data = list->data;
+	data.reserve(m_realms.size() * 150 + 20);
+
 	// packet header
-	ByteBuffer data(m_realms.size() * 150 + 20);
 	data << uint8(0x10);
 	data << uint16(0);	  // Size Placeholder
 
 	// dunno what this is..
 	data << uint32(0);
 
-	//sAuthLogonChallenge_C * client = Socket->GetChallenge();
 	data << uint16(m_realms.size());
 
 	// loop realms :/
-	map<uint32, Realm*>::iterator itr = m_realms.begin();
-	HM_NAMESPACE::hash_map<uint32, uint8>::iterator it;
-	for(; itr != m_realms.end(); ++itr)
+	for(map<uint32, Realm*>::iterator itr = m_realms.begin(); itr != m_realms.end(); ++itr)
 	{
-//		data << uint8(itr->second->Icon);
-//		data << uint8(0);				   // Locked Flag
-//		data << uint8(itr->second->Colour);
 		data << uint8(itr->second->Icon);
 		data << uint8(itr->second->Lock);		// delete when using data << itr->second->Lock;
 		data << uint8(itr->second->flags);
@@ -509,28 +554,56 @@ void InformationCore::SendRealms(AuthSocket* Socket)
 		// This part is the same for all.
 		data << itr->second->Name;
 		data << itr->second->Address;
-//		data << uint32(0x3fa1cac1);
 		data << float(itr->second->Population);
 
-		/* Get our character count */
-		it = itr->second->CharacterMap.find(Socket->GetAccountID());
-		data << uint8((it == itr->second->CharacterMap.end()) ? 0 : it->second);
-//		data << uint8(1);   // time zone
-//		data << uint8(6);
+		// character count, patched in for every account
+		list->charCounts.push_back(std::make_pair(itr->first, data.wpos()));
+		data << uint8(0);
 		data << uint8(itr->second->TimeZone);
 		data << uint8(GetRealmIdByName(itr->second->Name));        //Realm ID
 	}
 	data << uint8(0x17);
 	data << uint8(0);
 
+	// Re-calculate size.
+	*(uint16*)&data.contents()[1] = uint16(data.size() - 3);
+
+	// the list's reference, the caller gets the second one
+	list->AddRef();
+	realmListLock.Acquire();
+	m_realmList = list;
+	realmListLock.Release();
+
 	realmLock.Release();
+	return list;
+}
 
-	// Re-calculate size.
+void InformationCore::SendRealms(AuthSocket* Socket)
+{
+	RealmListPacket* list = GetRealmList();
 
-	*(uint16*)&data.contents()[1] = uint16(data.size() - 3);
+	ByteBuffer data(list->data);
+
+	/* Get our character counts */
+	uint32 accountId = Socket->GetAccountID();
+	HM_NAMESPACE::hash_map<uint32, uint8>::iterator it;
+
+	realmLock.Acquire();
+	for(std::vector< std::pair< uint32, size_t > >::iterator itr = list->charCounts.begin(); itr != list->charCounts.end(); ++itr)
+	{
+		map<uint32, Realm*>::iterator realm = m_realms.find(itr->first);
+		if(realm == m_realms.end())
+			continue;
+
+		it = realm->second->CharacterMap.find(accountId);
+		if(it != realm->second->CharacterMap.end())
+			data.put< uint8 >(itr->second, it->second);
+	}
+	realmLock.Release();
 
 	// Send to the socket.
 	Socket->Send((const uint8*)data.contents(), uint32(data.size()));
+	list->DecRef();
 
 	std::list< LogonCommServerSocket* > ss;
 	std::list< LogonCommServerSocket* >::iterator SSitr;
@@ -539,12 +612,16 @@ void InformationCore::SendRealms(AuthSocket* Socket)
 
 	serverSocketLock.Acquire();
 
-	if(m_serverSockets.empty())
+	// the realms answer with their population, don't ask them again for every client during a login storm
+	uint32 now = getMSTime();
+	if(m_serverSockets.empty() || (now - m_lastPopRefresh) < REALMLIST_POP_REFRESH_INTERVAL)
 	{
 		serverSocketLock.Release();
 		return;
 	}
 
+	m_lastPopRefresh = now;
+
 	set<LogonCommServerSocket*>::iterator itr1;
 
 	// We copy the sockets to a list and call RefreshRealmsPop() from there because if the socket is dead,
@@ -626,6 +703,7 @@ void InformationCore::SetRealmOffline(uint32 realm_id)
 	{
 		itr->second->flags = REALM_FLAG_OFFLINE | REALM_FLAG_INVALID;
 		itr->second->CharacterMap.clear();
+		InvalidateRealmList();
 		Log.Notice("InfoCore", "Realm %u is now offline (socket close).", realm_id);
 	}
 	realmLock.Release();
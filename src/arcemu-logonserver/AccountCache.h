@@ -183,6 +183,30 @@ typedef struct
 	HM_NAMESPACE::hash_map<uint32, uint8> CharacterMap;
 } Realm;
 
+// Minimum time in ms between two population refreshes asked from the realms
+#define REALMLIST_POP_REFRESH_INTERVAL 1000
+
+// The realm list as sent to the clients, except for the character counts.
+// It's built once after the realms change and shared by every client asking
+// for the list, which only copies it and patches in its own character counts.
+class RealmListPacket
+{
+	public:
+		RealmListPacket(uint32 ver) : version(ver) { m_refs.SetVal(1); }
+
+		void AddRef() { ++m_refs; }
+		void DecRef() { if((--m_refs) == 0) delete this; }
+
+		uint32 version;
+		ByteBuffer data;
+
+		// realm id and position of its character count in data
+		std::vector< std::pair< uint32, size_t > > charCounts;
+
+	private:
+		Arcemu::Threading::AtomicCounter m_refs;
+};
+
 class AuthSocket;
 class LogonCommServerSocket;
 
@@ -193,9 +217,20 @@ class InformationCore : public Singleton<InformationCore>
 		Mutex serverSocketLock;
 		Mutex realmLock;
 
+		// Prebuilt realm list, NULL until someone asks for it after a change.
+		// Replaced under realmLock then realmListLock, read under realmListLock only.
+		RealmListPacket* m_realmList;
+		uint32 m_realmListVersion;
+		FastMutex realmListLock;
+
+		uint32 m_lastPopRefresh;		// protected by serverSocketLock
+
 		uint32 realmhigh;
 		bool usepings;
 
+		RealmListPacket* GetRealmList();
+		void InvalidateRealmList();
+
 	public:
 		~InformationCore();
 
@@ -205,6 +240,9 @@ class InformationCore : public Singleton<InformationCore>
 		InformationCore()
 		{
 			realmhigh = 0;
+			m_realmList = NULL;
+			m_realmListVersion = 0;
+			m_lastPopRefresh = 0;
 			usepings  = !Config.MainConfig.GetBoolDefault("LogonServer", "DisablePings", false);
 			m_realms.clear();
 		}
@@ -0,0 +1,162 @@
+/*
+ * ArcEmu MMORPG Server
+ * Copyright (C) 2008-2012 <http://www.ArcEmu.org/>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "LogonStdAfx.h"
+
+initialiseSingleton(AuthCryptoPool);
+
+class AuthCryptoThread : public CThread
+{
+	public:
+		bool run()
+		{
+			sAuthCryptoPool.RunWorker();
+			return true;
+		}
+};
+
+AuthCryptoPool::AuthCryptoPool()
+{
+	BigNumber N, g;
+	N.SetHexStr(SRP6_N);
+	g.SetDword(SRP6_G);
+
+	m_gPow = new FixedBaseModExp(g, N, SRP6_MAX_G_EXPONENT_BITS);
+}
+
+AuthCryptoPool::~AuthCryptoPool()
+{
+	Shutdown();
+	delete m_gPow;
+}
+
+void AuthCryptoPool::Startup(uint32 threads)
+{
+	if(threads == 0)
+	{
+		Log.Notice("AuthCryptoPool", "No crypto threads, logons are verified on the socket threads.");
+		return;
+	}
+
+	m_running.SetVal(true);
+	for(uint32 i = 0; i < threads; ++i)
+		ThreadPool.ExecuteTask(new AuthCryptoThread());
+
+	Log.Success("AuthCryptoPool", "Started %u crypto threads.", threads);
+}
+
+void AuthCryptoPool::Shutdown()
+{
+	if(!m_running.GetVal())
+		return;
+
+	m_running.SetVal(false);
+	while(m_workers.GetVal() != 0)
+	{
+		m_cond.Signal();
+		Arcemu::Sleep(10);
+	}
+
+	m_lock.Acquire();
+	m_jobs.clear();
+	m_lock.Release();
+}
+
+bool AuthCryptoPool::QueueChallenge(AuthSocket* socket)
+{
+	AuthCryptoJob job;
+	job.socket = socket;
+	job.type = AUTH_CRYPTO_CHALLENGE;
+	return Queue(job);
+}
+
+bool AuthCryptoPool::QueueProof(AuthSocket* socket, const sAuthLogonProof_C & proof)
+{
+	AuthCryptoJob job;
+	job.socket = socket;
+	job.type = AUTH_CRYPTO_PROOF;
+	job.proof = proof;
+	return Queue(job);
+}
+
+bool AuthCryptoPool::Queue(AuthCryptoJob & job)
+{
+	if(!m_running.GetVal())
+		return false;
+
+	job.socket->m_cryptoPending.SetVal(true);
+
+	m_lock.Acquire();
+	m_jobs.push_back(job);
+	m_lock.Release();
+
+	m_cond.Signal();
+	return true;
+}
+
+void AuthCryptoPool::AbortJobs(AuthSocket* socket)
+{
+	m_lock.Acquire();
+	for(std::deque< AuthCryptoJob >::iterator itr = m_jobs.begin(); itr != m_jobs.end();)
+	{
+		if(itr->socket == socket)
+			itr = m_jobs.erase(itr);
+		else
+			++itr;
+	}
+	m_lock.Release();
+
+	// a crypto thread that already took a job of this socket holds its lock until the job is done
+	socket->m_cryptoLock.Acquire();
+	socket->m_cryptoPending.SetVal(false);
+	socket->m_cryptoLock.Release();
+}
+
+void AuthCryptoPool::RunWorker()
+{
+	++m_workers;
+
+	while(m_running.GetVal())
+	{
+		m_lock.Acquire();
+		if(m_jobs.empty())
+		{
+			m_lock.Release();
+			m_cond.Wait(AUTHCRYPTO_WORKER_WAIT);
+			continue;
+		}
+
+		AuthCryptoJob job = m_jobs.front();
+		m_jobs.pop_front();
+
+		// taken before m_lock is released, so AbortJobs() can't miss this job
+		job.socket->m_cryptoLock.Acquire();
+		m_lock.Release();
+
+		// the socket clears m_cryptoPending itself right before it sends the answer. Clearing it
+		// afterwards would make OnRead() skip the client's reply, or drop the flag of its next job.
+		if(job.type == AUTH_CRYPTO_CHALLENGE)
+			job.socket->FinishChallenge();
+		else
+			job.socket->FinishProof(job.proof);
+		job.socket->m_cryptoLock.Release();
+	}
+
+	--m_workers;
+}
@@ -0,0 +1,93 @@
+/*
+ * ArcEmu MMORPG Server
+ * Copyright (C) 2008-2012 <http://www.ArcEmu.org/>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AUTHCRYPTOPOOL_H
+#define AUTHCRYPTOPOOL_H
+
+// SRP6 safe prime and generator, the client expects these
+#define SRP6_N "894B645E89E1535BBDAD5B8B290650530801B18EBFBF5E8FAB3C82872A3E9BB7"
+#define SRP6_G 7
+
+// Longest exponent of g, x is a SHA1 digest and b is 152 bits
+#define SRP6_MAX_G_EXPONENT_BITS 160
+
+// Time in ms an idle crypto thread sleeps before looking at the queue again
+#define AUTHCRYPTO_WORKER_WAIT 100
+
+class AuthSocket;
+
+enum AuthCryptoJobType
+{
+    AUTH_CRYPTO_CHALLENGE,
+    AUTH_CRYPTO_PROOF
+};
+
+struct AuthCryptoJob
+{
+	AuthSocket* socket;
+	AuthCryptoJobType type;
+	sAuthLogonProof_C proof;
+};
+
+// Runs the SRP6 math of the logon handshake on its own threads, so the socket
+// threads only parse packets and look up accounts. The powers of g are taken from
+// a table built at startup instead of a full modular exponentiation.
+class AuthCryptoPool : public Singleton< AuthCryptoPool >
+{
+	public:
+		AuthCryptoPool();
+		~AuthCryptoPool();
+
+		// Starts the crypto threads. Without threads the sockets do the math themselves.
+		void Startup(uint32 threads);
+
+		// Stops the crypto threads and waits for them to exit.
+		void Shutdown();
+
+		// Returns g ^ exp % N.
+		BigNumber PowG(const BigNumber & exp) const { return m_gPow->ModExp(exp); }
+
+		// Queues the second half of a challenge or proof for the crypto threads.
+		// Returns false if there are no crypto threads, the caller has to finish it then.
+		bool QueueChallenge(AuthSocket* socket);
+		bool QueueProof(AuthSocket* socket, const sAuthLogonProof_C & proof);
+
+		// Forgets the queued jobs of a socket and waits for a running one to finish.
+		// Called when the socket disconnects, after that no thread touches it anymore.
+		void AbortJobs(AuthSocket* socket);
+
+		// Loop of a crypto thread.
+		void RunWorker();
+
+	private:
+		bool Queue(AuthCryptoJob & job);
+
+		FixedBaseModExp* m_gPow;
+
+		Mutex m_lock;
+		std::deque< AuthCryptoJob > m_jobs;
+
+		Arcemu::Threading::ConditionVariable m_cond;
+		Arcemu::Threading::AtomicBoolean m_running;
+		Arcemu::Threading::AtomicCounter m_workers;
+};
+
+#define sAuthCryptoPool AuthCryptoPool::getSingleton()
+
+#endif
@@ -36,8 +36,8 @@ enum _errors
 
 AuthSocket::AuthSocket(SOCKET fd) : Socket(fd, 32768, 4096)
 {
-	N.SetHexStr("894B645E89E1535BBDAD5B8B290650530801B18EBFBF5E8FAB3C82872A3E9BB7");
-	g.SetDword(7);
+	N.SetHexStr(SRP6_N);
+	g.SetDword(SRP6_G);
 	s.SetRand(256);
 	m_authenticated = false;
 	m_account = NULL;
@@ -69,6 +69,8 @@ void AuthSocket::OnDisconnect()
 		PatchMgr::getSingleton().AbortPatchJob(m_patchJob);
 		m_patchJob = NULL;
 	}
+
+	sAuthCryptoPool.AbortJobs(this);
 }
 
 void AuthSocket::HandleChallenge()
@@ -230,6 +232,14 @@ void AuthSocket::HandleChallenge()
 		*(uint32*)&m_account->Locale[0] = *(uint32*)temp;
 	}
 
+	if(sAuthCryptoPool.QueueChallenge(this))
+		return;
+
+	FinishChallenge();
+}
+
+void AuthSocket::FinishChallenge()
+{
 	//////////////////////////////////////////////// SRP6 Challenge ////////////////////////////////////////////////
 	//
 	//
@@ -252,7 +262,7 @@ void AuthSocket::HandleChallenge()
 
 	BigNumber x;
 	x.SetBinary(sha.GetDigest(), sha.GetLength());
-	v = g.ModExp(x, N);
+	v = sAuthCryptoPool.PowG(x);
 
 	// Next we generate b, and B which are the public and private values of the server
 	//
@@ -264,7 +274,7 @@ void AuthSocket::HandleChallenge()
 	b.SetRand(152);
 	uint8 k = 3;
 
-	BigNumber gmod = g.ModExp(b, N);
+	BigNumber gmod = sAuthCryptoPool.PowG(b);
 	B = ((v * k) + gmod) % N;
 	ASSERT(gmod.GetNumBytes() <= 32);
 
@@ -286,6 +296,8 @@ void AuthSocket::HandleChallenge()
 	memcpy(challenge.unk3, unk.AsByteArray(), 16);
 	challenge.unk4 = 0;
 
+	// cleared before the answer goes out, the client's next packet may arrive right after it
+	m_cryptoPending.SetVal(false);
 	Send(reinterpret_cast< uint8* >(&challenge), sizeof(sAuthLogonChallenge_S));
 }
 
@@ -318,7 +330,14 @@ void AuthSocket::HandleProof()
 	//Read(sizeof(sAuthLogonProof_C), (uint8*)&lp);
 	readBuffer.Read(&lp, sizeof(sAuthLogonProof_C));
 
+	if(sAuthCryptoPool.QueueProof(this, lp))
+		return;
+
+	FinishProof(lp);
+}
 
+void AuthSocket::FinishProof(sAuthLogonProof_C & lp)
+{
 	////////////////////////////////////////////////////// SRP6 ///////////////////////////////////////////////
 	//Now comes the famous secret Xi Chi fraternity handshake ( http://www.youtube.com/watch?v=jJSYBoI2si0 ),
 	//generating a session key
@@ -408,6 +427,7 @@ void AuthSocket::HandleProof()
 	{
 		// Authentication failed.
 		//SendProofError(4, 0);
+		m_cryptoPending.SetVal(false);
 		SendChallengeError(CE_NO_ACCOUNT);
 		LOG_DEBUG("[AuthLogonProof] M values don't match. ( Either invalid password or the logon server is bugged. )");
 		return;
@@ -421,12 +441,14 @@ void AuthSocket::HandleProof()
 	sha.UpdateBigNumbers(&A, &M, &m_sessionkey, 0);
 	sha.Finalize();
 
-	SendProofError(0, sha.GetDigest());
-	LOG_DEBUG("[AuthLogonProof] Authentication Success.");
-
 	// we're authenticated now :)
 	m_authenticated = true;
 
+	// cleared before the answer goes out, the client asks for the realm list right after it
+	m_cryptoPending.SetVal(false);
+	SendProofError(0, sha.GetDigest());
+	LOG_DEBUG("[AuthLogonProof] Authentication Success.");
+
 	// Don't update when IP banned, but update anyway if it's an account ban
 	sLogonSQL->Execute("UPDATE accounts SET lastlogin=NOW(), lastip='%s' WHERE acct=%u;", GetRemoteIP().c_str(), m_account->AccountId);
 }
@@ -534,6 +556,10 @@ static AuthHandler Handlers[MAX_AUTH_CMD] =
 
 void AuthSocket::OnRead()
 {
+	// the next packet is handled once the crypto threads answered the last one
+	if(m_cryptoPending.GetVal())
+		return;
+
 	if(readBuffer.GetContiguiousBytes() < 1)
 		return;
 
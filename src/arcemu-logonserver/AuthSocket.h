@@ -30,6 +30,7 @@ class PatchJob;
 class AuthSocket : public Socket
 {
 		friend class LogonCommServerSocket;
+		friend class AuthCryptoPool;
 	public:
 
 		///////////////////////////////////////////////////
@@ -53,6 +54,10 @@ class AuthSocket : public Socket
 		void HandleTransferResume();
 		void HandleTransferCancel();
 
+		// SRP6 halves of the challenge and the proof, run by the crypto threads when there are any
+		void FinishChallenge();
+		void FinishProof(sAuthLogonProof_C & lp);
+
 		///////////////////////////////////////////////////
 		// Server Packet Builders
 		//////////////////////////
@@ -88,6 +93,11 @@ class AuthSocket : public Socket
 		BigNumber m_sessionkey;
 		time_t last_recv;
 
+		// held by a crypto thread while it works on this socket
+		Mutex m_cryptoLock;
+		// reads wait until the queued crypto job is done, cleared by FinishChallenge() and FinishProof() before they answer
+		Arcemu::Threading::AtomicBoolean m_cryptoPending;
+
 		//////////////////////////////////////////////////////////////////////////
 		// Patching stuff
 		//////////////////////////////////////////////////////////////////////////
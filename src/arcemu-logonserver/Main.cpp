@@ -379,6 +379,9 @@ void LogonServer::Run(int argc, char** argv)
 	new InformationCore;
 
 	new PatchMgr;
+	new AuthCryptoPool;
+	sAuthCryptoPool.Startup(Config.MainConfig.GetIntDefault("Crypto", "Threads", 2));
+
 	Log.Notice("AccountMgr", "Precaching accounts...");
 	sAccountMgr.ReloadAccounts(true);
 	Log.Success("AccountMgr", "%u accounts are loaded and ready.", sAccountMgr.GetCount());
@@ -503,6 +506,7 @@ void LogonServer::Run(int argc, char** argv)
 #ifdef WIN32
 	sSocketMgr.ShutdownThreads();
 #endif
+	sAuthCryptoPool.Shutdown();
 	sLogonConsole.Kill();
 	delete LogonConsole::getSingletonPtr();
 
@@ -520,6 +524,7 @@ void LogonServer::Run(int argc, char** argv)
 	delete AccountMgr::getSingletonPtr();
 	delete InformationCore::getSingletonPtr();
 	delete PatchMgr::getSingletonPtr();
+	delete AuthCryptoPool::getSingletonPtr();
 	delete IPBanner::getSingletonPtr();
 	delete SocketMgr::getSingletonPtr();
 	delete SocketGarbageCollector::getSingletonPtr();
@@ -200,3 +200,88 @@ const char* BigNumber::AsDecStr()
 {
 	return BN_bn2dec(_bn);
 }
+
+FixedBaseModExp::FixedBaseModExp(const BigNumber & base, const BigNumber & mod, int maxbits)
+{
+	const int digits = 1 << FIXEDBASE_WINDOW_BITS;
+	BN_CTX* bnctx = BN_CTX_new();
+
+	_base = BN_dup(base._bn);
+	_mod = BN_dup(mod._bn);
+	_mont = BN_MONT_CTX_new();
+	BN_MONT_CTX_set(_mont, _mod, bnctx);
+
+	_one = BN_new();
+	BN_to_montgomery(_one, BN_value_one(), _mont, bnctx);
+
+	// cur is base ^ (1 << (window * FIXEDBASE_WINDOW_BITS))
+	BIGNUM* cur = BN_new();
+	BN_to_montgomery(cur, _base, _mont, bnctx);
+
+	_windows = (maxbits + FIXEDBASE_WINDOW_BITS - 1) / FIXEDBASE_WINDOW_BITS;
+	_table.resize(_windows * digits);
+
+	for(int w = 0; w < _windows; ++w)
+	{
+		BIGNUM** row = &_table[ w * digits ];
+		row[ 0 ] = BN_dup(_one);
+		row[ 1 ] = BN_dup(cur);
+		for(int d = 2; d < digits; ++d)
+		{
+			row[ d ] = BN_new();
+			BN_mod_mul_montgomery(row[ d ], row[ d - 1 ], cur, _mont, bnctx);
+		}
+
+		for(int i = 0; i < FIXEDBASE_WINDOW_BITS; ++i)
+			BN_mod_mul_montgomery(cur, cur, cur, _mont, bnctx);
+	}
+
+	BN_free(cur);
+	BN_CTX_free(bnctx);
+}
+
+FixedBaseModExp::~FixedBaseModExp()
+{
+	for(std::vector<BIGNUM*>::iterator itr = _table.begin(); itr != _table.end(); ++itr)
+		BN_free(*itr);
+
+	BN_free(_one);
+	BN_MONT_CTX_free(_mont);
+	BN_free(_mod);
+	BN_free(_base);
+}
+
+BigNumber FixedBaseModExp::ModExp(const BigNumber & exp) const
+{
+	BigNumber ret;
+	BN_CTX* bnctx = BN_CTX_new();
+
+	if(BN_num_bits(exp._bn) > _windows * FIXEDBASE_WINDOW_BITS)
+	{
+		BN_mod_exp(ret._bn, _base, exp._bn, _mod, bnctx);
+		BN_CTX_free(bnctx);
+		return ret;
+	}
+
+	const int digits = 1 << FIXEDBASE_WINDOW_BITS;
+	BIGNUM* acc = BN_dup(_one);
+
+	for(int w = 0; w < _windows; ++w)
+	{
+		int digit = 0;
+		for(int i = 0; i < FIXEDBASE_WINDOW_BITS; ++i)
+		{
+			if(BN_is_bit_set(exp._bn, w * FIXEDBASE_WINDOW_BITS + i))
+				digit |= 1 << i;
+		}
+
+		if(digit != 0)
+			BN_mod_mul_montgomery(acc, acc, _table[ w * digits + digit ], _mont, bnctx);
+	}
+
+	BN_from_montgomery(ret._bn, acc, _mont, bnctx);
+
+	BN_free(acc);
+	BN_CTX_free(bnctx);
+	return ret;
+}
@@ -91,8 +91,38 @@ class BigNumber
 		const char* AsDecStr();
 
 	private:
+		friend class FixedBaseModExp;
+
 		struct bignum_st* _bn;
 		uint8* _array;
 };
 
+// Bits of the exponent handled by one multiplication in FixedBaseModExp
+#define FIXEDBASE_WINDOW_BITS 4
+
+struct bn_mont_ctx_st;
+
+// Raises a base that never changes, like the SRP6 generator, to any power modulo
+// a fixed modulus. The powers of the base for every window of the exponent are
+// computed up front, so an exponentiation is one Montgomery multiplication per
+// window instead of a squaring per bit. The table is only read afterwards, so one
+// instance can be used by any number of threads.
+class FixedBaseModExp
+{
+	public:
+		FixedBaseModExp(const BigNumber & base, const BigNumber & mod, int maxbits);
+		~FixedBaseModExp();
+
+		// base ^ exp % mod, exponents longer than maxbits fall back to BN_mod_exp
+		BigNumber ModExp(const BigNumber & exp) const;
+
+	private:
+		int _windows;
+		std::vector<struct bignum_st*> _table;	// base ^ (digit << (window * FIXEDBASE_WINDOW_BITS)), in Montgomery form
+		struct bignum_st* _base;
+		struct bignum_st* _mod;
+		struct bignum_st* _one;					// 1 in Montgomery form
+		struct bn_mont_ctx_st* _mont;
+};
+
 #endif
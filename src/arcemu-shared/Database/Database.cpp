@@ -111,6 +111,27 @@ QueryResult* Database::FQuery(const char* QueryString, DatabaseConnection* con)
 	return qResult;
 }
 
+QueryResult* Database::QueryStream(const char* QueryString, ...)
+{
+	char sql[16384];
+	va_list vlist;
+	va_start(vlist, QueryString);
+	vsnprintf(sql, 16384, QueryString, vlist);
+	va_end(vlist);
+
+	// the result releases the connection when it's deleted
+	QueryResult* qResult = NULL;
+	DatabaseConnection* con = GetFreeConnection();
+
+	if(_SendQuery(con, sql, false))
+		qResult = _UseQueryResult(con);
+
+	if(qResult == NULL)
+		con->Busy.Release();
+
+	return qResult;
+}
+
 void Database::FWaitExecute(const char* QueryString, DatabaseConnection* con)
 {
 	// Send the query
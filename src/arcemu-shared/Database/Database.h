@@ -89,6 +89,13 @@ class SERVER_DECL Database : public CThread
 		virtual QueryResult* Query(const char* QueryString, ...);
 		virtual QueryResult* QueryNA(const char* QueryString);
 		virtual QueryResult* FQuery(const char* QueryString, DatabaseConnection* con);
+
+		/** Runs a query whose rows are fetched from the server while they are read, instead of
+		 * buffering the whole result set first. The connection stays busy until the result is deleted,
+		 * so read it to the end quickly and don't run other queries meanwhile.
+		 * GetRowCount() of the result is the number of rows fetched so far.
+		 */
+		virtual QueryResult* QueryStream(const char* QueryString, ...);
 		virtual void FWaitExecute(const char* QueryString, DatabaseConnection* con);
 		virtual bool WaitExecute(const char* QueryString, ...);//Wait For Request Completion
 		virtual bool WaitExecuteNA(const char* QueryString);//Wait For Request Completion
@@ -134,6 +141,7 @@ class SERVER_DECL Database : public CThread
 		// actual query function
 		virtual bool _SendQuery(DatabaseConnection* con, const char* Sql, bool Self) = 0;
 		virtual QueryResult* _StoreQueryResult(DatabaseConnection* con) = 0;
+		virtual QueryResult* _UseQueryResult(DatabaseConnection* con) = 0;
 
 		////////////////////////////////
 		FQueue<QueryBuffer*> query_buffer;
@@ -181,15 +181,19 @@ bool MySQLDatabase::_HandleError(MySQLDatabaseConnection* con, uint32 ErrorNumbe
 	return false;
 }
 
-MySQLQueryResult::MySQLQueryResult(MYSQL_RES* res, uint32 FieldCount, uint32 RowCount) : QueryResult(FieldCount, RowCount), mResult(res)
+MySQLQueryResult::MySQLQueryResult(MYSQL_RES* res, uint32 FieldCount, uint32 RowCount, DatabaseConnection* StreamCon) : QueryResult(FieldCount, RowCount), mResult(res), mStreamCon(StreamCon)
 {
 	mCurrentRow = new Field[FieldCount];
 }
 
 MySQLQueryResult::~MySQLQueryResult()
 {
+	// for a streamed result this also reads and drops the rows that are left
 	mysql_free_result(mResult);
 	delete [] mCurrentRow;
+
+	if(mStreamCon != NULL)
+		mStreamCon->Busy.Release();
 }
 
 bool MySQLQueryResult::NextRow()
@@ -198,6 +202,9 @@ bool MySQLQueryResult::NextRow()
 	if(row == NULL)
 		return false;
 
+	if(mStreamCon != NULL)
+		++mRowCount;
+
 	for(uint32 i = 0; i < mFieldCount; ++i)
 		mCurrentRow[i].SetValue(row[i]);
 
@@ -226,6 +233,33 @@ QueryResult* MySQLDatabase::_StoreQueryResult(DatabaseConnection* con)
 	return res;
 }
 
+QueryResult* MySQLDatabase::_UseQueryResult(DatabaseConnection* con)
+{
+	MySQLDatabaseConnection* db = static_cast<MySQLDatabaseConnection*>(con);
+	MYSQL_RES* pRes = mysql_use_result(db->MySql);
+	uint32 uFields = (uint32)mysql_field_count(db->MySql);
+
+	if(uFields == 0 || pRes == 0)
+	{
+		if(pRes != NULL)
+			mysql_free_result(pRes);
+
+		return NULL;
+	}
+
+	// the row count isn't known before the end, so fetch the first row to see if there is one
+	MySQLQueryResult* res = new MySQLQueryResult(pRes, uFields, 0, con);
+	if(!res->NextRow())
+	{
+		// don't release the connection twice, QueryStream() does it when we return NULL
+		res->mStreamCon = NULL;
+		delete res;
+		return NULL;
+	}
+
+	return res;
+}
+
 bool MySQLDatabase::_Reconnect(MySQLDatabaseConnection* conn)
 {
 	MYSQL* temp, *temp2;
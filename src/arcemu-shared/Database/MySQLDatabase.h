@@ -62,18 +62,23 @@ class SERVER_DECL MySQLDatabase : public Database
 		bool _Reconnect(MySQLDatabaseConnection* conn);
 
 		QueryResult* _StoreQueryResult(DatabaseConnection* con);
+		QueryResult* _UseQueryResult(DatabaseConnection* con);
 };
 
 class SERVER_DECL MySQLQueryResult : public QueryResult
 {
+		friend class MySQLDatabase;
 	public:
-		MySQLQueryResult(MYSQL_RES* res, uint32 FieldCount, uint32 RowCount);
+		MySQLQueryResult(MYSQL_RES* res, uint32 FieldCount, uint32 RowCount, DatabaseConnection* StreamCon = NULL);
 		~MySQLQueryResult();
 
 		bool NextRow();
 
 	protected:
 		MYSQL_RES* mResult;
+
+		// connection a streamed result is read from, released with the result
+		DatabaseConnection* mStreamCon;
 };
 
 #endif		// __MYSQLDATABASE_H
@@ -131,6 +131,25 @@ class FastQueue
 			m_lock.Release();
 		}
 
+		/** moves every queued element to the back of out, in order, taking the lock only once.
+		 */
+		template<class C>
+		void PopAll(C & out)
+		{
+			m_lock.Acquire();
+			node* n = first;
+			first = last = NULL;
+			m_lock.Release();
+
+			while(n != NULL)
+			{
+				node* td = n;
+				out.push_back(n->element);
+				n = n->next;
+				delete td;
+			}
+		}
+
 		bool HasItems()
 		{
 			bool ret;
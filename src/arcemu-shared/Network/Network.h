@@ -14,6 +14,7 @@
 #include "CircularBuffer.h"
 #include "SocketDefines.h"
 #include "SocketOps.h"
+#include "SendQueue.h"
 #include "Socket.h"
 
 #ifdef CONFIG_USE_IOCP
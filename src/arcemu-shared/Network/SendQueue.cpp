@@ -0,0 +1,209 @@
+/*
+ * Multiplatform Async Network Library
+ * Copyright (c) 2007 Burlex
+ *
+ * SendQueue.cpp - Queue of reference counted buffers waiting to be written
+ *                 to a socket with a single gather write.
+ *
+ */
+
+#include "Network.h"
+
+SharedPacketBuffer::SharedPacketBuffer(size_t size) : m_size(size), m_capacity(size)
+{
+	m_data = (uint8*)malloc(size ? size : 1);
+}
+
+SharedPacketBuffer::~SharedPacketBuffer()
+{
+	free(m_data);
+}
+
+SharedPacketBuffer* SharedPacketBuffer::Create(size_t size)
+{
+	return new SharedPacketBuffer(size);
+}
+
+SharedPacketBuffer* SharedPacketBuffer::Create(const void* data, size_t size)
+{
+	SharedPacketBuffer* buffer = new SharedPacketBuffer(size);
+	if(size)
+		memcpy(buffer->m_data, data, size);
+
+	return buffer;
+}
+
+SendQueue::SendQueue() : m_size(0), m_spareCopies(NULL)
+{
+}
+
+SendQueue::~SendQueue()
+{
+	Clear();
+
+	if(m_spareCopies != NULL)
+		m_spareCopies->DecRef();
+}
+
+void SendQueue::Push(const void* prefix, uint32 prefixSize, SharedPacketBuffer* payload)
+{
+	ASSERT(prefixSize <= SENDQUEUE_MAX_PREFIX);
+
+	Entry e;
+	if(prefixSize)
+		memcpy(e.prefix, prefix, prefixSize);
+	e.prefixSize = prefixSize;
+	e.payload = payload;
+	e.offset = 0;
+	e.copies = false;
+
+	if(payload != NULL)
+	{
+		payload->AddRef();
+		m_size += payload->GetSize();
+	}
+	m_size += prefixSize;
+
+	m_entries.push_back(e);
+}
+
+void SendQueue::PushCopy(const void* data, size_t size)
+{
+	if(size == 0)
+		return;
+
+	if(!m_entries.empty())
+	{
+		Entry & last = m_entries.back();
+		if(last.copies && last.payload->GetSpace() >= size)
+		{
+			last.payload->Append(data, size);
+			m_size += size;
+			return;
+		}
+	}
+
+	SharedPacketBuffer* buffer;
+	if(m_spareCopies != NULL && m_spareCopies->GetSpace() >= size)
+	{
+		buffer = m_spareCopies;
+		m_spareCopies = NULL;
+	}
+	else
+	{
+		buffer = SharedPacketBuffer::Create(std::max(size, (size_t)SENDQUEUE_COPY_BUFFER_SIZE));
+		buffer->SetSize(0);
+	}
+
+	buffer->Append(data, size);
+	Push(NULL, 0, buffer);
+	m_entries.back().copies = true;
+	buffer->DecRef();
+}
+
+void SendQueue::Release(Entry & e)
+{
+	if(e.payload == NULL)
+		return;
+
+	// nobody else knows about a copy buffer, so it can be emptied and filled again
+	if(e.copies && m_spareCopies == NULL)
+	{
+		e.payload->SetSize(0);
+		m_spareCopies = e.payload;
+	}
+	else
+		e.payload->DecRef();
+}
+
+void SendQueue::Remove(size_t len)
+{
+	while(len > 0 && !m_entries.empty())
+	{
+		Entry & e = m_entries.front();
+		size_t total = e.prefixSize + (e.payload ? e.payload->GetSize() : 0);
+		size_t left = total - e.offset;
+
+		if(len < left)
+		{
+			e.offset += len;
+			m_size -= len;
+			return;
+		}
+
+		len -= left;
+		m_size -= left;
+		Release(e);
+		m_entries.pop_front();
+	}
+}
+
+size_t SendQueue::CopyTo(CircularBuffer & buffer)
+{
+	size_t copied = 0;
+	while(!m_entries.empty())
+	{
+		Entry & e = m_entries.front();
+		size_t prefixLeft = (e.offset < e.prefixSize) ? e.prefixSize - e.offset : 0;
+		size_t payloadOffset = (e.offset > e.prefixSize) ? e.offset - e.prefixSize : 0;
+		size_t payloadLeft = e.payload ? e.payload->GetSize() - payloadOffset : 0;
+
+		// keep entries whole, so a header never ends up separated from its packet
+		if(buffer.GetSpace() < prefixLeft + payloadLeft)
+			break;
+
+		if(prefixLeft)
+			buffer.Write(&e.prefix[ e.offset ], prefixLeft);
+		if(payloadLeft)
+			buffer.Write(e.payload->GetData() + payloadOffset, payloadLeft);
+
+		copied += prefixLeft + payloadLeft;
+		Remove(prefixLeft + payloadLeft);
+	}
+
+	return copied;
+}
+
+void SendQueue::Clear()
+{
+	for(std::deque<Entry>::iterator itr = m_entries.begin(); itr != m_entries.end(); ++itr)
+		Release(*itr);
+
+	m_entries.clear();
+	m_size = 0;
+}
+
+#ifndef WIN32
+
+uint32 SendQueue::Gather(struct iovec* vec, uint32 count)
+{
+	uint32 used = 0;
+	for(std::deque<Entry>::iterator itr = m_entries.begin(); itr != m_entries.end() && used < count; ++itr)
+	{
+		Entry & e = *itr;
+		size_t payloadOffset = 0;
+
+		if(e.offset < e.prefixSize)
+		{
+			vec[ used ].iov_base = &e.prefix[ e.offset ];
+			vec[ used ].iov_len = e.prefixSize - e.offset;
+			++used;
+		}
+		else
+			payloadOffset = e.offset - e.prefixSize;
+
+		if(e.payload != NULL && e.payload->GetSize() > payloadOffset)
+		{
+			if(used == count)
+				break;
+
+			vec[ used ].iov_base = e.payload->GetData() + payloadOffset;
+			vec[ used ].iov_len = e.payload->GetSize() - payloadOffset;
+			++used;
+		}
+	}
+
+	return used;
+}
+
+#endif
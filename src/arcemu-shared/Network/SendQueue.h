@@ -0,0 +1,136 @@
+/*
+ * Multiplatform Async Network Library
+ * Copyright (c) 2007 Burlex
+ *
+ * SendQueue.h - Queue of reference counted buffers waiting to be written
+ *               to a socket with a single gather write.
+ *
+ */
+
+#ifndef _NETLIB_SENDQUEUE_H
+#define _NETLIB_SENDQUEUE_H
+
+#include <deque>
+
+#ifndef WIN32
+#include <sys/uio.h>
+#endif
+
+class CircularBuffer;
+
+/** Maximum number of per-socket bytes (packet header) that can precede a shared payload.
+ */
+#define SENDQUEUE_MAX_PREFIX 8
+
+/** Maximum number of buffers passed to a single writev() call.
+ */
+#define SENDQUEUE_MAX_IOV 64
+
+/** Size of the buffers copied bytes are packed into while shared buffers are queued.
+ */
+#define SENDQUEUE_COPY_BUFFER_SIZE 4096
+
+/** Reference counted, immutable once queued, byte buffer.
+ * The same buffer can be queued on any number of sockets, it is freed when the last one
+ * has written it out and released its reference.
+ */
+class SERVER_DECL SharedPacketBuffer : public Arcemu::Shared::CRefCounter
+{
+	public:
+		/** Allocates a buffer of size bytes with a reference count of 1
+		 */
+		static SharedPacketBuffer* Create(size_t size);
+
+		/** Allocates a buffer holding a copy of data, with a reference count of 1
+		 */
+		static SharedPacketBuffer* Create(const void* data, size_t size);
+
+		uint8* GetData() { return m_data; }
+		const uint8* GetData() const { return m_data; }
+		size_t GetSize() const { return m_size; }
+
+		/** Returns the number of bytes that can still be appended
+		 */
+		size_t GetSpace() const { return m_capacity - m_size; }
+
+		/** Shrinks the buffer to the number of bytes actually used. Only call this before the buffer is queued.
+		 */
+		void SetSize(size_t size) { ASSERT(size <= m_capacity); m_size = size; }
+
+		/** Copies size bytes to the end of the buffer. Only for buffers nobody else holds a reference to.
+		 */
+		void Append(const void* data, size_t size) { ASSERT(size <= GetSpace()); memcpy(m_data + m_size, data, size); m_size += size; }
+
+	private:
+		SharedPacketBuffer(size_t size);
+		~SharedPacketBuffer();
+
+		uint8* m_data;
+		size_t m_size;
+		size_t m_capacity;
+};
+
+class SERVER_DECL SendQueue
+{
+		struct Entry
+		{
+			uint8 prefix[SENDQUEUE_MAX_PREFIX];
+			uint32 prefixSize;
+			SharedPacketBuffer* payload;
+			size_t offset;				// bytes of prefix + payload already written
+			bool copies;				// payload only holds bytes copied by PushCopy, it can grow
+		};
+
+		std::deque<Entry> m_entries;
+		size_t m_size;
+		SharedPacketBuffer* m_spareCopies;	// written out copy buffer kept for the next PushCopy
+
+		void Release(Entry & e);
+
+	public:
+		SendQueue();
+		~SendQueue();
+
+		/** Appends prefix (copied) followed by payload (referenced, not copied)
+		 * @param prefix bytes that belong to this socket only, eg. an encrypted packet header
+		 * @param prefixSize size of prefix, at most SENDQUEUE_MAX_PREFIX
+		 * @param payload buffer to send after the prefix, may be NULL. The queue takes its own reference.
+		 */
+		void Push(const void* prefix, uint32 prefixSize, SharedPacketBuffer* payload);
+
+		/** Appends a copy of data. Small writes are packed together into one buffer owned by the
+		 * queue, which is kept for the next copies once it was written out.
+		 */
+		void PushCopy(const void* data, size_t size);
+
+		/** Returns the number of bytes waiting to be written
+		 */
+		size_t GetSize() const { return m_size; }
+
+		bool IsEmpty() const { return m_entries.empty(); }
+
+		/** Removes len bytes from the front of the queue, releasing buffers that were fully written
+		 */
+		void Remove(size_t len);
+
+		/** Copies as many whole entries as fit into a circular buffer and removes them from the queue.
+		 * Used by backends that can't write scattered buffers.
+		 * @return number of bytes copied
+		 */
+		size_t CopyTo(CircularBuffer & buffer);
+
+		/** Drops everything in the queue
+		 */
+		void Clear();
+
+#ifndef WIN32
+		/** Fills vec with the unwritten parts of the queued entries, in order
+		 * @param vec array to fill
+		 * @param count number of elements available in vec
+		 * @return number of elements used
+		 */
+		uint32 Gather(struct iovec* vec, uint32 count);
+#endif
+};
+
+#endif		// _NETLIB_SENDQUEUE_H
@@ -15,6 +15,7 @@ Socket::Socket(SOCKET fd, uint32 sendbuffersize, uint32 recvbuffersize) : m_fd(f
 	// Allocate Buffers
 	readBuffer.Allocate(recvbuffersize);
 	writeBuffer.Allocate(sendbuffersize);
+	m_writeBufferSize = sendbuffersize;
 
 	m_BytesSent = 0;
 	m_BytesRecieved = 0;
@@ -101,9 +102,35 @@ bool Socket::Send(const uint8* Bytes, uint32 Size)
 
 bool Socket::BurstSend(const uint8* Bytes, uint32 Size)
 {
+	// Once shared buffers are queued everything else has to go behind them, or the stream would be reordered.
+	if(!m_sendQueue.IsEmpty())
+	{
+		if(GetSharedSendSpace() < Size)
+			return false;
+
+		m_sendQueue.PushCopy(Bytes, Size);
+		return true;
+	}
+
 	return writeBuffer.Write(Bytes, Size);
 }
 
+bool Socket::BurstSendShared(const uint8* prefix, uint32 prefixSize, SharedPacketBuffer* payload)
+{
+	size_t size = prefixSize + (payload ? payload->GetSize() : 0);
+	if(prefixSize > SENDQUEUE_MAX_PREFIX || GetSharedSendSpace() < size)
+		return false;
+
+	m_sendQueue.Push(prefix, prefixSize, payload);
+	return true;
+}
+
+size_t Socket::GetSharedSendSpace()
+{
+	size_t used = writeBuffer.GetSize() + m_sendQueue.GetSize();
+	return (used < m_writeBufferSize) ? (m_writeBufferSize - used) : 0;
+}
+
 string Socket::GetRemoteIP()
 {
 	char* ip = (char*)inet_ntoa(m_client.sin_addr);
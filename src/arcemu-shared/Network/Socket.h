@@ -51,9 +51,18 @@ class SERVER_DECL Socket
 		// Burst system - Adds bytes to output buffer.
 		bool BurstSend(const uint8* Bytes, uint32 Size);
 
+		// Burst system - Queues prefix followed by a reference to payload. The payload is not copied.
+		bool BurstSendShared(const uint8* prefix, uint32 prefixSize, SharedPacketBuffer* payload);
+
 		// Burst system - Pushes event to queue - do at the end of write events.
 		void BurstPush();
 
+		// Burst system - Returns the number of bytes that can still be queued with BurstSendShared.
+		size_t GetSharedSendSpace();
+
+		// Returns true if there is data waiting in either the write buffer or the send queue.
+		ARCEMU_INLINE bool HasPendingWrites() { return (writeBuffer.GetSize() > 0 || !m_sendQueue.IsEmpty()); }
+
 		// Burst system - Unlocks the sending mutex.
 		ARCEMU_INLINE void BurstEnd() { m_writeMutex.Release(); }
 
@@ -98,6 +107,10 @@ class SERVER_DECL Socket
 		Mutex m_writeMutex;
 		Mutex m_readMutex;
 
+		// Shared buffers waiting to be written after the contents of writeBuffer. Protected by m_writeMutex.
+		SendQueue m_sendQueue;
+		uint32 m_writeBufferSize;
+
 		// we are connected? stop from posting events.
 		Arcemu::Threading::AtomicBoolean m_connected;
 
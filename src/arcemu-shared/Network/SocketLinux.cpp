@@ -57,7 +57,37 @@ void Socket::WriteCallback()
 		return;
 
 	// We should already be locked at this point, so try to push everything out.
-	int bytes_written = send(m_fd, writeBuffer.GetBufferStart(), writeBuffer.GetContiguiousBytes(), 0);
+	if(m_sendQueue.IsEmpty())
+	{
+		int bytes_written = send(m_fd, writeBuffer.GetBufferStart(), writeBuffer.GetContiguiousBytes(), 0);
+		if(bytes_written < 0)
+		{
+			// error.
+			Disconnect();
+			return;
+		}
+		m_BytesSent += bytes_written;
+
+		writeBuffer.Remove(bytes_written);
+		return;
+	}
+
+	// Gather the write buffer and the queued shared buffers into a single writev().
+	struct iovec vec[SENDQUEUE_MAX_IOV];
+	uint32 count = 0;
+	size_t buffered = writeBuffer.GetContiguiousBytes();
+	if(buffered > 0)
+	{
+		vec[ count ].iov_base = writeBuffer.GetBufferStart();
+		vec[ count ].iov_len = buffered;
+		++count;
+	}
+
+	// The second region of the write buffer has to go out before anything in the queue.
+	if(buffered == writeBuffer.GetSize())
+		count += m_sendQueue.Gather(&vec[ count ], SENDQUEUE_MAX_IOV - count);
+
+	ssize_t bytes_written = writev(m_fd, vec, count);
 	if(bytes_written < 0)
 	{
 		// error.
@@ -66,8 +96,9 @@ void Socket::WriteCallback()
 	}
 	m_BytesSent += bytes_written;
 
-	//RemoveWriteBufferBytes(bytes_written, false);
-	writeBuffer.Remove(bytes_written);
+	size_t from_buffer = std::min(buffered, (size_t)bytes_written);
+	writeBuffer.Remove(from_buffer);
+	m_sendQueue.Remove(bytes_written - from_buffer);
 }
 
 void Socket::BurstPush()
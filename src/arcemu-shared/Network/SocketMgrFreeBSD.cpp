@@ -16,7 +16,7 @@ void SocketMgr::AddSocket(Socket* s)
 	fds[s->GetFd()] = s;
 
 	struct kevent ev;
-	if(s->writeBuffer.GetSize())
+	if(s->HasPendingWrites())
 		EV_SET(&ev, s->GetFd(), EVFILT_WRITE, EV_ADD | EV_ONESHOT, 0, 0, NULL);
 	else
 		EV_SET(&ev, s->GetFd(), EVFILT_READ, EV_ADD, 0, 0, NULL);
@@ -136,7 +136,7 @@ bool SocketWorkerThread::run()
 			{
 				ptr->BurstBegin();          // Lock receive mutex
 				ptr->WriteCallback();       // Perform actual send()
-				if(ptr->writeBuffer.GetSize() > 0)
+				if(ptr->HasPendingWrites())
 					ptr->PostEvent(EVFILT_WRITE, true);   // Still remaining data.
 				else
 				{
@@ -148,7 +148,7 @@ bool SocketWorkerThread::run()
 			else if(events[i].filter == EVFILT_READ)
 			{
 				ptr->ReadCallback(0);               // Len is unknown at this point.
-				if(ptr->writeBuffer.GetSize() > 0 && ptr->IsConnected() && !ptr->HasSendLock())
+				if(ptr->HasPendingWrites() && ptr->IsConnected() && !ptr->HasSendLock())
 				{
 					ptr->PostEvent(EVFILT_WRITE, true);
 					ptr->IncSendLock();
@@ -51,7 +51,7 @@ void SocketMgr::AddSocket(Socket* s)
 	// Add epoll event based on socket activity.
 	struct epoll_event ev;
 	memset(&ev, 0, sizeof(epoll_event));
-	ev.events = (s->writeBuffer.GetSize()) ? EPOLLOUT : EPOLLIN;
+	ev.events = (s->HasPendingWrites()) ? EPOLLOUT : EPOLLIN;
 	ev.events |= EPOLLET;			/* use edge-triggered instead of level-triggered because we're using nonblocking sockets */
 	ev.data.fd = s->GetFd();
 
@@ -156,14 +156,14 @@ bool SocketWorkerThread::run()
 				ptr->ReadCallback(0);               // Len is unknown at this point.
 
 				/* changing to written state? */
-				if(ptr->writeBuffer.GetSize() && !ptr->HasSendLock() && ptr->IsConnected())
+				if(ptr->HasPendingWrites() && !ptr->HasSendLock() && ptr->IsConnected())
 					ptr->PostEvent(EPOLLOUT);
 			}
 			else if(events[i].events & EPOLLOUT)
 			{
 				ptr->BurstBegin();          // Lock receive mutex
 				ptr->WriteCallback();       // Perform actual send()
-				if(ptr->writeBuffer.GetSize() > 0)
+				if(ptr->HasPendingWrites())
 				{
 					/* we don't have to do anything here. no more oneshots :) */
 				}
@@ -97,7 +97,7 @@ void HandleWriteComplete(Socket* s, uint32 len)
 		s->m_writeEvent.Unmark();
 		s->BurstBegin();					// Lock
 		s->writeBuffer.Remove(len);
-		if(s->writeBuffer.GetContiguiousBytes() > 0)
+		if(s->HasPendingWrites())
 			s->WriteCallback();
 		else
 			s->DecSendLock();
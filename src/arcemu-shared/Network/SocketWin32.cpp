@@ -18,6 +18,11 @@ void Socket::WriteCallback()
 	//printf("\nSocket::Writecallback(): sendsize : %u\n", this->m_writeByteCount);
 	// We don't want any writes going on while this is happening.
 	m_writeMutex.Acquire();
+
+	// IOCP sends from the write buffer, so move whatever fits from the shared send queue into it.
+	if(!m_sendQueue.IsEmpty())
+		m_sendQueue.CopyTo(writeBuffer);
+
 	if(writeBuffer.GetContiguiousBytes())
 	{
 		DWORD w_length = 0;
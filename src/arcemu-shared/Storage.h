@@ -29,6 +29,9 @@
 
 #define STORAGE_ARRAY_MAX 200000
 
+// SQLStorage::PrepareLoad() only splits a table if every range gets at least this many rows
+#define STORAGE_RANGE_MIN_ROWS 10000
+
 #ifdef STORAGE_ALLOCATION_POOLS
 template<class T>
 class SERVER_DECL StorageAllocationPool
@@ -112,6 +115,8 @@ class SERVER_DECL ArrayStorageContainer
 		 */
 		uint32 _max;
 
+		ArrayStorageContainer() : _array(NULL), _max(0) {}
+
 		/** Returns an iterator currently referencing the start of the container
 		 */
 		StorageContainerIterator<T> * MakeIterator();
@@ -123,10 +128,15 @@ class SERVER_DECL ArrayStorageContainer
 			return true;
 		}
 
+		/** Returns the size the array was set up with
+		 */
+		uint32 GetMax() { return _max; }
+
 		/** Creates the array with specified maximum
 		 */
 		void Setup(uint32 Max)
 		{
+			delete [] _array;
 			_array = new T*[Max];
 			_max = Max;
 			memset(_array, 0, sizeof(T*) * Max);
@@ -275,6 +285,8 @@ class SERVER_DECL HashMapStorageContainer
 			return false;
 		}
 
+		uint32 GetMax() { return 0; }
+
 		/** Creates the array with specified maximum
 		 */
 		void Setup(uint32 Max)
@@ -587,7 +599,7 @@ template<class T, class StorageType>
 class SERVER_DECL SQLStorage : public Storage<T, StorageType>
 {
 	public:
-		SQLStorage() : Storage<T, StorageType>() {}
+		SQLStorage() : Storage<T, StorageType>(), _rangesLeft(0), _loadedRows(0), _loadStart(0) {}
 		~SQLStorage() {}
 
 		/** Loads the block using the format string.
@@ -645,70 +657,295 @@ class SERVER_DECL SQLStorage : public Storage<T, StorageType>
 			}
 		}
 
+		/** Writes one block to a snapshot file
+		 */
+		void SaveSnapshotBlock(FILE* f, T* Allocated)
+		{
+			char* p = Storage<T, StorageType>::_formatString;
+			char* structpointer = (char*)Allocated;
+			uint32 offset = 0;
+			for(; *p != 0; ++p)
+			{
+				switch(*p)
+				{
+					case 'u':
+					case 'i':
+					case 'f':
+						fwrite(&structpointer[offset], sizeof(uint32), 1, f);
+						offset += sizeof(uint32);
+						break;
+
+					case 's':
+						{
+							const char* str = *(char**)&structpointer[offset];
+							uint32 len = (uint32)strlen(str);
+							fwrite(&len, sizeof(uint32), 1, f);
+							fwrite(str, 1, len, f);
+							offset += sizeof(char*);
+						}
+						break;
+
+					case 'c':
+						fwrite(&structpointer[offset], sizeof(uint8), 1, f);
+						offset += sizeof(uint8);
+						break;
+
+					case 'h':
+						fwrite(&structpointer[offset], sizeof(uint16), 1, f);
+						offset += sizeof(uint16);
+						break;
+				}
+			}
+		}
+
+		/** Returns the size of the snapshot block at data, or 0 if it runs past end
+		 */
+		size_t GetSnapshotBlockSize(const uint8* data, const uint8* end)
+		{
+			char* p = Storage<T, StorageType>::_formatString;
+			size_t size = 0;
+			size_t left = end - data;
+			for(; *p != 0; ++p)
+			{
+				size_t len = 0;
+				switch(*p)
+				{
+					case 'u':
+					case 'i':
+					case 'f':
+						len = sizeof(uint32);
+						break;
+
+					case 's':
+						if(left - size < sizeof(uint32))
+							return 0;
+						len = sizeof(uint32) + *(uint32*)(data + size);
+						break;
+
+					case 'c':
+						len = sizeof(uint8);
+						break;
+
+					case 'h':
+						len = sizeof(uint16);
+						break;
+				}
+
+				if(left - size < len)
+					return 0;
+				size += len;
+			}
+
+			return size;
+		}
+
+		/** Loads one block from a snapshot, the size has to be checked with GetSnapshotBlockSize first
+		 */
+		void LoadSnapshotBlock(const uint8* data, T* Allocated)
+		{
+			char* p = Storage<T, StorageType>::_formatString;
+			char* structpointer = (char*)Allocated;
+			uint32 offset = 0;
+			for(; *p != 0; ++p)
+			{
+				switch(*p)
+				{
+					case 'u':
+					case 'i':
+					case 'f':
+						memcpy(&structpointer[offset], data, sizeof(uint32));
+						data += sizeof(uint32);
+						offset += sizeof(uint32);
+						break;
+
+					case 's':
+						{
+							uint32 len = *(uint32*)data;
+							char* str = (char*)malloc(len + 1);
+							memcpy(str, data + sizeof(uint32), len);
+							str[ len ] = 0;
+							*(char**)&structpointer[offset] = str;
+							data += sizeof(uint32) + len;
+							offset += sizeof(char*);
+						}
+						break;
+
+					case 'c':
+						structpointer[offset] = *data;
+						data += sizeof(uint8);
+						offset += sizeof(uint8);
+						break;
+
+					case 'h':
+						memcpy(&structpointer[offset], data, sizeof(uint16));
+						data += sizeof(uint16);
+						offset += sizeof(uint16);
+						break;
+				}
+			}
+		}
+
 		/** Loads from the table.
 		 */
 		void Load(const char* IndexName, const char* FormatString)
+		{
+			PrepareLoad(IndexName, FormatString, 1);
+			LoadRange(0);
+		}
+
+		/** Prepares loading the table in up to MaxRanges primary key ranges, which LoadRange()
+		 * can load at the same time, each over its own database connection.
+		 * Splitting needs an `entry` primary key, and is only done for tables of at least
+		 * STORAGE_RANGE_MIN_ROWS rows per range.
+		 * @return the number of ranges, pass 0 to this-1 to LoadRange()
+		 */
+		uint32 PrepareLoad(const char* IndexName, const char* FormatString, uint32 MaxRanges)
 		{
 			//printf("Loading database cache from `%s`...\n", IndexName);
 			Storage<T, StorageType>::Load(IndexName, FormatString);
+			_loadStart = getMSTime();
+			_loadedRows = 0;
+			_ranges.clear();
+
 			QueryResult* result;
-			if(Storage<T, StorageType>::_storage.NeedsMax())
+			uint32 Count = 0;
+			uint32 Min = 0;
+			uint32 Max = STORAGE_ARRAY_MAX;
+			if(MaxRanges > 1)
+			{
+				result = WorldDatabase.Query("SELECT COUNT(*), MIN(entry), MAX(entry) FROM %s", IndexName);
+				if(result)
+				{
+					Count = result->Fetch()[0].GetUInt32();
+					Min = result->Fetch()[1].GetUInt32();
+					Max = result->Fetch()[2].GetUInt32() + 1;
+					delete result;
+				}
+			}
+			else if(Storage<T, StorageType>::_storage.NeedsMax())
 			{
 				result = WorldDatabase.Query("SELECT MAX(entry) FROM %s", IndexName);
-				uint32 Max = STORAGE_ARRAY_MAX;
 				if(result)
 				{
 					Max = result->Fetch()[0].GetUInt32() + 1;
-					if(Max > STORAGE_ARRAY_MAX)
-					{
-						Log.Error("Storage", "The table, '%s', has a maximum entry of %u, which is less %u. Any items higher than %u will not be loaded.",
-						          IndexName, Max, STORAGE_ARRAY_MAX, STORAGE_ARRAY_MAX);
-
-						Max = STORAGE_ARRAY_MAX;
-					}
 					delete result;
 				}
+			}
+
+			if(Storage<T, StorageType>::_storage.NeedsMax())
+			{
+				if(Max > STORAGE_ARRAY_MAX)
+				{
+					Log.Error("Storage", "The table, '%s', has a maximum entry of %u, which is less %u. Any items higher than %u will not be loaded.",
+					          IndexName, Max, STORAGE_ARRAY_MAX, STORAGE_ARRAY_MAX);
+
+					Max = STORAGE_ARRAY_MAX;
+				}
 
 				Storage<T, StorageType>::_storage.Setup(Max);
 			}
 
-			size_t cols = strlen(FormatString);
-			result = WorldDatabase.Query("SELECT * FROM %s", IndexName);
-			if(!result)
-				return;
-			Field* fields = result->Fetch();
+#ifdef STORAGE_ALLOCATION_POOLS
+			if(Count == 0)
+			{
+				result = WorldDatabase.Query("SELECT COUNT(*) FROM %s", IndexName);
+				if(result)
+				{
+					Count = result->Fetch()[0].GetUInt32();
+					delete result;
+				}
+			}
+			Storage<T, StorageType>::_storage.InitPool(Count);
+#endif
 
-			if(result->GetFieldCount() != cols)
+			uint32 Ranges = Count / STORAGE_RANGE_MIN_ROWS;
+			if(Ranges > MaxRanges)
+				Ranges = MaxRanges;
+
+			if(Ranges < 2 || Max <= Min + Ranges)
+			{
+				// the whole table, without a WHERE
+				_ranges.push_back(make_pair(uint32(0), uint32(0)));
+			}
+			else
+			{
+				// equal parts of the key space, the entries are dense enough for that to even out
+				uint32 step = (Max - Min) / Ranges;
+				for(uint32 i = 0; i < Ranges; ++i)
+					_ranges.push_back(make_pair(Min + i * step, (i == Ranges - 1) ? Max : Min + (i + 1) * step));
+			}
+
+			_rangesLeft = (uint32)_ranges.size();
+			return _rangesLeft;
+		}
+
+		/** Loads one of the ranges set up by PrepareLoad(). The rows are parsed while they arrive
+		 * from the database, instead of after the whole table was buffered.
+		 */
+		void LoadRange(uint32 Index)
+		{
+			const char* IndexName = Storage<T, StorageType>::_indexName;
+			size_t cols = strlen(Storage<T, StorageType>::_formatString);
+			bool split = (_ranges.size() > 1);
+			uint32 rows = 0;
+
+			QueryResult* result;
+			if(split)
+				result = WorldDatabase.QueryStream("SELECT * FROM %s WHERE entry >= %u AND entry < %u", IndexName, _ranges[Index].first, _ranges[Index].second);
+			else
+				result = WorldDatabase.QueryStream("SELECT * FROM %s", IndexName);
+
+			if(result && result->GetFieldCount() != cols)
 			{
 				if(result->GetFieldCount() > cols)
 				{
-					Log.Error("Storage", "Invalid format in %s (%u/%u), loading anyway because we have enough data", IndexName, (unsigned int)cols, (unsigned int)result->GetFieldCount());
+					if(Index == 0)
+						Log.Error("Storage", "Invalid format in %s (%u/%u), loading anyway because we have enough data", IndexName, (unsigned int)cols, (unsigned int)result->GetFieldCount());
 				}
 				else
 				{
-					Log.Error("Storage", "Invalid format in %s (%u/%u), not enough data to proceed.", IndexName, (unsigned int)cols, (unsigned int)result->GetFieldCount());
+					if(Index == 0)
+						Log.Error("Storage", "Invalid format in %s (%u/%u), not enough data to proceed.", IndexName, (unsigned int)cols, (unsigned int)result->GetFieldCount());
 					delete result;
-					return;
+					result = NULL;
 				}
 			}
 
-			uint32 Entry;
-			T* Allocated;
-#ifdef STORAGE_ALLOCATION_POOLS
-			Storage<T, StorageType>::_storage.InitPool(result->GetRowCount());
-#endif
-			do
+			if(result)
 			{
-				Entry = fields[0].GetUInt32();
-				Allocated = Storage<T, StorageType>::_storage.AllocateEntry(Entry);
-				if(!Allocated)
-					continue;
+				Field* fields = result->Fetch();
+				uint32 Entry;
+				T* Allocated;
+				do
+				{
+					Entry = fields[0].GetUInt32();
 
-				LoadBlock(fields, Allocated);
+					// the other ranges fill the same container
+					if(split)
+						_loadLock.Acquire();
+					Allocated = Storage<T, StorageType>::_storage.AllocateEntry(Entry);
+					if(split)
+						_loadLock.Release();
+
+					if(!Allocated)
+						continue;
+
+					LoadBlock(fields, Allocated);
+				}
+				while(result->NextRow());
+
+				rows = result->GetRowCount();
+				delete result;
 			}
-			while(result->NextRow());
-			Log.Success("Storage", "%u entries loaded from table %s.", result->GetRowCount(), IndexName);
-			delete result;
+
+			// the last range to finish reports the whole table
+			_loadLock.Acquire();
+			_loadedRows += rows;
+			bool last = (--_rangesLeft == 0);
+			_loadLock.Release();
+
+			if(last)
+				Log.Success("Storage", "%u entries loaded from table %s in %u ms.", _loadedRows, IndexName, getMSTime() - _loadStart);
 
 			//Log.Success("Storage", "Loaded database cache from `%s`.", IndexName);
 		}
@@ -773,6 +1010,74 @@ class SERVER_DECL SQLStorage : public Storage<T, StorageType>
 			delete result;
 		}
 
+		/** Writes every entry to a snapshot file, each field as laid out by the format string.
+		 * Strings are written as a uint32 length followed by the characters.
+		 */
+		void SaveSnapshot(FILE* f)
+		{
+			uint32 Max = Storage<T, StorageType>::_storage.GetMax();
+			uint32 count = 0;
+
+			StorageContainerIterator<T> * itr = Storage<T, StorageType>::_storage.MakeIterator();
+			while(!itr->AtEnd())
+			{
+				++count;
+				if(!itr->Inc())
+					break;
+			}
+			itr->Destruct();
+
+			fwrite(&Max, sizeof(uint32), 1, f);
+			fwrite(&count, sizeof(uint32), 1, f);
+
+			itr = Storage<T, StorageType>::_storage.MakeIterator();
+			while(!itr->AtEnd())
+			{
+				SaveSnapshotBlock(f, itr->Get());
+				if(!itr->Inc())
+					break;
+			}
+			itr->Destruct();
+		}
+
+		/** Loads the container from a snapshot written by SaveSnapshot, instead of the table.
+		 * @param data current read position, advanced past this storage on success
+		 * @param end end of the snapshot data
+		 * @return false if the snapshot is truncated or inconsistent, the storage has to be cleaned up then
+		 */
+		bool LoadSnapshot(const char* IndexName, const char* FormatString, const uint8* & data, const uint8* end)
+		{
+			Storage<T, StorageType>::Load(IndexName, FormatString);
+
+			if(end - data < 2 * (ptrdiff_t)sizeof(uint32))
+				return false;
+
+			uint32 Max = *(uint32*)data;
+			uint32 count = *(uint32*)(data + sizeof(uint32));
+			data += 2 * sizeof(uint32);
+
+			if(Storage<T, StorageType>::_storage.NeedsMax())
+				Storage<T, StorageType>::_storage.Setup(Max);
+
+			for(uint32 i = 0; i < count; ++i)
+			{
+				// check the whole block first, so we never allocate an entry we can't fill
+				size_t len = GetSnapshotBlockSize(data, end);
+				if(len == 0)
+					return false;
+
+				T* Allocated = Storage<T, StorageType>::_storage.AllocateEntry(*(uint32*)data);
+				if(!Allocated)
+					return false;
+
+				LoadSnapshotBlock(data, Allocated);
+				data += len;
+			}
+
+			Log.Success("Storage", "%u entries loaded from snapshot of table %s.", count, IndexName);
+			return true;
+		}
+
 		/** Reloads the storage container
 		 */
 		void Reload()
@@ -827,6 +1132,14 @@ class SERVER_DECL SQLStorage : public Storage<T, StorageType>
 			while(result->NextRow());
 			delete result;
 		}
+
+	protected:
+		// set up by PrepareLoad(), primary key ranges [first, second), or a single (0, 0) for the whole table
+		std::vector< std::pair< uint32, uint32 > > _ranges;
+		Mutex _loadLock;
+		uint32 _rangesLeft;
+		uint32 _loadedRows;
+		uint32 _loadStart;
 };
 
 #endif
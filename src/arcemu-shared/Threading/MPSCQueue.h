@@ -0,0 +1,338 @@
+/*
+ * ArcEmu MMORPG Server
+ * Copyright (C) 2008-2012 <http://www.ArcEmu.org/>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MPSCQUEUE_HPP_
+#define MPSCQUEUE_HPP_
+
+#include "Mutex.h"
+#include <deque>
+
+namespace Arcemu
+{
+	namespace Threading
+	{
+
+		/////////////////////////////////////////////////////////////////////////
+		//class MPSCQueue
+		//  Bounded, lockless, multiple producer single consumer FIFO queue.
+		//
+		//  Any number of threads can Push() concurrently, but Pop(), front(),
+		//  pop_front(), PopAll() and HasItems() must only ever be called by one
+		//  thread at a time.
+		//
+		//  Elements are stored in a ring of cells. Every cell has a sequence
+		//  number that tells producers and the consumer whose turn it is, so
+		//  producers only have to agree on the next free position with a single
+		//  compare and swap, and the consumer never writes a shared counter.
+		//
+		//  T has to be a pointer type, Pop() returns NULL when the queue is empty.
+		//
+		//  A queue constructed with overflow set never fails a Push(). When the
+		//  ring is full, elements go to a locked list until the consumer has
+		//  emptied it, so only a queue that is already backed up pays for a lock.
+		//
+		/////////////////////////////////////////////////////////////////////////
+		template< class T >
+		class MPSCQueue
+		{
+			public:
+				////////////////////////////////////////////////////////////
+				//MPSCQueue( uint32 capacity, bool overflow )
+				// Parameters
+				//  uint32 capacity  -  size of the ring, rounded up to a power
+				//                      of 2. The maximum number of queued
+				//                      elements unless overflow is set.
+				//  bool overflow    -  queue elements that don't fit in the
+				//                      ring in a locked list instead of failing
+				///////////////////////////////////////////////////////////
+				MPSCQueue(uint32 capacity, bool overflow = false)
+				{
+					m_capacity = 2;
+					while(m_capacity < capacity)
+						m_capacity <<= 1;
+					m_mask = m_capacity - 1;
+
+					m_cells = new Cell[ m_capacity ];
+					for(uint32 i = 0; i < m_capacity; ++i)
+					{
+						m_cells[ i ].sequence = i;
+						m_cells[ i ].element = reinterpret_cast< T >(NULL);
+					}
+
+					m_enqueuePos = 0;
+					m_dequeuePos = 0;
+
+					m_overflow = overflow;
+					m_overflowing = 0;
+					m_frontFromOverflow = false;
+				}
+
+				~MPSCQueue()
+				{
+					delete[] m_cells;
+				}
+
+				////////////////////////////////////////////////////////////
+				//bool Push( T elem )
+				// threadsafe enqueue operation, lockless unless the queue overflows
+				//
+				// Parameters
+				//  T elem  -  element to queue
+				//
+				// Return values
+				//  Returns true if the element was queued.
+				//  Returns false if the queue is full, never if it overflows.
+				///////////////////////////////////////////////////////////
+				bool Push(T elem)
+				{
+					// once elements went to the overflow list, the ones after them have to follow
+					if(m_overflow && LoadAcquire(&m_overflowing) && PushOverflow(elem, false))
+						return true;
+
+					if(PushRing(elem))
+						return true;
+
+					if(!m_overflow)
+						return false;
+
+					PushOverflow(elem, true);
+					return true;
+				}
+
+				////////////////////////////////////////////////////////////
+				//T Pop()
+				// Removes the oldest element. Consumer thread only.
+				//
+				// Return values
+				//  Returns the element, or NULL if the queue is empty.
+				///////////////////////////////////////////////////////////
+				T Pop()
+				{
+					T ret = front();
+					if(ret != NULL)
+						pop_front();
+
+					return ret;
+				}
+
+				////////////////////////////////////////////////////////////
+				//T front()
+				// Returns the oldest element without removing it, or NULL
+				// if the queue is empty. Consumer thread only.
+				///////////////////////////////////////////////////////////
+				T front()
+				{
+					// the ring holds everything queued before the overflow started
+					Cell* cell = &m_cells[ m_dequeuePos & m_mask ];
+					if(LoadAcquire(&cell->sequence) == m_dequeuePos + 1)
+					{
+						m_frontFromOverflow = false;
+						return cell->element;
+					}
+
+					if(!m_overflow || !LoadAcquire(&m_overflowing))
+						return reinterpret_cast< T >(NULL);
+
+					// A cell claimed in the ring before the overflow started comes first, even if its producer
+					// hasn't written it yet. Checked under the lock, which makes that claim visible here.
+					T ret = reinterpret_cast< T >(NULL);
+					m_overflowLock.Acquire();
+					if(LoadAcquire(&m_enqueuePos) == m_dequeuePos && !m_overflowQueue.empty())
+						ret = m_overflowQueue.front();
+					m_overflowLock.Release();
+
+					m_frontFromOverflow = (ret != NULL);
+					return ret;
+				}
+
+				////////////////////////////////////////////////////////////
+				//void pop_front()
+				// Removes the element returned by front(). Consumer thread only.
+				///////////////////////////////////////////////////////////
+				void pop_front()
+				{
+					if(m_frontFromOverflow)
+					{
+						m_frontFromOverflow = false;
+
+						m_overflowLock.Acquire();
+						m_overflowQueue.pop_front();
+						if(m_overflowQueue.empty())
+							StoreRelease(&m_overflowing, 0);
+						m_overflowLock.Release();
+						return;
+					}
+
+					Cell* cell = &m_cells[ m_dequeuePos & m_mask ];
+					uint32 seq = LoadAcquire(&cell->sequence);
+
+					if(seq != m_dequeuePos + 1)
+						return;
+
+					cell->element = reinterpret_cast< T >(NULL);
+					StoreRelease(&cell->sequence, m_dequeuePos + m_capacity);
+					++m_dequeuePos;
+				}
+
+				////////////////////////////////////////////////////////////
+				//void PopAll( C &out )
+				// Moves every element queued so far to the back of out,
+				// in order. Consumer thread only.
+				///////////////////////////////////////////////////////////
+				template< class C >
+				void PopAll(C & out)
+				{
+					T elem;
+					while((elem = Pop()) != NULL)
+						out.push_back(elem);
+				}
+
+				// Consumer thread only.
+				bool HasItems() { return front() != NULL; }
+
+				uint32 GetCapacity() const { return m_capacity; }
+
+				bool CanOverflow() const { return m_overflow; }
+
+			private:
+				struct Cell
+				{
+					volatile uint32 sequence;
+					T element;
+				};
+
+				bool PushRing(T elem)
+				{
+					Cell* cell;
+					uint32 pos = LoadAcquire(&m_enqueuePos);
+
+					for(;;)
+					{
+						cell = &m_cells[ pos & m_mask ];
+						uint32 seq = LoadAcquire(&cell->sequence);
+
+						int32 diff = static_cast< int32 >(seq - pos);
+						if(diff == 0)
+						{
+							// the cell is free, try to claim it
+							uint32 prev = CompareAndSwap(&m_enqueuePos, pos, pos + 1);
+							if(prev == pos)
+								break;
+
+							pos = prev;
+						}
+						else if(diff < 0)
+						{
+							// the consumer hasn't freed this cell yet, so we've wrapped around
+							return false;
+						}
+						else
+							pos = LoadAcquire(&m_enqueuePos);
+					}
+
+					cell->element = elem;
+					StoreRelease(&cell->sequence, pos + 1);
+					return true;
+				}
+
+				// Queues elem in the overflow list. Unless start is set, only while the queue is still
+				// overflowing, the consumer may have emptied the list since the caller looked.
+				bool PushOverflow(T elem, bool start)
+				{
+					m_overflowLock.Acquire();
+					if(!start && !m_overflowing)
+					{
+						m_overflowLock.Release();
+						return false;
+					}
+
+					m_overflowQueue.push_back(elem);
+					StoreRelease(&m_overflowing, 1);
+					m_overflowLock.Release();
+					return true;
+				}
+
+				static uint32 LoadAcquire(volatile uint32* src)
+				{
+#ifdef WIN32
+					uint32 val = *src;		// volatile reads have acquire semantics on MSVC
+					_ReadWriteBarrier();
+					return val;
+#else
+#ifdef __GNUC__
+					return __atomic_load_n(src, __ATOMIC_ACQUIRE);
+#else
+#error Your platform (architecture and compiler) is NOT supported. Arcemu requires little endian architecture, and at least GCC 4.1
+#endif
+#endif
+				}
+
+				static void StoreRelease(volatile uint32* dest, uint32 value)
+				{
+#ifdef WIN32
+					_ReadWriteBarrier();
+					*dest = value;			// volatile writes have release semantics on MSVC
+#else
+#ifdef __GNUC__
+					__atomic_store_n(dest, value, __ATOMIC_RELEASE);
+#else
+#error Your platform (architecture and compiler) is NOT supported. Arcemu requires little endian architecture, and at least GCC 4.1
+#endif
+#endif
+				}
+
+				static uint32 CompareAndSwap(volatile uint32* dest, uint32 comparand, uint32 value)
+				{
+#ifdef WIN32
+					return static_cast< uint32 >(InterlockedCompareExchange(reinterpret_cast< volatile LONG* >(dest), LONG(value), LONG(comparand)));
+#else
+#ifdef __GNUC__
+					return __sync_val_compare_and_swap(dest, comparand, value);
+#else
+#error Your platform (architecture and compiler) is NOT supported. Arcemu requires little endian architecture, and at least GCC 4.1
+#endif
+#endif
+				}
+
+				// Disabled copy constructor
+				MPSCQueue(const MPSCQueue & other) {}
+
+				// Disabled assignment operator
+				MPSCQueue operator=(const MPSCQueue & other) { return *this; }
+
+				Cell* m_cells;
+				uint32 m_capacity;
+				uint32 m_mask;
+
+				// producers and the consumer work on different cache lines
+				uint8 m_pad0[ 64 ];
+				volatile uint32 m_enqueuePos;
+				uint8 m_pad1[ 64 ];
+				uint32 m_dequeuePos;
+				bool m_frontFromOverflow;
+
+				bool m_overflow;
+				volatile uint32 m_overflowing;	// the overflow list isn't empty, producers have to use it too
+				Mutex m_overflowLock;
+				std::deque< T > m_overflowQueue;
+		};
+	}
+}
+
+#endif
@@ -49,4 +49,39 @@ class RWLock
 		Mutex _lock;
 };
 
+// A reader/writer lock that lets any number of readers in at once.
+// Unlike RWLock it isn't recursive, a thread must not take it again
+// while holding it, neither for reading nor for writing.
+class SharedRWLock
+{
+	public:
+#ifdef WIN32
+		SharedRWLock() { InitializeSRWLock(&_lock); }
+		~SharedRWLock() {}
+
+		ARCEMU_INLINE void AcquireReadLock() { AcquireSRWLockShared(&_lock); }
+		ARCEMU_INLINE void ReleaseReadLock() { ReleaseSRWLockShared(&_lock); }
+		ARCEMU_INLINE void AcquireWriteLock() { AcquireSRWLockExclusive(&_lock); }
+		ARCEMU_INLINE void ReleaseWriteLock() { ReleaseSRWLockExclusive(&_lock); }
+
+	private:
+		SRWLOCK _lock;
+#else
+		SharedRWLock() { pthread_rwlock_init(&_lock, NULL); }
+		~SharedRWLock() { pthread_rwlock_destroy(&_lock); }
+
+		ARCEMU_INLINE void AcquireReadLock() { pthread_rwlock_rdlock(&_lock); }
+		ARCEMU_INLINE void ReleaseReadLock() { pthread_rwlock_unlock(&_lock); }
+		ARCEMU_INLINE void AcquireWriteLock() { pthread_rwlock_wrlock(&_lock); }
+		ARCEMU_INLINE void ReleaseWriteLock() { pthread_rwlock_unlock(&_lock); }
+
+	private:
+		pthread_rwlock_t _lock;
+#endif
+
+		// not copyable
+		SharedRWLock(const SharedRWLock &);
+		SharedRWLock & operator=(const SharedRWLock &);
+};
+
 #endif
@@ -111,7 +111,11 @@ AIInterface::AIInterface()
 	m_waypointsLoadedFromDB(false),
 	m_waypoints(NULL),
 	m_is_in_instance(false),
-	skip_reset_hp(false)
+	skip_reset_hp(false),
+	m_pathRequest(NULL),
+	m_sleeping(false),
+	m_sleepStart(0),
+	m_sleepUntil(0)
 {
 	m_aiTargets.clear();
 	m_assistTargets.clear();
@@ -160,6 +164,7 @@ AIInterface::~AIInterface()
 	m_spells.clear();
 
 	deleteWaypoints();
+	CancelPathRequest();
 }
 
 void AIInterface::Init(Unit* un, AIType at, MovementType mt, Unit* owner)
@@ -184,6 +189,8 @@ void AIInterface::HandleEvent(uint32 event, Unit* pUnit, uint32 misc1)
 {
 	if(m_Unit == NULL) return;
 
+	Wake();
+
 	// Passive NPCs (like target dummies) shouldn't do anything.
 	if(m_AIType == AITYPE_PASSIVE)
 		return;
@@ -231,6 +238,7 @@ void AIInterface::Update(uint32 p_time)
 		}
 	}
 
+	UpdatePathRequest();
 	UpdateMovementSpline();
 	_UpdateMovement(p_time);
 
@@ -323,6 +331,62 @@ void AIInterface::Update(uint32 p_time)
 	}
 }
 
+void AIInterface::TrySleep()
+{
+	// pets, totems and guardians follow their owner around
+	if(m_AIType == AITYPE_PET || m_AIType == AITYPE_TOTEM || m_AIType == AITYPE_GUARDIAN)
+		return;
+
+	if(!m_Unit->IsInWorld() || !m_Unit->isAlive() || m_Unit->CombatStatus.IsInCombat())
+		return;
+
+	// nothing for the AI to do, FindTarget() is left to whoever wakes us
+	if(m_AIState != STATE_IDLE || m_creatureState != STOPPED || !MoveDone() || m_fleeTimer != 0)
+		return;
+	if(getNextTarget() != NULL || !m_aiTargets.empty() || !m_assistTargets.empty())
+		return;
+	if(m_UnitToFollow != 0 || m_UnitToFear != 0 || m_formationLinkSqlId != 0)
+		return;
+
+	// nothing for the unit to do, not casting and nothing to regenerate
+	if(m_Unit->GetCurrentSpell() != NULL || m_Unit->m_diminishActive)
+		return;
+	if(m_Unit->GetHealth() != m_Unit->GetMaxHealth())
+		return;
+
+	uint8 powertype = m_Unit->GetPowerType();
+	uint32 restingPower = (powertype == POWER_TYPE_RAGE || powertype == POWER_TYPE_RUNIC_POWER) ? 0 : m_Unit->GetMaxPower(powertype);
+	if(m_Unit->GetPower(powertype) != restingPower)
+		return;
+
+	// wake up in time for the next waypoint and the next timed emote
+	uint32 sleep = AI_MAX_SLEEP_TIME;
+	if(GetWayPointsCount() != 0 && m_moveType != MOVEMENTTYPE_DONTMOVEWP && sWorld.getAllowMovement() && m_moveTimer < sleep)
+		sleep = m_moveTimer;
+	if(timed_emotes != NULL && timed_emote_expire < sleep)
+		sleep = timed_emote_expire;
+	if(sleep == 0)
+		return;
+
+	m_sleeping = true;
+	m_sleepStart = getMSTime();
+	m_sleepUntil = m_sleepStart + sleep;
+}
+
+uint32 AIInterface::EndSleep(uint32 mstime)
+{
+	if(!m_sleeping)
+		return 0;
+
+	m_sleeping = false;
+
+	// a creature in a cell that went inactive may have slept much longer, don't let the timers wrap
+	uint32 slept = mstime - m_sleepStart;
+	if(slept > AI_MAX_SLEEP_TIME)
+		slept = AI_MAX_SLEEP_TIME;
+	return slept;
+}
+
 void AIInterface::_UpdateTimer(uint32 p_time)
 {
 	if(m_updateAssistTimer > p_time)
@@ -1690,7 +1754,7 @@ void AIInterface::_CalcDestinationAndMove(Unit* target, float dist)
 		newz = m_Unit->GetPositionZ();
 	}
 
-	if(!Move(newx, newy, newz))
+	if(!Move(newx, newy, newz, 0, target))
 	{
 		//todo: enter evade mode if creature, not pet, not totem
 	}
@@ -1854,6 +1918,7 @@ bool AIInterface::StopMovement(uint32 time)
 	m_moveTimer = time; //set pause after stopping
 
 	//Clear current spline
+	CancelPathRequest();
 	m_currentMoveSpline.clear();
 	m_currentMoveSplineIndex = 1;
 	m_currentSplineUpdateCounter = 0;
@@ -3594,14 +3659,17 @@ void AIInterface::UpdateMovementSpline()
 	}
 }
 
-bool AIInterface::Move(float & x, float & y, float & z, float o /*= 0*/)
+bool AIInterface::Move(float & x, float & y, float & z, float o /*= 0*/, Unit* chaseTarget /*= NULL*/)
 {
+	Wake();
+
 	if(m_splinePriority > SPLINE_PRIORITY_MOVEMENT)
 		return false;
 	//Make sure our position is up to date
 	UpdateMovementSpline();
 
 	//Clear current spline
+	CancelPathRequest();
 	m_currentMoveSpline.clear();
 	m_currentMoveSplineIndex = 1;
 	m_currentSplineUpdateCounter = 0;
@@ -3610,7 +3678,17 @@ bool AIInterface::Move(float & x, float & y, float & z, float o /*= 0*/)
 
 	//Add new points
 #ifdef TEST_PATHFINDING
-	if(!Flying())
+	if(!Flying() && chaseTarget != NULL && CreateChasePath(chaseTarget, x, y, z))
+	{
+		//walked from the chase field shared by everyone chasing the target
+	}
+	else if(!Flying() && sPathfindingMgr.IsAsync())
+	{
+		//the points are added by UpdatePathRequest() once a worker found the path
+		m_pathRequest = sPathfindingMgr.RequestPath(m_Unit->GetMapId(), m_Unit->GetPositionX(), m_Unit->GetPositionY(), m_Unit->GetPositionZ(), x, y, z);
+		return true;
+	}
+	else if(!Flying())
 	{
 		if(!CreatePath(x, y, z))
 		{
@@ -3689,253 +3767,67 @@ void AIInterface::AddSpline(float x, float y, float z)
 
 bool AIInterface::CreatePath(float x, float y, float z, bool onlytest /*= false*/)
 {
-	//make sure current spline is updated
-
-	NavMeshData* nav = CollideInterface.GetNavMesh(m_Unit->GetMapId());
-
-	if(nav == NULL)
-		return false;
-
-	float start[3] = { m_Unit->GetPositionY(), m_Unit->GetPositionZ(), m_Unit->GetPositionX() };
-	float end[3] = { y, z, x };
-	float extents[3] = { 3, 5, 3 };
-
-	dtQueryFilter filter;
-	filter.setIncludeFlags(NAV_GROUND | NAV_WATER | NAV_SLIME | NAV_MAGMA);
-
-	dtPolyRef startref, endref;
-	nav->query->findNearestPoly(start, extents, &filter, &startref, NULL);
-	nav->query->findNearestPoly(end, extents, &filter, &endref, NULL);
-
+	if(onlytest)
+		return sPathfindingMgr.CalculatePath(m_Unit->GetMapId(), m_Unit->GetPositionX(), m_Unit->GetPositionY(), m_Unit->GetPositionZ(), x, y, z, NULL);
 
-	if(startref == 0 || endref == 0)
-		return false;
-
-	dtPolyRef path[256];
-	int pathcount;
-
-	if(nav->query->findPath(startref, endref, start, end, &filter, path, &pathcount, 256) != DT_SUCCESS)
-		return false;
-
-	if(pathcount == 0 || path[pathcount - 1] != endref)
-		return false;
-
-	float points[MAX_PATH_LENGTH * 3];
-	int32 pointcount;
-	bool usedoffmesh;
-
-	if(findSmoothPath(start, end, path, pathcount, points, &pointcount, usedoffmesh, MAX_PATH_LENGTH, nav->mesh, nav->query, filter) != DT_SUCCESS)
+	std::vector< G3D::Vector3 > points;
+	if(!sPathfindingMgr.CalculatePath(m_Unit->GetMapId(), m_Unit->GetPositionX(), m_Unit->GetPositionY(), m_Unit->GetPositionZ(), x, y, z, &points))
 		return false;
 
 	//add to spline
-	if(!onlytest)
-	{
-		for(int32 i = 0; i < pointcount; ++i)
-			AddSpline(points[i * 3 + 2], points[i * 3 + 0], points[i * 3 + 1]);
-	}
+	for(std::vector< G3D::Vector3 >::iterator itr = points.begin(); itr != points.end(); ++itr)
+		AddSpline(itr->x, itr->y, itr->z);
 	return true;
 }
 
-dtStatus AIInterface::findSmoothPath(const float* startPos, const float* endPos, const dtPolyRef* polyPath, const uint32 polyPathSize, float* smoothPath, int* smoothPathSize, bool & usedOffmesh, const uint32 maxSmoothPathSize, dtNavMesh* mesh, dtNavMeshQuery* query, dtQueryFilter & filter)
+bool AIInterface::CreateChasePath(Unit* target, float x, float y, float z)
 {
-	*smoothPathSize = 0;
-	uint32 nsmoothPath = 0;
-	usedOffmesh = false;
-
-	dtPolyRef polys[MAX_PATH_LENGTH];
-	memcpy(polys, polyPath, sizeof(dtPolyRef)*polyPathSize);
-	uint32 npolys = polyPathSize;
-
-	float iterPos[VERTEX_SIZE], targetPos[VERTEX_SIZE];
-	if(DT_SUCCESS != query->closestPointOnPolyBoundary(polys[0], startPos, iterPos))
-		return DT_FAILURE;
-
-	if(DT_SUCCESS != query->closestPointOnPolyBoundary(polys[npolys - 1], endPos, targetPos))
-		return DT_FAILURE;
-
-	dtVcopy(&smoothPath[nsmoothPath * VERTEX_SIZE], iterPos);
-	nsmoothPath++;
-
-	// Move towards target a small advancement at a time until target reached or
-	// when ran out of memory to store the path.
-	while(npolys && nsmoothPath < maxSmoothPathSize)
-	{
-		// Find location to steer towards.
-		float steerPos[VERTEX_SIZE];
-		unsigned char steerPosFlag;
-		dtPolyRef steerPosRef = 0;
-
-		if(!getSteerTarget(iterPos, targetPos, SMOOTH_PATH_SLOP, polys, npolys, steerPos, steerPosFlag, steerPosRef, query))
-			break;
-
-		bool endOfPath = (steerPosFlag & DT_STRAIGHTPATH_END) != 0;
-		bool offMeshConnection = (steerPosFlag & DT_STRAIGHTPATH_OFFMESH_CONNECTION) != 0;
-
-		// Find movement delta.
-		float delta[VERTEX_SIZE];
-		dtVsub(delta, steerPos, iterPos);
-		float len = dtSqrt(dtVdot(delta, delta));
-		// If the steer target is end of path or off-mesh link, do not move past the location.
-		if((endOfPath || offMeshConnection) && len < SMOOTH_PATH_STEP_SIZE)
-			len = 1.0f;
-		else
-			len = SMOOTH_PATH_STEP_SIZE / len;
-
-		float moveTgt[VERTEX_SIZE];
-		dtVmad(moveTgt, iterPos, delta, len);
-
-		// Move
-		float result[VERTEX_SIZE];
-		const static uint32 MAX_VISIT_POLY = 16;
-		dtPolyRef visited[MAX_VISIT_POLY];
-
-		uint32 nvisited = 0;
-		query->moveAlongSurface(polys[0], iterPos, moveTgt, &filter, result, visited, (int*)&nvisited, MAX_VISIT_POLY);
-		npolys = fixupCorridor(polys, npolys, MAX_PATH_LENGTH, visited, nvisited);
-
-		query->getPolyHeight(visited[nvisited - 1], result, &result[1]);
-		dtVcopy(iterPos, result);
-
-		// Handle end of path and off-mesh links when close enough.
-		if(endOfPath && inRangeYZX(iterPos, steerPos, SMOOTH_PATH_SLOP, 2.0f))
-		{
-			// Reached end of path.
-			dtVcopy(iterPos, targetPos);
-			if(nsmoothPath < maxSmoothPathSize)
-			{
-				dtVcopy(&smoothPath[nsmoothPath * VERTEX_SIZE], iterPos);
-				nsmoothPath++;
-			}
-			break;
-		}
-		else if(offMeshConnection && inRangeYZX(iterPos, steerPos, SMOOTH_PATH_SLOP, 2.0f))
-		{
-			// Reached off-mesh connection.
-			usedOffmesh = true;
-
-			// Advance the path up to and over the off-mesh connection.
-			dtPolyRef prevRef = 0;
-			dtPolyRef polyRef = polys[0];
-			uint32 npos = 0;
-			while(npos < npolys && polyRef != steerPosRef)
-			{
-				prevRef = polyRef;
-				polyRef = polys[npos];
-				npos++;
-			}
-
-			for(uint32 i = npos; i < npolys; ++i)
-				polys[i - npos] = polys[i];
-
-			npolys -= npos;
-
-			// Handle the connection.
-			float startPos[VERTEX_SIZE], endPos[VERTEX_SIZE];
-			if(DT_SUCCESS == mesh->getOffMeshConnectionPolyEndPoints(prevRef, polyRef, startPos, endPos))
-			{
-				if(nsmoothPath < maxSmoothPathSize)
-				{
-					dtVcopy(&smoothPath[nsmoothPath * VERTEX_SIZE], startPos);
-					nsmoothPath++;
-				}
-				// Move position at the other side of the off-mesh link.
-				dtVcopy(iterPos, endPos);
-				query->getPolyHeight(polys[0], iterPos, &iterPos[1]);
-			}
-		}
-
-		// Store results.
-		if(nsmoothPath < maxSmoothPathSize)
-		{
-			dtVcopy(&smoothPath[nsmoothPath * VERTEX_SIZE], iterPos);
-			nsmoothPath++;
-		}
-	}
-
-	*smoothPathSize = nsmoothPath;
-
-	// this is most likely loop
-	return nsmoothPath < maxSmoothPathSize ? DT_SUCCESS : DT_FAILURE;
-}
-
-bool AIInterface::getSteerTarget(const float* startPos, const float* endPos, const float minTargetDist, const dtPolyRef* path, const uint32 pathSize, float* steerPos, unsigned char & steerPosFlag, dtPolyRef & steerPosRef, dtNavMeshQuery* query)
-{
-	// Find steer target.
-	static const uint32 MAX_STEER_POINTS = 3;
-	float steerPath[MAX_STEER_POINTS * VERTEX_SIZE];
-	unsigned char steerPathFlags[MAX_STEER_POINTS];
-	dtPolyRef steerPathPolys[MAX_STEER_POINTS];
-	uint32 nsteerPath = 0;
-	dtStatus dtResult = query->findStraightPath(startPos, endPos, path, pathSize,
-	                    steerPath, steerPathFlags, steerPathPolys, (int*)&nsteerPath, MAX_STEER_POINTS);
-	if(!nsteerPath || DT_SUCCESS != dtResult)
+	if(target->GetMapId() != m_Unit->GetMapId())
 		return false;
 
-	// Find vertex far enough to steer to.
-	uint32 ns = 0;
-	while(ns < nsteerPath)
-	{
-		// Stop at Off-Mesh link or when point is further than slop away.
-		if((steerPathFlags[ns] & DT_STRAIGHTPATH_OFFMESH_CONNECTION) ||
-		        !inRangeYZX(&steerPath[ns * VERTEX_SIZE], startPos, minTargetDist, 1000.0f))
-			break;
-		ns++;
-	}
-	// Failed to find good point to steer to.
-	if(ns >= nsteerPath)
+	std::vector< G3D::Vector3 > points;
+	if(!sPathfindingMgr.CalculateChasePath(m_Unit->GetMapId(), target->GetGUID(), target->GetPositionX(), target->GetPositionY(), target->GetPositionZ(),
+	                                       m_Unit->GetPositionX(), m_Unit->GetPositionY(), m_Unit->GetPositionZ(), x, y, z, &points))
 		return false;
 
-	dtVcopy(steerPos, &steerPath[ns * VERTEX_SIZE]);
-	steerPos[1] = startPos[1];  // keep Z value
-	steerPosFlag = steerPathFlags[ns];
-	steerPosRef = steerPathPolys[ns];
-
+	for(std::vector< G3D::Vector3 >::iterator itr = points.begin(); itr != points.end(); ++itr)
+		AddSpline(itr->x, itr->y, itr->z);
 	return true;
 }
 
-uint32 AIInterface::fixupCorridor(dtPolyRef* path, const uint32 npath, const uint32 maxPath, const dtPolyRef* visited, const uint32 nvisited)
+void AIInterface::UpdatePathRequest()
 {
-	int32 furthestPath = -1;
-	int32 furthestVisited = -1;
+	if(m_pathRequest == NULL || !m_pathRequest->IsDone())
+		return;
 
-	// Find furthest common polygon.
-	for(int32 i = npath - 1; i >= 0; --i)
+	PathRequest* req = m_pathRequest;
+	m_pathRequest = NULL;
+
+	if(!req->Succeeded())
 	{
-		bool found = false;
-		for(int32 j = nvisited - 1; j >= 0; --j)
-		{
-			if(path[i] == visited[j])
-			{
-				furthestPath = i;
-				furthestVisited = j;
-				found = true;
-			}
-		}
-		if(found)
-			break;
+		req->DecRef();
+		StopMovement(0); //old spline is probly still active on client, need to keep in sync
+		return;
 	}
 
-	// If no intersection found just return current path.
-	if(furthestPath == -1 || furthestVisited == -1)
-		return npath;
-
-	// Concatenate paths.
-
-	// Adjust beginning of the buffer to include the visited.
-	uint32 req = nvisited - furthestVisited;
-	uint32 orig = uint32(furthestPath + 1) < npath ? furthestPath + 1 : npath;
-	uint32 size = npath - orig > 0 ? npath - orig : 0;
-	if(req + size > maxPath)
-		size = maxPath - req;
+	//the unit hasn't moved while waiting, the spline was cleared by Move()
+	//the request may have been merged with another unit's, start from our own position instead of its first point
+	const std::vector< G3D::Vector3 > & points = req->GetPoints();
+	AddSpline(m_Unit->GetPositionX(), m_Unit->GetPositionY(), m_Unit->GetPositionZ());
+	for(size_t i = 1; i < points.size(); ++i)
+		AddSpline(points[ i ].x, points[ i ].y, points[ i ].z);
+	req->DecRef();
 
-	if(size)
-		memmove(path + req, path + orig, size * sizeof(dtPolyRef));
+	SendMoveToPacket();
+}
 
-	// Store visited
-	for(uint32 i = 0; i < req; ++i)
-		path[i] = visited[(nvisited - 1) - i];
+void AIInterface::CancelPathRequest()
+{
+	if(m_pathRequest == NULL)
+		return;
 
-	return req + size;
+	m_pathRequest->DecRef();
+	m_pathRequest = NULL;
 }
 
 void AIInterface::EventEnterCombat(Unit* pUnit, uint32 misc1)
@@ -4413,6 +4305,7 @@ void AIInterface::MoveKnockback(float x, float y, float z, float horizontal, flo
 	m_splinePriority = SPLINE_PRIORITY_REDIRECTION;
 
 	//Clear current spline
+	CancelPathRequest();
 	m_currentMoveSpline.clear();
 	m_currentMoveSplineIndex = 1;
 	m_currentSplineUpdateCounter = 0;
@@ -4477,9 +4370,12 @@ void AIInterface::EventForceRedirected(Unit* pUnit, uint32 misc1)
 
 void AIInterface::MoveJump(float x, float y, float z, float o /*= 0*/)
 {
+	Wake();
+
 	m_splinePriority = SPLINE_PRIORITY_REDIRECTION;
 
 	//Clear current spline
+	CancelPathRequest();
 	m_currentMoveSpline.clear();
 	m_currentMoveSplineIndex = 1;
 	m_currentSplineUpdateCounter = 0;
@@ -4514,9 +4410,12 @@ void AIInterface::SetReturnPosition()
 
 bool AIInterface::MoveCharge(float x, float y, float z)
 {
+	Wake();
+
 	m_splinePriority = SPLINE_PRIORITY_REDIRECTION;
 
 	//Clear current spline
+	CancelPathRequest();
 	m_currentMoveSpline.clear();
 	m_currentMoveSplineIndex = 1;
 	m_currentSplineUpdateCounter = 0;
@@ -4554,6 +4453,9 @@ bool AIInterface::MoveCharge(float x, float y, float z)
 
 void AIInterface::MoveTeleport(float x, float y, float z, float o /*= 0*/)
 {
+	Wake();
+
+	CancelPathRequest();
 	m_currentMoveSpline.clear();
 	m_currentMoveSplineIndex = 1;
 	m_currentSplineUpdateCounter = 0;
@@ -24,6 +24,8 @@
 #define UNIT_MOVEMENT_INTERPOLATE_INTERVAL 400/*750*/ // ms smoother server/client side moving vs less cpu/ less b/w
 #define TARGET_UPDATE_INTERVAL_ON_PLAYER 1000 // we most likely will have to kill players and only then check mobs
 #define TARGET_UPDATE_INTERVAL 5000 // this is a multiple of PLAYER_TARGET_UPDATE_INTERVAL
+#define AI_MAX_SLEEP_TIME 1000 // ms an idle creature sleeps at most before it's updated again
+#define AI_WAKE_RANGE 45.0f // players moving closer than this wake sleeping creatures, a bit more than the biggest aggro range
 #define PLAYER_SIZE 1.5f
 
 #define ENABLE_CREATURE_DAZE
@@ -41,25 +43,11 @@
 
 //#define INHERIT_FOLLOWED_UNIT_SPEED 1
 
-//Pathfinding stuff
-#define VERTEX_SIZE 3
-#define MAX_PATH_LENGTH 512
-#define SMOOTH_PATH_STEP_SIZE   6.0f
-#define SMOOTH_PATH_SLOP        0.4f
-
-inline bool inRangeYZX(const float* v1, const float* v2, const float r, const float h)
-{
-	const float dx = v2[0] - v1[0];
-	const float dy = v2[1] - v1[1]; // elevation
-	const float dz = v2[2] - v1[2];
-	return (dx * dx + dz * dz) < r * r && fabsf(dy) < h;
-}
-
-
 class Object;
 class Creature;
 class Unit;
 class Player;
+class PathRequest;
 class WorldSession;
 class SpellCastTargets;
 
@@ -298,8 +286,9 @@ class SERVER_DECL AIInterface
 				m_UnitToFollow = 0;
 			else
 				m_UnitToFollow = un->GetGUID();
+			Wake();
 		};
-		void SetUnitToFollow(uint64 guid) { m_UnitToFollow = guid; };
+		void SetUnitToFollow(uint64 guid) { m_UnitToFollow = guid; Wake(); };
 		void ResetUnitToFollow() { m_UnitToFollow = 0; };
 		void SetUnitToFear(Unit* un)
 		{
@@ -395,6 +384,14 @@ class SERVER_DECL AIInterface
 		// Update
 		virtual void Update(uint32 p_time);
 
+		// Sleeping
+		// An idle creature isn't updated until something wakes it or AI_MAX_SLEEP_TIME passes,
+		// see TrySleep() for what idle means. Events and movement started on it wake it up.
+		void TrySleep();
+		void Wake() { m_sleepUntil = m_sleepStart; }
+		bool IsSleeping(uint32 mstime) { return m_sleeping && int32(m_sleepUntil - mstime) > 0; }
+		uint32 EndSleep(uint32 mstime);	// returns the ms slept, 0 if it wasn't sleeping
+
 		void SetReturnPosition();
 
 		void _UpdateTotem(uint32 p_time);
@@ -439,9 +436,9 @@ class SERVER_DECL AIInterface
 		void deleteWayPoint(uint32 wpid);
 		void deleteWaypoints();
 		ARCEMU_INLINE bool hasWaypoints() { return m_waypoints != NULL; }
-		ARCEMU_INLINE void setMoveType(uint32 movetype) { m_moveType = movetype; }
+		ARCEMU_INLINE void setMoveType(uint32 movetype) { m_moveType = movetype; Wake(); }
 		ARCEMU_INLINE uint32 getMoveType() { return m_moveType; }
-		void setWaypointToMove(uint32 id) { m_currentWaypoint = id; }
+		void setWaypointToMove(uint32 id) { m_currentWaypoint = id; Wake(); }
 		bool IsFlying();
 
 		// Calculation
@@ -455,7 +452,7 @@ class SERVER_DECL AIInterface
 		ARCEMU_INLINE bool GetAllowedToEnterCombat(void) { return m_AllowedToEnterCombat; }
 
 		void CheckTarget(Unit* target);
-		ARCEMU_INLINE void SetAIState(AI_State newstate) { m_AIState = newstate; }
+		ARCEMU_INLINE void SetAIState(AI_State newstate) { m_AIState = newstate; Wake(); }
 
 		// Movement
 		bool m_canMove;
@@ -550,16 +547,17 @@ class SERVER_DECL AIInterface
 		void _UpdateMovement(uint32 p_time);
 		void _UpdateTimer(uint32 p_time);
 		void AddSpline(float x, float y, float z);
-		bool Move(float & x, float & y, float & z, float o = 0);
+		bool Move(float & x, float & y, float & z, float o = 0, Unit* chaseTarget = NULL);
 		void OnMoveCompleted();
 
 		void MoveEvadeReturn();
 
 		bool CreatePath(float x, float y, float z,  bool onlytest = false);
-		dtStatus findSmoothPath(const float* startPos, const float* endPos, const dtPolyRef* polyPath, const uint32 polyPathSize, float* smoothPath, int* smoothPathSize, bool & usedOffmesh, const uint32 maxSmoothPathSize, dtNavMesh* mesh, dtNavMeshQuery* query, dtQueryFilter & filter);
-		bool getSteerTarget(const float* startPos, const float* endPos, const float minTargetDist, const dtPolyRef* path, const uint32 pathSize, float* steerPos, unsigned char & steerPosFlag, dtPolyRef & steerPosRef, dtNavMeshQuery* query);
-		uint32 fixupCorridor(dtPolyRef* path, const uint32 npath, const uint32 maxPath,
-		                     const dtPolyRef* visited, const uint32 nvisited);
+		//Creates the path to a chased unit from its shared chase field, returns false if the path has to be calculated alone.
+		bool CreateChasePath(Unit* target, float x, float y, float z);
+		//Adds the path found by the pathfinding workers to the spline once it's ready.
+		void UpdatePathRequest();
+		void CancelPathRequest();
 
 		bool m_updateAssist;
 		bool m_updateTargets;
@@ -659,15 +657,21 @@ class SERVER_DECL AIInterface
 	public:
 		bool m_is_in_instance;
 		bool skip_reset_hp;
+		PathRequest* m_pathRequest;
 
 		void WipeCurrentTarget();
 
 		void UpdateMovementSpline();
-		bool MoveDone() { return m_currentMoveSplineIndex >= m_currentMoveSpline.size(); }
+		bool MoveDone() { return m_pathRequest == NULL && m_currentMoveSplineIndex >= m_currentMoveSpline.size(); }
 		bool CanCreatePath(float x, float y, float z) { return CreatePath(x, y, z, true); }
 		void MoveKnockback(float x, float y, float z, float horizontal, float vertical);
 		void MoveJump(float x, float y, float z, float o = 0);
 		void MoveTeleport(float x, float y, float z, float o = 0);
 		bool MoveCharge(float x, float y, float z);
+
+	private:
+		bool m_sleeping;
+		uint32 m_sleepStart;		// getMSTime() it fell asleep at
+		uint32 m_sleepUntil;		// getMSTime() it's updated again at
 };
 #endif
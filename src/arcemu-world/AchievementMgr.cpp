@@ -182,9 +182,11 @@ bool ShowCompletedAchievement(uint32 achievementID, const Player* plr)
 AchievementMgr::AchievementMgr(Player* player)
 	:
 	m_player(player),
-	isCharacterLoading(true)
+	isCharacterLoading(true),
+	m_activeCriteriaTeam(0),
+	m_activeCriteriaDepth(0)
 {
-
+	memset(m_activeCriteria, 0, sizeof(m_activeCriteria));
 }
 
 /**
@@ -196,6 +198,7 @@ AchievementMgr::~AchievementMgr()
 		delete iter->second;
 	m_criteriaProgress.clear();
 	m_completedAchievements.clear();
+	InvalidateActiveCriteria();
 }
 
 /**
@@ -343,6 +346,8 @@ void AchievementMgr::LoadFromDB(QueryResult* achievementResult, QueryResult* cri
 		}
 		while(criteriaResult->NextRow());
 	}
+
+	InvalidateActiveCriteria();
 }
 
 /**
@@ -563,20 +568,218 @@ void AchievementMgr::UpdateAchievementCriteria(AchievementCriteriaTypes type, in
 {
 	if( m_player->GetSession()->HasGMPermissions() && sWorld.gamemaster_disableachievements )
 		return;
-	
+
+	ActiveCriteriaList* list = GetActiveCriteria(type, miscvalue1);
+	if(list == NULL)
+		return;
+
+	++m_activeCriteriaDepth;
+	UpdateActiveCriteria(*list, type, miscvalue1, miscvalue2, time);
+	--m_activeCriteriaDepth;
+
+	// a nested update may still be walking the list, those completed criteria are removed by the next top level update
+	if(m_activeCriteriaDepth == 0 && list->removed != 0)
+		CompactActiveCriteria(*list);
+}
+
+/**
+	Returns the criteria of the specified type that can be progressed by an event with this miscvalue1, or NULL if there are none.
+	The index of the type is built on first use.
+*/
+AchievementMgr::ActiveCriteriaList* AchievementMgr::GetActiveCriteria(AchievementCriteriaTypes type, int32 miscvalue1)
+{
+	if(type >= ACHIEVEMENT_CRITERIA_TYPE_TOTAL)
+		return NULL;
+
+	if(m_activeCriteriaDepth == 0 && m_activeCriteriaTeam != GetPlayer()->GetTeam())
+	{
+		InvalidateActiveCriteria();
+		m_activeCriteriaTeam = GetPlayer()->GetTeam();
+	}
+
+	ActiveCriteriaIndex* index = m_activeCriteria[type];
+	if(index == NULL)
+	{
+		index = new ActiveCriteriaIndex;
+		index->all.removed = 0;
+
+		uint32 key;
+		AchievementCriteriaEntryList const & achievementCriteriaList = objmgr.GetAchievementCriteriaByType(type);
+		index->keyed = !achievementCriteriaList.empty() && GetCriteriaKey(achievementCriteriaList.front(), key);
+
+		for(AchievementCriteriaEntryList::const_iterator i = achievementCriteriaList.begin(); i != achievementCriteriaList.end(); ++i)
+		{
+			AchievementCriteriaEntry const* achievementCriteria = (*i);
+
+			if(IsCompletedCriteria(achievementCriteria))
+				continue;
+
+			AchievementEntry const* achievement = dbcAchievementStore.LookupEntryForced(achievementCriteria->referredAchievement);
+			if(!achievement)
+			{
+				// referred achievement not found (shouldn't normally happen)
+				continue;
+			}
+
+			if((achievement->factionFlag == ACHIEVEMENT_FACTION_FLAG_HORDE && !GetPlayer()->IsTeamHorde()) ||
+			        (achievement->factionFlag == ACHIEVEMENT_FACTION_FLAG_ALLIANCE && !GetPlayer()->IsTeamAlliance()))
+			{
+				// achievement requires a faction of which the player is not a member
+				continue;
+			}
+
+			ActiveCriteria ac;
+			ac.criteria = achievementCriteria;
+			ac.achievement = achievement;
+
+			if(index->keyed)
+			{
+				GetCriteriaKey(achievementCriteria, key);
+				ActiveCriteriaList & list = index->byKey[key];
+				if(list.entries.empty())
+					list.removed = 0;
+				list.entries.push_back(ac);
+			}
+			else
+				index->all.entries.push_back(ac);
+		}
+
+		m_activeCriteria[type] = index;
+	}
+
+	if(!index->keyed)
+		return index->all.entries.empty() ? NULL : &index->all;
+
+	HM_NAMESPACE::hash_map<uint32, ActiveCriteriaList>::iterator itr = index->byKey.find(static_cast<uint32>(miscvalue1));
+	if(itr == index->byKey.end())
+		return NULL;
+
+	return &itr->second;
+}
+
+/**
+	Removes the criteria flagged completed by UpdateActiveCriteria from the list.
+*/
+void AchievementMgr::CompactActiveCriteria(ActiveCriteriaList & list)
+{
+	std::vector<ActiveCriteria>::iterator out = list.entries.begin();
+	for(std::vector<ActiveCriteria>::iterator itr = list.entries.begin(); itr != list.entries.end(); ++itr)
+	{
+		if(itr->criteria != NULL)
+			*out++ = *itr;
+	}
+	list.entries.erase(out, list.entries.end());
+	list.removed = 0;
+}
+
+/**
+	Drops the active criteria index, it gets rebuilt type by type on the next updates.
+	Needed when criteria can become uncompleted again, eg. when a GM resets them.
+*/
+void AchievementMgr::InvalidateActiveCriteria()
+{
+	for(uint32 i = 0; i < ACHIEVEMENT_CRITERIA_TYPE_TOTAL; ++i)
+	{
+		delete m_activeCriteria[i];
+		m_activeCriteria[i] = NULL;
+	}
+}
+
+/**
+	Gets the ID UpdateAchievementCriteria matches miscvalue1 against for this criteria.
+	Returns false if the criteria type isn't matched on a single ID.
+*/
+bool AchievementMgr::GetCriteriaKey(AchievementCriteriaEntry const* entry, uint32 & key)
+{
+	switch(entry->requiredType)
+	{
+		case ACHIEVEMENT_CRITERIA_TYPE_LOOT_ITEM:
+		case ACHIEVEMENT_CRITERIA_TYPE_OWN_ITEM:
+			key = entry->loot_item.itemID;
+			return true;
+		case ACHIEVEMENT_CRITERIA_TYPE_COMPLETE_QUESTS_IN_ZONE:
+			key = entry->complete_quests_in_zone.zoneID;
+			return true;
+		case ACHIEVEMENT_CRITERIA_TYPE_COMPLETE_QUEST:
+			key = entry->complete_quest.questID;
+			return true;
+		case ACHIEVEMENT_CRITERIA_TYPE_GAIN_REPUTATION:
+			key = entry->gain_reputation.factionID;
+			return true;
+		case ACHIEVEMENT_CRITERIA_TYPE_LEARN_SPELL:
+			key = entry->learn_spell.spellID;
+			return true;
+		case ACHIEVEMENT_CRITERIA_TYPE_NUMBER_OF_MOUNTS:
+			key = entry->number_of_mounts.unknown;
+			return true;
+		case ACHIEVEMENT_CRITERIA_TYPE_BE_SPELL_TARGET:
+		case ACHIEVEMENT_CRITERIA_TYPE_BE_SPELL_TARGET2:
+			key = entry->be_spell_target.spellID;
+			return true;
+		case ACHIEVEMENT_CRITERIA_TYPE_KILL_CREATURE:
+			key = entry->kill_creature.creatureID;
+			return true;
+		case ACHIEVEMENT_CRITERIA_TYPE_REACH_SKILL_LEVEL:
+			key = entry->reach_skill_level.skillID;
+			return true;
+		case ACHIEVEMENT_CRITERIA_TYPE_LEARN_SKILL_LEVEL:
+			key = entry->learn_skill_level.skillID;
+			return true;
+		case ACHIEVEMENT_CRITERIA_TYPE_EQUIP_ITEM:
+			key = entry->equip_item.itemID;
+			return true;
+		case ACHIEVEMENT_CRITERIA_TYPE_EQUIP_EPIC_ITEM:
+			key = entry->equip_epic_item.itemSlot;
+			return true;
+		case ACHIEVEMENT_CRITERIA_TYPE_DO_EMOTE:
+			key = entry->do_emote.emoteID;
+			return true;
+		case ACHIEVEMENT_CRITERIA_TYPE_USE_ITEM:
+			key = entry->use_item.itemID;
+			return true;
+		case ACHIEVEMENT_CRITERIA_TYPE_USE_GAMEOBJECT:
+			key = entry->use_gameobject.goEntry;
+			return true;
+		case ACHIEVEMENT_CRITERIA_TYPE_HONORABLE_KILL_AT_AREA:
+			key = entry->honorable_kill_at_area.areaID;
+			return true;
+		case ACHIEVEMENT_CRITERIA_TYPE_HK_CLASS:
+			key = entry->hk_class.classID;
+			return true;
+		case ACHIEVEMENT_CRITERIA_TYPE_HK_RACE:
+			key = entry->hk_race.raceID;
+			return true;
+		case ACHIEVEMENT_CRITERIA_TYPE_DEATH_AT_MAP:
+			key = entry->death_at_map.mapID;
+			return true;
+		default:
+			return false;
+	}
+}
+
+/**
+	Does the actual work of UpdateAchievementCriteria on the criteria that can react to this event.
+*/
+void AchievementMgr::UpdateActiveCriteria(ActiveCriteriaList & list, AchievementCriteriaTypes type, int32 miscvalue1, int32 miscvalue2, uint32 time)
+{
 	uint64 selectedGUID;
 	if(type == ACHIEVEMENT_CRITERIA_TYPE_DO_EMOTE)
 	{
 		selectedGUID = GetPlayer()->GetSelection();
 	}
-	AchievementCriteriaEntryList const & achievementCriteriaList = objmgr.GetAchievementCriteriaByType(type);
-	for(AchievementCriteriaEntryList::const_iterator i = achievementCriteriaList.begin(); i != achievementCriteriaList.end(); ++i)
+
+	// indexed instead of iterated, rewards of a completed achievement can update the same list again
+	for(size_t idx = 0; idx < list.entries.size(); ++idx)
 	{
-		AchievementCriteriaEntry const* achievementCriteria = (*i);
+		AchievementCriteriaEntry const* achievementCriteria = list.entries[idx].criteria;
+		if(achievementCriteria == NULL)
+			continue;
 
 		if(IsCompletedCriteria(achievementCriteria))
 		{
 			// don't bother updating it, if it has already been completed
+			list.entries[idx].criteria = NULL;
+			++list.removed;
 			continue;
 		}
 
@@ -586,19 +789,7 @@ void AchievementMgr::UpdateAchievementCriteria(AchievementCriteriaTypes type, in
 			continue;
 		}
 
-		AchievementEntry const* achievement = dbcAchievementStore.LookupEntryForced(achievementCriteria->referredAchievement);
-		if(!achievement)
-		{
-			// referred achievement not found (shouldn't normally happen)
-			continue;
-		}
-
-		if((achievement->factionFlag == ACHIEVEMENT_FACTION_FLAG_HORDE && !GetPlayer()->IsTeamHorde()) ||
-		        (achievement->factionFlag == ACHIEVEMENT_FACTION_FLAG_ALLIANCE && !GetPlayer()->IsTeamAlliance()))
-		{
-			// achievement requires a faction of which the player is not a member
-			continue;
-		}
+		AchievementEntry const* achievement = list.entries[idx].achievement;
 
 		switch(type)
 		{
@@ -2213,6 +2404,7 @@ void AchievementMgr::GMResetAchievement(int32 achievementID)
 		ss << "DELETE FROM character_achievement WHERE guid = " << m_player->GetLowGUID() << " AND achievement = " << achievementID;
 		CharacterDatabase.Execute(ss.str().c_str());
 	}
+	InvalidateActiveCriteria();
 }
 
 /**
@@ -2245,6 +2437,7 @@ void AchievementMgr::GMResetCriteria(int32 criteriaID)
 		ss << "DELETE FROM character_achievement_progress WHERE guid = " << m_player->GetLowGUID() << " AND criteria = " << criteriaID;
 		CharacterDatabase.Execute(ss.str().c_str());
 	}
+	InvalidateActiveCriteria();
 	CheckAllAchievementCriteria();
 }
 
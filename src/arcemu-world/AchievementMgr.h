@@ -309,11 +309,48 @@ class SERVER_DECL AchievementMgr
 		bool IsCompletedCriteria(AchievementCriteriaEntry const* entry);
 		AchievementCompletionState GetAchievementCompletionState(AchievementEntry const* entry);
 
+		/**
+			A criteria that can still progress for this player, with its achievement looked up already
+		*/
+		struct ActiveCriteria
+		{
+			AchievementCriteriaEntry const* criteria; //! NULL once it was found completed, removed by CompactActiveCriteria()
+			AchievementEntry const* achievement;
+		};
+
+		struct ActiveCriteriaList
+		{
+			std::vector<ActiveCriteria> entries;
+			uint32 removed; //! Number of completed entries waiting to be removed
+		};
+
+		/**
+			Criteria of one type that this player can still progress, built the first time that type is updated.
+			Completed criteria and criteria of the other faction's achievements are left out.
+			Types matched on an ID in miscvalue1 (creature entry, item, spell, quest, ...) are split by that ID.
+		*/
+		struct ActiveCriteriaIndex
+		{
+			bool keyed;
+			ActiveCriteriaList all;                                        //! Types that aren't keyed
+			HM_NAMESPACE::hash_map<uint32, ActiveCriteriaList> byKey;      //! Keyed types
+		};
+
+		void UpdateActiveCriteria(ActiveCriteriaList & list, AchievementCriteriaTypes type, int32 miscvalue1, int32 miscvalue2, uint32 time);
+		ActiveCriteriaList* GetActiveCriteria(AchievementCriteriaTypes type, int32 miscvalue1);
+		void CompactActiveCriteria(ActiveCriteriaList & list);
+		void InvalidateActiveCriteria();
+		static bool GetCriteriaKey(AchievementCriteriaEntry const* entry, uint32 & key);
+
 		RWLock m_lock;
 		Player* m_player;
 		CriteriaProgressMap m_criteriaProgress;
 		CompletedAchievementMap m_completedAchievements;
 		bool isCharacterLoading;
+
+		ActiveCriteriaIndex* m_activeCriteria[ACHIEVEMENT_CRITERIA_TYPE_TOTAL];
+		uint32 m_activeCriteriaTeam;  //! Team the index was built for
+		uint32 m_activeCriteriaDepth; //! Nesting level of UpdateAchievementCriteria calls
 };
 
 // Function declarations - related to achievements - not in AchievementMgr class - defined in AchievementMgr.cpp
@@ -335,26 +335,31 @@ void Channel::Moderate(Player* plr)
 
 void Channel::Say(Player* plr, const char* message, Player* for_gm_client, bool forced)
 {
-	Guard mGuard(m_lock);
-	MemberMap::iterator itr = m_members.find(plr);
 	WorldPacket data(SMSG_CHANNEL_NOTIFY, strlen(message) + 100);
 	if(!forced)
 	{
-		if(m_members.end() == itr)
+		m_lock.Acquire();
+		MemberMap::iterator itr = m_members.find(plr);
+		bool member = (itr != m_members.end());
+		uint32 flags = member ? itr->second : 0;
+		bool muted = m_muted;
+		m_lock.Release();
+
+		if(!member)
 		{
 			data << uint8(CHANNEL_NOTIFY_FLAG_NOTON) << m_name;
 			plr->GetSession()->SendPacket(&data);
 			return;
 		}
 
-		if(itr->second & CHANNEL_FLAG_MUTED)
+		if(flags & CHANNEL_FLAG_MUTED)
 		{
 			data << uint8(CHANNEL_NOTIFY_FLAG_YOUCANTSPEAK) << m_name;
 			plr->GetSession()->SendPacket(&data);
 			return;
 		}
 
-		if(m_muted && !(itr->second & CHANNEL_FLAG_VOICED) && !(itr->second & CHANNEL_FLAG_MODERATOR) && !(itr->second & CHANNEL_FLAG_OWNER))
+		if(muted && !(flags & CHANNEL_FLAG_VOICED) && !(flags & CHANNEL_FLAG_MODERATOR) && !(flags & CHANNEL_FLAG_OWNER))
 		{
 			data << uint8(CHANNEL_NOTIFY_FLAG_YOUCANTSPEAK) << m_name;
 			plr->GetSession()->SendPacket(&data);
@@ -814,19 +819,32 @@ Channel::~Channel()
 
 void Channel::SendToAll(WorldPacket* data)
 {
-	Guard guard(m_lock);
-	for(MemberMap::iterator itr = m_members.begin(); itr != m_members.end(); ++itr)
-		itr->first->GetSession()->SendPacket(data);
+	SendToAll(data, NULL);
 }
 
 void Channel::SendToAll(WorldPacket* data, Player* plr)
 {
-	Guard guard(m_lock);
+	// Only the sockets are collected under the lock, sending to them happens after releasing it.
+	// A socket outlives its session by SOCKET_GC_TIMEOUT seconds, so the pointers stay valid
+	// even if a member logs out in the meantime.
+	std::vector< WorldSocket* > sockets;
+
+	m_lock.Acquire();
+	sockets.reserve(m_members.size());
 	for(MemberMap::iterator itr = m_members.begin(); itr != m_members.end(); ++itr)
 	{
-		if(itr->first != plr)
-			itr->first->GetSession()->SendPacket(data);
+		if(itr->first == plr)
+			continue;
+
+		WorldSocket* socket = itr->first->GetSession()->GetSocket();
+		if(socket != NULL)
+			sockets.push_back(socket);
 	}
+	m_lock.Release();
+
+	BroadcastPacket packet(data);
+	for(std::vector< WorldSocket* >::iterator itr = sockets.begin(); itr != sockets.end(); ++itr)
+		packet.SendTo(*itr);
 }
 
 Channel* ChannelMgr::GetCreateChannel(const char* name, Player* p, uint32 type_id)
@@ -318,6 +318,10 @@ void CommandTableStorage::Init()
 		{ "updateworldstate",    'd', &ChatHandler::HandleUpdateWorldStateCommand, "Sets the specified worldstate field to the specified value",                                                        NULL, 0, 0, 0 },
 		{ "initworldstates",     'd', &ChatHandler::HandleInitWorldStatesCommand,  "(re)initializes the worldstates.",                                                                                  NULL, 0, 0, 0 },
 		{ "clearworldstates",    'd', &ChatHandler::HandleClearWorldStatesCommand, "Clears the worldstates",                                                                                            NULL, 0, 0, 0 },
+		{ "checkstats",          'd', &ChatHandler::HandleDebugCheckStatsCommand,  "Compares the stats of the selected player with a full recalculation.",                                         NULL, 0, 0, 0 },
+		{ "benchcompress",       'd', &ChatHandler::HandleDebugBenchCompressCommand, "<iterations> - Times every packet compressor on the update packets of the objects around you.",                              NULL, 0, 0, 0 },
+		{ "benchfilter",         'd', &ChatHandler::HandleDebugBenchFilterCommand, "<iterations> [message] - Times the chat filter on a few chat lines, or on the message.",                             NULL, 0, 0, 0 },
+		{ "benchplayerinfo",     'd', &ChatHandler::HandleDebugBenchPlayerInfoCommand, "<threads> <lookups> - Times character lookups by guid and name from one and from several threads.",          NULL, 0, 0, 0 },
 		{ NULL,                  '0', NULL,                                        "",                                                                                                                  NULL, 0, 0, 0 }
 	};
 	dupe_command_table(debugCommandTable, _debugCommandTable);
@@ -558,6 +562,10 @@ void CommandTableStorage::Init()
 		{ "saveall",       's', &ChatHandler::HandleSaveAllCommand,         "Save's all playing characters",                            NULL, 0, 0, 0 },
 		{ "info",          '0', &ChatHandler::HandleInfoCommand,            "Server info",                                              NULL, 0, 0, 0 },
 		{ "netstatus",     '0', &ChatHandler::HandleNetworkStatusCommand,   "Shows network status.", NULL, 0, 0, 0 },
+		{ "movestats",     'm', &ChatHandler::HandleMovementStatsCommand,   "Shows movement packets relayed on your map.",              NULL, 0, 0, 0 },
+		{ "partystats",    'm', &ChatHandler::HandlePartyUpdateStatsCommand, "Shows party member stat packets sent on your map.",       NULL, 0, 0, 0 },
+		{ "spellpool",     'm', &ChatHandler::HandleSpellPoolStatsCommand,  "Shows how many spell allocations were recycled.",          NULL, 0, 0, 0 },
+		{ "pathstats",     'm', &ChatHandler::HandlePathfindingStatsCommand, "Shows the time spent finding paths per map.",            NULL, 0, 0, 0 },
 		{ NULL,            '0', NULL,                                       "",                                                         NULL, 0, 0, 0 }
 	};
 	dupe_command_table(serverCommandTable, _serverCommandTable);
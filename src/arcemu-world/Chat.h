@@ -238,6 +238,10 @@ class SERVER_DECL ChatHandler : public Singleton<ChatHandler>
 		bool HandleStartCommand(const char* args, WorldSession* m_session);
 		bool HandleInfoCommand(const char* args, WorldSession* m_session);
 		bool HandleNetworkStatusCommand(const char* args, WorldSession* m_session);
+		bool HandleMovementStatsCommand(const char* args, WorldSession* m_session);
+		bool HandlePartyUpdateStatsCommand(const char* args, WorldSession* m_session);
+		bool HandleSpellPoolStatsCommand(const char* args, WorldSession* m_session);
+		bool HandlePathfindingStatsCommand(const char* args, WorldSession* m_session);
 		bool HandleDismountCommand(const char* args, WorldSession* m_session);
 		bool HandleSaveCommand(const char* args, WorldSession* m_session);
 		bool HandleGMListCommand(const char* args, WorldSession* m_session);
@@ -297,6 +301,10 @@ class SERVER_DECL ChatHandler : public Singleton<ChatHandler>
 		bool HandleUpdateWorldStateCommand( const char *args, WorldSession *session );
 		bool HandleInitWorldStatesCommand( const char *args, WorldSession *session );
 		bool HandleClearWorldStatesCommand( const char *args, WorldSession *session );
+		bool HandleDebugCheckStatsCommand(const char* args, WorldSession* m_session);
+		bool HandleDebugBenchCompressCommand(const char* args, WorldSession* m_session);
+		bool HandleDebugBenchFilterCommand(const char* args, WorldSession* m_session);
+		bool HandleDebugBenchPlayerInfoCommand(const char* args, WorldSession* m_session);
 
 		// WayPoint Commands
 		bool HandleWPAddCommand(const char* args, WorldSession* m_session);
@@ -225,7 +225,11 @@ void CCollideInterface::DeactivateTile(uint32 mapId, uint32 tileX, uint32 tileY)
 
 			if(itr != nav->tilerefs.end())
 			{
+				//cached corridors may go through the removed polygons, drop them before a query can see the new mesh
+				nav->meshlock.AcquireWriteLock();
 				nav->mesh->removeTile(itr->second, NULL, NULL);
+				sPathfindingMgr.OnMeshChanged(mapId);
+				nav->meshlock.ReleaseWriteLock();
 				nav->tilerefs.erase(itr);
 			}
 
@@ -248,7 +252,7 @@ void CCollideInterface::ActivateMap(uint32 mapid)
 	std::map<uint32, NavMeshData*>::iterator itr = m_navdata.find(mapid);
 
 	if(itr != m_navdata.end())
-		++itr->second->refs;
+		++itr->second->activations;
 	else
 	{
 
@@ -269,10 +273,9 @@ void CCollideInterface::ActivateMap(uint32 mapid)
 
 		NavMeshData* d = new NavMeshData;
 		d->mesh = dtAllocNavMesh();
-		d->query = dtAllocNavMeshQuery();
 		d->mesh->init(&params);
-		d->query->init(d->mesh, 1024);
-		d->AddRef();
+		d->activations = 1;
+		d->AddRef(); //released when the last map is deactivated
 		m_navdata.insert(std::make_pair(mapid, d));
 	}
 	m_navmaplock.Release();
@@ -284,10 +287,11 @@ void CCollideInterface::DeactiveMap(uint32 mapid)
 
 	std::map<uint32, NavMeshData*>::iterator itr = m_navdata.find(mapid);
 
-	if(itr != m_navdata.end())
+	if(itr != m_navdata.end() && --itr->second->activations == 0)
 	{
-		if(itr->second->DecRef())
-			m_navdata.erase(itr);
+		//pathfinding workers may still hold a reference
+		itr->second->DecRef();
+		m_navdata.erase(itr);
 	}
 
 	m_navmaplock.Release();
@@ -309,6 +313,25 @@ NavMeshData* CCollideInterface::GetNavMesh(uint32 mapId)
 	return retval;
 }
 
+NavMeshData* CCollideInterface::AcquireNavMesh(uint32 mapId)
+{
+#ifndef TEST_PATHFINDING
+	return NULL;
+#endif
+	NavMeshData* retval = NULL;
+	m_navmaplock.Acquire();
+	std::map<uint32, NavMeshData*>::iterator itr = m_navdata.find(mapId);
+
+	if(itr != m_navdata.end())
+	{
+		retval = itr->second;
+		retval->AddRef();
+	}
+
+	m_navmaplock.Release();
+	return retval;
+}
+
 void CCollideInterface::LoadNavMeshTile(uint32 mapId, uint32 tileX, uint32 tileY)
 {
 	NavMeshData* nav = GetNavMesh(mapId);
@@ -347,7 +370,11 @@ void CCollideInterface::LoadNavMeshTile(uint32 mapId, uint32 tileX, uint32 tileY
 	fclose(f);
 
 	dtTileRef dtref;
+	//the new tile may offer shorter ways than the cached corridors
+	nav->meshlock.AcquireWriteLock();
 	nav->mesh->addTile(data, header.size, DT_TILE_FREE_DATA, 0, &dtref);
+	sPathfindingMgr.OnMeshChanged(mapId);
+	nav->meshlock.ReleaseWriteLock();
 
 	nav->tilelock.Acquire();
 	nav->tilerefs.insert(std::make_pair(tileX | (tileY << 16), dtref));
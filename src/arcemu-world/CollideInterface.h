@@ -73,21 +73,57 @@ class NavMeshData
 {
 	public:
 		dtNavMesh* mesh;
-		dtNavMeshQuery* query;
 
 		Arcemu::Threading::AtomicCounter refs;
+		uint32 activations; //maps using the mesh, protected by CCollideInterface::m_navmaplock
 
 		FastMutex tilelock;
 		std::map<uint32, dtTileRef> tilerefs; //key by tile, x | y <<  16
 
+		//read locked while querying, write locked while adding or removing tiles, not recursive
+		SharedRWLock meshlock;
+
 		~NavMeshData()
 		{
+			for(std::vector<dtNavMeshQuery*>::iterator itr = freequeries.begin(); itr != freequeries.end(); ++itr)
+				dtFreeNavMeshQuery(*itr);
 			dtFreeNavMesh(mesh);
-			dtFreeNavMeshQuery(query);
 		}
 
 		void AddRef() { ++refs; }
 		bool DecRef() { if((--refs) == 0) { delete this; return true; } return false; }
+
+		//a dtNavMeshQuery keeps its search state in itself, so every thread querying the mesh needs its own
+		dtNavMeshQuery* AcquireQuery()
+		{
+			dtNavMeshQuery* query = NULL;
+
+			querylock.Acquire();
+			if(!freequeries.empty())
+			{
+				query = freequeries.back();
+				freequeries.pop_back();
+			}
+			querylock.Release();
+
+			if(query == NULL)
+			{
+				query = dtAllocNavMeshQuery();
+				query->init(mesh, 1024);
+			}
+			return query;
+		}
+
+		void ReleaseQuery(dtNavMeshQuery* query)
+		{
+			querylock.Acquire();
+			freequeries.push_back(query);
+			querylock.Release();
+		}
+
+	private:
+		FastMutex querylock;
+		std::vector<dtNavMeshQuery*> freequeries;
 };
 
 class CCollideInterface
@@ -107,6 +143,8 @@ class CCollideInterface
 
 
 		NavMeshData* GetNavMesh(uint32 mapId);
+		//Same as GetNavMesh, but the mesh stays valid until the caller calls DecRef() even if the map is deactivated meanwhile
+		NavMeshData* AcquireNavMesh(uint32 mapId);
 		void LoadNavMeshTile(uint32 mapId, uint32 tileX, uint32 tileY);
 
 
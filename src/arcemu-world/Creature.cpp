@@ -266,6 +266,11 @@ Creature::~Creature()
 
 void Creature::Update(uint32 p_time)
 {
+	// a creature that slept skipped its updates, catch its timers up with the whole time
+	uint32 slept = m_aiInterface->EndSleep(getMSTime());
+	if(slept != 0)
+		p_time = slept;
+
 	Unit::Update(p_time);
 
 	if(m_corpseEvent)
@@ -280,6 +285,8 @@ void Creature::Update(uint32 p_time)
 
 		m_corpseEvent = false;
 	}
+
+	m_aiInterface->TrySleep();
 }
 
 void Creature::SafeDelete()
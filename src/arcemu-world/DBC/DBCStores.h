@@ -885,21 +885,37 @@ struct SpellEntry
 		for(uint32 i = 0; i < MAX_SPELL_EFFECTS; ++i)
 		{
 
-			if((Effect[ i ] == 6 ||   // SPELL_EFFECT_APPLY_GROUP_AREA_AURA
-			        Effect[ i ] == 27 || // SPELL_EFFECT_PERSISTENT_AREA_AURA
-			        Effect[ i ] == 35 || // SPELL_EFFECT_APPLY_GROUP_AREA_AURA
-			        Effect[ i ] == 65 || // SPELL_EFFECT_APPLY_RAID_AREA_AURA
-			        Effect[ i ] == 119 || // SPELL_EFFECT_APPLY_PET_AREA_AURA
-			        Effect[ i ] == 128 || // SPELL_EFFECT_APPLY_FRIEND_AREA_AURA
-			        Effect[ i ] == 129 || // SPELL_EFFECT_APPLY_ENEMY_AREA_AURA
-			        Effect[ i ] == 143) &&  // SPELL_EFFECT_APPLY_OWNER_AREA_AURA
-			        EffectApplyAuraName[ i ] == aura)
+			if(EffectAppliesAura(i) && EffectApplyAuraName[ i ] == aura)
 				return true;
 		}
 
 		return false;
 	}
 
+	//////////////////////////////////////////////////////////////////////////////
+	//bool EffectAppliesAura( uint32 i )
+	//  Tells if effect i of the Spell applies an Aura
+	//
+	//Parameters
+	//  uint32 i - effect index
+	//
+	//Return Value
+	//  Returns true if the effect applies an Aura (EffectApplyAuraName[ i ]).
+	//  Returns false otherwise.
+	//
+	//////////////////////////////////////////////////////////////////////////////
+	bool EffectAppliesAura(uint32 i)
+	{
+		return (Effect[ i ] == 6 ||   // SPELL_EFFECT_APPLY_AURA
+		        Effect[ i ] == 27 || // SPELL_EFFECT_PERSISTENT_AREA_AURA
+		        Effect[ i ] == 35 || // SPELL_EFFECT_APPLY_GROUP_AREA_AURA
+		        Effect[ i ] == 65 || // SPELL_EFFECT_APPLY_RAID_AREA_AURA
+		        Effect[ i ] == 119 || // SPELL_EFFECT_APPLY_PET_AREA_AURA
+		        Effect[ i ] == 128 || // SPELL_EFFECT_APPLY_FRIEND_AREA_AURA
+		        Effect[ i ] == 129 || // SPELL_EFFECT_APPLY_ENEMY_AREA_AURA
+		        Effect[ i ] == 143);  // SPELL_EFFECT_APPLY_OWNER_AREA_AURA
+	}
+
 	/////////////////////////////////////////////////////////////////////////////////
 	//uint32 GetAAEffectId()
 	//  Returns the Effect Id of the Area Aura effect if the spell has one.
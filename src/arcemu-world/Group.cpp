@@ -858,12 +858,11 @@ void Group::SaveToDB()
 	CharacterDatabase.Execute(ss.str().c_str());
 }
 
-void Group::UpdateOutOfRangePlayer(Player* pPlayer, uint32 Flags, bool Distribute, WorldPacket* Packet)
+uint32 Group::UpdateOutOfRangePlayer(Player* pPlayer, uint32 Flags, bool Distribute, WorldPacket* Packet)
 {
 	uint8 member_flags = 0x01;
-	WorldPacket* data = Packet;
-	if(!Packet)
-		data = new WorldPacket(SMSG_PARTY_MEMBER_STATS, 500);
+	WorldPacket packet(SMSG_PARTY_MEMBER_STATS, 64);
+	WorldPacket* data = (Packet != NULL) ? Packet : &packet;
 
 	if(pPlayer->GetPowerType() != POWER_TYPE_MANA)
 		Flags |= GROUP_UPDATE_FLAG_POWER_TYPE;
@@ -935,31 +934,64 @@ void Group::UpdateOutOfRangePlayer(Player* pPlayer, uint32 Flags, bool Distribut
 
 	if(Distribute && pPlayer->IsInWorld())
 	{
-		Player* plr;
-		float dist = pPlayer->GetMapMgr()->m_UpdateDistance;
-		m_groupLock.Acquire();
-		for(uint32 i = 0; i < m_SubGroupCount; ++i)
+		GroupMemberStats & sent = pPlayer->m_groupSentStats;
+		sent.powertype = pPlayer->GetPowerType();
+		if(Flags & GROUP_UPDATE_FLAG_HEALTH)
+			sent.health = pPlayer->GetHealth();
+		if(Flags & GROUP_UPDATE_FLAG_MAXHEALTH)
+			sent.maxhealth = pPlayer->GetMaxHealth();
+		if(Flags & GROUP_UPDATE_FLAG_POWER)
+			sent.power = uint16(pPlayer->GetPower(sent.powertype));
+		if(Flags & GROUP_UPDATE_FLAG_MAXPOWER)
+			sent.maxpower = uint16(pPlayer->GetMaxPower(sent.powertype));
+		if(Flags & GROUP_UPDATE_FLAG_LEVEL)
+			sent.level = uint16(pPlayer->getLevel());
+		if(Flags & GROUP_UPDATE_FLAG_ZONEID)
+			sent.areaid = uint16(pPlayer->GetAreaID());
+
+		// collect the recipients first, the packet is only encoded if somebody is out of range
+		WorldSocket* sockets[ MAX_GROUP_SIZE_RAID ];
+		uint32 count = GetOutOfRangeSockets(pPlayer, sockets);
+
+		if(count != 0)
 		{
-			if(m_SubGroups[i] == NULL)
-				continue;
+			BroadcastPacket broadcast(data);
+			for(uint32 i = 0; i < count; ++i)
+				broadcast.SendTo(sockets[ i ]);
+		}
+		return count;
+	}
 
-			for(GroupMembersSet::iterator itr = m_SubGroups[i]->GetGroupMembersBegin(); itr != m_SubGroups[i]->GetGroupMembersEnd();)
-			{
-				plr = (*itr)->m_loggedInPlayer;
-				++itr;
+	return 0;
+}
 
-				if(plr && plr != pPlayer)
-				{
-					if(plr->GetDistance2dSq(pPlayer) > dist)
-						plr->GetSession()->SendPacket(data);
-				}
+uint32 Group::GetOutOfRangeSockets(Player* pPlayer, WorldSocket** sockets)
+{
+	uint32 count = 0;
+	Player* plr;
+	float dist = pPlayer->GetMapMgr()->m_UpdateDistance;
+
+	m_groupLock.Acquire();
+	for(uint32 i = 0; i < m_SubGroupCount; ++i)
+	{
+		if(m_SubGroups[i] == NULL)
+			continue;
+
+		for(GroupMembersSet::iterator itr = m_SubGroups[i]->GetGroupMembersBegin(); itr != m_SubGroups[i]->GetGroupMembersEnd();)
+		{
+			plr = (*itr)->m_loggedInPlayer;
+			++itr;
+
+			if(plr && plr != pPlayer && count < MAX_GROUP_SIZE_RAID)
+			{
+				if(plr->GetDistance2dSq(pPlayer) > dist && plr->GetSession()->GetSocket() != NULL)
+					sockets[ count++ ] = plr->GetSession()->GetSocket();
 			}
 		}
-		m_groupLock.Release();
 	}
+	m_groupLock.Release();
 
-	if(!Packet)
-		delete data;
+	return count;
 }
 
 void Group::UpdateAllOutOfRangePlayersFor(Player* pPlayer)
@@ -1079,9 +1111,8 @@ void Group::HandleUpdateFieldChange(uint32 Index, Player* pPlayer)
 
 	if(Flags != 0)
 	{
-		m_groupLock.Acquire();
-		UpdateOutOfRangePlayer(pPlayer, Flags, true, 0);
-		m_groupLock.Release();
+		pPlayer->m_groupUpdateFlags |= Flags;
+		++pPlayer->m_groupUpdateChanges;
 	}
 }
 
@@ -1102,9 +1133,64 @@ void Group::HandlePartialChange(uint32 Type, Player* pPlayer)
 
 	if(Flags != 0)
 	{
-		m_groupLock.Acquire();
-		UpdateOutOfRangePlayer(pPlayer, Flags, true, 0);
-		m_groupLock.Release();
+		pPlayer->m_groupUpdateFlags |= Flags;
+		++pPlayer->m_groupUpdateChanges;
+	}
+}
+
+void Group::SendPendingUpdate(Player* pPlayer)
+{
+	uint32 Flags = pPlayer->m_groupUpdateFlags;
+	uint32 changes = pPlayer->m_groupUpdateChanges;
+	pPlayer->m_groupUpdateFlags = 0;
+	pPlayer->m_groupUpdateChanges = 0;
+
+	// the values may have changed back during the update, or only in a power the player isn't using
+	const GroupMemberStats & sent = pPlayer->m_groupSentStats;
+	uint8 powertype = pPlayer->GetPowerType();
+	if(powertype != sent.powertype)
+		Flags |= GROUP_UPDATE_FLAG_POWER | GROUP_UPDATE_FLAG_MAXPOWER;
+
+	if((Flags & GROUP_UPDATE_FLAG_HEALTH) && pPlayer->GetHealth() == sent.health)
+		Flags &= ~GROUP_UPDATE_FLAG_HEALTH;
+	if((Flags & GROUP_UPDATE_FLAG_MAXHEALTH) && pPlayer->GetMaxHealth() == sent.maxhealth)
+		Flags &= ~GROUP_UPDATE_FLAG_MAXHEALTH;
+	if((Flags & GROUP_UPDATE_FLAG_POWER) && powertype == sent.powertype && uint16(pPlayer->GetPower(powertype)) == sent.power)
+		Flags &= ~GROUP_UPDATE_FLAG_POWER;
+	if((Flags & GROUP_UPDATE_FLAG_MAXPOWER) && powertype == sent.powertype && uint16(pPlayer->GetMaxPower(powertype)) == sent.maxpower)
+		Flags &= ~GROUP_UPDATE_FLAG_MAXPOWER;
+	if((Flags & GROUP_UPDATE_FLAG_LEVEL) && uint16(pPlayer->getLevel()) == sent.level)
+		Flags &= ~GROUP_UPDATE_FLAG_LEVEL;
+	if((Flags & GROUP_UPDATE_FLAG_ZONEID) && uint16(pPlayer->GetAreaID()) == sent.areaid)
+		Flags &= ~GROUP_UPDATE_FLAG_ZONEID;
+
+	// every change used to go out right away to the members out of range
+	uint32 recipients;
+	uint32 bytes = 0;
+	if(Flags != 0)
+	{
+		WorldPacket data(SMSG_PARTY_MEMBER_STATS, 64);
+		recipients = UpdateOutOfRangePlayer(pPlayer, Flags, true, &data);
+		bytes = recipients * uint32(data.size() + 4);
+	}
+	else
+	{
+		WorldSocket* sockets[ MAX_GROUP_SIZE_RAID ];
+		recipients = pPlayer->IsInWorld() ? GetOutOfRangeSockets(pPlayer, sockets) : 0;
+	}
+
+	// called from the update of pPlayer, so on the thread of its map
+	MapMgr* mgr = pPlayer->GetMapMgr();
+	if(mgr != NULL)
+	{
+		PartyUpdateStats & stats = mgr->m_partyUpdateStats;
+		stats.changes += changes;
+		stats.oldPackets += changes * recipients;
+		if(Flags != 0)
+		{
+			stats.packets += recipients;
+			stats.bytes += bytes;
+		}
 	}
 }
 
@@ -89,6 +89,18 @@ enum PartyUpdateFlagGroups
     GROUP_UPDATE_TYPE_FULL_REQUEST_REPLY		=   0x7FFC0BFF,
 };
 
+// Party stats of a member as its group was last told about them
+struct GroupMemberStats
+{
+	uint32 health;
+	uint32 maxhealth;
+	uint8 powertype;
+	uint16 power;
+	uint16 maxpower;
+	uint16 level;
+	uint16 areaid;
+};
+
 class PlayerInfo;
 typedef struct
 {
@@ -98,6 +110,7 @@ typedef struct
 
 class Group;
 class Player;
+class WorldSocket;
 
 typedef std::set<PlayerInfo*> GroupMembersSet;
 
@@ -205,11 +218,16 @@ class SERVER_DECL Group
 		ARCEMU_INLINE uint8 GetGroupType() { return m_GroupType; }
 		ARCEMU_INLINE uint32 GetID() { return m_Id; }
 
-		void UpdateOutOfRangePlayer(Player* pPlayer, uint32 Flags, bool Distribute, WorldPacket* Packet);
+		// Returns the number of out of range members the packet was sent to
+		uint32 UpdateOutOfRangePlayer(Player* pPlayer, uint32 Flags, bool Distribute, WorldPacket* Packet);
 		void UpdateAllOutOfRangePlayersFor(Player* pPlayer);
+		// Mark the party stats of pPlayer as changed, they are sent by SendPendingUpdate()
 		void HandleUpdateFieldChange(uint32 Index, Player* pPlayer);
 		void HandlePartialChange(uint32 Type, Player* pPlayer);
 
+		// Sends the marked party stats of pPlayer that differ from what the group was last told, called once per update
+		void SendPendingUpdate(Player* pPlayer);
+
 		uint64 m_targetIcons[8];
 		bool m_disbandOnNoMembers;
 		ARCEMU_INLINE Mutex & getLock() { return m_groupLock; }
@@ -270,6 +288,9 @@ class SERVER_DECL Group
 		Mutex m_groupLock;
 		bool m_dirty;
 		bool m_updateblock;
+
+		// Fills sockets with the ones of the members that are out of range of pPlayer, returns how many
+		uint32 GetOutOfRangeSockets(Player* pPlayer, WorldSocket** sockets);
 	public:
 		uint8 m_difficulty;
 		uint8 m_raiddifficulty;
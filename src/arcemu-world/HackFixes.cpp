@@ -42,1251 +42,1646 @@ void CreateDummySpell(uint32 id)
 	sWorld.dummyspells.push_back(sp);
 }
 
-void ApplyNormalFixes()
+// Number of batches the parallel spell fixes are split into, more than the startup threads so they finish evenly
+#define SPELLFIX_BATCH_COUNT 32
+
+// A trigger spell that was missing when its row was processed. The dummy for it is created after the parallel pass.
+struct MissingTriggerSpell
 {
-	//Updating spell.dbc
+	uint32 row;
+	uint32 spellId;
+};
 
-	Log.Success("World", "Processing %u spells...", dbcSpell.GetNumRows());
+static bool MissingTriggerRowLess(const MissingTriggerSpell & a, const MissingTriggerSpell & b)
+{
+	return a.row < b.row;
+}
 
-	//checking if the DBCs have been extracted from an english client, based on namehash of spell 4, the first with a different name in non-english DBCs
-	SpellEntry* sp = dbcSpell.LookupEntry(4);
-	if(crc32((const unsigned char*)sp->Name, (unsigned int)strlen(sp->Name)) != SPELL_HASH_WORD_OF_RECALL_OTHER)
+//////////////////////////////////////////////////////////////////////
+//class SpellFixBatch
+// A set of spell.dbc rows fixed by one worker thread of the startup
+// task list, in ascending row order.
+//
+/////////////////////////////////////////////////////////////////////
+class SpellFixBatch
+{
+	public:
+		SpellFixBatch() : talentSpells(NULL) {}
+
+		std::vector< uint32 > rows;
+		const map< uint32, uint32 >* talentSpells;
+		std::vector< MissingTriggerSpell > missingTriggers;
+};
+
+//////////////////////////////////////////////////////////////////////
+//class SpellRowGroups
+// Groups the rows of spell.dbc that have to be processed by the same
+// thread, because processing one of them reads what the other writes.
+//
+/////////////////////////////////////////////////////////////////////
+class SpellRowGroups
+{
+	public:
+		SpellRowGroups(uint32 count) : m_parent(count)
+		{
+			for(uint32 i = 0; i < count; ++i)
+				m_parent[ i ] = i;
+		}
+
+		uint32 Find(uint32 row)
+		{
+			while(m_parent[ row ] != row)
+			{
+				m_parent[ row ] = m_parent[ m_parent[ row ] ];
+				row = m_parent[ row ];
+			}
+			return row;
+		}
+
+		void Join(uint32 a, uint32 b)
+		{
+			a = Find(a);
+			b = Find(b);
+			if(a != b)
+				m_parent[ std::max(a, b) ] = std::min(a, b);
+		}
+
+		//Splits the rows into at most count batches without separating a group, keeping every batch in ascending row order.
+		void MakeBatches(uint32 count, std::vector< SpellFixBatch* > & batches)
+		{
+			uint32 rows = uint32(m_parent.size());
+			uint32 perBatch = (rows + count - 1) / count;
+			std::vector< uint32 > batchOfGroup(rows, uint32(-1));
+
+			for(uint32 row = 0; row < rows; ++row)
+			{
+				uint32 group = Find(row);
+				if(batchOfGroup[ group ] == uint32(-1))
+				{
+					// groups are assigned in the order of their first row, so batches stay close to contiguous
+					if(batches.empty() || batches.back()->rows.size() >= perBatch)
+						batches.push_back(new SpellFixBatch());
+					batchOfGroup[ group ] = uint32(batches.size() - 1);
+				}
+				batches[ batchOfGroup[ group ] ]->rows.push_back(row);
+			}
+		}
+
+	private:
+		std::vector< uint32 > m_parent;
+};
+
+static uint32 GetSpellRow(SpellEntry* sp, SpellEntry* firstRow, uint32 cnt)
+{
+	if(sp == NULL || sp < firstRow || sp >= firstRow + cnt)
+		return uint32(-1);
+
+	return uint32(sp - firstRow);
+}
+
+//Rows that lowercase their description while looking for proc flags.
+static bool LowersDescription(SpellEntry* sp)
+{
+	for(uint32 y = 0; y < 3; ++y)
 	{
-		Log.LargeErrorMessage("You are using DBCs extracted from an unsupported client.", "ArcEmu supports only enUS and enGB!!!", NULL);
-		abort();
+		if(sp->Effect[ y ] == SPELL_EFFECT_APPLY_AURA &&
+		        (sp->EffectApplyAuraName[ y ] == SPELL_AURA_PROC_TRIGGER_SPELL || sp->EffectApplyAuraName[ y ] == SPELL_AURA_PROC_TRIGGER_DAMAGE))
+			return true;
 	}
 
-	uint32 cnt = dbcSpell.GetNumRows();
-	uint32 effect;
-	uint32 result;
+	return false;
+}
 
-	map<uint32, uint32> talentSpells;
-	map<uint32, uint32>::iterator talentSpellIterator;
-	uint32 i, j;
-	for(i = 0; i < dbcTalent.GetNumRows(); ++i)
-	{
-		TalentEntry* tal = dbcTalent.LookupRow(i);
-		for(j = 0; j < 5; ++j)
-			if(tal->RankID[j] != 0)
-				talentSpells.insert(make_pair(tal->RankID[j], tal->TalentTree));
+struct SpellStringRange
+{
+	const char* start;
+	const char* end;
+	uint32 row;
 
-	}
+	bool operator<(const SpellStringRange & other) const { return start < other.start; }
+};
 
-	for(uint32 x = 0; x < cnt; x++)
+static bool StartsBeforeEnd(const SpellStringRange & value, const SpellStringRange & range)
+{
+	return value.start < range.end;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//static bool GroupNormalFixRows( SpellRowGroups & groups, uint32 cnt )
+// Joins the rows that ApplyNormalFixesToRow() can't process independently:
+//  - rows whose name, rank or description shares bytes with a description that
+//    another row lowercases (the DBC string block stores duplicate strings once)
+//  - profession ranks and the spell they set the level of
+//
+//Return values
+// Returns false if a row would write to a spell that isn't a row of spell.dbc,
+// in that case the rows have to be processed serially.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+static bool GroupNormalFixRows(SpellRowGroups & groups, uint32 cnt)
+{
+	SpellEntry* firstRow = dbcSpell.LookupRow(0);
+	std::vector< SpellStringRange > lowered;
+
+	for(uint32 x = 0; x < cnt; ++x)
 	{
-		// Read every SpellEntry row
-		sp = dbcSpell.LookupRow(x);
+		SpellEntry* sp = dbcSpell.LookupRow(x);
+
+		if(LowersDescription(sp))
+		{
+			SpellStringRange r;
+			r.start = sp->Description;
+			r.end = sp->Description + strlen(sp->Description);
+			r.row = x;
+			if(r.end != r.start)
+				lowered.push_back(r);
+		}
 
-		uint32 rank = 0;
-		uint32 namehash = 0;
-
-		sp->self_cast_only = false;
-		sp->apply_on_shapeshift_change = false;
-		sp->always_apply = false;
-
-		// hash the name
-		//!!!!!!! representing all strings on 32 bits is dangerous. There is a chance to get same hash for a lot of strings ;)
-		namehash = crc32((const unsigned char*)sp->Name, (unsigned int)strlen(sp->Name));
-		sp->NameHash   = namehash; //need these set before we start processing spells
-
-		float radius = std::max(::GetRadius(dbcSpellRadius.LookupEntry(sp->EffectRadiusIndex[0])), ::GetRadius(dbcSpellRadius.LookupEntry(sp->EffectRadiusIndex[1])));
-		radius = std::max(::GetRadius(dbcSpellRadius.LookupEntry(sp->EffectRadiusIndex[2])), radius);
-		radius = std::max(GetMaxRange(dbcSpellRange.LookupEntry(sp->rangeIndex)), radius);
-		sp->base_range_or_radius_sqr = radius * radius;
-
-		sp->ai_target_type = GetAiTargetType(sp);
-		// NEW SCHOOLS AS OF 2.4.0:
-		/* (bitwise)
-		SCHOOL_NORMAL = 1,
-		SCHOOL_HOLY   = 2,
-		SCHOOL_FIRE   = 4,
-		SCHOOL_NATURE = 8,
-		SCHOOL_FROST  = 16,
-		SCHOOL_SHADOW = 32,
-		SCHOOL_ARCANE = 64
-		*/
-
-		// Save School as SchoolMask, and set School as an index
-		sp->SchoolMask = sp->School;
-		for(i = 0; i < SCHOOL_COUNT; i++)
+		// see "stupid spell ranking problem", only rows with a level of 0 set the level of the spell they teach
+		if(sp->spellLevel == 0 && (strstr(sp->Name, "Apprentice ") || strstr(sp->Name, "Journeyman ") || strstr(sp->Name, "Expert ") || strstr(sp->Name, "Artisan ") || strstr(sp->Name, "Master ")))
 		{
-			if(sp->School & (1 << i))
+			uint32 teachspell = 0;
+			if(sp->Effect[0] == SPELL_EFFECT_LEARN_SPELL)
+				teachspell = sp->EffectTriggerSpell[0];
+			else if(sp->Effect[1] == SPELL_EFFECT_LEARN_SPELL)
+				teachspell = sp->EffectTriggerSpell[1];
+			else if(sp->Effect[2] == SPELL_EFFECT_LEARN_SPELL)
+				teachspell = sp->EffectTriggerSpell[2];
+
+			if(teachspell)
 			{
-				sp->School = i;
-				break;
+				uint32 row = GetSpellRow(dbcSpell.LookupEntryForced(teachspell), firstRow, cnt);
+				if(row == uint32(-1))
+					return false;
+
+				groups.Join(x, row);
 			}
 		}
+	}
+
+	if(lowered.empty())
+		return true;
+
+	// merge the overlapping descriptions, the rows lowercasing one of them belong together anyway
+	std::sort(lowered.begin(), lowered.end());
+	std::vector< SpellStringRange > merged;
+	for(std::vector< SpellStringRange >::iterator itr = lowered.begin(); itr != lowered.end(); ++itr)
+	{
+		if(!merged.empty() && itr->start < merged.back().end)
+		{
+			merged.back().end = std::max(merged.back().end, itr->end);
+			groups.Join(merged.back().row, itr->row);
+		}
+		else
+			merged.push_back(*itr);
+	}
 
-		ARCEMU_ASSERT(sp->School < SCHOOL_COUNT);
+	for(uint32 x = 0; x < cnt; ++x)
+	{
+		SpellEntry* sp = dbcSpell.LookupRow(x);
+		const char* strings[ 3 ] = { sp->Name, sp->Rank, sp->Description };
 
-		// correct caster/target aura states
-		if(sp->CasterAuraState > 1)
-			sp->CasterAuraState = 1 << (sp->CasterAuraState - 1);
+		for(uint32 s = 0; s < 3; ++s)
+		{
+			SpellStringRange r;
+			r.start = strings[ s ];
+			r.end = strings[ s ] + strlen(strings[ s ]);
+			if(r.end == r.start)
+				continue;
 
-		if(sp->TargetAuraState > 1)
-			sp->TargetAuraState = 1 << (sp->TargetAuraState - 1);
+			// the merged ranges don't overlap, so they are sorted by their end too
+			std::vector< SpellStringRange >::iterator itr = std::upper_bound(merged.begin(), merged.end(), r, StartsBeforeEnd);
+			for(; itr != merged.end() && itr->start < r.end; ++itr)
+				groups.Join(x, itr->row);
+		}
+	}
 
-		// apply on shapeshift change
-		if(sp->NameHash == SPELL_HASH_TRACK_HUMANOIDS)
-			sp->apply_on_shapeshift_change = true;
+	return true;
+}
 
-		if(sp->NameHash == SPELL_HASH_BLOOD_FURY
-			|| sp->NameHash == SPELL_HASH_SHADOWSTEP
-			|| sp->NameHash == SPELL_HASH_PSYCHIC_HORROR)
-			sp->always_apply = true;
+//Joins the periodic trigger spells with the rows triggering them, ApplyCoefficientFixesToRow() reads the effects of the triggered row.
+static void GroupCoefficientFixRows(SpellRowGroups & groups, uint32 cnt)
+{
+	SpellEntry* firstRow = dbcSpell.LookupRow(0);
 
-		//there are some spells that change the "damage" value of 1 effect to another : devastate = bonus first then damage
-		//this is a total bullshit so remove it when spell system supports effect overwriting
-		for(uint32 col1_swap = 0; col1_swap < 2 ; col1_swap++)
-			for(uint32 col2_swap = col1_swap ; col2_swap < 3 ; col2_swap++)
-				if(sp->Effect[col1_swap] == SPELL_EFFECT_WEAPON_PERCENT_DAMAGE && sp->Effect[col2_swap] == SPELL_EFFECT_DUMMYMELEE)
-				{
-					uint32 temp;
-					float ftemp;
-					temp = sp->Effect[col1_swap];
-					sp->Effect[col1_swap] = sp->Effect[col2_swap] ;
-					sp->Effect[col2_swap] = temp;
-					temp = sp->EffectDieSides[col1_swap];
-					sp->EffectDieSides[col1_swap] = sp->EffectDieSides[col2_swap] ;
-					sp->EffectDieSides[col2_swap] = temp;
-					//temp = sp->EffectBaseDice[col1_swap];	sp->EffectBaseDice[col1_swap] = sp->EffectBaseDice[col2_swap] ;		sp->EffectBaseDice[col2_swap] = temp;
-					//ftemp = sp->EffectDicePerLevel[col1_swap];			sp->EffectDicePerLevel[col1_swap] = sp->EffectDicePerLevel[col2_swap] ;				sp->EffectDicePerLevel[col2_swap] = ftemp;
-					ftemp = sp->EffectRealPointsPerLevel[col1_swap];
-					sp->EffectRealPointsPerLevel[col1_swap] = sp->EffectRealPointsPerLevel[col2_swap] ;
-					sp->EffectRealPointsPerLevel[col2_swap] = ftemp;
-					temp = sp->EffectBasePoints[col1_swap];
-					sp->EffectBasePoints[col1_swap] = sp->EffectBasePoints[col2_swap] ;
-					sp->EffectBasePoints[col2_swap] = temp;
-					temp = sp->EffectMechanic[col1_swap];
-					sp->EffectMechanic[col1_swap] = sp->EffectMechanic[col2_swap] ;
-					sp->EffectMechanic[col2_swap] = temp;
-					temp = sp->EffectImplicitTargetA[col1_swap];
-					sp->EffectImplicitTargetA[col1_swap] = sp->EffectImplicitTargetA[col2_swap] ;
-					sp->EffectImplicitTargetA[col2_swap] = temp;
-					temp = sp->EffectImplicitTargetB[col1_swap];
-					sp->EffectImplicitTargetB[col1_swap] = sp->EffectImplicitTargetB[col2_swap] ;
-					sp->EffectImplicitTargetB[col2_swap] = temp;
-					temp = sp->EffectRadiusIndex[col1_swap];
-					sp->EffectRadiusIndex[col1_swap] = sp->EffectRadiusIndex[col2_swap] ;
-					sp->EffectRadiusIndex[col2_swap] = temp;
-					temp = sp->EffectApplyAuraName[col1_swap];
-					sp->EffectApplyAuraName[col1_swap] = sp->EffectApplyAuraName[col2_swap] ;
-					sp->EffectApplyAuraName[col2_swap] = temp;
-					temp = sp->EffectAmplitude[col1_swap];
-					sp->EffectAmplitude[col1_swap] = sp->EffectAmplitude[col2_swap] ;
-					sp->EffectAmplitude[col2_swap] = temp;
-					ftemp = sp->EffectMultipleValue[col1_swap];
-					sp->EffectMultipleValue[col1_swap] = sp->EffectMultipleValue[col2_swap] ;
-					sp->EffectMultipleValue[col2_swap] = ftemp;
-					temp = sp->EffectChainTarget[col1_swap];
-					sp->EffectChainTarget[col1_swap] = sp->EffectChainTarget[col2_swap] ;
-					sp->EffectChainTarget[col2_swap] = temp;
-					temp = sp->EffectMiscValue[col1_swap];
-					sp->EffectMiscValue[col1_swap] = sp->EffectMiscValue[col2_swap] ;
-					sp->EffectMiscValue[col2_swap] = temp;
-					temp = sp->EffectTriggerSpell[col1_swap];
-					sp->EffectTriggerSpell[col1_swap] = sp->EffectTriggerSpell[col2_swap] ;
-					sp->EffectTriggerSpell[col2_swap] = temp;
-					ftemp = sp->EffectPointsPerComboPoint[col1_swap];
-					sp->EffectPointsPerComboPoint[col1_swap] = sp->EffectPointsPerComboPoint[col2_swap] ;
-					sp->EffectPointsPerComboPoint[col2_swap] = ftemp;
-				}
+	for(uint32 x = 0; x < cnt; ++x)
+	{
+		SpellEntry* sp = dbcSpell.LookupRow(x);
+		for(uint32 i = 0; i < 3; ++i)
+		{
+			if(sp->EffectApplyAuraName[ i ] != SPELL_AURA_PERIODIC_TRIGGER_SPELL || sp->EffectTriggerSpell[ i ] == 0)
+				continue;
+
+			uint32 row = GetSpellRow(dbcSpell.LookupEntryForced(sp->EffectTriggerSpell[ i ]), firstRow, cnt);
+			if(row != uint32(-1))
+				groups.Join(x, row);
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//static void ApplyNormalFixesToRow( SpellEntry *sp, uint32 row, const map< uint32, uint32 > &talentSpells, std::vector< MissingTriggerSpell > *missingTriggers )
+// Sets the custom fields of a spell.dbc row and applies the fixes that only depend on the row itself.
+//
+//Parameter(s)
+// SpellEntry *sp                      -  the row
+// uint32 row                          -  index of the row
+// const map &talentSpells             -  talent tree of the talent spells
+// std::vector *missingTriggers        -  if not NULL, trigger spells missing from spell.dbc are added to it
+//                                        instead of creating their dummy spell right away
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+static void ApplyNormalFixesToRow(SpellEntry* sp, uint32 row, const map< uint32, uint32 > & talentSpells, std::vector< MissingTriggerSpell >* missingTriggers)
+{
+	map< uint32, uint32 >::const_iterator talentSpellIterator;
+	uint32 i;
+	uint32 effect;
+	uint32 result;
+
+	uint32 rank = 0;
+	uint32 namehash = 0;
+
+	sp->self_cast_only = false;
+	sp->apply_on_shapeshift_change = false;
+	sp->always_apply = false;
+
+	// hash the name
+	//!!!!!!! representing all strings on 32 bits is dangerous. There is a chance to get same hash for a lot of strings ;)
+	namehash = crc32((const unsigned char*)sp->Name, (unsigned int)strlen(sp->Name));
+	sp->NameHash   = namehash; //need these set before we start processing spells
+
+	float radius = std::max(::GetRadius(dbcSpellRadius.LookupEntry(sp->EffectRadiusIndex[0])), ::GetRadius(dbcSpellRadius.LookupEntry(sp->EffectRadiusIndex[1])));
+	radius = std::max(::GetRadius(dbcSpellRadius.LookupEntry(sp->EffectRadiusIndex[2])), radius);
+	radius = std::max(GetMaxRange(dbcSpellRange.LookupEntry(sp->rangeIndex)), radius);
+	sp->base_range_or_radius_sqr = radius * radius;
+
+	sp->ai_target_type = GetAiTargetType(sp);
+	// NEW SCHOOLS AS OF 2.4.0:
+	/* (bitwise)
+	SCHOOL_NORMAL = 1,
+	SCHOOL_HOLY   = 2,
+	SCHOOL_FIRE   = 4,
+	SCHOOL_NATURE = 8,
+	SCHOOL_FROST  = 16,
+	SCHOOL_SHADOW = 32,
+	SCHOOL_ARCANE = 64
+	*/
 
-		for(uint32 b = 0; b < 3; ++b)
+	// Save School as SchoolMask, and set School as an index
+	sp->SchoolMask = sp->School;
+	for(i = 0; i < SCHOOL_COUNT; i++)
+	{
+		if(sp->School & (1 << i))
 		{
-			if(sp->EffectTriggerSpell[b] != 0 && dbcSpell.LookupEntryForced(sp->EffectTriggerSpell[b]) == NULL)
+			sp->School = i;
+			break;
+		}
+	}
+
+	ARCEMU_ASSERT(sp->School < SCHOOL_COUNT);
+
+	// correct caster/target aura states
+	if(sp->CasterAuraState > 1)
+		sp->CasterAuraState = 1 << (sp->CasterAuraState - 1);
+
+	if(sp->TargetAuraState > 1)
+		sp->TargetAuraState = 1 << (sp->TargetAuraState - 1);
+
+	// apply on shapeshift change
+	if(sp->NameHash == SPELL_HASH_TRACK_HUMANOIDS)
+		sp->apply_on_shapeshift_change = true;
+
+	if(sp->NameHash == SPELL_HASH_BLOOD_FURY
+		|| sp->NameHash == SPELL_HASH_SHADOWSTEP
+		|| sp->NameHash == SPELL_HASH_PSYCHIC_HORROR)
+		sp->always_apply = true;
+
+	//there are some spells that change the "damage" value of 1 effect to another : devastate = bonus first then damage
+	//this is a total bullshit so remove it when spell system supports effect overwriting
+	for(uint32 col1_swap = 0; col1_swap < 2 ; col1_swap++)
+		for(uint32 col2_swap = col1_swap ; col2_swap < 3 ; col2_swap++)
+			if(sp->Effect[col1_swap] == SPELL_EFFECT_WEAPON_PERCENT_DAMAGE && sp->Effect[col2_swap] == SPELL_EFFECT_DUMMYMELEE)
 			{
-				/* proc spell referencing non-existent spell. create a dummy spell for use w/ it. */
-				CreateDummySpell(sp->EffectTriggerSpell[b]);
+				uint32 temp;
+				float ftemp;
+				temp = sp->Effect[col1_swap];
+				sp->Effect[col1_swap] = sp->Effect[col2_swap] ;
+				sp->Effect[col2_swap] = temp;
+				temp = sp->EffectDieSides[col1_swap];
+				sp->EffectDieSides[col1_swap] = sp->EffectDieSides[col2_swap] ;
+				sp->EffectDieSides[col2_swap] = temp;
+				//temp = sp->EffectBaseDice[col1_swap];	sp->EffectBaseDice[col1_swap] = sp->EffectBaseDice[col2_swap] ;		sp->EffectBaseDice[col2_swap] = temp;
+				//ftemp = sp->EffectDicePerLevel[col1_swap];			sp->EffectDicePerLevel[col1_swap] = sp->EffectDicePerLevel[col2_swap] ;				sp->EffectDicePerLevel[col2_swap] = ftemp;
+				ftemp = sp->EffectRealPointsPerLevel[col1_swap];
+				sp->EffectRealPointsPerLevel[col1_swap] = sp->EffectRealPointsPerLevel[col2_swap] ;
+				sp->EffectRealPointsPerLevel[col2_swap] = ftemp;
+				temp = sp->EffectBasePoints[col1_swap];
+				sp->EffectBasePoints[col1_swap] = sp->EffectBasePoints[col2_swap] ;
+				sp->EffectBasePoints[col2_swap] = temp;
+				temp = sp->EffectMechanic[col1_swap];
+				sp->EffectMechanic[col1_swap] = sp->EffectMechanic[col2_swap] ;
+				sp->EffectMechanic[col2_swap] = temp;
+				temp = sp->EffectImplicitTargetA[col1_swap];
+				sp->EffectImplicitTargetA[col1_swap] = sp->EffectImplicitTargetA[col2_swap] ;
+				sp->EffectImplicitTargetA[col2_swap] = temp;
+				temp = sp->EffectImplicitTargetB[col1_swap];
+				sp->EffectImplicitTargetB[col1_swap] = sp->EffectImplicitTargetB[col2_swap] ;
+				sp->EffectImplicitTargetB[col2_swap] = temp;
+				temp = sp->EffectRadiusIndex[col1_swap];
+				sp->EffectRadiusIndex[col1_swap] = sp->EffectRadiusIndex[col2_swap] ;
+				sp->EffectRadiusIndex[col2_swap] = temp;
+				temp = sp->EffectApplyAuraName[col1_swap];
+				sp->EffectApplyAuraName[col1_swap] = sp->EffectApplyAuraName[col2_swap] ;
+				sp->EffectApplyAuraName[col2_swap] = temp;
+				temp = sp->EffectAmplitude[col1_swap];
+				sp->EffectAmplitude[col1_swap] = sp->EffectAmplitude[col2_swap] ;
+				sp->EffectAmplitude[col2_swap] = temp;
+				ftemp = sp->EffectMultipleValue[col1_swap];
+				sp->EffectMultipleValue[col1_swap] = sp->EffectMultipleValue[col2_swap] ;
+				sp->EffectMultipleValue[col2_swap] = ftemp;
+				temp = sp->EffectChainTarget[col1_swap];
+				sp->EffectChainTarget[col1_swap] = sp->EffectChainTarget[col2_swap] ;
+				sp->EffectChainTarget[col2_swap] = temp;
+				temp = sp->EffectMiscValue[col1_swap];
+				sp->EffectMiscValue[col1_swap] = sp->EffectMiscValue[col2_swap] ;
+				sp->EffectMiscValue[col2_swap] = temp;
+				temp = sp->EffectTriggerSpell[col1_swap];
+				sp->EffectTriggerSpell[col1_swap] = sp->EffectTriggerSpell[col2_swap] ;
+				sp->EffectTriggerSpell[col2_swap] = temp;
+				ftemp = sp->EffectPointsPerComboPoint[col1_swap];
+				sp->EffectPointsPerComboPoint[col1_swap] = sp->EffectPointsPerComboPoint[col2_swap] ;
+				sp->EffectPointsPerComboPoint[col2_swap] = ftemp;
 			}
 
-			if(sp->Attributes & ATTRIBUTES_ONLY_OUTDOORS && sp->EffectApplyAuraName[b] == SPELL_AURA_MOUNTED)
+	for(uint32 b = 0; b < 3; ++b)
+	{
+		if(sp->EffectTriggerSpell[b] != 0 && dbcSpell.LookupEntryForced(sp->EffectTriggerSpell[b]) == NULL)
+		{
+			/* proc spell referencing non-existent spell. create a dummy spell for use w/ it. */
+			if(missingTriggers == NULL)
+				CreateDummySpell(sp->EffectTriggerSpell[b]);
+			else
 			{
-				sp->Attributes &= ~ATTRIBUTES_ONLY_OUTDOORS;
+				MissingTriggerSpell missing;
+				missing.row = row;
+				missing.spellId = sp->EffectTriggerSpell[b];
+				missingTriggers->push_back(missing);
 			}
 		}
 
-		if(!strcmp(sp->Name, "Hearthstone") || !strcmp(sp->Name, "Stuck") || !strcmp(sp->Name, "Astral Recall"))
-			sp->self_cast_only = true;
-
-		sp->proc_interval = 0;//trigger at each event
-		sp->c_is_flags = 0;
-		sp->spell_coef_flags = 0;
-		sp->Dspell_coef_override = -1;
-		sp->OTspell_coef_override = -1;
-		sp->casttime_coef = 0;
-		sp->fixed_dddhcoef = -1;
-		sp->fixed_hotdotcoef = -1;
-
-		talentSpellIterator = talentSpells.find(sp->Id);
-		if(talentSpellIterator == talentSpells.end())
-			sp->talent_tree = 0;
-		else
-			sp->talent_tree = talentSpellIterator->second;
-
-		// parse rank text
-		if(sscanf(sp->Rank, "Rank %d", (unsigned int*)&rank) != 1)
-			rank = 0;
-
-		//seal of command
-		else if(namehash == SPELL_HASH_SEAL_OF_COMMAND)
-			sp->Spell_Dmg_Type = SPELL_DMG_TYPE_MAGIC;
-
-		//judgement of command
-		else if(namehash == SPELL_HASH_JUDGEMENT_OF_COMMAND)
-			sp->Spell_Dmg_Type = SPELL_DMG_TYPE_MAGIC;
-
-		else if(namehash == SPELL_HASH_ARCANE_SHOT)
-			sp->c_is_flags |= SPELL_FLAG_IS_NOT_USING_DMG_BONUS;
-
-		else if(namehash == SPELL_HASH_SERPENT_STING)
-			sp->c_is_flags |= SPELL_FLAG_IS_NOT_USING_DMG_BONUS;
-
-		//Rogue: Poison time fix for 2.3
-		if(strstr(sp->Name, "Crippling Poison") && sp->Effect[0] == SPELL_EFFECT_ENCHANT_ITEM_TEMPORARY)    //I, II
-			sp->EffectBasePoints[0] = 3599;
-		if(strstr(sp->Name, "Mind-numbing Poison") && sp->Effect[0] == SPELL_EFFECT_ENCHANT_ITEM_TEMPORARY)    //I,II,III
-			sp->EffectBasePoints[0] = 3599;
-		if(strstr(sp->Name, "Instant Poison") && sp->Effect[0] == SPELL_EFFECT_ENCHANT_ITEM_TEMPORARY)    //I,II,III,IV,V,VI,VII
-			sp->EffectBasePoints[0] = 3599;
-		if(strstr(sp->Name, "Deadly Poison") && sp->Effect[0] == SPELL_EFFECT_ENCHANT_ITEM_TEMPORARY)    //I,II,III,IV,V,VI,VII
-			sp->EffectBasePoints[0] = 3599;
-		if(strstr(sp->Name, "Wound Poison") && sp->Effect[0] == SPELL_EFFECT_ENCHANT_ITEM_TEMPORARY)    //I,II,III,IV,V
-			sp->EffectBasePoints[0] = 3599;
-		if(strstr(sp->Name, "Anesthetic Poison") && sp->Effect[0] == SPELL_EFFECT_ENCHANT_ITEM_TEMPORARY)    //I
-			sp->EffectBasePoints[0] = 3599;
-
-		if(strstr(sp->Name, "Sharpen Blade") && sp->Effect[0] == SPELL_EFFECT_ENCHANT_ITEM_TEMPORARY)    //All BS stones
-			sp->EffectBasePoints[0] = 3599;
-
-		//these mostly do not mix so we can use else
-		// look for seal, etc in name
-		if(strstr(sp->Name, "Seal of"))
-			sp->BGR_one_buff_on_target |= SPELL_TYPE_SEAL;
-		else if(strstr(sp->Name, "Hand of"))
-			sp->BGR_one_buff_on_target |= SPELL_TYPE_HAND;
-		else if(strstr(sp->Name, "Blessing"))
-			sp->BGR_one_buff_on_target |= SPELL_TYPE_BLESSING;
-		else if(strstr(sp->Name, "Curse"))
-			sp->BGR_one_buff_on_target |= SPELL_TYPE_CURSE;
-		else if(strstr(sp->Name, "Corruption"))
-			sp->BGR_one_buff_on_target |= SPELL_TYPE_CORRUPTION;
-		else if(strstr(sp->Name, "Aspect"))
-			sp->BGR_one_buff_on_target |= SPELL_TYPE_ASPECT;
-		else if(strstr(sp->Name, "Sting") || strstr(sp->Name, "sting"))
-			sp->BGR_one_buff_on_target |= SPELL_TYPE_STING;
-		// don't break armor items!
-		else if(strstr(sp->Name, "Fel Armor") || strstr(sp->Name, "Frost Armor") || strstr(sp->Name, "Ice Armor") || strstr(sp->Name, "Mage Armor") || strstr(sp->Name, "Molten Armor") || strstr(sp->Name, "Demon Skin") || strstr(sp->Name, "Demon Armor"))
-			sp->BGR_one_buff_on_target |= SPELL_TYPE_ARMOR;
-		else if(strstr(sp->Name, "Aura")
-		        && !strstr(sp->Name, "Trueshot") && !strstr(sp->Name, "Moonkin")
-		        && !strstr(sp->Name, "Crusader") && !strstr(sp->Name, "Sanctity") && !strstr(sp->Name, "Devotion") && !strstr(sp->Name, "Retribution") && !strstr(sp->Name, "Concentration") && !strstr(sp->Name, "Shadow Resistance") && !strstr(sp->Name, "Frost Resistance") && !strstr(sp->Name, "Fire Resistance")
-		       )
-			sp->BGR_one_buff_on_target |= SPELL_TYPE_AURA;
-		else if(strstr(sp->Name, "Track") == sp->Name)
-			sp->BGR_one_buff_on_target |= SPELL_TYPE_TRACK;
-		else if(namehash == SPELL_HASH_GIFT_OF_THE_WILD || namehash == SPELL_HASH_MARK_OF_THE_WILD)
-			sp->BGR_one_buff_on_target |= SPELL_TYPE_MARK_GIFT;
-		else if(namehash == SPELL_HASH_IMMOLATION_TRAP || namehash == SPELL_HASH_FREEZING_TRAP || namehash == SPELL_HASH_FROST_TRAP || namehash == SPELL_HASH_EXPLOSIVE_TRAP || namehash == SPELL_HASH_SNAKE_TRAP)
-			sp->BGR_one_buff_on_target |= SPELL_TYPE_HUNTER_TRAP;
-		else if(namehash == SPELL_HASH_ARCANE_INTELLECT || namehash == SPELL_HASH_ARCANE_BRILLIANCE)
-			sp->BGR_one_buff_on_target |= SPELL_TYPE_MAGE_INTEL;
-		else if(namehash == SPELL_HASH_AMPLIFY_MAGIC || namehash == SPELL_HASH_DAMPEN_MAGIC)
-			sp->BGR_one_buff_on_target |= SPELL_TYPE_MAGE_MAGI;
-		else if(namehash == SPELL_HASH_FIRE_WARD || namehash == SPELL_HASH_FROST_WARD)
-			sp->BGR_one_buff_on_target |= SPELL_TYPE_MAGE_WARDS;
-		else if(namehash == SPELL_HASH_SHADOW_PROTECTION || namehash == SPELL_HASH_PRAYER_OF_SHADOW_PROTECTION)
-			sp->BGR_one_buff_on_target |= SPELL_TYPE_PRIEST_SH_PPROT;
-		else if(namehash == SPELL_HASH_WATER_SHIELD || namehash == SPELL_HASH_EARTH_SHIELD || namehash == SPELL_HASH_LIGHTNING_SHIELD)
-			sp->BGR_one_buff_on_target |= SPELL_TYPE_SHIELD;
-		else if(namehash == SPELL_HASH_POWER_WORD__FORTITUDE || namehash == SPELL_HASH_PRAYER_OF_FORTITUDE)
-			sp->BGR_one_buff_on_target |= SPELL_TYPE_FORTITUDE;
-		else if(namehash == SPELL_HASH_DIVINE_SPIRIT || namehash == SPELL_HASH_PRAYER_OF_SPIRIT)
-			sp->BGR_one_buff_on_target |= SPELL_TYPE_SPIRIT;
+		if(sp->Attributes & ATTRIBUTES_ONLY_OUTDOORS && sp->EffectApplyAuraName[b] == SPELL_AURA_MOUNTED)
+		{
+			sp->Attributes &= ~ATTRIBUTES_ONLY_OUTDOORS;
+		}
+	}
+
+	if(!strcmp(sp->Name, "Hearthstone") || !strcmp(sp->Name, "Stuck") || !strcmp(sp->Name, "Astral Recall"))
+		sp->self_cast_only = true;
+
+	sp->proc_interval = 0;//trigger at each event
+	sp->c_is_flags = 0;
+	sp->spell_coef_flags = 0;
+	sp->Dspell_coef_override = -1;
+	sp->OTspell_coef_override = -1;
+	sp->casttime_coef = 0;
+	sp->fixed_dddhcoef = -1;
+	sp->fixed_hotdotcoef = -1;
+
+	talentSpellIterator = talentSpells.find(sp->Id);
+	if(talentSpellIterator == talentSpells.end())
+		sp->talent_tree = 0;
+	else
+		sp->talent_tree = talentSpellIterator->second;
+
+	// parse rank text
+	if(sscanf(sp->Rank, "Rank %d", (unsigned int*)&rank) != 1)
+		rank = 0;
+
+	//seal of command
+	else if(namehash == SPELL_HASH_SEAL_OF_COMMAND)
+		sp->Spell_Dmg_Type = SPELL_DMG_TYPE_MAGIC;
+
+	//judgement of command
+	else if(namehash == SPELL_HASH_JUDGEMENT_OF_COMMAND)
+		sp->Spell_Dmg_Type = SPELL_DMG_TYPE_MAGIC;
+
+	else if(namehash == SPELL_HASH_ARCANE_SHOT)
+		sp->c_is_flags |= SPELL_FLAG_IS_NOT_USING_DMG_BONUS;
+
+	else if(namehash == SPELL_HASH_SERPENT_STING)
+		sp->c_is_flags |= SPELL_FLAG_IS_NOT_USING_DMG_BONUS;
+
+	//Rogue: Poison time fix for 2.3
+	if(strstr(sp->Name, "Crippling Poison") && sp->Effect[0] == SPELL_EFFECT_ENCHANT_ITEM_TEMPORARY)    //I, II
+		sp->EffectBasePoints[0] = 3599;
+	if(strstr(sp->Name, "Mind-numbing Poison") && sp->Effect[0] == SPELL_EFFECT_ENCHANT_ITEM_TEMPORARY)    //I,II,III
+		sp->EffectBasePoints[0] = 3599;
+	if(strstr(sp->Name, "Instant Poison") && sp->Effect[0] == SPELL_EFFECT_ENCHANT_ITEM_TEMPORARY)    //I,II,III,IV,V,VI,VII
+		sp->EffectBasePoints[0] = 3599;
+	if(strstr(sp->Name, "Deadly Poison") && sp->Effect[0] == SPELL_EFFECT_ENCHANT_ITEM_TEMPORARY)    //I,II,III,IV,V,VI,VII
+		sp->EffectBasePoints[0] = 3599;
+	if(strstr(sp->Name, "Wound Poison") && sp->Effect[0] == SPELL_EFFECT_ENCHANT_ITEM_TEMPORARY)    //I,II,III,IV,V
+		sp->EffectBasePoints[0] = 3599;
+	if(strstr(sp->Name, "Anesthetic Poison") && sp->Effect[0] == SPELL_EFFECT_ENCHANT_ITEM_TEMPORARY)    //I
+		sp->EffectBasePoints[0] = 3599;
+
+	if(strstr(sp->Name, "Sharpen Blade") && sp->Effect[0] == SPELL_EFFECT_ENCHANT_ITEM_TEMPORARY)    //All BS stones
+		sp->EffectBasePoints[0] = 3599;
+
+	//these mostly do not mix so we can use else
+	// look for seal, etc in name
+	if(strstr(sp->Name, "Seal of"))
+		sp->BGR_one_buff_on_target |= SPELL_TYPE_SEAL;
+	else if(strstr(sp->Name, "Hand of"))
+		sp->BGR_one_buff_on_target |= SPELL_TYPE_HAND;
+	else if(strstr(sp->Name, "Blessing"))
+		sp->BGR_one_buff_on_target |= SPELL_TYPE_BLESSING;
+	else if(strstr(sp->Name, "Curse"))
+		sp->BGR_one_buff_on_target |= SPELL_TYPE_CURSE;
+	else if(strstr(sp->Name, "Corruption"))
+		sp->BGR_one_buff_on_target |= SPELL_TYPE_CORRUPTION;
+	else if(strstr(sp->Name, "Aspect"))
+		sp->BGR_one_buff_on_target |= SPELL_TYPE_ASPECT;
+	else if(strstr(sp->Name, "Sting") || strstr(sp->Name, "sting"))
+		sp->BGR_one_buff_on_target |= SPELL_TYPE_STING;
+	// don't break armor items!
+	else if(strstr(sp->Name, "Fel Armor") || strstr(sp->Name, "Frost Armor") || strstr(sp->Name, "Ice Armor") || strstr(sp->Name, "Mage Armor") || strstr(sp->Name, "Molten Armor") || strstr(sp->Name, "Demon Skin") || strstr(sp->Name, "Demon Armor"))
+		sp->BGR_one_buff_on_target |= SPELL_TYPE_ARMOR;
+	else if(strstr(sp->Name, "Aura")
+	        && !strstr(sp->Name, "Trueshot") && !strstr(sp->Name, "Moonkin")
+	        && !strstr(sp->Name, "Crusader") && !strstr(sp->Name, "Sanctity") && !strstr(sp->Name, "Devotion") && !strstr(sp->Name, "Retribution") && !strstr(sp->Name, "Concentration") && !strstr(sp->Name, "Shadow Resistance") && !strstr(sp->Name, "Frost Resistance") && !strstr(sp->Name, "Fire Resistance")
+	       )
+		sp->BGR_one_buff_on_target |= SPELL_TYPE_AURA;
+	else if(strstr(sp->Name, "Track") == sp->Name)
+		sp->BGR_one_buff_on_target |= SPELL_TYPE_TRACK;
+	else if(namehash == SPELL_HASH_GIFT_OF_THE_WILD || namehash == SPELL_HASH_MARK_OF_THE_WILD)
+		sp->BGR_one_buff_on_target |= SPELL_TYPE_MARK_GIFT;
+	else if(namehash == SPELL_HASH_IMMOLATION_TRAP || namehash == SPELL_HASH_FREEZING_TRAP || namehash == SPELL_HASH_FROST_TRAP || namehash == SPELL_HASH_EXPLOSIVE_TRAP || namehash == SPELL_HASH_SNAKE_TRAP)
+		sp->BGR_one_buff_on_target |= SPELL_TYPE_HUNTER_TRAP;
+	else if(namehash == SPELL_HASH_ARCANE_INTELLECT || namehash == SPELL_HASH_ARCANE_BRILLIANCE)
+		sp->BGR_one_buff_on_target |= SPELL_TYPE_MAGE_INTEL;
+	else if(namehash == SPELL_HASH_AMPLIFY_MAGIC || namehash == SPELL_HASH_DAMPEN_MAGIC)
+		sp->BGR_one_buff_on_target |= SPELL_TYPE_MAGE_MAGI;
+	else if(namehash == SPELL_HASH_FIRE_WARD || namehash == SPELL_HASH_FROST_WARD)
+		sp->BGR_one_buff_on_target |= SPELL_TYPE_MAGE_WARDS;
+	else if(namehash == SPELL_HASH_SHADOW_PROTECTION || namehash == SPELL_HASH_PRAYER_OF_SHADOW_PROTECTION)
+		sp->BGR_one_buff_on_target |= SPELL_TYPE_PRIEST_SH_PPROT;
+	else if(namehash == SPELL_HASH_WATER_SHIELD || namehash == SPELL_HASH_EARTH_SHIELD || namehash == SPELL_HASH_LIGHTNING_SHIELD)
+		sp->BGR_one_buff_on_target |= SPELL_TYPE_SHIELD;
+	else if(namehash == SPELL_HASH_POWER_WORD__FORTITUDE || namehash == SPELL_HASH_PRAYER_OF_FORTITUDE)
+		sp->BGR_one_buff_on_target |= SPELL_TYPE_FORTITUDE;
+	else if(namehash == SPELL_HASH_DIVINE_SPIRIT || namehash == SPELL_HASH_PRAYER_OF_SPIRIT)
+		sp->BGR_one_buff_on_target |= SPELL_TYPE_SPIRIT;
 //		else if( strstr( sp->Name, "Curse of Weakness") || strstr( sp->Name, "Curse of Agony") || strstr( sp->Name, "Curse of Recklessness") || strstr( sp->Name, "Curse of Tongues") || strstr( sp->Name, "Curse of the Elements") || strstr( sp->Name, "Curse of Idiocy") || strstr( sp->Name, "Curse of Shadow") || strstr( sp->Name, "Curse of Doom"))
 //		else if(namehash==4129426293 || namehash==885131426 || namehash==626036062 || namehash==3551228837 || namehash==2784647472 || namehash==776142553 || namehash==3407058720 || namehash==202747424)
 //		else if( strstr( sp->Name, "Curse of "))
 //            type |= SPELL_TYPE_WARLOCK_CURSES;
-		else if(strstr(sp->Name, "Immolate") || strstr(sp->Name, "Conflagrate"))
-			sp->BGR_one_buff_on_target |= SPELL_TYPE_WARLOCK_IMMOLATE;
-		else if(strstr(sp->Name, "Amplify Magic") || strstr(sp->Name, "Dampen Magic"))
-			sp->BGR_one_buff_on_target |= SPELL_TYPE_MAGE_AMPL_DUMP;
-		else if(strstr(sp->Description, "Battle Elixir"))
-			sp->BGR_one_buff_on_target |= SPELL_TYPE_ELIXIR_BATTLE;
-		else if(strstr(sp->Description, "Guardian Elixir"))
-			sp->BGR_one_buff_on_target |= SPELL_TYPE_ELIXIR_GUARDIAN;
-		else if(strstr(sp->Description, "Battle and Guardian elixir"))
-			sp->BGR_one_buff_on_target |= SPELL_TYPE_ELIXIR_FLASK;
-		else if(namehash == SPELL_HASH_HUNTER_S_MARK)		// hunter's mark
-			sp->BGR_one_buff_on_target |= SPELL_TYPE_HUNTER_MARK;
-		else if(namehash == SPELL_HASH_COMMANDING_SHOUT || namehash == SPELL_HASH_BATTLE_SHOUT)
-			sp->BGR_one_buff_on_target |= SPELL_TYPE_WARRIOR_SHOUT;
-		else if(strstr(sp->Description, "Finishing move") == sp->Description)
-			sp->c_is_flags |= SPELL_FLAG_IS_FINISHING_MOVE;
-		if(IsDamagingSpell(sp))
-			sp->c_is_flags |= SPELL_FLAG_IS_DAMAGING;
-		if(IsHealingSpell(sp))
-			sp->c_is_flags |= SPELL_FLAG_IS_HEALING;
-		if(IsTargetingStealthed(sp))
-			sp->c_is_flags |= SPELL_FLAG_IS_TARGETINGSTEALTHED;
-
-		if(sp->NameHash == SPELL_HASH_HEMORRHAGE)
-			sp->c_is_flags |= SPELL_FLAG_IS_MAXSTACK_FOR_DEBUFF;
-
-		//stupid spell ranking problem
-		if(sp->spellLevel == 0)
+	else if(strstr(sp->Name, "Immolate") || strstr(sp->Name, "Conflagrate"))
+		sp->BGR_one_buff_on_target |= SPELL_TYPE_WARLOCK_IMMOLATE;
+	else if(strstr(sp->Name, "Amplify Magic") || strstr(sp->Name, "Dampen Magic"))
+		sp->BGR_one_buff_on_target |= SPELL_TYPE_MAGE_AMPL_DUMP;
+	else if(strstr(sp->Description, "Battle Elixir"))
+		sp->BGR_one_buff_on_target |= SPELL_TYPE_ELIXIR_BATTLE;
+	else if(strstr(sp->Description, "Guardian Elixir"))
+		sp->BGR_one_buff_on_target |= SPELL_TYPE_ELIXIR_GUARDIAN;
+	else if(strstr(sp->Description, "Battle and Guardian elixir"))
+		sp->BGR_one_buff_on_target |= SPELL_TYPE_ELIXIR_FLASK;
+	else if(namehash == SPELL_HASH_HUNTER_S_MARK)		// hunter's mark
+		sp->BGR_one_buff_on_target |= SPELL_TYPE_HUNTER_MARK;
+	else if(namehash == SPELL_HASH_COMMANDING_SHOUT || namehash == SPELL_HASH_BATTLE_SHOUT)
+		sp->BGR_one_buff_on_target |= SPELL_TYPE_WARRIOR_SHOUT;
+	else if(strstr(sp->Description, "Finishing move") == sp->Description)
+		sp->c_is_flags |= SPELL_FLAG_IS_FINISHING_MOVE;
+	if(IsDamagingSpell(sp))
+		sp->c_is_flags |= SPELL_FLAG_IS_DAMAGING;
+	if(IsHealingSpell(sp))
+		sp->c_is_flags |= SPELL_FLAG_IS_HEALING;
+	if(IsTargetingStealthed(sp))
+		sp->c_is_flags |= SPELL_FLAG_IS_TARGETINGSTEALTHED;
+
+	if(sp->NameHash == SPELL_HASH_HEMORRHAGE)
+		sp->c_is_flags |= SPELL_FLAG_IS_MAXSTACK_FOR_DEBUFF;
+
+	//stupid spell ranking problem
+	if(sp->spellLevel == 0)
+	{
+		uint32 new_level = 0;
+
+		if(strstr(sp->Name, "Apprentice "))
+			new_level = 1;
+		else if(strstr(sp->Name, "Journeyman "))
+			new_level = 2;
+		else if(strstr(sp->Name, "Expert "))
+			new_level = 3;
+		else if(strstr(sp->Name, "Artisan "))
+			new_level = 4;
+		else if(strstr(sp->Name, "Master "))
+			new_level = 5;
+		else if(strstr(sp->Name, "Grand Master "))
+			new_level = 6;
+
+		if(new_level != 0)
 		{
-			uint32 new_level = 0;
-
-			if(strstr(sp->Name, "Apprentice "))
-				new_level = 1;
-			else if(strstr(sp->Name, "Journeyman "))
-				new_level = 2;
-			else if(strstr(sp->Name, "Expert "))
-				new_level = 3;
-			else if(strstr(sp->Name, "Artisan "))
-				new_level = 4;
-			else if(strstr(sp->Name, "Master "))
-				new_level = 5;
-			else if(strstr(sp->Name, "Grand Master "))
-				new_level = 6;
-
-			if(new_level != 0)
+			uint32 teachspell = 0;
+			if(sp->Effect[0] == SPELL_EFFECT_LEARN_SPELL)
+				teachspell = sp->EffectTriggerSpell[0];
+			else if(sp->Effect[1] == SPELL_EFFECT_LEARN_SPELL)
+				teachspell = sp->EffectTriggerSpell[1];
+			else if(sp->Effect[2] == SPELL_EFFECT_LEARN_SPELL)
+				teachspell = sp->EffectTriggerSpell[2];
+
+			if(teachspell)
 			{
-				uint32 teachspell = 0;
-				if(sp->Effect[0] == SPELL_EFFECT_LEARN_SPELL)
-					teachspell = sp->EffectTriggerSpell[0];
-				else if(sp->Effect[1] == SPELL_EFFECT_LEARN_SPELL)
-					teachspell = sp->EffectTriggerSpell[1];
-				else if(sp->Effect[2] == SPELL_EFFECT_LEARN_SPELL)
-					teachspell = sp->EffectTriggerSpell[2];
-
-				if(teachspell)
-				{
-					SpellEntry* spellInfo;
-					spellInfo = CheckAndReturnSpellEntry(teachspell);
-					spellInfo->spellLevel = new_level;
-					sp->spellLevel = new_level;
-				}
+				SpellEntry* spellInfo;
+				spellInfo = CheckAndReturnSpellEntry(teachspell);
+				spellInfo->spellLevel = new_level;
+				sp->spellLevel = new_level;
 			}
 		}
+	}
 
-		/*FILE * f = fopen("C:\\spells.txt", "a");
-		fprintf(f, "case 0x%08X:		// %s\n", namehash, sp->Name);
-		fclose(f);*/
+	/*FILE * f = fopen("C:\\spells.txt", "a");
+	fprintf(f, "case 0x%08X:		// %s\n", namehash, sp->Name);
+	fclose(f);*/
 
-		// find diminishing status
-		sp->DiminishStatus = GetDiminishingGroup(namehash);
+	// find diminishing status
+	sp->DiminishStatus = GetDiminishingGroup(namehash);
 
-		//another grouping rule
+	//another grouping rule
 
-		//Quivers, Ammo Pouches and Thori'dal the Star's Fury
-		if((namehash == SPELL_HASH_HASTE && sp->Attributes & 0x10000) || sp->Id == 44972)
-		{
-			sp->Attributes &= ~ATTRIBUTES_PASSIVE;//Otherwise we couldn't remove them
-			sp->BGR_one_buff_on_target |= SPELL_TYPE_QUIVER_HASTE;
-		}
+	//Quivers, Ammo Pouches and Thori'dal the Star's Fury
+	if((namehash == SPELL_HASH_HASTE && sp->Attributes & 0x10000) || sp->Id == 44972)
+	{
+		sp->Attributes &= ~ATTRIBUTES_PASSIVE;//Otherwise we couldn't remove them
+		sp->BGR_one_buff_on_target |= SPELL_TYPE_QUIVER_HASTE;
+	}
 
-		switch(namehash)
-		{
-				//case SPELL_HASH_SANCTITY_AURA:
-			case SPELL_HASH_DEVOTION_AURA:
-			case SPELL_HASH_RETRIBUTION_AURA:
-			case SPELL_HASH_CONCENTRATION_AURA:
-			case SPELL_HASH_SHADOW_RESISTANCE_AURA:
-			case SPELL_HASH_FIRE_RESISTANCE_AURA:
-			case SPELL_HASH_FROST_RESISTANCE_AURA:
-			case SPELL_HASH_CRUSADER_AURA:
-				sp->BGR_one_buff_from_caster_on_self = SPELL_TYPE2_PALADIN_AURA;
-				break;
-		}
+	switch(namehash)
+	{
+			//case SPELL_HASH_SANCTITY_AURA:
+		case SPELL_HASH_DEVOTION_AURA:
+		case SPELL_HASH_RETRIBUTION_AURA:
+		case SPELL_HASH_CONCENTRATION_AURA:
+		case SPELL_HASH_SHADOW_RESISTANCE_AURA:
+		case SPELL_HASH_FIRE_RESISTANCE_AURA:
+		case SPELL_HASH_FROST_RESISTANCE_AURA:
+		case SPELL_HASH_CRUSADER_AURA:
+			sp->BGR_one_buff_from_caster_on_self = SPELL_TYPE2_PALADIN_AURA;
+			break;
+	}
 
-		switch(namehash)
-		{
-			case SPELL_HASH_BLOOD_PRESENCE:
-			case SPELL_HASH_FROST_PRESENCE:
-			case SPELL_HASH_UNHOLY_PRESENCE:
-				sp->BGR_one_buff_from_caster_on_self = SPELL_TYPE3_DEATH_KNIGHT_AURA;
-				break;
-		}
+	switch(namehash)
+	{
+		case SPELL_HASH_BLOOD_PRESENCE:
+		case SPELL_HASH_FROST_PRESENCE:
+		case SPELL_HASH_UNHOLY_PRESENCE:
+			sp->BGR_one_buff_from_caster_on_self = SPELL_TYPE3_DEATH_KNIGHT_AURA;
+			break;
+	}
 
-		// HACK FIX: Break roots/fear on damage.. this needs to be fixed properly!
-		if(!(sp->AuraInterruptFlags & AURA_INTERRUPT_ON_ANY_DAMAGE_TAKEN))
+	// HACK FIX: Break roots/fear on damage.. this needs to be fixed properly!
+	if(!(sp->AuraInterruptFlags & AURA_INTERRUPT_ON_ANY_DAMAGE_TAKEN))
+	{
+		for(uint32 z = 0; z < 3; ++z)
 		{
-			for(uint32 z = 0; z < 3; ++z)
+			if(sp->EffectApplyAuraName[z] == SPELL_AURA_MOD_FEAR ||
+			        sp->EffectApplyAuraName[z] == SPELL_AURA_MOD_ROOT)
 			{
-				if(sp->EffectApplyAuraName[z] == SPELL_AURA_MOD_FEAR ||
-				        sp->EffectApplyAuraName[z] == SPELL_AURA_MOD_ROOT)
-				{
-					sp->AuraInterruptFlags |= AURA_INTERRUPT_ON_UNUSED2;
-					break;
-				}
+				sp->AuraInterruptFlags |= AURA_INTERRUPT_ON_UNUSED2;
+				break;
+			}
 
-				if((sp->Effect[z] == SPELL_EFFECT_SCHOOL_DAMAGE && sp->Spell_Dmg_Type == SPELL_DMG_TYPE_MELEE) || sp->Effect[z] == SPELL_EFFECT_WEAPON_DAMAGE_NOSCHOOL || sp->Effect[z] == SPELL_EFFECT_WEAPON_DAMAGE || sp->Effect[z] == SPELL_EFFECT_WEAPON_PERCENT_DAMAGE || sp->Effect[z] == SPELL_EFFECT_DUMMYMELEE)
-					sp->is_melee_spell = true;
-				if((sp->Effect[z] == SPELL_EFFECT_SCHOOL_DAMAGE && sp->Spell_Dmg_Type == SPELL_DMG_TYPE_RANGED))
-				{
-					//Log.Notice( "SpellFixes" , "Ranged Spell: %u [%s]" , sp->Id , sp->Name );
-					sp->is_ranged_spell = true;
-				}
+			if((sp->Effect[z] == SPELL_EFFECT_SCHOOL_DAMAGE && sp->Spell_Dmg_Type == SPELL_DMG_TYPE_MELEE) || sp->Effect[z] == SPELL_EFFECT_WEAPON_DAMAGE_NOSCHOOL || sp->Effect[z] == SPELL_EFFECT_WEAPON_DAMAGE || sp->Effect[z] == SPELL_EFFECT_WEAPON_PERCENT_DAMAGE || sp->Effect[z] == SPELL_EFFECT_DUMMYMELEE)
+				sp->is_melee_spell = true;
+			if((sp->Effect[z] == SPELL_EFFECT_SCHOOL_DAMAGE && sp->Spell_Dmg_Type == SPELL_DMG_TYPE_RANGED))
+			{
+				//Log.Notice( "SpellFixes" , "Ranged Spell: %u [%s]" , sp->Id , sp->Name );
+				sp->is_ranged_spell = true;
 			}
 		}
+	}
 
-		// set extra properties
-		sp->RankNumber = rank;
+	// set extra properties
+	sp->RankNumber = rank;
 
 
-		// various flight spells
-		// these make vehicles and other charmed stuff fliable
-		if( sp->activeIconID == 2158 )
-			sp->Attributes |= ATTRIBUTES_PASSIVE;
+	// various flight spells
+	// these make vehicles and other charmed stuff fliable
+	if( sp->activeIconID == 2158 )
+		sp->Attributes |= ATTRIBUTES_PASSIVE;
 
-		uint32 pr = sp->procFlags;
-		for(uint32 y = 0; y < 3; y++)
-		{
-			// get the effect number from the spell
-			effect = sp->Effect[y];
+	uint32 pr = sp->procFlags;
+	for(uint32 y = 0; y < 3; y++)
+	{
+		// get the effect number from the spell
+		effect = sp->Effect[y];
 
-			//spell group
+		//spell group
 
-			if(effect == SPELL_EFFECT_APPLY_AURA)
+		if(effect == SPELL_EFFECT_APPLY_AURA)
+		{
+			uint32 aura = sp->EffectApplyAuraName[y];
+			if(aura == SPELL_AURA_PROC_TRIGGER_SPELL ||
+			        aura == SPELL_AURA_PROC_TRIGGER_DAMAGE
+			  )//search for spellid in description
 			{
-				uint32 aura = sp->EffectApplyAuraName[y];
-				if(aura == SPELL_AURA_PROC_TRIGGER_SPELL ||
-				        aura == SPELL_AURA_PROC_TRIGGER_DAMAGE
-				  )//search for spellid in description
+				const char* p = sp->Description;
+				while((p = strstr(p, "$")) != 0)
 				{
-					const char* p = sp->Description;
-					while((p = strstr(p, "$")) != 0)
+					p++;
+					//got $  -> check if spell
+					if(*p >= '0' && *p <= '9')
 					{
-						p++;
-						//got $  -> check if spell
-						if(*p >= '0' && *p <= '9')
-						{
-							//woot this is spell id
+						//woot this is spell id
 
-							result = atoi(p);
-						}
+						result = atoi(p);
 					}
-					pr = 0;
-
-					uint32 len = (uint32)strlen(sp->Description);
-					for(i = 0; i < len; ++i)
-						sp->Description[i] = static_cast<char>(tolower(sp->Description[i]));
-					//dirty code for procs, if any1 got any better idea-> u are welcome
-					//139944 --- some magic number, it will trigger on all hits etc
-					//for seems to be smth like custom check
-					if(strstr(sp->Description, "your ranged criticals"))
-						pr |= PROC_ON_RANGED_CRIT_ATTACK;
-					if(strstr(sp->Description, "chance on hit"))
-						pr |= PROC_ON_MELEE_ATTACK;
-					if(strstr(sp->Description, "takes damage"))
-						pr |= PROC_ON_ANY_DAMAGE_VICTIM;
-					if(strstr(sp->Description, "attackers when hit"))
-						pr |= PROC_ON_MELEE_ATTACK_VICTIM;
-					if(strstr(sp->Description, "character strikes an enemy"))
-						pr |= PROC_ON_MELEE_ATTACK;
-					if(strstr(sp->Description, "strike you with a melee attack"))
-						pr |= PROC_ON_MELEE_ATTACK_VICTIM;
-					if(strstr(sp->Description, "target casts a spell"))
-						pr |= PROC_ON_CAST_SPELL;
-					if(strstr(sp->Description, "your harmful spells land"))
-						pr |= PROC_ON_CAST_SPELL;
-					if(strstr(sp->Description, "on spell critical hit"))
-						pr |= PROC_ON_SPELL_CRIT_HIT;
-					if(strstr(sp->Description, "spell critical strikes"))
-						pr |= PROC_ON_SPELL_CRIT_HIT;
-					if(strstr(sp->Description, "being able to resurrect"))
-						pr |= PROC_ON_DIE;
-					if(strstr(sp->Description, "any damage caused"))
-						pr |= PROC_ON_ANY_DAMAGE_VICTIM;
-					if(strstr(sp->Description, "the next melee attack against the caster"))
-						pr |= PROC_ON_MELEE_ATTACK_VICTIM;
-					if(strstr(sp->Description, "when successfully hit"))
-						pr |= PROC_ON_MELEE_ATTACK ;
-					if(strstr(sp->Description, "an enemy on hit"))
-						pr |= PROC_ON_MELEE_ATTACK;
-					if(strstr(sp->Description, "when it hits"))
-						pr |= PROC_ON_MELEE_ATTACK;
-					if(strstr(sp->Description, "when successfully hit"))
-						pr |= PROC_ON_MELEE_ATTACK;
-					if(strstr(sp->Description, "on a successful hit"))
-						pr |= PROC_ON_MELEE_ATTACK;
-					if(strstr(sp->Description, "damage to attacker on hit"))
-						pr |= PROC_ON_MELEE_ATTACK_VICTIM;
-					if(strstr(sp->Description, "on a hit"))
-						pr |= PROC_ON_MELEE_ATTACK;
-					if(strstr(sp->Description, "strikes you with a melee attack"))
-						pr |= PROC_ON_MELEE_ATTACK_VICTIM;
-					if(strstr(sp->Description, "when caster takes damage"))
-						pr |= PROC_ON_ANY_DAMAGE_VICTIM;
-					if(strstr(sp->Description, "when the caster is using melee attacks"))
-						pr |= PROC_ON_MELEE_ATTACK;
-					if(strstr(sp->Description, "when struck in combat") || strstr(sp->Description, "When struck in combat"))
-						pr |= PROC_ON_MELEE_ATTACK_VICTIM;
-					if(strstr(sp->Description, "successful melee attack"))
-						pr |= PROC_ON_MELEE_ATTACK;
-					if(strstr(sp->Description, "chance per attack"))
-						pr |= PROC_ON_MELEE_ATTACK;
-					if(strstr(sp->Description, "chance per hit"))
-						pr |= PROC_ON_MELEE_ATTACK;
-					if(strstr(sp->Description, "that strikes a party member"))
-						pr |= PROC_ON_MELEE_ATTACK_VICTIM;
-					if(strstr(sp->Description, "when hit by a melee attack"))
-						pr |= PROC_ON_MELEE_ATTACK_VICTIM;
-					if(strstr(sp->Description, "landing a melee critical strike"))
-						pr |= PROC_ON_CRIT_ATTACK;
-					if(strstr(sp->Description, "your critical strikes"))
-						pr |= PROC_ON_CRIT_ATTACK;
-					if(strstr(sp->Description, "whenever you deal ranged damage"))
-						pr |= PROC_ON_RANGED_ATTACK;
-					if(strstr(sp->Description, "you deal melee damage"))
-						pr |= PROC_ON_MELEE_ATTACK;
-					if(strstr(sp->Description, "your melee attacks"))
-						pr |= PROC_ON_MELEE_ATTACK;
-					if(strstr(sp->Description, "damage with your Sword"))
-						pr |= PROC_ON_MELEE_ATTACK;
-					if(strstr(sp->Description, "when struck in melee combat"))
-						pr |= PROC_ON_MELEE_ATTACK_VICTIM;
-					if(strstr(sp->Description, "any successful spell cast against the priest"))
-						pr |= PROC_ON_SPELL_HIT_VICTIM;
-					if(strstr(sp->Description, "the next melee attack on the caster"))
-						pr |= PROC_ON_MELEE_ATTACK_VICTIM;
-					if(strstr(sp->Description, "striking melee or ranged attackers"))
-						pr |= PROC_ON_MELEE_ATTACK_VICTIM | PROC_ON_RANGED_ATTACK_VICTIM;
-					if(strstr(sp->Description, "when damaging an enemy in melee"))
-						pr |= PROC_ON_MELEE_ATTACK;
-					if(strstr(sp->Description, "victim of a critical strike"))
-						pr |= PROC_ON_CRIT_HIT_VICTIM;
-					if(strstr(sp->Description, "on successful melee or ranged attack"))
-						pr |= PROC_ON_MELEE_ATTACK | PROC_ON_RANGED_ATTACK;
-					if(strstr(sp->Description, "enemy that strikes you in melee"))
-						pr |= PROC_ON_MELEE_ATTACK_VICTIM;
-					if(strstr(sp->Description, "after getting a critical strike"))
-						pr |= PROC_ON_CRIT_ATTACK;
-					if(strstr(sp->Description, "whenever damage is dealt to you"))
-						pr |= PROC_ON_ANY_DAMAGE_VICTIM;
-					if(strstr(sp->Description, "when ranged or melee damage is dealt"))
-						pr |= PROC_ON_MELEE_ATTACK | PROC_ON_RANGED_ATTACK;
-					if(strstr(sp->Description, "damaging melee attacks"))
-						pr |= PROC_ON_MELEE_ATTACK;
-					if(strstr(sp->Description, "on melee or ranged attack"))
-						pr |= PROC_ON_MELEE_ATTACK | PROC_ON_RANGED_ATTACK;
-					if(strstr(sp->Description, "on a melee swing"))
-						pr |= PROC_ON_MELEE_ATTACK;
-					if(strstr(sp->Description, "Chance on melee"))
-						pr |= PROC_ON_MELEE_ATTACK;
-					if(strstr(sp->Description, "spell criticals against you"))
-						pr |= PROC_ON_SPELL_CRIT_HIT_VICTIM;
-					if(strstr(sp->Description, "after being struck by a melee or ranged critical hit"))
-						pr |= PROC_ON_CRIT_HIT_VICTIM;
-					if(strstr(sp->Description, "on a critical hit"))
-						if(strstr(sp->Description, "critical hit"))
-							pr |= PROC_ON_CRIT_ATTACK;
-					if(strstr(sp->Description, "strikes the caster"))
-						pr |= PROC_ON_MELEE_ATTACK_VICTIM;
-					if(strstr(sp->Description, "a spell, melee or ranged attack hits the caster"))
-						pr |= PROC_ON_ANY_DAMAGE_VICTIM;
-					if(strstr(sp->Description, "after dealing a critical strike"))
-						pr |= PROC_ON_CRIT_ATTACK;
-					if(strstr(sp->Description, "each melee or ranged damage hit against the priest"))
-						pr |= PROC_ON_MELEE_ATTACK_VICTIM | PROC_ON_RANGED_ATTACK_VICTIM;
-					if(strstr(sp->Description, "a chance to deal additional"))
-						pr |= PROC_ON_MELEE_ATTACK;
-					if(strstr(sp->Description, "chance to get an extra attack"))
-						pr |= PROC_ON_MELEE_ATTACK;
-					if(strstr(sp->Description, "melee attacks have"))
-						pr |= PROC_ON_MELEE_ATTACK;
-					if(strstr(sp->Description, "any damage spell hits a target"))
-						pr |= PROC_ON_CAST_SPELL;
-					if(strstr(sp->Description, "giving each melee attack a chance"))
-						pr |= PROC_ON_MELEE_ATTACK;
-					if(strstr(sp->Description, "damage when hit"))
-						pr |= PROC_ON_ANY_DAMAGE_VICTIM; //maybe melee damage ?
-					if(strstr(sp->Description, "gives your"))
-					{
-						if(strstr(sp->Description, "finishing moves"))
-							pr |= PROC_ON_CAST_SPELL;
-						else if(strstr(sp->Description, "melee"))
-							pr |= PROC_ON_MELEE_ATTACK;
-						else if(strstr(sp->Description, "sinister strike, backstab, gouge and shiv"))
-							pr |= PROC_ON_CAST_SPELL;
-						else if(strstr(sp->Description, "chance to daze the target"))
-							pr |= PROC_ON_CAST_SPELL;
-						else pr |= PROC_ON_CAST_SPECIFIC_SPELL;
-					}
-					if(strstr(sp->Description, "chance to add an additional combo") && strstr(sp->Description, "critical"))
+				}
+				pr = 0;
+
+				uint32 len = (uint32)strlen(sp->Description);
+				for(i = 0; i < len; ++i)
+					sp->Description[i] = static_cast<char>(tolower(sp->Description[i]));
+				//dirty code for procs, if any1 got any better idea-> u are welcome
+				//139944 --- some magic number, it will trigger on all hits etc
+				//for seems to be smth like custom check
+				if(strstr(sp->Description, "your ranged criticals"))
+					pr |= PROC_ON_RANGED_CRIT_ATTACK;
+				if(strstr(sp->Description, "chance on hit"))
+					pr |= PROC_ON_MELEE_ATTACK;
+				if(strstr(sp->Description, "takes damage"))
+					pr |= PROC_ON_ANY_DAMAGE_VICTIM;
+				if(strstr(sp->Description, "attackers when hit"))
+					pr |= PROC_ON_MELEE_ATTACK_VICTIM;
+				if(strstr(sp->Description, "character strikes an enemy"))
+					pr |= PROC_ON_MELEE_ATTACK;
+				if(strstr(sp->Description, "strike you with a melee attack"))
+					pr |= PROC_ON_MELEE_ATTACK_VICTIM;
+				if(strstr(sp->Description, "target casts a spell"))
+					pr |= PROC_ON_CAST_SPELL;
+				if(strstr(sp->Description, "your harmful spells land"))
+					pr |= PROC_ON_CAST_SPELL;
+				if(strstr(sp->Description, "on spell critical hit"))
+					pr |= PROC_ON_SPELL_CRIT_HIT;
+				if(strstr(sp->Description, "spell critical strikes"))
+					pr |= PROC_ON_SPELL_CRIT_HIT;
+				if(strstr(sp->Description, "being able to resurrect"))
+					pr |= PROC_ON_DIE;
+				if(strstr(sp->Description, "any damage caused"))
+					pr |= PROC_ON_ANY_DAMAGE_VICTIM;
+				if(strstr(sp->Description, "the next melee attack against the caster"))
+					pr |= PROC_ON_MELEE_ATTACK_VICTIM;
+				if(strstr(sp->Description, "when successfully hit"))
+					pr |= PROC_ON_MELEE_ATTACK ;
+				if(strstr(sp->Description, "an enemy on hit"))
+					pr |= PROC_ON_MELEE_ATTACK;
+				if(strstr(sp->Description, "when it hits"))
+					pr |= PROC_ON_MELEE_ATTACK;
+				if(strstr(sp->Description, "when successfully hit"))
+					pr |= PROC_ON_MELEE_ATTACK;
+				if(strstr(sp->Description, "on a successful hit"))
+					pr |= PROC_ON_MELEE_ATTACK;
+				if(strstr(sp->Description, "damage to attacker on hit"))
+					pr |= PROC_ON_MELEE_ATTACK_VICTIM;
+				if(strstr(sp->Description, "on a hit"))
+					pr |= PROC_ON_MELEE_ATTACK;
+				if(strstr(sp->Description, "strikes you with a melee attack"))
+					pr |= PROC_ON_MELEE_ATTACK_VICTIM;
+				if(strstr(sp->Description, "when caster takes damage"))
+					pr |= PROC_ON_ANY_DAMAGE_VICTIM;
+				if(strstr(sp->Description, "when the caster is using melee attacks"))
+					pr |= PROC_ON_MELEE_ATTACK;
+				if(strstr(sp->Description, "when struck in combat") || strstr(sp->Description, "When struck in combat"))
+					pr |= PROC_ON_MELEE_ATTACK_VICTIM;
+				if(strstr(sp->Description, "successful melee attack"))
+					pr |= PROC_ON_MELEE_ATTACK;
+				if(strstr(sp->Description, "chance per attack"))
+					pr |= PROC_ON_MELEE_ATTACK;
+				if(strstr(sp->Description, "chance per hit"))
+					pr |= PROC_ON_MELEE_ATTACK;
+				if(strstr(sp->Description, "that strikes a party member"))
+					pr |= PROC_ON_MELEE_ATTACK_VICTIM;
+				if(strstr(sp->Description, "when hit by a melee attack"))
+					pr |= PROC_ON_MELEE_ATTACK_VICTIM;
+				if(strstr(sp->Description, "landing a melee critical strike"))
+					pr |= PROC_ON_CRIT_ATTACK;
+				if(strstr(sp->Description, "your critical strikes"))
+					pr |= PROC_ON_CRIT_ATTACK;
+				if(strstr(sp->Description, "whenever you deal ranged damage"))
+					pr |= PROC_ON_RANGED_ATTACK;
+				if(strstr(sp->Description, "you deal melee damage"))
+					pr |= PROC_ON_MELEE_ATTACK;
+				if(strstr(sp->Description, "your melee attacks"))
+					pr |= PROC_ON_MELEE_ATTACK;
+				if(strstr(sp->Description, "damage with your Sword"))
+					pr |= PROC_ON_MELEE_ATTACK;
+				if(strstr(sp->Description, "when struck in melee combat"))
+					pr |= PROC_ON_MELEE_ATTACK_VICTIM;
+				if(strstr(sp->Description, "any successful spell cast against the priest"))
+					pr |= PROC_ON_SPELL_HIT_VICTIM;
+				if(strstr(sp->Description, "the next melee attack on the caster"))
+					pr |= PROC_ON_MELEE_ATTACK_VICTIM;
+				if(strstr(sp->Description, "striking melee or ranged attackers"))
+					pr |= PROC_ON_MELEE_ATTACK_VICTIM | PROC_ON_RANGED_ATTACK_VICTIM;
+				if(strstr(sp->Description, "when damaging an enemy in melee"))
+					pr |= PROC_ON_MELEE_ATTACK;
+				if(strstr(sp->Description, "victim of a critical strike"))
+					pr |= PROC_ON_CRIT_HIT_VICTIM;
+				if(strstr(sp->Description, "on successful melee or ranged attack"))
+					pr |= PROC_ON_MELEE_ATTACK | PROC_ON_RANGED_ATTACK;
+				if(strstr(sp->Description, "enemy that strikes you in melee"))
+					pr |= PROC_ON_MELEE_ATTACK_VICTIM;
+				if(strstr(sp->Description, "after getting a critical strike"))
+					pr |= PROC_ON_CRIT_ATTACK;
+				if(strstr(sp->Description, "whenever damage is dealt to you"))
+					pr |= PROC_ON_ANY_DAMAGE_VICTIM;
+				if(strstr(sp->Description, "when ranged or melee damage is dealt"))
+					pr |= PROC_ON_MELEE_ATTACK | PROC_ON_RANGED_ATTACK;
+				if(strstr(sp->Description, "damaging melee attacks"))
+					pr |= PROC_ON_MELEE_ATTACK;
+				if(strstr(sp->Description, "on melee or ranged attack"))
+					pr |= PROC_ON_MELEE_ATTACK | PROC_ON_RANGED_ATTACK;
+				if(strstr(sp->Description, "on a melee swing"))
+					pr |= PROC_ON_MELEE_ATTACK;
+				if(strstr(sp->Description, "Chance on melee"))
+					pr |= PROC_ON_MELEE_ATTACK;
+				if(strstr(sp->Description, "spell criticals against you"))
+					pr |= PROC_ON_SPELL_CRIT_HIT_VICTIM;
+				if(strstr(sp->Description, "after being struck by a melee or ranged critical hit"))
+					pr |= PROC_ON_CRIT_HIT_VICTIM;
+				if(strstr(sp->Description, "on a critical hit"))
+					if(strstr(sp->Description, "critical hit"))
 						pr |= PROC_ON_CRIT_ATTACK;
-					else if(strstr(sp->Description, "chance to add an additional combo"))
+				if(strstr(sp->Description, "strikes the caster"))
+					pr |= PROC_ON_MELEE_ATTACK_VICTIM;
+				if(strstr(sp->Description, "a spell, melee or ranged attack hits the caster"))
+					pr |= PROC_ON_ANY_DAMAGE_VICTIM;
+				if(strstr(sp->Description, "after dealing a critical strike"))
+					pr |= PROC_ON_CRIT_ATTACK;
+				if(strstr(sp->Description, "each melee or ranged damage hit against the priest"))
+					pr |= PROC_ON_MELEE_ATTACK_VICTIM | PROC_ON_RANGED_ATTACK_VICTIM;
+				if(strstr(sp->Description, "a chance to deal additional"))
+					pr |= PROC_ON_MELEE_ATTACK;
+				if(strstr(sp->Description, "chance to get an extra attack"))
+					pr |= PROC_ON_MELEE_ATTACK;
+				if(strstr(sp->Description, "melee attacks have"))
+					pr |= PROC_ON_MELEE_ATTACK;
+				if(strstr(sp->Description, "any damage spell hits a target"))
+					pr |= PROC_ON_CAST_SPELL;
+				if(strstr(sp->Description, "giving each melee attack a chance"))
+					pr |= PROC_ON_MELEE_ATTACK;
+				if(strstr(sp->Description, "damage when hit"))
+					pr |= PROC_ON_ANY_DAMAGE_VICTIM; //maybe melee damage ?
+				if(strstr(sp->Description, "gives your"))
+				{
+					if(strstr(sp->Description, "finishing moves"))
 						pr |= PROC_ON_CAST_SPELL;
-					if(strstr(sp->Description, "victim of a melee or ranged critical strike"))
-						pr |= PROC_ON_CRIT_HIT_VICTIM;
-					if(strstr(sp->Description, "getting a critical effect from"))
-						pr |= PROC_ON_SPELL_CRIT_HIT_VICTIM;
-					if(strstr(sp->Description, "damaging attack is taken"))
-						pr |= PROC_ON_ANY_DAMAGE_VICTIM;
-					if(strstr(sp->Description, "struck by a Stun or Immobilize"))
-						pr |= PROC_ON_SPELL_HIT_VICTIM;
-					if(strstr(sp->Description, "melee critical strike"))
-						pr |= PROC_ON_CRIT_ATTACK;
-					if(strstr(sp->Name, "Bloodthirst"))
-						pr |= PROC_ON_MELEE_ATTACK | static_cast<uint32>(PROC_TARGET_SELF);
-					if(strstr(sp->Description, "experience or honor"))
-						pr |= PROC_ON_GAIN_EXPIERIENCE;
-					if(strstr(sp->Description, "hit by a melee or ranged attack"))
-						pr |= PROC_ON_MELEE_ATTACK_VICTIM | PROC_ON_RANGED_ATTACK_VICTIM;
-					if(strstr(sp->Description, "enemy strikes the caster"))
-						pr |= PROC_ON_MELEE_ATTACK_VICTIM;
-					if(strstr(sp->Description, "melee and ranged attacks against you"))
-						pr |= PROC_ON_MELEE_ATTACK_VICTIM | PROC_ON_RANGED_ATTACK_VICTIM;
-					if(strstr(sp->Description, "when a block occurs"))
-						pr |= PROC_ON_BLOCK_VICTIM;
-					if(strstr(sp->Description, "dealing a critical strike from a weapon swing, spell, or ability"))
-						pr |= PROC_ON_CRIT_ATTACK | PROC_ON_SPELL_CRIT_HIT;
-					if(strstr(sp->Description, "dealing a critical strike from a weapon swing, spell, or ability"))
-						pr |= PROC_ON_CRIT_ATTACK | PROC_ON_SPELL_CRIT_HIT;
-					if(strstr(sp->Description, "shadow bolt critical strikes increase shadow damage"))
-						pr |= PROC_ON_SPELL_CRIT_HIT;
-					if(strstr(sp->Description, "after being hit with a shadow or fire spell"))
-						pr |= PROC_ON_SPELL_LAND_VICTIM;
-					if(strstr(sp->Description, "giving each melee attack"))
+					else if(strstr(sp->Description, "melee"))
 						pr |= PROC_ON_MELEE_ATTACK;
-					if(strstr(sp->Description, "each strike has"))
-						pr |= PROC_ON_MELEE_ATTACK;
-					if(strstr(sp->Description, "your Fire damage spell hits"))
-						pr |= PROC_ON_CAST_SPELL;		//this happens only on hit ;)
-					if(strstr(sp->Description, "corruption, curse of agony, siphon life and seed of corruption spells also cause"))
-						pr |= PROC_ON_CAST_SPELL;
-					if(strstr(sp->Description, "pain, mind flay and vampiric touch spells also cause"))
-						pr |= PROC_ON_CAST_SPELL;
-					if(strstr(sp->Description, "shadow damage spells have"))
-						pr |= PROC_ON_CAST_SPELL;
-					if(strstr(sp->Description, "on successful spellcast"))
+					else if(strstr(sp->Description, "sinister strike, backstab, gouge and shiv"))
 						pr |= PROC_ON_CAST_SPELL;
-					if(strstr(sp->Description, "your spell criticals have"))
-						pr |= PROC_ON_SPELL_CRIT_HIT | PROC_ON_SPELL_CRIT_HIT_VICTIM;
-					if(strstr(sp->Description, "after dodging their attack"))
-					{
-						pr |= PROC_ON_DODGE_VICTIM;
-						if(strstr(sp->Description, "add a combo point"))
-							pr |= PROC_TARGET_SELF;
-					}
-					if(strstr(sp->Description, "fully resisting"))
-						pr |= PROC_ON_RESIST_VICTIM;
-					if(strstr(sp->Description, "Your Shadow Word: Pain, Mind Flay and Vampiric Touch spells also cause the target"))
+					else if(strstr(sp->Description, "chance to daze the target"))
 						pr |= PROC_ON_CAST_SPELL;
-					if(strstr(sp->Description, "chance on spell hit"))
-						pr |= PROC_ON_CAST_SPELL;
-					if(strstr(sp->Description, "your melee and ranged attacks"))
-						pr |= PROC_ON_MELEE_ATTACK | PROC_ON_RANGED_ATTACK;
-					//////////////////////////////////////////////////
-					//proc dmg flags
-					//////////////////////////////////////////////////
-					if(strstr(sp->Description, "each attack blocked"))
-						pr |= PROC_ON_BLOCK_VICTIM;
-					if(strstr(sp->Description, "into flame, causing an additional"))
-						pr |= PROC_ON_MELEE_ATTACK;
-					if(strstr(sp->Description, "victim of a critical melee strike"))
-						pr |= PROC_ON_CRIT_HIT_VICTIM;
-					if(strstr(sp->Description, "damage to melee attackers"))
-						pr |= PROC_ON_MELEE_ATTACK;
-					if(strstr(sp->Description, "target blocks a melee attack"))
-						pr |= PROC_ON_BLOCK_VICTIM;
-					if(strstr(sp->Description, "ranged and melee attacks to deal"))
-						pr |= PROC_ON_MELEE_ATTACK_VICTIM | PROC_ON_RANGED_ATTACK_VICTIM;
-					if(strstr(sp->Description, "damage on hit"))
-						pr |= PROC_ON_ANY_DAMAGE_VICTIM;
-					if(strstr(sp->Description, "chance on hit"))
-						pr |= PROC_ON_MELEE_ATTACK;
-					if(strstr(sp->Description, "after being hit by any damaging attack"))
-						pr |= PROC_ON_ANY_DAMAGE_VICTIM;
-					if(strstr(sp->Description, "striking melee or ranged attackers"))
-						pr |= PROC_ON_MELEE_ATTACK_VICTIM | PROC_ON_RANGED_ATTACK_VICTIM;
-					if(strstr(sp->Description, "damage to attackers when hit"))
-						pr |= PROC_ON_MELEE_ATTACK_VICTIM;
-					if(strstr(sp->Description, "striking melee attackers"))
-						pr |= PROC_ON_MELEE_ATTACK_VICTIM;
-					if(strstr(sp->Description, "whenever the caster takes damage"))
-						pr |= PROC_ON_ANY_DAMAGE_VICTIM;
-					if(strstr(sp->Description, "damage on every attack"))
-						pr |= PROC_ON_MELEE_ATTACK | PROC_ON_RANGED_ATTACK;
-					if(strstr(sp->Description, "chance to reflect Fire spells"))
-						pr |= PROC_ON_SPELL_HIT_VICTIM;
-					if(strstr(sp->Description, "hunter takes on the aspects of a hawk"))
-						pr |= PROC_TARGET_SELF | PROC_ON_RANGED_ATTACK;
-					if(strstr(sp->Description, "successful auto shot attacks"))
-						pr |= PROC_ON_AUTO_SHOT_HIT;
-					if(strstr(sp->Description, "after getting a critical effect from your"))
-						pr = PROC_ON_SPELL_CRIT_HIT;
-				}//end "if procspellaura"
-
-				// Fix if it's a periodic trigger with amplitude = 0, to avoid division by zero
-				else if((aura == SPELL_AURA_PERIODIC_TRIGGER_SPELL || aura == SPELL_AURA_PERIODIC_TRIGGER_SPELL_WITH_VALUE) && sp->EffectAmplitude[y] == 0)
+					else pr |= PROC_ON_CAST_SPECIFIC_SPELL;
+				}
+				if(strstr(sp->Description, "chance to add an additional combo") && strstr(sp->Description, "critical"))
+					pr |= PROC_ON_CRIT_ATTACK;
+				else if(strstr(sp->Description, "chance to add an additional combo"))
+					pr |= PROC_ON_CAST_SPELL;
+				if(strstr(sp->Description, "victim of a melee or ranged critical strike"))
+					pr |= PROC_ON_CRIT_HIT_VICTIM;
+				if(strstr(sp->Description, "getting a critical effect from"))
+					pr |= PROC_ON_SPELL_CRIT_HIT_VICTIM;
+				if(strstr(sp->Description, "damaging attack is taken"))
+					pr |= PROC_ON_ANY_DAMAGE_VICTIM;
+				if(strstr(sp->Description, "struck by a Stun or Immobilize"))
+					pr |= PROC_ON_SPELL_HIT_VICTIM;
+				if(strstr(sp->Description, "melee critical strike"))
+					pr |= PROC_ON_CRIT_ATTACK;
+				if(strstr(sp->Name, "Bloodthirst"))
+					pr |= PROC_ON_MELEE_ATTACK | static_cast<uint32>(PROC_TARGET_SELF);
+				if(strstr(sp->Description, "experience or honor"))
+					pr |= PROC_ON_GAIN_EXPIERIENCE;
+				if(strstr(sp->Description, "hit by a melee or ranged attack"))
+					pr |= PROC_ON_MELEE_ATTACK_VICTIM | PROC_ON_RANGED_ATTACK_VICTIM;
+				if(strstr(sp->Description, "enemy strikes the caster"))
+					pr |= PROC_ON_MELEE_ATTACK_VICTIM;
+				if(strstr(sp->Description, "melee and ranged attacks against you"))
+					pr |= PROC_ON_MELEE_ATTACK_VICTIM | PROC_ON_RANGED_ATTACK_VICTIM;
+				if(strstr(sp->Description, "when a block occurs"))
+					pr |= PROC_ON_BLOCK_VICTIM;
+				if(strstr(sp->Description, "dealing a critical strike from a weapon swing, spell, or ability"))
+					pr |= PROC_ON_CRIT_ATTACK | PROC_ON_SPELL_CRIT_HIT;
+				if(strstr(sp->Description, "dealing a critical strike from a weapon swing, spell, or ability"))
+					pr |= PROC_ON_CRIT_ATTACK | PROC_ON_SPELL_CRIT_HIT;
+				if(strstr(sp->Description, "shadow bolt critical strikes increase shadow damage"))
+					pr |= PROC_ON_SPELL_CRIT_HIT;
+				if(strstr(sp->Description, "after being hit with a shadow or fire spell"))
+					pr |= PROC_ON_SPELL_LAND_VICTIM;
+				if(strstr(sp->Description, "giving each melee attack"))
+					pr |= PROC_ON_MELEE_ATTACK;
+				if(strstr(sp->Description, "each strike has"))
+					pr |= PROC_ON_MELEE_ATTACK;
+				if(strstr(sp->Description, "your Fire damage spell hits"))
+					pr |= PROC_ON_CAST_SPELL;		//this happens only on hit ;)
+				if(strstr(sp->Description, "corruption, curse of agony, siphon life and seed of corruption spells also cause"))
+					pr |= PROC_ON_CAST_SPELL;
+				if(strstr(sp->Description, "pain, mind flay and vampiric touch spells also cause"))
+					pr |= PROC_ON_CAST_SPELL;
+				if(strstr(sp->Description, "shadow damage spells have"))
+					pr |= PROC_ON_CAST_SPELL;
+				if(strstr(sp->Description, "on successful spellcast"))
+					pr |= PROC_ON_CAST_SPELL;
+				if(strstr(sp->Description, "your spell criticals have"))
+					pr |= PROC_ON_SPELL_CRIT_HIT | PROC_ON_SPELL_CRIT_HIT_VICTIM;
+				if(strstr(sp->Description, "after dodging their attack"))
 				{
-					sp->EffectAmplitude[y] = 1000;
+					pr |= PROC_ON_DODGE_VICTIM;
+					if(strstr(sp->Description, "add a combo point"))
+						pr |= PROC_TARGET_SELF;
 				}
-				else if(aura == SPELL_AURA_SCHOOL_ABSORB && sp->AuraFactoryFunc == NULL)
-					sp->AuraFactoryFunc = (void * (*)) &AbsorbAura::Create;
-			}//end "if aura"
-		}//end "for each effect"
-		sp->procFlags = pr;
-
-		if(strstr(sp->Description, "Must remain seated"))
-		{
-			sp->RecoveryTime = 1000;
-			sp->CategoryRecoveryTime = 1000;
-		}
-
-		//////////////////////////////////////////////////////////////////////////////////////////////////////
-		// procintervals
-		//////////////////////////////////////////////////////////////////////////////////////////////////////
-		//omg lightning shield trigger spell id's are all wrong ?
-		//if you are bored you could make these by hand but i guess we might find other spells with this problem..and this way it's safe
-		if(strstr(sp->Name, "Lightning Shield") && sp->EffectTriggerSpell[0])
-		{
-			//check if we can find in the description
-			const char* startofid = strstr(sp->Description, "for $");
-			if(startofid)
+				if(strstr(sp->Description, "fully resisting"))
+					pr |= PROC_ON_RESIST_VICTIM;
+				if(strstr(sp->Description, "Your Shadow Word: Pain, Mind Flay and Vampiric Touch spells also cause the target"))
+					pr |= PROC_ON_CAST_SPELL;
+				if(strstr(sp->Description, "chance on spell hit"))
+					pr |= PROC_ON_CAST_SPELL;
+				if(strstr(sp->Description, "your melee and ranged attacks"))
+					pr |= PROC_ON_MELEE_ATTACK | PROC_ON_RANGED_ATTACK;
+				//////////////////////////////////////////////////
+				//proc dmg flags
+				//////////////////////////////////////////////////
+				if(strstr(sp->Description, "each attack blocked"))
+					pr |= PROC_ON_BLOCK_VICTIM;
+				if(strstr(sp->Description, "into flame, causing an additional"))
+					pr |= PROC_ON_MELEE_ATTACK;
+				if(strstr(sp->Description, "victim of a critical melee strike"))
+					pr |= PROC_ON_CRIT_HIT_VICTIM;
+				if(strstr(sp->Description, "damage to melee attackers"))
+					pr |= PROC_ON_MELEE_ATTACK;
+				if(strstr(sp->Description, "target blocks a melee attack"))
+					pr |= PROC_ON_BLOCK_VICTIM;
+				if(strstr(sp->Description, "ranged and melee attacks to deal"))
+					pr |= PROC_ON_MELEE_ATTACK_VICTIM | PROC_ON_RANGED_ATTACK_VICTIM;
+				if(strstr(sp->Description, "damage on hit"))
+					pr |= PROC_ON_ANY_DAMAGE_VICTIM;
+				if(strstr(sp->Description, "chance on hit"))
+					pr |= PROC_ON_MELEE_ATTACK;
+				if(strstr(sp->Description, "after being hit by any damaging attack"))
+					pr |= PROC_ON_ANY_DAMAGE_VICTIM;
+				if(strstr(sp->Description, "striking melee or ranged attackers"))
+					pr |= PROC_ON_MELEE_ATTACK_VICTIM | PROC_ON_RANGED_ATTACK_VICTIM;
+				if(strstr(sp->Description, "damage to attackers when hit"))
+					pr |= PROC_ON_MELEE_ATTACK_VICTIM;
+				if(strstr(sp->Description, "striking melee attackers"))
+					pr |= PROC_ON_MELEE_ATTACK_VICTIM;
+				if(strstr(sp->Description, "whenever the caster takes damage"))
+					pr |= PROC_ON_ANY_DAMAGE_VICTIM;
+				if(strstr(sp->Description, "damage on every attack"))
+					pr |= PROC_ON_MELEE_ATTACK | PROC_ON_RANGED_ATTACK;
+				if(strstr(sp->Description, "chance to reflect Fire spells"))
+					pr |= PROC_ON_SPELL_HIT_VICTIM;
+				if(strstr(sp->Description, "hunter takes on the aspects of a hawk"))
+					pr |= PROC_TARGET_SELF | PROC_ON_RANGED_ATTACK;
+				if(strstr(sp->Description, "successful auto shot attacks"))
+					pr |= PROC_ON_AUTO_SHOT_HIT;
+				if(strstr(sp->Description, "after getting a critical effect from your"))
+					pr = PROC_ON_SPELL_CRIT_HIT;
+			}//end "if procspellaura"
+
+			// Fix if it's a periodic trigger with amplitude = 0, to avoid division by zero
+			else if((aura == SPELL_AURA_PERIODIC_TRIGGER_SPELL || aura == SPELL_AURA_PERIODIC_TRIGGER_SPELL_WITH_VALUE) && sp->EffectAmplitude[y] == 0)
 			{
-				startofid += strlen("for $");
-				sp->EffectTriggerSpell[0] = atoi(startofid);   //get new lightning shield trigger id
+				sp->EffectAmplitude[y] = 1000;
 			}
-			sp->proc_interval = 3000; //few seconds
-		}
-		//mage ignite talent should proc only on some chances
-		else if(strstr(sp->Name, "Ignite") && sp->Id >= 11119 && sp->Id <= 12848 && sp->EffectApplyAuraName[0] == SPELL_AURA_DUMMY)
-		{
-			//check if we can find in the description
-			const char* startofid = strstr(sp->Description, "an additional ");
-			if(startofid)
-			{
-				startofid += strlen("an additional ");
-				sp->EffectBasePoints[0] = atoi(startofid); //get new value. This is actually level*8 ;)
-			}
-			sp->Effect[0] = SPELL_EFFECT_APPLY_AURA; //aura
-			sp->EffectApplyAuraName[0] = SPELL_AURA_PROC_TRIGGER_SPELL; //force him to use procspell effect
-			sp->EffectTriggerSpell[0] = 12654; //evil , but this is good for us :D
-			sp->procFlags = PROC_ON_SPELL_CRIT_HIT; //add procflag here since this was not processed with the others !
-		}
-		// Winter's Chill handled by frost school
-		else if(strstr(sp->Name, "Winter's Chill"))
+			else if(aura == SPELL_AURA_SCHOOL_ABSORB && sp->AuraFactoryFunc == NULL)
+				sp->AuraFactoryFunc = (void * (*)) &AbsorbAura::Create;
+		}//end "if aura"
+	}//end "for each effect"
+	sp->procFlags = pr;
+
+	if(strstr(sp->Description, "Must remain seated"))
+	{
+		sp->RecoveryTime = 1000;
+		sp->CategoryRecoveryTime = 1000;
+	}
+
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	// procintervals
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	//omg lightning shield trigger spell id's are all wrong ?
+	//if you are bored you could make these by hand but i guess we might find other spells with this problem..and this way it's safe
+	if(strstr(sp->Name, "Lightning Shield") && sp->EffectTriggerSpell[0])
+	{
+		//check if we can find in the description
+		const char* startofid = strstr(sp->Description, "for $");
+		if(startofid)
 		{
-			sp->School = SCHOOL_FROST;
+			startofid += strlen("for $");
+			sp->EffectTriggerSpell[0] = atoi(startofid);   //get new lightning shield trigger id
 		}
-		//more triggered spell ids are wrong. I think blizz is trying to outsmart us :S
-		//Chain Heal all ranks %50 heal value (49 + 1)
-		else if(strstr(sp->Name, "Chain Heal"))
+		sp->proc_interval = 3000; //few seconds
+	}
+	//mage ignite talent should proc only on some chances
+	else if(strstr(sp->Name, "Ignite") && sp->Id >= 11119 && sp->Id <= 12848 && sp->EffectApplyAuraName[0] == SPELL_AURA_DUMMY)
+	{
+		//check if we can find in the description
+		const char* startofid = strstr(sp->Description, "an additional ");
+		if(startofid)
 		{
-			sp->EffectDieSides[0] = 49;
+			startofid += strlen("an additional ");
+			sp->EffectBasePoints[0] = atoi(startofid); //get new value. This is actually level*8 ;)
 		}
-		else if(strstr(sp->Name, "Touch of Weakness"))
+		sp->Effect[0] = SPELL_EFFECT_APPLY_AURA; //aura
+		sp->EffectApplyAuraName[0] = SPELL_AURA_PROC_TRIGGER_SPELL; //force him to use procspell effect
+		sp->EffectTriggerSpell[0] = 12654; //evil , but this is good for us :D
+		sp->procFlags = PROC_ON_SPELL_CRIT_HIT; //add procflag here since this was not processed with the others !
+	}
+	// Winter's Chill handled by frost school
+	else if(strstr(sp->Name, "Winter's Chill"))
+	{
+		sp->School = SCHOOL_FROST;
+	}
+	//more triggered spell ids are wrong. I think blizz is trying to outsmart us :S
+	//Chain Heal all ranks %50 heal value (49 + 1)
+	else if(strstr(sp->Name, "Chain Heal"))
+	{
+		sp->EffectDieSides[0] = 49;
+	}
+	else if(strstr(sp->Name, "Touch of Weakness"))
+	{
+		//check if we can find in the description
+		const char* startofid = strstr(sp->Description, "cause $");
+		if(startofid)
 		{
-			//check if we can find in the description
-			const char* startofid = strstr(sp->Description, "cause $");
-			if(startofid)
-			{
-				startofid += strlen("cause $");
-				sp->EffectTriggerSpell[0] = atoi(startofid);
-				sp->EffectTriggerSpell[1] = sp->EffectTriggerSpell[0]; //later versions of this spell changed to eff[1] the aura
-				sp->procFlags = uint32(PROC_ON_MELEE_ATTACK_VICTIM);
-			}
+			startofid += strlen("cause $");
+			sp->EffectTriggerSpell[0] = atoi(startofid);
+			sp->EffectTriggerSpell[1] = sp->EffectTriggerSpell[0]; //later versions of this spell changed to eff[1] the aura
+			sp->procFlags = uint32(PROC_ON_MELEE_ATTACK_VICTIM);
 		}
-		else if(strstr(sp->Name, "Firestone Passive"))
+	}
+	else if(strstr(sp->Name, "Firestone Passive"))
+	{
+		//Enchants the main hand weapon with fire, granting each attack a chance to deal $17809s1 additional fire damage.
+		//check if we can find in the description
+		char* startofid = strstr(sp->Description, "to deal $");
+		if(startofid)
 		{
-			//Enchants the main hand weapon with fire, granting each attack a chance to deal $17809s1 additional fire damage.
-			//check if we can find in the description
-			char* startofid = strstr(sp->Description, "to deal $");
-			if(startofid)
-			{
-				startofid += strlen("to deal $");
-				sp->EffectTriggerSpell[0] = atoi(startofid);
-				sp->EffectApplyAuraName[0] = SPELL_AURA_PROC_TRIGGER_SPELL;
-				sp->procFlags = PROC_ON_MELEE_ATTACK;
-				sp->procChance = 50;
-			}
+			startofid += strlen("to deal $");
+			sp->EffectTriggerSpell[0] = atoi(startofid);
+			sp->EffectApplyAuraName[0] = SPELL_AURA_PROC_TRIGGER_SPELL;
+			sp->procFlags = PROC_ON_MELEE_ATTACK;
+			sp->procChance = 50;
 		}
-		//some procs trigger at intervals
-		else if(strstr(sp->Name, "Water Shield"))
+	}
+	//some procs trigger at intervals
+	else if(strstr(sp->Name, "Water Shield"))
+	{
+		sp->proc_interval = 3000; //few seconds
+		sp->procFlags |= PROC_TARGET_SELF;
+	}
+	else if(strstr(sp->Name, "Earth Shield"))
+		sp->proc_interval = 3000; //few seconds
+	else if(strstr(sp->Name, "Poison Shield"))
+		sp->proc_interval = 3000; //few seconds
+	else if(strstr(sp->Name, "Infused Mushroom"))
+		sp->proc_interval = 10000; //10 seconds
+	else if(strstr(sp->Name, "Aviana's Purpose"))
+		sp->proc_interval = 10000; //10 seconds
+	//don't change to namehash since we are searching only a portion of the name
+	else if(strstr(sp->Name, "Crippling Poison"))
+	{
+		sp->c_is_flags |= SPELL_FLAG_IS_POISON;
+	}
+	else if(strstr(sp->Name, "Mind-numbing Poison"))
+	{
+		sp->c_is_flags |= SPELL_FLAG_IS_POISON;
+	}
+	else if(strstr(sp->Name, "Instant Poison"))
+	{
+		sp->c_is_flags |= SPELL_FLAG_IS_POISON;
+	}
+	else if(strstr(sp->Name, "Deadly Poison"))
+	{
+		sp->c_is_flags |= SPELL_FLAG_IS_POISON;
+	}
+	else if(strstr(sp->Name, "Wound Poison"))
+	{
+		sp->c_is_flags |= SPELL_FLAG_IS_POISON;
+	}
+	else if(strstr(sp->Name, "Scorpid Poison"))
+	{
+		// groups?
+		sp->c_is_flags |= SPELL_FLAG_IS_POISON;
+	}
+
+	if(sp->NameHash == SPELL_HASH_ILLUMINATION)
+		sp->procFlags |= PROC_TARGET_SELF;
+
+	// Set default mechanics if we don't already have one
+	if(!sp->MechanicsType)
+	{
+		//Set Silencing spells mechanic.
+		if(sp->EffectApplyAuraName[0] == SPELL_AURA_MOD_SILENCE ||
+		        sp->EffectApplyAuraName[1] == SPELL_AURA_MOD_SILENCE ||
+		        sp->EffectApplyAuraName[2] == SPELL_AURA_MOD_SILENCE)
+			sp->MechanicsType = MECHANIC_SILENCED;
+
+		//Set Stunning spells mechanic.
+		if(sp->EffectApplyAuraName[0] == SPELL_AURA_MOD_STUN ||
+		        sp->EffectApplyAuraName[1] == SPELL_AURA_MOD_STUN ||
+		        sp->EffectApplyAuraName[2] == SPELL_AURA_MOD_STUN)
+			sp->MechanicsType = MECHANIC_STUNNED;
+
+		//Set Fearing spells mechanic
+		if(sp->EffectApplyAuraName[0] == SPELL_AURA_MOD_FEAR ||
+		        sp->EffectApplyAuraName[1] == SPELL_AURA_MOD_FEAR ||
+		        sp->EffectApplyAuraName[2] == SPELL_AURA_MOD_FEAR)
+			sp->MechanicsType = MECHANIC_FLEEING;
+
+		//Set Interrupted spells mech
+		if(sp->Effect[0] == SPELL_EFFECT_INTERRUPT_CAST ||
+		        sp->Effect[1] == SPELL_EFFECT_INTERRUPT_CAST ||
+		        sp->Effect[2] == SPELL_EFFECT_INTERRUPT_CAST)
+			sp->MechanicsType = MECHANIC_INTERRUPTED;
+	}
+
+	if(sp->proc_interval != 0)
+		sp->procFlags |= PROC_REMOVEONUSE;
+
+	// Seal of Command - Proc Chance
+	if(sp->NameHash == SPELL_HASH_SEAL_OF_COMMAND)
+	{
+		sp->procChance = 25;
+		sp->School = SCHOOL_HOLY; //the procspells of the original seal of command have physical school instead of holy
+		sp->Spell_Dmg_Type = SPELL_DMG_TYPE_MAGIC; //heh, crazy spell uses melee/ranged/magic dmg type for 1 spell. Now which one is correct ?
+	}
+
+	/* Decapitate */
+	if(sp->NameHash == SPELL_HASH_DECAPITATE)
+		sp->procChance = 30;
+
+	//shaman - shock, has no spellgroup.very dangerous move !
+
+	//mage - fireball. Only some of the spell has the flags
+
+	if(sp->NameHash == SPELL_HASH_DIVINE_SHIELD || sp->NameHash == SPELL_HASH_DIVINE_PROTECTION || sp->NameHash == SPELL_HASH_BLESSING_OF_PROTECTION)
+		sp->MechanicsType = MECHANIC_INVULNARABLE;
+
+	/* hackfix for this - FIX ME LATER - Burlex */
+	if(namehash == SPELL_HASH_SEAL_FATE)
+		sp->procFlags = 0;
+
+	if(
+	    ((sp->Attributes & ATTRIBUTES_TRIGGER_COOLDOWN) && (sp->AttributesEx & ATTRIBUTESEX_NOT_BREAK_STEALTH)) //rogue cold blood
+	    || ((sp->Attributes & ATTRIBUTES_TRIGGER_COOLDOWN) && (!sp->AttributesEx || sp->AttributesEx & ATTRIBUTESEX_REMAIN_OOC))
+	)
+	{
+		sp->c_is_flags |= SPELL_FLAG_IS_REQUIRECOOLDOWNUPDATE;
+	}
+
+	if(namehash == SPELL_HASH_SHRED || namehash == SPELL_HASH_BACKSTAB || namehash == SPELL_HASH_AMBUSH || namehash == SPELL_HASH_GARROTE || namehash == SPELL_HASH_RAVAGE)
+	{
+		// FIX ME: needs different flag check
+		sp->FacingCasterFlags = SPELL_INFRONT_STATUS_REQUIRE_INBACK;
+	}
+}
+
+//Calculates the spell coefficients of a spell.dbc row and applies the class specific fixes.
+static void ApplyCoefficientFixesToRow(SpellEntry* sp)
+{
+	uint32 i;
+
+	//Setting Cast Time Coefficient
+	SpellCastTime* sd = dbcSpellCastTime.LookupEntry(sp->CastingTimeIndex);
+	float castaff = float(GetCastTime(sd));
+	if(castaff < 1500)
+		castaff = 1500;
+	else if(castaff > 7000)
+		castaff = 7000;
+
+	sp->casttime_coef = castaff / 3500;
+
+	SpellEntry* spz;
+	bool spcheck = false;
+
+	//Flag for DoT and HoT
+	for(i = 0 ; i < 3 ; i++)
+	{
+		if(sp->EffectApplyAuraName[i] == SPELL_AURA_PERIODIC_DAMAGE ||
+		        sp->EffectApplyAuraName[i] == SPELL_AURA_PERIODIC_HEAL ||
+		        sp->EffectApplyAuraName[i] == SPELL_AURA_PERIODIC_LEECH)
 		{
-			sp->proc_interval = 3000; //few seconds
-			sp->procFlags |= PROC_TARGET_SELF;
+			sp->spell_coef_flags |= SPELL_FLAG_IS_DOT_OR_HOT_SPELL;
+			break;
 		}
-		else if(strstr(sp->Name, "Earth Shield"))
-			sp->proc_interval = 3000; //few seconds
-		else if(strstr(sp->Name, "Poison Shield"))
-			sp->proc_interval = 3000; //few seconds
-		else if(strstr(sp->Name, "Infused Mushroom"))
-			sp->proc_interval = 10000; //10 seconds
-		else if(strstr(sp->Name, "Aviana's Purpose"))
-			sp->proc_interval = 10000; //10 seconds
-		//don't change to namehash since we are searching only a portion of the name
-		else if(strstr(sp->Name, "Crippling Poison"))
+	}
+
+	//Flag for DD or DH
+	for(i = 0 ; i < 3 ; i++)
+	{
+		if(sp->EffectApplyAuraName[i] == SPELL_AURA_PERIODIC_TRIGGER_SPELL && sp->EffectTriggerSpell[i])
 		{
-			sp->c_is_flags |= SPELL_FLAG_IS_POISON;
+			spz = dbcSpell.LookupEntryForced(sp->EffectTriggerSpell[i]);
+			if(spz &&
+			        (spz->Effect[i] == SPELL_EFFECT_SCHOOL_DAMAGE ||
+			         spz->Effect[i] == SPELL_EFFECT_HEAL)
+			  )
+				spcheck = true;
 		}
-		else if(strstr(sp->Name, "Mind-numbing Poison"))
+		if(sp->Effect[i] == SPELL_EFFECT_SCHOOL_DAMAGE ||
+		        sp->Effect[i] == SPELL_EFFECT_HEAL ||
+		        spcheck
+		  )
 		{
-			sp->c_is_flags |= SPELL_FLAG_IS_POISON;
+			sp->spell_coef_flags |= SPELL_FLAG_IS_DD_OR_DH_SPELL;
+			break;
 		}
-		else if(strstr(sp->Name, "Instant Poison"))
+	}
+
+	for(i = 0 ; i < 3; i++)
+	{
+		switch(sp->EffectImplicitTargetA[i])
 		{
-			sp->c_is_flags |= SPELL_FLAG_IS_POISON;
+				//AoE
+			case EFF_TARGET_ALL_TARGETABLE_AROUND_LOCATION_IN_RADIUS:
+			case EFF_TARGET_ALL_ENEMY_IN_AREA:
+			case EFF_TARGET_ALL_ENEMY_IN_AREA_INSTANT:
+			case EFF_TARGET_ALL_PARTY_AROUND_CASTER:
+			case EFF_TARGET_ALL_ENEMIES_AROUND_CASTER:
+			case EFF_TARGET_IN_FRONT_OF_CASTER:
+			case EFF_TARGET_ALL_ENEMY_IN_AREA_CHANNELED:
+			case EFF_TARGET_ALL_PARTY_IN_AREA_CHANNELED:
+			case EFF_TARGET_ALL_FRIENDLY_IN_AREA:
+			case EFF_TARGET_ALL_TARGETABLE_AROUND_LOCATION_IN_RADIUS_OVER_TIME:
+			case EFF_TARGET_ALL_PARTY:
+			case EFF_TARGET_LOCATION_INFRONT_CASTER:
+			case EFF_TARGET_BEHIND_TARGET_LOCATION:
+			case EFF_TARGET_LOCATION_INFRONT_CASTER_AT_RANGE:
+				{
+					sp->spell_coef_flags |= SPELL_FLAG_AOE_SPELL;
+					break;
+				}
 		}
-		else if(strstr(sp->Name, "Deadly Poison"))
+	}
+
+	for(i = 0 ; i < 3 ; i++)
+	{
+		switch(sp->EffectImplicitTargetB[i])
 		{
-			sp->c_is_flags |= SPELL_FLAG_IS_POISON;
+				//AoE
+			case EFF_TARGET_ALL_TARGETABLE_AROUND_LOCATION_IN_RADIUS:
+			case EFF_TARGET_ALL_ENEMY_IN_AREA:
+			case EFF_TARGET_ALL_ENEMY_IN_AREA_INSTANT:
+			case EFF_TARGET_ALL_PARTY_AROUND_CASTER:
+			case EFF_TARGET_ALL_ENEMIES_AROUND_CASTER:
+			case EFF_TARGET_IN_FRONT_OF_CASTER:
+			case EFF_TARGET_ALL_ENEMY_IN_AREA_CHANNELED:
+			case EFF_TARGET_ALL_PARTY_IN_AREA_CHANNELED:
+			case EFF_TARGET_ALL_FRIENDLY_IN_AREA:
+			case EFF_TARGET_ALL_TARGETABLE_AROUND_LOCATION_IN_RADIUS_OVER_TIME:
+			case EFF_TARGET_ALL_PARTY:
+			case EFF_TARGET_LOCATION_INFRONT_CASTER:
+			case EFF_TARGET_BEHIND_TARGET_LOCATION:
+			case EFF_TARGET_LOCATION_INFRONT_CASTER_AT_RANGE:
+				{
+					sp->spell_coef_flags |= SPELL_FLAG_AOE_SPELL;
+					break;
+				}
 		}
-		else if(strstr(sp->Name, "Wound Poison"))
+	}
+
+	//Special Cases
+	//Holy Light & Flash of Light
+	if(sp->NameHash == SPELL_HASH_HOLY_LIGHT ||
+	        sp->NameHash == SPELL_HASH_FLASH_OF_LIGHT)
+		sp->spell_coef_flags |= SPELL_FLAG_IS_DD_OR_DH_SPELL;
+
+
+	//Additional Effect (not healing or damaging)
+	for(i = 0 ; i < 3 ; i++)
+	{
+		if(sp->Effect[i] == SPELL_EFFECT_NULL)
+			continue;
+
+		switch(sp->Effect[i])
 		{
-			sp->c_is_flags |= SPELL_FLAG_IS_POISON;
+			case SPELL_EFFECT_SCHOOL_DAMAGE:
+			case SPELL_EFFECT_ENVIRONMENTAL_DAMAGE:
+			case SPELL_EFFECT_HEALTH_LEECH:
+			case SPELL_EFFECT_WEAPON_DAMAGE_NOSCHOOL:
+			case SPELL_EFFECT_ADD_EXTRA_ATTACKS:
+			case SPELL_EFFECT_WEAPON_PERCENT_DAMAGE:
+			case SPELL_EFFECT_POWER_BURN:
+			case SPELL_EFFECT_ATTACK:
+			case SPELL_EFFECT_HEAL:
+			case SPELL_EFFECT_HEAL_MAX_HEALTH:
+			case SPELL_EFFECT_DUMMY:
+				continue;
 		}
-		else if(strstr(sp->Name, "Scorpid Poison"))
+
+		switch(sp->EffectApplyAuraName[i])
 		{
-			// groups?
-			sp->c_is_flags |= SPELL_FLAG_IS_POISON;
+			case SPELL_AURA_PERIODIC_DAMAGE:
+			case SPELL_AURA_PROC_TRIGGER_DAMAGE:
+			case SPELL_AURA_PERIODIC_DAMAGE_PERCENT:
+			case SPELL_AURA_POWER_BURN:
+			case SPELL_AURA_PERIODIC_HEAL:
+			case SPELL_AURA_MOD_INCREASE_HEALTH:
+			case SPELL_AURA_PERIODIC_HEALTH_FUNNEL:
+			case SPELL_AURA_DUMMY:
+				continue;
 		}
 
-		if(sp->NameHash == SPELL_HASH_ILLUMINATION)
-			sp->procFlags |= PROC_TARGET_SELF;
+		sp->spell_coef_flags |= SPELL_FLAG_ADITIONAL_EFFECT;
+		break;
 
-		// Set default mechanics if we don't already have one
-		if(!sp->MechanicsType)
-		{
-			//Set Silencing spells mechanic.
-			if(sp->EffectApplyAuraName[0] == SPELL_AURA_MOD_SILENCE ||
-			        sp->EffectApplyAuraName[1] == SPELL_AURA_MOD_SILENCE ||
-			        sp->EffectApplyAuraName[2] == SPELL_AURA_MOD_SILENCE)
-				sp->MechanicsType = MECHANIC_SILENCED;
-
-			//Set Stunning spells mechanic.
-			if(sp->EffectApplyAuraName[0] == SPELL_AURA_MOD_STUN ||
-			        sp->EffectApplyAuraName[1] == SPELL_AURA_MOD_STUN ||
-			        sp->EffectApplyAuraName[2] == SPELL_AURA_MOD_STUN)
-				sp->MechanicsType = MECHANIC_STUNNED;
-
-			//Set Fearing spells mechanic
-			if(sp->EffectApplyAuraName[0] == SPELL_AURA_MOD_FEAR ||
-			        sp->EffectApplyAuraName[1] == SPELL_AURA_MOD_FEAR ||
-			        sp->EffectApplyAuraName[2] == SPELL_AURA_MOD_FEAR)
-				sp->MechanicsType = MECHANIC_FLEEING;
-
-			//Set Interrupted spells mech
-			if(sp->Effect[0] == SPELL_EFFECT_INTERRUPT_CAST ||
-			        sp->Effect[1] == SPELL_EFFECT_INTERRUPT_CAST ||
-			        sp->Effect[2] == SPELL_EFFECT_INTERRUPT_CAST)
-				sp->MechanicsType = MECHANIC_INTERRUPTED;
-		}
+	}
 
-		if(sp->proc_interval != 0)
-			sp->procFlags |= PROC_REMOVEONUSE;
+	//Calculating fixed coeficients
+	//Channeled spells
+	if(sp->ChannelInterruptFlags != 0)
+	{
+		float Duration = float(GetDuration(dbcSpellDuration.LookupEntry(sp->DurationIndex)));
+		if(Duration < 1500) Duration = 1500;
+		else if(Duration > 7000) Duration = 7000;
+		sp->fixed_hotdotcoef = (Duration / 3500.0f);
 
-		// Seal of Command - Proc Chance
-		if(sp->NameHash == SPELL_HASH_SEAL_OF_COMMAND)
-		{
-			sp->procChance = 25;
-			sp->School = SCHOOL_HOLY; //the procspells of the original seal of command have physical school instead of holy
-			sp->Spell_Dmg_Type = SPELL_DMG_TYPE_MAGIC; //heh, crazy spell uses melee/ranged/magic dmg type for 1 spell. Now which one is correct ?
-		}
+		if(sp->spell_coef_flags & SPELL_FLAG_ADITIONAL_EFFECT)
+			sp->fixed_hotdotcoef *= 0.95f;
+		if(sp->spell_coef_flags & SPELL_FLAG_AOE_SPELL)
+			sp->fixed_hotdotcoef *= 0.5f;
+	}
+
+	//Standard spells
+	else if((sp->spell_coef_flags & SPELL_FLAG_IS_DD_OR_DH_SPELL) && !(sp->spell_coef_flags & SPELL_FLAG_IS_DOT_OR_HOT_SPELL))
+	{
+		sp->fixed_dddhcoef = sp->casttime_coef;
+		if(sp->spell_coef_flags & SPELL_FLAG_ADITIONAL_EFFECT)
+			sp->fixed_dddhcoef *= 0.95f;
+		if(sp->spell_coef_flags & SPELL_FLAG_AOE_SPELL)
+			sp->fixed_dddhcoef *= 0.5f;
+	}
 
-		/* Decapitate */
-		if(sp->NameHash == SPELL_HASH_DECAPITATE)
-			sp->procChance = 30;
+	//Over-time spells
+	else if(!(sp->spell_coef_flags & SPELL_FLAG_IS_DD_OR_DH_SPELL) && (sp->spell_coef_flags & SPELL_FLAG_IS_DOT_OR_HOT_SPELL))
+	{
+		float Duration = float(GetDuration(dbcSpellDuration.LookupEntry(sp->DurationIndex)));
+		sp->fixed_hotdotcoef = (Duration / 15000.0f);
 
-		//shaman - shock, has no spellgroup.very dangerous move !
+		if(sp->spell_coef_flags & SPELL_FLAG_ADITIONAL_EFFECT)
+			sp->fixed_hotdotcoef *= 0.95f;
+		if(sp->spell_coef_flags & SPELL_FLAG_AOE_SPELL)
+			sp->fixed_hotdotcoef *= 0.5f;
 
-		//mage - fireball. Only some of the spell has the flags
+	}
 
-		if(sp->NameHash == SPELL_HASH_DIVINE_SHIELD || sp->NameHash == SPELL_HASH_DIVINE_PROTECTION || sp->NameHash == SPELL_HASH_BLESSING_OF_PROTECTION)
-			sp->MechanicsType = MECHANIC_INVULNARABLE;
+	//Combined standard and over-time spells
+	else if(sp->spell_coef_flags & SPELL_FLAG_IS_DD_DH_DOT_SPELL)
+	{
+		float Duration = float(GetDuration(dbcSpellDuration.LookupEntry(sp->DurationIndex)));
+		float Portion_to_Over_Time = (Duration / 15000.0f) / ((Duration / 15000.0f) + sp->casttime_coef);
+		float Portion_to_Standard = 1.0f - Portion_to_Over_Time;
 
-		/* hackfix for this - FIX ME LATER - Burlex */
-		if(namehash == SPELL_HASH_SEAL_FATE)
-			sp->procFlags = 0;
+		sp->fixed_dddhcoef = sp->casttime_coef * Portion_to_Standard;
+		sp->fixed_hotdotcoef = (Duration / 15000.0f) * Portion_to_Over_Time;
 
-		if(
-		    ((sp->Attributes & ATTRIBUTES_TRIGGER_COOLDOWN) && (sp->AttributesEx & ATTRIBUTESEX_NOT_BREAK_STEALTH)) //rogue cold blood
-		    || ((sp->Attributes & ATTRIBUTES_TRIGGER_COOLDOWN) && (!sp->AttributesEx || sp->AttributesEx & ATTRIBUTESEX_REMAIN_OOC))
-		)
+		if(sp->spell_coef_flags & SPELL_FLAG_ADITIONAL_EFFECT)
 		{
-			sp->c_is_flags |= SPELL_FLAG_IS_REQUIRECOOLDOWNUPDATE;
+			sp->fixed_dddhcoef *= 0.95f;
+			sp->fixed_hotdotcoef *= 0.95f;
 		}
-
-		if(namehash == SPELL_HASH_SHRED || namehash == SPELL_HASH_BACKSTAB || namehash == SPELL_HASH_AMBUSH || namehash == SPELL_HASH_GARROTE || namehash == SPELL_HASH_RAVAGE)
+		if(sp->spell_coef_flags & SPELL_FLAG_AOE_SPELL)
 		{
-			// FIX ME: needs different flag check
-			sp->FacingCasterFlags = SPELL_INFRONT_STATUS_REQUIRE_INBACK;
+			sp->fixed_dddhcoef *= 0.5f;
+			sp->fixed_hotdotcoef *= 0.5f;
 		}
 	}
 
-	/////////////////////////////////////////////////////////////////
-	//SPELL COEFFICIENT SETTINGS START
-	//////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////
+	// CLASS-SPECIFIC SPELL FIXES						//
+	//////////////////////////////////////////////////////
 
-	for(uint32 x = 0; x < cnt; x++)
-	{
-		// get spellentry
-		sp = dbcSpell.LookupRow(x);
+	/* Note: when applying spell hackfixes, please follow a template */
+	/* Please don't put fixes like "sp = CheckAndReturnSpellEntry( 15270 );" inside the loop */
 
-		//Setting Cast Time Coefficient
-		SpellCastTime* sd = dbcSpellCastTime.LookupEntry(sp->CastingTimeIndex);
-		float castaff = float(GetCastTime(sd));
-		if(castaff < 1500)
-			castaff = 1500;
-		else if(castaff > 7000)
-			castaff = 7000;
+	//////////////////////////////////////////
+	// WARRIOR								//
+	//////////////////////////////////////////
 
-		sp->casttime_coef = castaff / 3500;
 
-		SpellEntry* spz;
-		bool spcheck = false;
 
-		//Flag for DoT and HoT
-		for(i = 0 ; i < 3 ; i++)
-		{
-			if(sp->EffectApplyAuraName[i] == SPELL_AURA_PERIODIC_DAMAGE ||
-			        sp->EffectApplyAuraName[i] == SPELL_AURA_PERIODIC_HEAL ||
-			        sp->EffectApplyAuraName[i] == SPELL_AURA_PERIODIC_LEECH)
-			{
-				sp->spell_coef_flags |= SPELL_FLAG_IS_DOT_OR_HOT_SPELL;
-				break;
-			}
-		}
+	//////////////////////////////////////////
+	// PALADIN								//
+	//////////////////////////////////////////
 
-		//Flag for DD or DH
-		for(i = 0 ; i < 3 ; i++)
-		{
-			if(sp->EffectApplyAuraName[i] == SPELL_AURA_PERIODIC_TRIGGER_SPELL && sp->EffectTriggerSpell[i])
-			{
-				spz = dbcSpell.LookupEntryForced(sp->EffectTriggerSpell[i]);
-				if(spz &&
-				        (spz->Effect[i] == SPELL_EFFECT_SCHOOL_DAMAGE ||
-				         spz->Effect[i] == SPELL_EFFECT_HEAL)
-				  )
-					spcheck = true;
-			}
-			if(sp->Effect[i] == SPELL_EFFECT_SCHOOL_DAMAGE ||
-			        sp->Effect[i] == SPELL_EFFECT_HEAL ||
-			        spcheck
-			  )
-			{
-				sp->spell_coef_flags |= SPELL_FLAG_IS_DD_OR_DH_SPELL;
-				break;
-			}
-		}
+	// Insert paladin spell fixes here
 
-		for(i = 0 ; i < 3; i++)
-		{
-			switch(sp->EffectImplicitTargetA[i])
-			{
-					//AoE
-				case EFF_TARGET_ALL_TARGETABLE_AROUND_LOCATION_IN_RADIUS:
-				case EFF_TARGET_ALL_ENEMY_IN_AREA:
-				case EFF_TARGET_ALL_ENEMY_IN_AREA_INSTANT:
-				case EFF_TARGET_ALL_PARTY_AROUND_CASTER:
-				case EFF_TARGET_ALL_ENEMIES_AROUND_CASTER:
-				case EFF_TARGET_IN_FRONT_OF_CASTER:
-				case EFF_TARGET_ALL_ENEMY_IN_AREA_CHANNELED:
-				case EFF_TARGET_ALL_PARTY_IN_AREA_CHANNELED:
-				case EFF_TARGET_ALL_FRIENDLY_IN_AREA:
-				case EFF_TARGET_ALL_TARGETABLE_AROUND_LOCATION_IN_RADIUS_OVER_TIME:
-				case EFF_TARGET_ALL_PARTY:
-				case EFF_TARGET_LOCATION_INFRONT_CASTER:
-				case EFF_TARGET_BEHIND_TARGET_LOCATION:
-				case EFF_TARGET_LOCATION_INFRONT_CASTER_AT_RANGE:
-					{
-						sp->spell_coef_flags |= SPELL_FLAG_AOE_SPELL;
-						break;
-					}
-			}
-		}
+	// Shield of Righteousness
+	if(sp->NameHash == SPELL_HASH_SHIELD_OF_RIGHTEOUSNESS)
+	{
+		sp->School = SCHOOL_HOLY;
+		sp->Effect[0] = SPELL_EFFECT_DUMMY;
+		sp->Effect[1] = SPELL_EFFECT_NULL; //hacks, handling it in Spell::SpellEffectSchoolDMG(uint32 i)
+		sp->Effect[2] = SPELL_EFFECT_SCHOOL_DAMAGE; //hack
+	}
 
-		for(i = 0 ; i < 3 ; i++)
-		{
-			switch(sp->EffectImplicitTargetB[i])
-			{
-					//AoE
-				case EFF_TARGET_ALL_TARGETABLE_AROUND_LOCATION_IN_RADIUS:
-				case EFF_TARGET_ALL_ENEMY_IN_AREA:
-				case EFF_TARGET_ALL_ENEMY_IN_AREA_INSTANT:
-				case EFF_TARGET_ALL_PARTY_AROUND_CASTER:
-				case EFF_TARGET_ALL_ENEMIES_AROUND_CASTER:
-				case EFF_TARGET_IN_FRONT_OF_CASTER:
-				case EFF_TARGET_ALL_ENEMY_IN_AREA_CHANNELED:
-				case EFF_TARGET_ALL_PARTY_IN_AREA_CHANNELED:
-				case EFF_TARGET_ALL_FRIENDLY_IN_AREA:
-				case EFF_TARGET_ALL_TARGETABLE_AROUND_LOCATION_IN_RADIUS_OVER_TIME:
-				case EFF_TARGET_ALL_PARTY:
-				case EFF_TARGET_LOCATION_INFRONT_CASTER:
-				case EFF_TARGET_BEHIND_TARGET_LOCATION:
-				case EFF_TARGET_LOCATION_INFRONT_CASTER_AT_RANGE:
-					{
-						sp->spell_coef_flags |= SPELL_FLAG_AOE_SPELL;
-						break;
-					}
-			}
-		}
+	// Paladin - Consecration
+	if(sp->NameHash == SPELL_HASH_CONSECRATION)
+	{
+		sp->School = SCHOOL_HOLY; //Consecration is a holy redirected spell.
+		sp->Spell_Dmg_Type = SPELL_DMG_TYPE_MAGIC; //Speaks for itself.
+	}
 
-		//Special Cases
-		//Holy Light & Flash of Light
-		if(sp->NameHash == SPELL_HASH_HOLY_LIGHT ||
-		        sp->NameHash == SPELL_HASH_FLASH_OF_LIGHT)
-			sp->spell_coef_flags |= SPELL_FLAG_IS_DD_OR_DH_SPELL;
+	if(sp->NameHash == SPELL_HASH_SEALS_OF_THE_PURE)
+	{
+		sp->EffectSpellClassMask[0][0] = 0x08000400;
+		sp->EffectSpellClassMask[0][1] = 0x20000000;
+		sp->EffectSpellClassMask[1][1] = 0x800;
+	}
 
+	//////////////////////////////////////////
+	// HUNTER								//
+	//////////////////////////////////////////
 
-		//Additional Effect (not healing or damaging)
-		for(i = 0 ; i < 3 ; i++)
-		{
-			if(sp->Effect[i] == SPELL_EFFECT_NULL)
-				continue;
+	// THESE FIXES ARE GROUPED FOR CODE CLEANLINESS.
+	//Mend Pet
+	if(sp->NameHash == SPELL_HASH_MEND_PET)
+		sp->ChannelInterruptFlags = 0;
 
-			switch(sp->Effect[i])
-			{
-				case SPELL_EFFECT_SCHOOL_DAMAGE:
-				case SPELL_EFFECT_ENVIRONMENTAL_DAMAGE:
-				case SPELL_EFFECT_HEALTH_LEECH:
-				case SPELL_EFFECT_WEAPON_DAMAGE_NOSCHOOL:
-				case SPELL_EFFECT_ADD_EXTRA_ATTACKS:
-				case SPELL_EFFECT_WEAPON_PERCENT_DAMAGE:
-				case SPELL_EFFECT_POWER_BURN:
-				case SPELL_EFFECT_ATTACK:
-				case SPELL_EFFECT_HEAL:
-				case SPELL_EFFECT_HEAL_MAX_HEALTH:
-				case SPELL_EFFECT_DUMMY:
-					continue;
-			}
 
-			switch(sp->EffectApplyAuraName[i])
-			{
-				case SPELL_AURA_PERIODIC_DAMAGE:
-				case SPELL_AURA_PROC_TRIGGER_DAMAGE:
-				case SPELL_AURA_PERIODIC_DAMAGE_PERCENT:
-				case SPELL_AURA_POWER_BURN:
-				case SPELL_AURA_PERIODIC_HEAL:
-				case SPELL_AURA_MOD_INCREASE_HEALTH:
-				case SPELL_AURA_PERIODIC_HEALTH_FUNNEL:
-				case SPELL_AURA_DUMMY:
-					continue;
-			}
+	// Disengage
+	// Only works in combat
+	if(sp->Id == 781)
+		sp->CustomFlags = CUSTOM_FLAG_SPELL_REQUIRES_COMBAT;
 
-			sp->spell_coef_flags |= SPELL_FLAG_ADITIONAL_EFFECT;
-			break;
+	//////////////////////////////////////////
+	// ROGUE								//
+	//////////////////////////////////////////
 
-		}
+	// Insert rogue spell fixes here
 
-		//Calculating fixed coeficients
-		//Channeled spells
-		if(sp->ChannelInterruptFlags != 0)
-		{
-			float Duration = float(GetDuration(dbcSpellDuration.LookupEntry(sp->DurationIndex)));
-			if(Duration < 1500) Duration = 1500;
-			else if(Duration > 7000) Duration = 7000;
-			sp->fixed_hotdotcoef = (Duration / 3500.0f);
-
-			if(sp->spell_coef_flags & SPELL_FLAG_ADITIONAL_EFFECT)
-				sp->fixed_hotdotcoef *= 0.95f;
-			if(sp->spell_coef_flags & SPELL_FLAG_AOE_SPELL)
-				sp->fixed_hotdotcoef *= 0.5f;
-		}
+	//////////////////////////////////////////
+	// PRIEST								//
+	//////////////////////////////////////////
+
+	//Borrowed Time
+	if(sp->NameHash == SPELL_HASH_BORROWED_TIME)
+	{
+		sp->procFlags = PROC_ON_CAST_SPELL;
+	}
 
-		//Standard spells
-		else if((sp->spell_coef_flags & SPELL_FLAG_IS_DD_OR_DH_SPELL) && !(sp->spell_coef_flags & SPELL_FLAG_IS_DOT_OR_HOT_SPELL))
+	//megai2: Grace http://www.wowhead.com/?spell=47516
+	if(sp->NameHash == SPELL_HASH_GRACE)
+	{
+		switch(sp->Id)
 		{
-			sp->fixed_dddhcoef = sp->casttime_coef;
-			if(sp->spell_coef_flags & SPELL_FLAG_ADITIONAL_EFFECT)
-				sp->fixed_dddhcoef *= 0.95f;
-			if(sp->spell_coef_flags & SPELL_FLAG_AOE_SPELL)
-				sp->fixed_dddhcoef *= 0.5f;
+			case 47516:	// Rank 1
+			case 47517:	// Rank 2
+				sp->procFlags = PROC_ON_CAST_SPELL;
+				break;
+
+			case 47930:
+				sp->rangeIndex = 4;
+				break;
 		}
+	}
 
-		//Over-time spells
-		else if(!(sp->spell_coef_flags & SPELL_FLAG_IS_DD_OR_DH_SPELL) && (sp->spell_coef_flags & SPELL_FLAG_IS_DOT_OR_HOT_SPELL))
-		{
-			float Duration = float(GetDuration(dbcSpellDuration.LookupEntry(sp->DurationIndex)));
-			sp->fixed_hotdotcoef = (Duration / 15000.0f);
+	//////////////////////////////////////////
+	// SHAMAN								//
+	//////////////////////////////////////////
 
-			if(sp->spell_coef_flags & SPELL_FLAG_ADITIONAL_EFFECT)
-				sp->fixed_hotdotcoef *= 0.95f;
-			if(sp->spell_coef_flags & SPELL_FLAG_AOE_SPELL)
-				sp->fixed_hotdotcoef *= 0.5f;
+	// Insert shaman spell fixes here
 
-		}
+	// Flametongue Totem passive target fix
+	if(sp->NameHash == SPELL_HASH_FLAMETONGUE_TOTEM && sp->Attributes & ATTRIBUTES_PASSIVE)
+	{
+		sp->EffectImplicitTargetA[0] = EFF_TARGET_SELF;
+		sp->EffectImplicitTargetB[0] = 0;
+		sp->EffectImplicitTargetA[1] = EFF_TARGET_SELF;
+		sp->EffectImplicitTargetB[1] = 0;
+	}
 
-		//Combined standard and over-time spells
-		else if(sp->spell_coef_flags & SPELL_FLAG_IS_DD_DH_DOT_SPELL)
-		{
-			float Duration = float(GetDuration(dbcSpellDuration.LookupEntry(sp->DurationIndex)));
-			float Portion_to_Over_Time = (Duration / 15000.0f) / ((Duration / 15000.0f) + sp->casttime_coef);
-			float Portion_to_Standard = 1.0f - Portion_to_Over_Time;
+	// Frostbrand Weapon - 10% spd coefficient
+	if(sp->NameHash == SPELL_HASH_FROSTBRAND_ATTACK)
+		sp->fixed_dddhcoef = 0.1f;
 
-			sp->fixed_dddhcoef = sp->casttime_coef * Portion_to_Standard;
-			sp->fixed_hotdotcoef = (Duration / 15000.0f) * Portion_to_Over_Time;
+	// Fire Nova - 0% spd coefficient
+	if(sp->NameHash == SPELL_HASH_FIRE_NOVA)
+		sp->fixed_dddhcoef = 0.0f;
 
-			if(sp->spell_coef_flags & SPELL_FLAG_ADITIONAL_EFFECT)
-			{
-				sp->fixed_dddhcoef *= 0.95f;
-				sp->fixed_hotdotcoef *= 0.95f;
-			}
-			if(sp->spell_coef_flags & SPELL_FLAG_AOE_SPELL)
-			{
-				sp->fixed_dddhcoef *= 0.5f;
-				sp->fixed_hotdotcoef *= 0.5f;
-			}
-		}
+	// Searing Totem - 8% spd coefficient
+	if(sp->NameHash == SPELL_HASH_ATTACK)
+		sp->fixed_dddhcoef = 0.08f;
 
-		//////////////////////////////////////////////////////
-		// CLASS-SPECIFIC SPELL FIXES						//
-		//////////////////////////////////////////////////////
+	// Healing Stream Totem - 8% healing coefficient
+	if(sp->NameHash == SPELL_HASH_HEALING_STREAM)
+		sp->OTspell_coef_override = 0.08f;
 
-		/* Note: when applying spell hackfixes, please follow a template */
-		/* Please don't put fixes like "sp = CheckAndReturnSpellEntry( 15270 );" inside the loop */
+	// Nature's Guardian
+	if(sp->NameHash == SPELL_HASH_NATURE_S_GUARDIAN)
+	{
+		sp->procFlags = PROC_ON_SPELL_HIT_VICTIM | PROC_ON_MELEE_ATTACK_VICTIM |
+		                PROC_ON_RANGED_ATTACK_VICTIM | PROC_ON_ANY_DAMAGE_VICTIM;
+		sp->proc_interval = 5000;
+		sp->EffectTriggerSpell[0] = 31616;
+	}
 
-		//////////////////////////////////////////
-		// WARRIOR								//
-		//////////////////////////////////////////
+	if(sp->NameHash == SPELL_HASH_HEX)
+	{
+		sp->AuraInterruptFlags |= AURA_INTERRUPT_ON_UNUSED2;
+	}
 
+	//////////////////////////////////////////
+	// MAGE									//
+	//////////////////////////////////////////
 
+	//////////////////////////////////////////
+	// WARLOCK								//
+	//////////////////////////////////////////
 
-		//////////////////////////////////////////
-		// PALADIN								//
-		//////////////////////////////////////////
+	//////////////////////////////////////////
+	// DRUID								//
+	//////////////////////////////////////////
 
-		// Insert paladin spell fixes here
+	// Dash
+	if(sp->NameHash == SPELL_HASH_DASH)
+	{
+		// mask for FORM_CAT(1) = 1 << (1 - 1), which is 1
+		sp->RequiredShapeShift = 1;
+	}
+}
 
-		// Shield of Righteousness
-		if(sp->NameHash == SPELL_HASH_SHIELD_OF_RIGHTEOUSNESS)
-		{
-			sp->School = SCHOOL_HOLY;
-			sp->Effect[0] = SPELL_EFFECT_DUMMY;
-			sp->Effect[1] = SPELL_EFFECT_NULL; //hacks, handling it in Spell::SpellEffectSchoolDMG(uint32 i)
-			sp->Effect[2] = SPELL_EFFECT_SCHOOL_DAMAGE; //hack
-		}
+static void RunNormalFixBatch(SpellFixBatch* batch)
+{
+	for(std::vector< uint32 >::iterator itr = batch->rows.begin(); itr != batch->rows.end(); ++itr)
+		ApplyNormalFixesToRow(dbcSpell.LookupRow(*itr), *itr, *batch->talentSpells, &batch->missingTriggers);
+}
 
-		// Paladin - Consecration
-		if(sp->NameHash == SPELL_HASH_CONSECRATION)
-		{
-			sp->School = SCHOOL_HOLY; //Consecration is a holy redirected spell.
-			sp->Spell_Dmg_Type = SPELL_DMG_TYPE_MAGIC; //Speaks for itself.
-		}
+static void RunCoefficientFixBatch(SpellFixBatch* batch)
+{
+	for(std::vector< uint32 >::iterator itr = batch->rows.begin(); itr != batch->rows.end(); ++itr)
+		ApplyCoefficientFixesToRow(dbcSpell.LookupRow(*itr));
+}
 
-		if(sp->NameHash == SPELL_HASH_SEALS_OF_THE_PURE)
-		{
-			sp->EffectSpellClassMask[0][0] = 0x08000400;
-			sp->EffectSpellClassMask[0][1] = 0x20000000;
-			sp->EffectSpellClassMask[1][1] = 0x800;
-		}
+//Runs the batches on the worker threads of the task list and waits for them. The batches are deleted by the caller.
+static void RunSpellFixBatches(TaskList & tl, std::vector< SpellFixBatch* > & batches, void (*run)(SpellFixBatch*))
+{
+	for(std::vector< SpellFixBatch* >::iterator itr = batches.begin(); itr != batches.end(); ++itr)
+		tl.AddTask(new Task(new CallBackFunctionP1< SpellFixBatch* >(run, *itr)));
 
-		//////////////////////////////////////////
-		// HUNTER								//
-		//////////////////////////////////////////
+	tl.wait();
+}
 
-		// THESE FIXES ARE GROUPED FOR CODE CLEANLINESS.
-		//Mend Pet
-		if(sp->NameHash == SPELL_HASH_MEND_PET)
-			sp->ChannelInterruptFlags = 0;
+static uint32 HashBytes(uint32 hash, const void* data, size_t size)
+{
+	const uint8* p = static_cast< const uint8* >(data);
+	for(size_t i = 0; i < size; ++i)
+	{
+		hash ^= p[ i ];
+		hash *= 16777619U;
+	}
+	return hash;
+}
 
+static uint32 HashSpellEntry(uint32 hash, SpellEntry* sp)
+{
+	SpellEntry copy;
+	memcpy(&copy, sp, sizeof(SpellEntry));
 
-		// Disengage
-		// Only works in combat
-		if(sp->Id == 781)
-			sp->CustomFlags = CUSTOM_FLAG_SPELL_REQUIRES_COMBAT;
+	// pointers change from run to run, hash the strings and whether there is a factory instead
+	const char* strings[ 4 ] = { copy.Name, copy.Rank, copy.Description, copy.BuffDescription };
+	for(uint32 i = 0; i < 4; ++i)
+	{
+		if(strings[ i ] != NULL)
+			hash = HashBytes(hash, strings[ i ], strlen(strings[ i ]) + 1);
+	}
 
-		//////////////////////////////////////////
-		// ROGUE								//
-		//////////////////////////////////////////
+	uint8 factories = uint8((copy.SpellFactoryFunc != NULL ? 1 : 0) | (copy.AuraFactoryFunc != NULL ? 2 : 0));
+	hash = HashBytes(hash, &factories, 1);
 
-		// Insert rogue spell fixes here
+	copy.Name = NULL;
+	copy.Rank = NULL;
+	copy.Description = NULL;
+	copy.BuffDescription = NULL;
+	copy.SpellFactoryFunc = NULL;
+	copy.AuraFactoryFunc = NULL;
 
-		//////////////////////////////////////////
-		// PRIEST								//
-		//////////////////////////////////////////
+	return HashBytes(hash, &copy, sizeof(SpellEntry));
+}
 
-		//Borrowed Time
-		if(sp->NameHash == SPELL_HASH_BORROWED_TIME)
-		{
-			sp->procFlags = PROC_ON_CAST_SPELL;
-		}
+//////////////////////////////////////////////////////////////////////////////////////////
+//static uint32 HashSpellTable()
+// Hashes every row of spell.dbc and the dummy spells created for it, so the result
+// of the parallel and the serial spell fixes can be compared between two startups.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+static uint32 HashSpellTable()
+{
+	uint32 hash = 2166136261U;
 
-		//megai2: Grace http://www.wowhead.com/?spell=47516
-		if(sp->NameHash == SPELL_HASH_GRACE)
-		{
-			switch(sp->Id)
-			{
-				case 47516:	// Rank 1
-				case 47517:	// Rank 2
-					sp->procFlags = PROC_ON_CAST_SPELL;
-					break;
+	for(uint32 x = 0; x < dbcSpell.GetNumRows(); ++x)
+		hash = HashSpellEntry(hash, dbcSpell.LookupRow(x));
 
-				case 47930:
-					sp->rangeIndex = 4;
-					break;
-			}
-		}
+	for(std::list< SpellEntry* >::iterator itr = sWorld.dummyspells.begin(); itr != sWorld.dummyspells.end(); ++itr)
+		hash = HashSpellEntry(hash, *itr);
+
+	return hash;
+}
+
+void ApplyNormalFixes(TaskList & tl)
+{
+	//Updating spell.dbc
+
+	Log.Success("World", "Processing %u spells...", dbcSpell.GetNumRows());
+
+	//checking if the DBCs have been extracted from an english client, based on namehash of spell 4, the first with a different name in non-english DBCs
+	SpellEntry* sp = dbcSpell.LookupEntry(4);
+	if(crc32((const unsigned char*)sp->Name, (unsigned int)strlen(sp->Name)) != SPELL_HASH_WORD_OF_RECALL_OTHER)
+	{
+		Log.LargeErrorMessage("You are using DBCs extracted from an unsupported client.", "ArcEmu supports only enUS and enGB!!!", NULL);
+		abort();
+	}
 
-		//////////////////////////////////////////
-		// SHAMAN								//
-		//////////////////////////////////////////
+	uint32 cnt = dbcSpell.GetNumRows();
+
+	map<uint32, uint32> talentSpells;
+	uint32 i, j;
+	for(i = 0; i < dbcTalent.GetNumRows(); ++i)
+	{
+		TalentEntry* tal = dbcTalent.LookupRow(i);
+		for(j = 0; j < 5; ++j)
+			if(tal->RankID[j] != 0)
+				talentSpells.insert(make_pair(tal->RankID[j], tal->TalentTree));
 
-		// Insert shaman spell fixes here
+	}
 
-		// Flametongue Totem passive target fix
-		if(sp->NameHash == SPELL_HASH_FLAMETONGUE_TOTEM && sp->Attributes & ATTRIBUTES_PASSIVE)
+	// spell fixes are order dependent where rows share strings or write to each other, those rows stay in one batch
+	bool parallel = Config.MainConfig.GetBoolDefault("Startup", "EnableMultithreadedLoading", true);
+	std::vector< SpellFixBatch* > batches;
+	if(parallel)
+	{
+		SpellRowGroups groups(cnt);
+		if(GroupNormalFixRows(groups, cnt))
+			groups.MakeBatches(SPELLFIX_BATCH_COUNT, batches);
+		else
 		{
-			sp->EffectImplicitTargetA[0] = EFF_TARGET_SELF;
-			sp->EffectImplicitTargetB[0] = 0;
-			sp->EffectImplicitTargetA[1] = EFF_TARGET_SELF;
-			sp->EffectImplicitTargetB[1] = 0;
+			Log.Notice("World", "A profession spell teaches a spell missing from Spell.dbc, fixing spells serially.");
+			parallel = false;
 		}
+	}
 
-		// Frostbrand Weapon - 10% spd coefficient
-		if(sp->NameHash == SPELL_HASH_FROSTBRAND_ATTACK)
-			sp->fixed_dddhcoef = 0.1f;
-
-		// Fire Nova - 0% spd coefficient
-		if(sp->NameHash == SPELL_HASH_FIRE_NOVA)
-			sp->fixed_dddhcoef = 0.0f;
+	if(parallel)
+	{
+		std::vector< MissingTriggerSpell > missingTriggers;
 
-		// Searing Totem - 8% spd coefficient
-		if(sp->NameHash == SPELL_HASH_ATTACK)
-			sp->fixed_dddhcoef = 0.08f;
+		for(std::vector< SpellFixBatch* >::iterator itr = batches.begin(); itr != batches.end(); ++itr)
+			(*itr)->talentSpells = &talentSpells;
 
-		// Healing Stream Totem - 8% healing coefficient
-		if(sp->NameHash == SPELL_HASH_HEALING_STREAM)
-			sp->OTspell_coef_override = 0.08f;
+		RunSpellFixBatches(tl, batches, &RunNormalFixBatch);
 
-		// Nature's Guardian
-		if(sp->NameHash == SPELL_HASH_NATURE_S_GUARDIAN)
+		for(std::vector< SpellFixBatch* >::iterator itr = batches.begin(); itr != batches.end(); ++itr)
 		{
-			sp->procFlags = PROC_ON_SPELL_HIT_VICTIM | PROC_ON_MELEE_ATTACK_VICTIM |
-			                PROC_ON_RANGED_ATTACK_VICTIM | PROC_ON_ANY_DAMAGE_VICTIM;
-			sp->proc_interval = 5000;
-			sp->EffectTriggerSpell[0] = 31616;
+			missingTriggers.insert(missingTriggers.end(), (*itr)->missingTriggers.begin(), (*itr)->missingTriggers.end());
+			delete *itr;
 		}
+		batches.clear();
 
-		if(sp->NameHash == SPELL_HASH_HEX)
+		// create the dummy trigger spells in the same order as the serial loop does, a spell id can be missing from several rows
+		std::stable_sort(missingTriggers.begin(), missingTriggers.end(), MissingTriggerRowLess);
+		for(std::vector< MissingTriggerSpell >::iterator itr = missingTriggers.begin(); itr != missingTriggers.end(); ++itr)
 		{
-			sp->AuraInterruptFlags |= AURA_INTERRUPT_ON_UNUSED2;
+			if(dbcSpell.LookupEntryForced(itr->spellId) == NULL)
+				CreateDummySpell(itr->spellId);
 		}
+	}
+	else
+	{
+		for(uint32 x = 0; x < cnt; x++)
+			ApplyNormalFixesToRow(dbcSpell.LookupRow(x), x, talentSpells, NULL);
+	}
 
-		//////////////////////////////////////////
-		// MAGE									//
-		//////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////
+	//SPELL COEFFICIENT SETTINGS START
+	//////////////////////////////////////////////////////////////////
 
-		//////////////////////////////////////////
-		// WARLOCK								//
-		//////////////////////////////////////////
+	if(parallel)
+	{
+		SpellRowGroups groups(cnt);
+		GroupCoefficientFixRows(groups, cnt);
+		groups.MakeBatches(SPELLFIX_BATCH_COUNT, batches);
 
-		//////////////////////////////////////////
-		// DRUID								//
-		//////////////////////////////////////////
+		RunSpellFixBatches(tl, batches, &RunCoefficientFixBatch);
 
-		// Dash
-		if(sp->NameHash == SPELL_HASH_DASH)
-		{
-			// mask for FORM_CAT(1) = 1 << (1 - 1), which is 1
-			sp->RequiredShapeShift = 1;
-		}
+		for(std::vector< SpellFixBatch* >::iterator itr = batches.begin(); itr != batches.end(); ++itr)
+			delete *itr;
+		batches.clear();
+	}
+	else
+	{
+		for(uint32 x = 0; x < cnt; x++)
+			ApplyCoefficientFixesToRow(dbcSpell.LookupRow(x));
 	}
-	// END OF LOOP
 
 	//Settings for special cases
 	QueryResult* resultx = WorldDatabase.Query("SELECT * FROM spell_coef_override");
@@ -1310,6 +1705,7 @@ void ApplyNormalFixes()
 	}
 
 	//Fully loaded coefficients, we must share channeled coefficient to its triggered spells
+	//this writes to the triggered rows, so it stays serial
 	for(uint32 x = 0; x < cnt; x++)
 	{
 		// get spellentry
@@ -7045,4 +7441,7 @@ void ApplyNormalFixes()
 			ritOfSumm->Id = ritOfSummId;
 		}
 	}
+
+	if(Config.MainConfig.GetBoolDefault("Startup", "SpellTableHash", false))
+		Log.Notice("World", "Spell table hash: %08X", HashSpellTable());
 }
\ No newline at end of file
@@ -755,7 +755,7 @@ void Item::ApplyEnchantmentBonus(uint32 Slot, bool Apply)
 							m_owner->ModPosDamageDoneMod(SCHOOL_NORMAL, val);
 						else
 							m_owner->ModPosDamageDoneMod(SCHOOL_NORMAL, -val);
-						m_owner->CalcDamage();
+						m_owner->MarkStatsDirty(PLAYER_STATS_DIRTY_DAMAGE);
 					}
 					break;
 
@@ -814,7 +814,7 @@ void Item::ApplyEnchantmentBonus(uint32 Slot, bool Apply)
 							val = RANDOM_SUFFIX_MAGIC_CALCULATION(RandomSuffixAmount, GetItemRandomSuffixFactor());
 
 						m_owner->ModifyBonuses(Entry->spell[c], val, Apply);
-						m_owner->UpdateStats();
+						m_owner->MarkStatsDirty(PLAYER_STATS_DIRTY_STATS);
 					}
 					break;
 
@@ -840,7 +840,7 @@ void Item::ApplyEnchantmentBonus(uint32 Slot, bool Apply)
 							int32 value = - (int32)(GetProto()->Delay * val / 1000);
 							m_owner->ModPosDamageDoneMod(SCHOOL_NORMAL, value);
 						}
-						m_owner->CalcDamage();
+						m_owner->MarkStatsDirty(PLAYER_STATS_DIRTY_DAMAGE);
 					}
 					break;
 
@@ -3268,7 +3268,7 @@ void ItemInterface::SwapItemSlots(int8 srcslot, int8 dstslot)
 		if(m_pItems[(int)srcslot] != NULL)
 			m_pOwner->ApplyItemMods(m_pItems[(int)srcslot], srcslot, true);
 		else if(srcslot == EQUIPMENT_SLOT_MAINHAND || srcslot == EQUIPMENT_SLOT_OFFHAND)
-			m_pOwner->CalcDamage();
+			m_pOwner->MarkStatsDirty(PLAYER_STATS_DIRTY_DAMAGE);
 	}
 
 	//dst item is equipped now
@@ -3277,7 +3277,7 @@ void ItemInterface::SwapItemSlots(int8 srcslot, int8 dstslot)
 		if(m_pItems[(int)dstslot] != NULL)
 			m_pOwner->ApplyItemMods(m_pItems[(int)dstslot], dstslot, true);
 		else if(dstslot == EQUIPMENT_SLOT_MAINHAND || dstslot == EQUIPMENT_SLOT_OFFHAND)
-			m_pOwner->CalcDamage();
+			m_pOwner->MarkStatsDirty(PLAYER_STATS_DIRTY_DAMAGE);
 	}
 
 	//Recalculate Expertise (for Weapon specs)
@@ -260,6 +260,79 @@ bool ChatHandler::HandleNetworkStatusCommand(const char* args, WorldSession* m_s
 	return true;
 }
 
+bool ChatHandler::HandleMovementStatsCommand(const char* args, WorldSession* m_session)
+{
+	MapMgr* mgr = m_session->GetPlayer()->GetMapMgr();
+	if(mgr == NULL)
+		return true;
+
+	MovementRelayStats & stats = mgr->m_movementRelayStats;
+	GreenSystemMessage(m_session, "Movement relay on map %u instance %u:", mgr->GetMapId(), mgr->GetInstanceID());
+	GreenSystemMessage(m_session, "Packets sent: |r%.1f/s", stats.packetsPerSec);
+	GreenSystemMessage(m_session, "Bytes sent: |r%.1f/s", stats.bytesPerSec);
+	GreenSystemMessage(m_session, "Heartbeats held back: |r%.1f/s", stats.skippedPerSec);
+	return true;
+}
+
+bool ChatHandler::HandlePartyUpdateStatsCommand(const char* args, WorldSession* m_session)
+{
+	MapMgr* mgr = m_session->GetPlayer()->GetMapMgr();
+	if(mgr == NULL)
+		return true;
+
+	PartyUpdateStats & stats = mgr->m_partyUpdateStats;
+	GreenSystemMessage(m_session, "Party member stats on map %u instance %u:", mgr->GetMapId(), mgr->GetInstanceID());
+	GreenSystemMessage(m_session, "Stat changes: |r%.1f/s", stats.changesPerSec);
+	GreenSystemMessage(m_session, "Packets sent: |r%.1f/s, %.1f/s if every change was sent right away", stats.packetsPerSec, stats.oldPacketsPerSec);
+	GreenSystemMessage(m_session, "Bytes sent: |r%.1f/s", stats.bytesPerSec);
+	return true;
+}
+
+bool ChatHandler::HandleSpellPoolStatsCommand(const char* args, WorldSession* m_session)
+{
+	SpellPoolStats stats;
+	SpellPool::GetStats(stats);
+
+	uint64 spellAllocs = stats.spellsCreated - stats.spellsReused;
+	uint64 listAllocs = stats.listsAcquired - stats.listsReused;
+
+	GreenSystemMessage(m_session, "Spells created: |r" I64FMTD, stats.spellsCreated);
+	GreenSystemMessage(m_session, "Spells allocated from the heap: |r" I64FMTD " (%.1f%%)", spellAllocs, stats.spellsCreated ? 100.0f * spellAllocs / stats.spellsCreated : 0.0f);
+	GreenSystemMessage(m_session, "Target lists without a recycled buffer: |r" I64FMTD " (%.2f per spell)", listAllocs, stats.spellsCreated ? float(listAllocs) / stats.spellsCreated : 0.0f);
+
+	// Without the pools every spell and every target list it filled took a heap block. With them only the
+	// spells without a recycled block and the lists filled without a recycled buffer do. Regrowing lists are
+	// left out of both.
+	if(stats.spellsCreated)
+	{
+		uint64 before = stats.spellsCreated + stats.listsFilled;
+		uint64 after = spellAllocs + (stats.listsFilled > stats.listsReused ? stats.listsFilled - stats.listsReused : 0);
+		GreenSystemMessage(m_session, "Heap allocations per spell: |r%.2f with the pools, %.2f without", float(after) / stats.spellsCreated, float(before) / stats.spellsCreated);
+	}
+	return true;
+}
+
+bool ChatHandler::HandlePathfindingStatsCommand(const char* args, WorldSession* m_session)
+{
+	std::map< uint32, PathfindingStats > stats;
+	sPathfindingMgr.GetStats(stats);
+
+	if(stats.empty())
+	{
+		RedSystemMessage(m_session, "No paths were calculated yet.");
+		return true;
+	}
+
+	for(std::map< uint32, PathfindingStats >::iterator itr = stats.begin(); itr != stats.end(); ++itr)
+	{
+		PathfindingStats & s = itr->second;
+		GreenSystemMessage(m_session, "Map %u: |r" I64FMTD " paths, " I64FMTD " merged, " I64FMTD " cached corridors, " I64FMTD " failed, %.2f ms average, %.2f ms max",
+		                   itr->first, s.requests, s.merged, s.cacheHits, s.failures, s.requests ? s.totalTime / 1000.0f / s.requests : 0.0f, s.maxTime / 1000.0f);
+		GreenSystemMessage(m_session, "Map %u chases: |r" I64FMTD " fields built, " I64FMTD " paths walked from them", itr->first, s.chaseFields, s.chasePaths);
+	}
+	return true;
+}
+
 bool ChatHandler::HandleNYICommand(const char* args, WorldSession* m_session)
 {
 	RedSystemMessage(m_session, "Not yet implemented.");
@@ -27,7 +27,7 @@
 #define CREATURESPAWNSFIELDCOUNT 27
 #define GOSPAWNSFIELDCOUNT		 18
 
-Map::Map(uint32 mapid, MapInfo* inf)
+Map::Map(uint32 mapid, MapInfo* inf, SpawnTableLoader* loader)
 {
 	memset(spawns, 0, sizeof(CellSpawns*) * _sizeX);
 
@@ -35,7 +35,10 @@ Map::Map(uint32 mapid, MapInfo* inf)
 	_mapId = mapid;
 
 	//new stuff Load Spawns
-	LoadSpawns(false);
+	if(loader != NULL)
+		LoadSpawns(loader);
+	else
+		LoadSpawns(false);
 
 	// get our name
 	me = dbcMap.LookupEntry(_mapId);
@@ -115,6 +118,75 @@ bool CheckResultLengthGameObject(QueryResult* res)
 		return true;
 }
 
+static CreatureSpawn* ReadCreatureSpawn(Field* fields, bool staticSpawn)
+{
+	CreatureSpawn* cspawn = new CreatureSpawn;
+	cspawn->id = fields[0].GetUInt32();
+	cspawn->form = FormationMgr::getSingleton().GetFormation(cspawn->id);
+	cspawn->entry = fields[1].GetUInt32();
+	cspawn->x = fields[3].GetFloat();
+	cspawn->y = fields[4].GetFloat();
+	cspawn->z = fields[5].GetFloat();
+	cspawn->o = fields[6].GetFloat();
+	cspawn->movetype = fields[7].GetUInt8();
+	cspawn->displayid = fields[8].GetUInt32();
+	cspawn->factionid = fields[9].GetUInt32();
+	cspawn->flags = fields[10].GetUInt32();
+	cspawn->bytes0 = fields[11].GetUInt32();
+	cspawn->bytes1 = fields[12].GetUInt32();
+	cspawn->bytes2 = fields[13].GetUInt32();
+	cspawn->emote_state = fields[14].GetUInt32();
+	//cspawn->respawnNpcLink = fields[15].GetUInt32();
+	if(staticSpawn)
+	{
+		cspawn->channel_spell = 0;
+		cspawn->channel_target_creature = 0;
+		cspawn->channel_target_go = 0;
+	}
+	else
+	{
+		cspawn->channel_spell = fields[16].GetUInt16();
+		cspawn->channel_target_go = fields[17].GetUInt32();
+		cspawn->channel_target_creature = fields[18].GetUInt32();
+	}
+	cspawn->stand_state = fields[19].GetUInt16();
+	cspawn->death_state = fields[20].GetUInt32();
+	cspawn->MountedDisplayID = fields[21].GetUInt32();
+	cspawn->Item1SlotDisplay = fields[22].GetUInt32();
+	cspawn->Item2SlotDisplay = fields[23].GetUInt32();
+	cspawn->Item3SlotDisplay = fields[24].GetUInt32();
+	cspawn->CanFly = fields[25].GetUInt32();
+	cspawn->phase = fields[26].GetUInt32();
+	if(cspawn->phase == 0) cspawn->phase = 0xFFFFFFFF;
+
+	return cspawn;
+}
+
+static GOSpawn* ReadGOSpawn(Field* fields)
+{
+	GOSpawn* gspawn = new GOSpawn;
+	gspawn->entry = fields[1].GetUInt32();
+	gspawn->id = fields[0].GetUInt32();
+	gspawn->x = fields[3].GetFloat();
+	gspawn->y = fields[4].GetFloat();
+	gspawn->z = fields[5].GetFloat();
+	gspawn->facing = fields[6].GetFloat();
+	gspawn->o = fields[7].GetFloat();
+	gspawn->o1 = fields[8].GetFloat();
+	gspawn->o2 = fields[9].GetFloat();
+	gspawn->o3 = fields[10].GetFloat();
+	gspawn->state = fields[11].GetUInt32();
+	gspawn->flags = fields[12].GetUInt32();
+	gspawn->faction = fields[13].GetUInt32();
+	gspawn->scale = fields[14].GetFloat();
+	//gspawn->stateNpcLink = fields[15].GetUInt32();
+	gspawn->phase = fields[16].GetUInt32();
+	if(gspawn->phase == 0) gspawn->phase = 0xFFFFFFFF;
+	gspawn->overrides = fields[17].GetUInt32();
+
+	return gspawn;
+}
+
 void Map::LoadSpawns(bool reload)
 {
 	//uint32 st=getMSTime();
@@ -145,51 +217,7 @@ void Map::LoadSpawns(bool reload)
 			{
 				do
 				{
-					Field* fields = result->Fetch();
-					CreatureSpawn* cspawn = new CreatureSpawn;
-					cspawn->id = fields[0].GetUInt32();
-					cspawn->form = FormationMgr::getSingleton().GetFormation(cspawn->id);
-					cspawn->entry = fields[1].GetUInt32();
-					cspawn->x = fields[3].GetFloat();
-					cspawn->y = fields[4].GetFloat();
-					cspawn->z = fields[5].GetFloat();
-					cspawn->o = fields[6].GetFloat();
-					/*uint32 cellx=float2int32(((_maxX-cspawn->x)/_cellSize));
-					uint32 celly=float2int32(((_maxY-cspawn->y)/_cellSize));*/
-					uint32 cellx = CellHandler<MapMgr>::GetPosX(cspawn->x);
-					uint32 celly = CellHandler<MapMgr>::GetPosY(cspawn->y);
-					if(spawns[cellx] == NULL)
-					{
-						spawns[cellx] = new CellSpawns*[_sizeY];
-						memset(spawns[cellx], 0, sizeof(CellSpawns*)*_sizeY);
-					}
-
-					if(!spawns[cellx][celly])
-						spawns[cellx][celly] = new CellSpawns;
-					cspawn->movetype = fields[7].GetUInt8();
-					cspawn->displayid = fields[8].GetUInt32();
-					cspawn->factionid = fields[9].GetUInt32();
-					cspawn->flags = fields[10].GetUInt32();
-					cspawn->bytes0 = fields[11].GetUInt32();
-					cspawn->bytes1 = fields[12].GetUInt32();
-					cspawn->bytes2 = fields[13].GetUInt32();
-					cspawn->emote_state = fields[14].GetUInt32();
-					//cspawn->respawnNpcLink = fields[15].GetUInt32();
-					cspawn->channel_spell = fields[16].GetUInt16();
-					cspawn->channel_target_go = fields[17].GetUInt32();
-					cspawn->channel_target_creature = fields[18].GetUInt32();
-					cspawn->stand_state = fields[19].GetUInt16();
-					cspawn->death_state = fields[20].GetUInt32();
-					cspawn->MountedDisplayID = fields[21].GetUInt32();
-					cspawn->Item1SlotDisplay = fields[22].GetUInt32();
-					cspawn->Item2SlotDisplay = fields[23].GetUInt32();
-					cspawn->Item3SlotDisplay = fields[24].GetUInt32();
-					cspawn->CanFly = fields[25].GetUInt32();
-					cspawn->phase = fields[26].GetUInt32();
-					if(cspawn->phase == 0) cspawn->phase = 0xFFFFFFFF;
-
-					spawns[cellx][celly]->CreatureSpawns.push_back(cspawn);
-					++CreatureSpawnCount;
+					AddCreatureSpawn(ReadCreatureSpawn(result->Fetch(), false), false);
 				}
 				while(result->NextRow());
 			}
@@ -205,38 +233,7 @@ void Map::LoadSpawns(bool reload)
 		{
 			do
 			{
-				Field* fields = result->Fetch();
-				CreatureSpawn* cspawn = new CreatureSpawn;
-				cspawn->id = fields[0].GetUInt32();
-				cspawn->form = FormationMgr::getSingleton().GetFormation(cspawn->id);
-				cspawn->entry = fields[1].GetUInt32();
-				cspawn->x = fields[3].GetFloat();
-				cspawn->y = fields[4].GetFloat();
-				cspawn->z = fields[5].GetFloat();
-				cspawn->o = fields[6].GetFloat();
-				cspawn->movetype = fields[7].GetUInt8();
-				cspawn->displayid = fields[8].GetUInt32();
-				cspawn->factionid = fields[9].GetUInt32();
-				cspawn->flags = fields[10].GetUInt32();
-				cspawn->bytes0 = fields[11].GetUInt32();
-				cspawn->bytes1 = fields[12].GetUInt32();
-				cspawn->bytes2 = fields[13].GetUInt32();
-				cspawn->emote_state = fields[14].GetUInt32();
-				//cspawn->respawnNpcLink = fields[15].GetUInt32();
-				cspawn->channel_spell = 0;
-				cspawn->channel_target_creature = 0;
-				cspawn->channel_target_go = 0;
-				cspawn->stand_state = fields[19].GetUInt16();
-				cspawn->death_state = fields[20].GetUInt32();
-				cspawn->MountedDisplayID = fields[21].GetUInt32();
-				cspawn->Item1SlotDisplay = fields[22].GetUInt32();
-				cspawn->Item2SlotDisplay = fields[23].GetUInt32();
-				cspawn->Item3SlotDisplay = fields[24].GetUInt32();
-				cspawn->CanFly = fields[25].GetUInt32();
-				cspawn->phase = fields[26].GetUInt32();
-				if(cspawn->phase == 0) cspawn->phase = 0xFFFFFFFF;
-				staticSpawns.CreatureSpawns.push_back(cspawn);
-				++CreatureSpawnCount;
+				AddCreatureSpawn(ReadCreatureSpawn(result->Fetch(), true), true);
 			}
 			while(result->NextRow());
 		}
@@ -252,28 +249,7 @@ void Map::LoadSpawns(bool reload)
 		{
 			do
 			{
-				Field* fields = result->Fetch();
-				GOSpawn* gspawn = new GOSpawn;
-				gspawn->entry = fields[1].GetUInt32();
-				gspawn->id = fields[0].GetUInt32();
-				gspawn->x = fields[3].GetFloat();
-				gspawn->y = fields[4].GetFloat();
-				gspawn->z = fields[5].GetFloat();
-				gspawn->facing = fields[6].GetFloat();
-				gspawn->o = fields[7].GetFloat();
-				gspawn->o1 = fields[8].GetFloat();
-				gspawn->o2 = fields[9].GetFloat();
-				gspawn->o3 = fields[10].GetFloat();
-				gspawn->state = fields[11].GetUInt32();
-				gspawn->flags = fields[12].GetUInt32();
-				gspawn->faction = fields[13].GetUInt32();
-				gspawn->scale = fields[14].GetFloat();
-				//gspawn->stateNpcLink = fields[15].GetUInt32();
-				gspawn->phase = fields[16].GetUInt32();
-				if(gspawn->phase == 0) gspawn->phase = 0xFFFFFFFF;
-				gspawn->overrides = fields[17].GetUInt32();
-				staticSpawns.GOSpawns.push_back(gspawn);
-				++GameObjectSpawnCount;
+				AddGOSpawn(ReadGOSpawn(result->Fetch()), true);
 			}
 			while(result->NextRow());
 		}
@@ -290,50 +266,7 @@ void Map::LoadSpawns(bool reload)
 			{
 				do
 				{
-					Field* fields = result->Fetch();
-					GOSpawn* gspawn = new GOSpawn;
-					gspawn->entry = fields[1].GetUInt32();
-					gspawn->id = fields[0].GetUInt32();
-					gspawn->x = fields[3].GetFloat();
-					gspawn->y = fields[4].GetFloat();
-					gspawn->z = fields[5].GetFloat();
-					gspawn->facing = fields[6].GetFloat();
-					gspawn->o = fields[7].GetFloat();
-					gspawn->o1 = fields[8].GetFloat();
-					gspawn->o2 = fields[9].GetFloat();
-					gspawn->o3 = fields[10].GetFloat();
-					gspawn->state = fields[11].GetUInt32();
-					gspawn->flags = fields[12].GetUInt32();
-					gspawn->faction = fields[13].GetUInt32();
-					gspawn->scale = fields[14].GetFloat();
-					//gspawn->stateNpcLink = fields[15].GetUInt32();
-					gspawn->phase = fields[16].GetUInt32();
-					if(gspawn->phase == 0) gspawn->phase = 0xFFFFFFFF;
-					gspawn->overrides = fields[17].GetUInt32();
-
-					if(gspawn->overrides & GAMEOBJECT_MAPWIDE)
-					{
-						staticSpawns.GOSpawns.push_back(gspawn); //We already have a staticSpawns in the Map class, and it does just the right thing
-						++GameObjectSpawnCount;
-					}
-					else
-					{
-						//uint32 cellx=float2int32(((_maxX-gspawn->x)/_cellSize));
-						//uint32 celly=float2int32(((_maxY-gspawn->y)/_cellSize));
-						uint32 cellx = CellHandler<MapMgr>::GetPosX(gspawn->x);
-						uint32 celly = CellHandler<MapMgr>::GetPosY(gspawn->y);
-						if(spawns[cellx] == NULL)
-						{
-							spawns[cellx] = new CellSpawns*[_sizeY];
-							memset(spawns[cellx], 0, sizeof(CellSpawns*)*_sizeY);
-						}
-
-						if(!spawns[cellx][celly])
-							spawns[cellx][celly] = new CellSpawns;
-
-						spawns[cellx][celly]->GOSpawns.push_back(gspawn);
-						++GameObjectSpawnCount;
-					}
+					AddGOSpawn(ReadGOSpawn(result->Fetch()), false);
 				}
 				while(result->NextRow());
 			}
@@ -343,4 +276,216 @@ void Map::LoadSpawns(bool reload)
 	}
 
 	Log.Notice("Map", "%u creatures / %u gameobjects on map %u cached.", CreatureSpawnCount, GameObjectSpawnCount, _mapId);
+}
+
+void Map::AddCreatureSpawn(CreatureSpawn* cspawn, bool staticSpawn)
+{
+	if(staticSpawn)
+		staticSpawns.CreatureSpawns.push_back(cspawn);
+	else
+	{
+		/*uint32 cellx=float2int32(((_maxX-cspawn->x)/_cellSize));
+		uint32 celly=float2int32(((_maxY-cspawn->y)/_cellSize));*/
+		uint32 cellx = CellHandler<MapMgr>::GetPosX(cspawn->x);
+		uint32 celly = CellHandler<MapMgr>::GetPosY(cspawn->y);
+		GetSpawnsListAndCreate(cellx, celly)->CreatureSpawns.push_back(cspawn);
+	}
+
+	++CreatureSpawnCount;
+}
+
+void Map::AddGOSpawn(GOSpawn* gspawn, bool staticSpawn)
+{
+	//We already have a staticSpawns in the Map class, and it does just the right thing
+	if(staticSpawn || (gspawn->overrides & GAMEOBJECT_MAPWIDE))
+		staticSpawns.GOSpawns.push_back(gspawn);
+	else
+	{
+		//uint32 cellx=float2int32(((_maxX-gspawn->x)/_cellSize));
+		//uint32 celly=float2int32(((_maxY-gspawn->y)/_cellSize));
+		uint32 cellx = CellHandler<MapMgr>::GetPosX(gspawn->x);
+		uint32 celly = CellHandler<MapMgr>::GetPosY(gspawn->y);
+		GetSpawnsListAndCreate(cellx, celly)->GOSpawns.push_back(gspawn);
+	}
+
+	++GameObjectSpawnCount;
+}
+
+void Map::LoadSpawns(SpawnTableLoader* loader)
+{
+	uint32 start = getMSTime();
+	CreatureSpawnCount = 0;
+	GameObjectSpawnCount = 0;
+
+	std::vector< SpawnTable* > & tables = loader->GetTables();
+	std::vector< SpawnTable* >::iterator itr;
+
+	// count the spawns of each cell first, so every list is allocated once at its final size
+	std::map< uint32, std::pair< uint32, uint32 > > cellCounts;
+	for(itr = tables.begin(); itr != tables.end(); ++itr)
+	{
+		SpawnTable* table = *itr;
+		if(table->type == SPAWN_TABLE_CREATURES)
+		{
+			CreatureSpawnList & list = table->creatures[ _mapId ];
+			for(CreatureSpawnList::iterator i = list.begin(); i != list.end(); ++i)
+				++cellCounts[(CellHandler<MapMgr>::GetPosX((*i)->x) << 16) | CellHandler<MapMgr>::GetPosY((*i)->y) ].first;
+		}
+		else if(table->type == SPAWN_TABLE_GAMEOBJECTS)
+		{
+			GOSpawnList & list = table->gameobjects[ _mapId ];
+			for(GOSpawnList::iterator i = list.begin(); i != list.end(); ++i)
+			{
+				if(!((*i)->overrides & GAMEOBJECT_MAPWIDE))
+					++cellCounts[(CellHandler<MapMgr>::GetPosX((*i)->x) << 16) | CellHandler<MapMgr>::GetPosY((*i)->y) ].second;
+			}
+		}
+	}
+
+	for(std::map< uint32, std::pair< uint32, uint32 > >::iterator c = cellCounts.begin(); c != cellCounts.end(); ++c)
+	{
+		CellSpawns* sp = GetSpawnsListAndCreate(c->first >> 16, c->first & 0xFFFF);
+		sp->CreatureSpawns.reserve(c->second.first);
+		sp->GOSpawns.reserve(c->second.second);
+	}
+
+	// same order as the queries of LoadSpawns( bool )
+	for(itr = tables.begin(); itr != tables.end(); ++itr)
+	{
+		SpawnTable* table = *itr;
+		switch(table->type)
+		{
+			case SPAWN_TABLE_CREATURES:
+			case SPAWN_TABLE_STATIC_CREATURES:
+				{
+					CreatureSpawnList & list = table->creatures[ _mapId ];
+					for(CreatureSpawnList::iterator i = list.begin(); i != list.end(); ++i)
+						AddCreatureSpawn(*i, table->type == SPAWN_TABLE_STATIC_CREATURES);
+
+					// the map owns them now
+					CreatureSpawnList().swap(list);
+				}
+				break;
+
+			case SPAWN_TABLE_STATIC_GAMEOBJECTS:
+			case SPAWN_TABLE_GAMEOBJECTS:
+				{
+					GOSpawnList & list = table->gameobjects[ _mapId ];
+					for(GOSpawnList::iterator i = list.begin(); i != list.end(); ++i)
+						AddGOSpawn(*i, table->type == SPAWN_TABLE_STATIC_GAMEOBJECTS);
+
+					GOSpawnList().swap(list);
+				}
+				break;
+		}
+	}
+
+	Log.Notice("Map", "%u creatures / %u gameobjects on map %u cached in %u ms.", CreatureSpawnCount, GameObjectSpawnCount, _mapId, getMSTime() - start);
+}
+
+SpawnTableLoader::SpawnTableLoader()
+{
+	// the order of LoadSpawns( bool ): creature tables, static creatures, static gameobjects, gameobject tables
+	std::vector< std::pair< string, SpawnTableType > > names;
+	for(set<string>::iterator itr = ExtraMapCreatureTables.begin(); itr != ExtraMapCreatureTables.end(); ++itr)
+		names.push_back(std::make_pair(*itr, SPAWN_TABLE_CREATURES));
+	names.push_back(std::make_pair(string("creature_staticspawns"), SPAWN_TABLE_STATIC_CREATURES));
+	names.push_back(std::make_pair(string("gameobject_staticspawns"), SPAWN_TABLE_STATIC_GAMEOBJECTS));
+	for(set<string>::iterator itr = ExtraMapGameObjectTables.begin(); itr != ExtraMapGameObjectTables.end(); ++itr)
+		names.push_back(std::make_pair(*itr, SPAWN_TABLE_GAMEOBJECTS));
+
+	for(std::vector< std::pair< string, SpawnTableType > >::iterator itr = names.begin(); itr != names.end(); ++itr)
+	{
+		SpawnTable* table = new SpawnTable;
+		table->name = itr->first;
+		table->type = itr->second;
+		if(table->type == SPAWN_TABLE_CREATURES || table->type == SPAWN_TABLE_STATIC_CREATURES)
+			table->creatures.resize(NUM_MAPS);
+		else
+			table->gameobjects.resize(NUM_MAPS);
+		table->rows = 0;
+		table->loadTime = 0;
+		m_tables.push_back(table);
+	}
+}
+
+SpawnTableLoader::~SpawnTableLoader()
+{
+	for(std::vector< SpawnTable* >::iterator itr = m_tables.begin(); itr != m_tables.end(); ++itr)
+	{
+		SpawnTable* table = *itr;
+		for(std::vector< CreatureSpawnList >::iterator l = table->creatures.begin(); l != table->creatures.end(); ++l)
+			for(CreatureSpawnList::iterator i = l->begin(); i != l->end(); ++i)
+				delete *i;
+		for(std::vector< GOSpawnList >::iterator l = table->gameobjects.begin(); l != table->gameobjects.end(); ++l)
+			for(GOSpawnList::iterator i = l->begin(); i != l->end(); ++i)
+				delete *i;
+
+		delete table;
+	}
+}
+
+void SpawnTableLoader::FillTaskList(TaskList & tl)
+{
+	for(std::vector< SpawnTable* >::iterator itr = m_tables.begin(); itr != m_tables.end(); ++itr)
+		tl.AddTask(new Task(new CallbackP1< SpawnTableLoader, SpawnTable* >(this, &SpawnTableLoader::LoadTable, *itr)));
+}
+
+void SpawnTableLoader::LoadTable(SpawnTable* table)
+{
+	uint32 start = getMSTime();
+	bool creatures = (table->type == SPAWN_TABLE_CREATURES || table->type == SPAWN_TABLE_STATIC_CREATURES);
+	bool invalidMap = false;
+
+	QueryResult* result = WorldDatabase.QueryStream("SELECT * FROM %s", table->name.c_str());
+	if(result == NULL)
+		return;
+
+	if(creatures ? CheckResultLengthCreatures(result) : CheckResultLengthGameObject(result))
+	{
+		do
+		{
+			Field* fields = result->Fetch();
+			uint32 mapid = fields[2].GetUInt32();
+			if(mapid >= NUM_MAPS)
+			{
+				invalidMap = true;
+				continue;
+			}
+
+			if(creatures)
+				table->creatures[ mapid ].push_back(ReadCreatureSpawn(fields, table->type == SPAWN_TABLE_STATIC_CREATURES));
+			else
+				table->gameobjects[ mapid ].push_back(ReadGOSpawn(fields));
+		}
+		while(result->NextRow());
+	}
+
+	table->rows = result->GetRowCount();
+	delete result;
+
+	if(invalidMap)
+		Log.Error("Map", "One or more of your %s rows specifies an invalid map.", table->name.c_str());
+
+	table->loadTime = getMSTime() - start;
+}
+
+uint32 SpawnTableLoader::GetSpawnCount(uint32 mapid)
+{
+	uint32 count = 0;
+	for(std::vector< SpawnTable* >::iterator itr = m_tables.begin(); itr != m_tables.end(); ++itr)
+	{
+		if(mapid < (*itr)->creatures.size())
+			count += (uint32)(*itr)->creatures[ mapid ].size();
+		if(mapid < (*itr)->gameobjects.size())
+			count += (uint32)(*itr)->gameobjects[ mapid ].size();
+	}
+
+	return count;
+}
+
+void SpawnTableLoader::LogTimes()
+{
+	for(std::vector< SpawnTable* >::iterator itr = m_tables.begin(); itr != m_tables.end(); ++itr)
+		Log.Notice("Map", "%u rows read from %s in %u ms.", (*itr)->rows, (*itr)->name.c_str(), (*itr)->loadTime);
 }
\ No newline at end of file
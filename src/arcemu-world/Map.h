@@ -109,10 +109,76 @@ typedef struct
 	GOSpawnList GOSpawns;
 } CellSpawns;
 
+class TaskList;
+
+enum SpawnTableType
+{
+    SPAWN_TABLE_CREATURES,			// creature_spawns and additional creature tables
+    SPAWN_TABLE_STATIC_CREATURES,	// creature_staticspawns
+    SPAWN_TABLE_STATIC_GAMEOBJECTS,	// gameobject_staticspawns
+    SPAWN_TABLE_GAMEOBJECTS			// gameobject_spawns and additional gameobject tables
+};
+
+// The rows of one spawn table, sorted by map
+struct SpawnTable
+{
+	string name;
+	SpawnTableType type;
+	std::vector< CreatureSpawnList > creatures;	// by map id
+	std::vector< GOSpawnList > gameobjects;		// by map id
+	uint32 rows;
+	uint32 loadTime;
+};
+
+//////////////////////////////////////////////////////////////////////
+//class SpawnTableLoader
+// Reads the spawn tables at startup with one streamed query per table,
+// instead of one query per table and map, and sorts the rows by map.
+//
+//The tables are read at the same time, over separate connections.
+//The maps then take their spawns from here, also at the same time,
+//see Map::Map().
+//
+/////////////////////////////////////////////////////////////////////
+class SERVER_DECL SpawnTableLoader
+{
+	public:
+		SpawnTableLoader();
+
+		//Deletes the spawns no map took.
+		~SpawnTableLoader();
+
+		//Adds one task per spawn table to tl, which reads that table.
+		void FillTaskList(TaskList & tl);
+
+		//Number of spawns on a map, from every table. Only valid after the tasks finished.
+		uint32 GetSpawnCount(uint32 mapid);
+
+		//Tables in the order Map::LoadSpawns() reads them.
+		std::vector< SpawnTable* > & GetTables() { return m_tables; }
+
+		//Logs the time spent reading each table.
+		void LogTimes();
+
+	private:
+		void LoadTable(SpawnTable* table);
+
+		std::vector< SpawnTable* > m_tables;
+};
+
 class SERVER_DECL Map
 {
 	public:
-		Map(uint32 mapid, MapInfo* inf);
+		//////////////////////////////////////////////////////////////////////////////////////////
+		//Map( uint32 mapid, MapInfo *inf, SpawnTableLoader *loader = NULL )
+		// Creates the map and caches its spawns.
+		//
+		//Parameter(s)
+		// SpawnTableLoader *loader  -  takes the spawns from the tables read at startup,
+		//                              if NULL the spawn tables are queried for this map
+		//
+		//////////////////////////////////////////////////////////////////////////////////////////
+		Map(uint32 mapid, MapInfo* inf, SpawnTableLoader* loader = NULL);
 		~Map();
 
 		ARCEMU_INLINE string GetNameString() { return name; }
@@ -143,6 +209,9 @@ class SERVER_DECL Map
 		}
 
 		void LoadSpawns(bool reload);//set to true to make clean up
+
+		//Takes this map's spawns from the spawn tables read at startup.
+		void LoadSpawns(SpawnTableLoader* loader);
 		uint32 CreatureSpawnCount;
 		uint32 GameObjectSpawnCount;
 
@@ -155,6 +224,10 @@ class SERVER_DECL Map
 		}
 
 	private:
+		// staticSpawn is true for the rows of the static spawn tables
+		void AddCreatureSpawn(CreatureSpawn* cspawn, bool staticSpawn);
+		void AddGOSpawn(GOSpawn* gspawn, bool staticSpawn);
+
 		MapInfo* 	   _mapInfo;
 		uint32 _mapId;
 		string name;
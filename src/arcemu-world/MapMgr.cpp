@@ -67,6 +67,10 @@ worldstateshandler( mapId )
 	forced_expire = false;
 	InactiveMoveTime = 0;
 	mLoopCounter = 0;
+	m_visibilityBusy = false;
+	memset(&m_movementRelayStats, 0, sizeof(MovementRelayStats));
+	memset(&m_partyUpdateStats, 0, sizeof(PartyUpdateStats));
+	m_movementRelayStats.lastPeriod = getMSTime();
 	pInstance = NULL;
 	thread_kill_only = false;
 	thread_running = false;
@@ -81,6 +85,8 @@ worldstateshandler( mapId )
 	//_worldStateSet.clear();
 	_updates.clear();
 	_processQueue.clear();
+	_statsQueue.clear();
+	_visibilityQueue.clear();
 	Sessions.clear();
 
 	activeGameObjects.clear();
@@ -164,6 +170,8 @@ MapMgr::~MapMgr()
 	_combatProgress.clear();
 	_updates.clear();
 	_processQueue.clear();
+	_statsQueue.clear();
+	_visibilityQueue.clear();
 	Sessions.clear();
 
 	activeCreatures.clear();
@@ -451,6 +459,16 @@ void MapMgr::RemoveObject(Object* obj, bool free_guid)
 	//ARCEMU_ASSERT(   obj->GetPositionY() > _minY && obj->GetPositionY() < _maxY);
 	ARCEMU_ASSERT(_cells != NULL);
 
+	// apply the stat changes of this update while the player is still in world
+	if(obj->IsPlayer() && TO_PLAYER(obj)->GetDirtyStats() != 0)
+	{
+		m_updateMutex.Acquire();
+		_statsQueue.erase(TO_PLAYER(obj));
+		m_updateMutex.Release();
+
+		TO_PLAYER(obj)->UpdateDirtyStats();
+	}
+
 	if(obj->IsActive())
 		obj->Deactivate(this);
 
@@ -549,7 +567,9 @@ void MapMgr::RemoveObject(Object* obj, bool free_guid)
 	{
 		plObj = TO_PLAYER(obj);
 		_processQueue.erase(plObj);
+		_visibilityQueue.erase(plObj);
 		plObj->ClearAllPendingUpdates();
+		plObj->GetPendingCreates().clear();
 	}
 
 	obj->RemoveSelfFromInrangeSets();
@@ -656,7 +676,13 @@ void MapMgr::ChangeObjectLocation(Object* obj)
 			else
 				fRange = m_UpdateDistance; // normal distance
 
-			if(fRange > 0.0f && (curObj->GetDistance2dSq(obj) > fRange))
+			float dist = curObj->GetDistance2dSq(obj);
+
+			// a player walking up to a sleeping creature has to wake it, it may want to aggro
+			if(plObj != NULL && curObj->IsCreature() && dist <= AI_WAKE_RANGE * AI_WAKE_RANGE)
+				TO< Creature* >(curObj)->GetAIInterface()->Wake();
+
+			if(fRange > 0.0f && dist > fRange)
 			{
 				if(plObj != NULL)
 					plObj->RemoveIfVisible(curObj->GetGUID());
@@ -800,14 +826,11 @@ void MapMgr::ChangeObjectLocation(Object* obj)
 
 void MapMgr::UpdateInRangeSet(Object* obj, Player* plObj, MapCell* cell, ByteBuffer** buf)
 {
-#define CHECK_BUF if(!*buf) *buf = new ByteBuffer(2500)
-
 	if(cell == NULL)
 		return;
 
 	Object* curObj;
 	Player* plObj2;
-	int count;
 	float fRange;
 	bool cansee, isvisible;
 
@@ -842,17 +865,16 @@ void MapMgr::UpdateInRangeSet(Object* obj, Player* plObj, MapCell* cell, ByteBuf
 				obj->AddInRangeObject(curObj);
 				curObj->AddInRangeObject(obj);
 
+				if(plObj != NULL && curObj->IsCreature())
+					TO< Creature* >(curObj)->GetAIInterface()->Wake();
+
 				if(curObj->IsPlayer())
 				{
 					plObj2 = TO< Player* >(curObj);
 
 					if(plObj2->CanSee(obj) && !plObj2->IsVisible(obj->GetGUID()))
 					{
-						CHECK_BUF;
-						count = obj->BuildCreateUpdateBlockForPlayer(*buf, plObj2);
-						plObj2->PushCreationData(*buf, count);
-						plObj2->AddVisibleObject(obj->GetGUID());
-						(*buf)->clear();
+						CreateForPlayer(obj, plObj2, buf);
 					}
 				}
 
@@ -860,11 +882,7 @@ void MapMgr::UpdateInRangeSet(Object* obj, Player* plObj, MapCell* cell, ByteBuf
 				{
 					if(plObj->CanSee(curObj) && !plObj->IsVisible(curObj->GetGUID()))
 					{
-						CHECK_BUF;
-						count = curObj->BuildCreateUpdateBlockForPlayer(*buf, plObj);
-						plObj->PushCreationData(*buf, count);
-						plObj->AddVisibleObject(curObj->GetGUID());
-						(*buf)->clear();
+						CreateForPlayer(curObj, plObj, buf);
 					}
 				}
 			}
@@ -883,11 +901,7 @@ void MapMgr::UpdateInRangeSet(Object* obj, Player* plObj, MapCell* cell, ByteBuf
 					}
 					else if(cansee && !isvisible)
 					{
-						CHECK_BUF;
-						count = obj->BuildCreateUpdateBlockForPlayer(*buf, plObj2);
-						plObj2->PushCreationData(*buf, count);
-						plObj2->AddVisibleObject(obj->GetGUID());
-						(*buf)->clear();
+						CreateForPlayer(obj, plObj2, buf);
 					}
 				}
 
@@ -902,11 +916,7 @@ void MapMgr::UpdateInRangeSet(Object* obj, Player* plObj, MapCell* cell, ByteBuf
 					}
 					else if(cansee && !isvisible)
 					{
-						CHECK_BUF;
-						count = curObj->BuildCreateUpdateBlockForPlayer(*buf, plObj);
-						plObj->PushCreationData(*buf, count);
-						plObj->AddVisibleObject(curObj->GetGUID());
-						(*buf)->clear();
+						CreateForPlayer(curObj, plObj, buf);
 					}
 				}
 			}
@@ -914,6 +924,134 @@ void MapMgr::UpdateInRangeSet(Object* obj, Player* plObj, MapCell* cell, ByteBuf
 	}
 }
 
+// Objects a player has to know about right away, its own pets, summons and gameobjects,
+// and the ones that can't be looked up again by guid later
+static bool IsUrgentCreate(Player* plr, Object* obj)
+{
+	switch(obj->GetTypeFromGUID())
+	{
+		case HIGHGUID_TYPE_PLAYER:
+			return false;
+
+		case HIGHGUID_TYPE_UNIT:
+		case HIGHGUID_TYPE_VEHICLE:
+		case HIGHGUID_TYPE_PET:
+			{
+				Unit* u = TO< Unit* >(obj);
+				return (u->GetSummonedByGUID() == plr->GetGUID() || u->GetCharmedByGUID() == plr->GetGUID() || u->GetCreatedByGUID() == plr->GetGUID());
+			}
+
+		case HIGHGUID_TYPE_GAMEOBJECT:
+			return ((TO< GameObject* >(obj)->GetOverrides() & GAMEOBJECT_INFVIS) || obj->GetUInt64Value(OBJECT_FIELD_CREATED_BY) == plr->GetGUID());
+
+		default:
+			return true;
+	}
+}
+
+// Lower is created first, the distance scaled down for the objects that matter more
+static float GetCreatePriority(Player* plr, Object* obj)
+{
+	if(obj->GetGUID() == plr->GetSelection())
+		return 0.0f;
+
+	float dist = plr->GetDistance2dSq(obj);
+	if(obj->IsPlayer())
+	{
+		if(plr->GetGroup() != NULL && TO< Player* >(obj)->GetGroup() == plr->GetGroup())
+			return dist * 0.1f;
+		return dist * 0.25f;
+	}
+
+	if(obj->IsUnit() && isHostile(obj, plr))
+		return dist * 0.5f;
+
+	return dist;
+}
+
+void MapMgr::CreateForPlayer(Object* obj, Player* plr, ByteBuffer** buf)
+{
+	if(World::m_visibilityCreateBudget != 0 && !IsUrgentCreate(plr, obj))
+	{
+		plr->QueueCreate(obj->GetGUID());
+		_visibilityQueue.insert(plr);
+		return;
+	}
+
+	if(!*buf)
+		*buf = new ByteBuffer(2500);
+
+	uint32 count = obj->BuildCreateUpdateBlockForPlayer(*buf, plr);
+	plr->PushCreationData(*buf, count);
+	plr->AddVisibleObject(obj->GetGUID());
+	(*buf)->clear();
+}
+
+void MapMgr::_UpdateVisibility()
+{
+	if(_visibilityQueue.empty())
+		return;
+
+	ByteBuffer buf(2500);
+	std::vector< std::pair< float, Object* > > candidates;
+
+	// when the map can't keep up, the far away objects wait until it does
+	float busyRange = m_visibilityBusy ? World::m_visibilityBusyRange : 0.0f;
+
+	for(PUpdateQueue::iterator it = _visibilityQueue.begin(); it != _visibilityQueue.end();)
+	{
+		Player* plr = *it;
+		PUpdateQueue::iterator eit = it;
+		++it;
+
+		std::set< uint64 > & pending = plr->GetPendingCreates();
+		candidates.clear();
+
+		for(std::set< uint64 >::iterator itr = pending.begin(); itr != pending.end();)
+		{
+			Object* obj = _GetObject(*itr);
+			if(obj == NULL || obj->GetMapMgr() != this || !plr->IsInRangeSet(obj) || plr->IsVisible(*itr) || !plr->CanSee(obj))
+			{
+				pending.erase(itr++);
+				continue;
+			}
+
+			candidates.push_back(std::make_pair(GetCreatePriority(plr, obj), obj));
+			++itr;
+		}
+
+		std::sort(candidates.begin(), candidates.end());
+
+		// the far away objects wait, but not the nearest one
+		if(busyRange != 0.0f)
+		{
+			size_t keep = 1;
+			while(keep < candidates.size() && candidates[ keep ].first <= busyRange)
+				++keep;
+			if(keep < candidates.size())
+				candidates.resize(keep);
+		}
+
+		// at least one object per update however big it is, everything if the budget was turned off
+		uint32 budget = World::m_visibilityCreateBudget;
+		uint32 bytes = 0;
+		for(size_t i = 0; i < candidates.size() && (i == 0 || budget == 0 || bytes < budget); ++i)
+		{
+			Object* obj = candidates[ i ].second;
+			uint32 count = obj->BuildCreateUpdateBlockForPlayer(&buf, plr);
+			plr->PushCreationData(&buf, count);
+			plr->AddVisibleObject(obj->GetGUID());
+			pending.erase(obj->GetGUID());
+
+			bytes += uint32(buf.size());
+			buf.clear();
+		}
+
+		if(pending.empty())
+			_visibilityQueue.erase(eit);
+	}
+}
+
 void MapMgr::_UpdateObjects()
 {
 	if(!_updates.size() && !_processQueue.size())
@@ -1173,6 +1311,28 @@ void MapMgr::PushToProcessed(Player* plr)
 	_processQueue.insert(plr);
 }
 
+void MapMgr::PlayerStatsDirty(Player* plr)
+{
+	m_updateMutex.Acquire();
+	_statsQueue.insert(plr);
+	m_updateMutex.Release();
+}
+
+void MapMgr::_UpdatePlayerStats()
+{
+	if(_statsQueue.empty())
+		return;
+
+	// recalculating can mark stats dirty again (auras updated by UpdateStats), those players are queued for the next update
+	PUpdateQueue players;
+	m_updateMutex.Acquire();
+	players.swap(_statsQueue);
+	m_updateMutex.Release();
+
+	for(PUpdateQueue::iterator itr = players.begin(); itr != players.end(); ++itr)
+		(*itr)->UpdateDirtyStats();
+}
+
 
 void MapMgr::ChangeFarsightLocation(Player* plr, DynamicObject* farsight)
 {
@@ -1237,6 +1397,9 @@ bool MapMgr::run()
 	rv = Do();
 	THREAD_HANDLE_CRASH
 
+	// the map is gone, the pooled thread may run something that doesn't cast next
+	SpellPool::ReleaseThreadPool();
+
 	return rv;
 }
 
@@ -1314,6 +1477,7 @@ bool MapMgr::Do()
 
 		last_exec = getMSTime();
 		exec_time = last_exec - exec_start;
+		m_visibilityBusy = (exec_time >= MAP_MGR_UPDATE_PERIOD);
 		if(exec_time < MAP_MGR_UPDATE_PERIOD)
 		{
 
@@ -1467,6 +1631,11 @@ void MapMgr::_PerformObjectDuties()
 		{
 			ptr = *creature_iterator;
 			++creature_iterator;
+
+			// idle creatures sleep until something wakes them, see AIInterface::TrySleep()
+			if(ptr->GetAIInterface()->IsSleeping(mstime))
+				continue;
+
 			ptr->Update(difftime);
 		}
 
@@ -1530,9 +1699,28 @@ void MapMgr::_PerformObjectDuties()
 	{
 		int result;
 		WorldSession* session;
-		SessionSet::iterator itr = Sessions.begin();
+		SessionSet::iterator itr;
 		SessionSet::iterator it2;
 
+		// Drain every session's receive queue first (one lock per session), then validate and run the
+		// movement packets of all sessions back to back. Everything else, and the movement of sessions
+		// that are disconnecting or logging out, is handled by the per session update below.
+		for(itr = Sessions.begin(); itr != Sessions.end(); ++itr)
+		{
+			session = (*itr);
+			if(session->GetInstance() == m_instanceID && session->GetPlayer() && session->GetPlayer()->GetMapMgr() == this)
+				session->StagePackets(m_instanceID);
+		}
+
+		for(itr = Sessions.begin(); itr != Sessions.end(); ++itr)
+		{
+			session = (*itr);
+			if(session->GetInstance() == m_instanceID && session->GetPlayer() && session->GetPlayer()->GetMapMgr() == this)
+				session->ProcessStagedMovement(m_instanceID);
+		}
+
+		itr = Sessions.begin();
+
 		for(; itr != Sessions.end();)
 		{
 			session = (*itr);
@@ -1563,8 +1751,43 @@ void MapMgr::_PerformObjectDuties()
 				Sessions.erase(it2);
 			}
 		}
+
+		// Heartbeats held back from distant observers go out once their interval is up.
+		for(itr = Sessions.begin(); itr != Sessions.end(); ++itr)
+		{
+			session = (*itr);
+			if(session->GetPlayer() && session->GetPlayer()->GetMapMgr() == this)
+				session->FlushPendingMovement();
+		}
 	}
 
+	if((mstime - m_movementRelayStats.lastPeriod) >= MOVEMENT_RELAY_STATS_PERIOD)
+	{
+		float secs = (mstime - m_movementRelayStats.lastPeriod) / 1000.0f;
+		m_movementRelayStats.packetsPerSec = m_movementRelayStats.packets / secs;
+		m_movementRelayStats.bytesPerSec = m_movementRelayStats.bytes / secs;
+		m_movementRelayStats.skippedPerSec = m_movementRelayStats.skipped / secs;
+		m_movementRelayStats.packets = 0;
+		m_movementRelayStats.bytes = 0;
+		m_movementRelayStats.skipped = 0;
+		m_movementRelayStats.lastPeriod = mstime;
+
+		m_partyUpdateStats.changesPerSec = m_partyUpdateStats.changes / secs;
+		m_partyUpdateStats.oldPacketsPerSec = m_partyUpdateStats.oldPackets / secs;
+		m_partyUpdateStats.packetsPerSec = m_partyUpdateStats.packets / secs;
+		m_partyUpdateStats.bytesPerSec = m_partyUpdateStats.bytes / secs;
+		m_partyUpdateStats.changes = 0;
+		m_partyUpdateStats.oldPackets = 0;
+		m_partyUpdateStats.packets = 0;
+		m_partyUpdateStats.bytes = 0;
+	}
+
+	// Objects that came into view, within each player's budget
+	_UpdateVisibility();
+
+	// Stat changes of this update go out with the other value changes
+	_UpdatePlayerStats();
+
 	// Finally, A9 Building/Distribution
 	_UpdateObjects();
 }
@@ -1914,20 +2137,24 @@ void MapMgr::SendPvPCaptureMessage(int32 ZoneMask, uint32 ZoneId, const char* Me
 }
 
 void MapMgr::SendPacketToAllPlayers( WorldPacket *packet ) const{
+	BroadcastPacket broadcast( packet );
+
 	for( PlayerStorageMap::const_iterator itr = m_PlayerStorage.begin(); itr != m_PlayerStorage.end(); ++itr ){
 		Player *p = itr->second;
 
 		if( p->GetSession() != NULL )
-			p->GetSession()->SendPacket( packet );
+			broadcast.SendTo( p->GetSession() );
 	}
 }
 
 void MapMgr::SendPacketToPlayersInZone( uint32 zone, WorldPacket *packet ) const{
+	BroadcastPacket broadcast( packet );
+
 	for( PlayerStorageMap::const_iterator itr = m_PlayerStorage.begin(); itr != m_PlayerStorage.end(); ++itr ){
 		Player *p = itr->second;
 
 		if( ( p->GetSession() != NULL ) && ( p->GetZoneId() == zone ) )
-			p->GetSession()->SendPacket( packet );
+			broadcast.SendTo( p->GetSession() );
 	}
 }
 
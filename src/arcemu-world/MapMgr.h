@@ -83,6 +83,37 @@ typedef set<GameObject*> GameObjectSet;
 typedef HM_NAMESPACE::hash_map<uint32, Creature*> CreatureSqlIdMap;
 typedef HM_NAMESPACE::hash_map<uint32, GameObject*> GameObjectSqlIdMap;
 
+// Movement packets relayed to observers on this map, see WorldSession::_RelayMovement.
+// The counters are rolled into per second rates every MOVEMENT_RELAY_STATS_PERIOD ms.
+#define MOVEMENT_RELAY_STATS_PERIOD 5000
+
+struct MovementRelayStats
+{
+	uint32 packets;		// packets sent since the last period
+	uint32 bytes;
+	uint32 skipped;		// heartbeats held back from distant observers
+
+	float packetsPerSec;
+	float bytesPerSec;
+	float skippedPerSec;
+	uint32 lastPeriod;
+};
+
+// Party stat updates of the players on this map, see Group::SendPendingUpdate.
+// Rolled into per second rates together with the movement relay stats.
+struct PartyUpdateStats
+{
+	uint32 changes;		// party stat changes marked since the last period
+	uint32 oldPackets;	// packets sending every change right away would have taken, one per change and out of range member
+	uint32 packets;		// packets sent since the last period
+	uint32 bytes;		// bytes of those, headers included
+
+	float changesPerSec;
+	float oldPacketsPerSec;
+	float packetsPerSec;
+	float bytesPerSec;
+};
+
 #define MAX_TRANSPORTERS_PER_MAP 25
 
 class Transporter;
@@ -243,6 +274,9 @@ class SERVER_DECL MapMgr : public CellHandler <MapCell>, public EventableObject,
 
 		void PushToProcessed(Player* plr);
 
+		//! Queues the stats recalculation of a player for the end of this update, see Player::MarkStatsDirty()
+		void PlayerStatsDirty(Player* plr);
+
 		bool HasPlayers() { return (m_PlayerStorage.size() > 0); }
 		bool IsCombatInProgress() { return (_combatProgress.size() > 0); }
 		void TeleportPlayers();
@@ -263,6 +297,8 @@ class SERVER_DECL MapMgr : public CellHandler <MapCell>, public EventableObject,
 		uint32 mLoopCounter;
 		uint32 lastGameobjectUpdate;
 		uint32 lastUnitUpdate;
+		MovementRelayStats m_movementRelayStats;
+		PartyUpdateStats m_partyUpdateStats;
 		void EventCorpseDespawn(uint64 guid);
 
 		time_t InactiveMoveTime;
@@ -305,6 +341,12 @@ class SERVER_DECL MapMgr : public CellHandler <MapCell>, public EventableObject,
 		//! Collect and send updates to clients
 		void _UpdateObjects();
 
+		//! Run the stats recalculations queued during this update
+		void _UpdatePlayerStats();
+
+		//! Send the creates held back by the visibility budget, most important first
+		void _UpdateVisibility();
+
 	private:
 		//! Objects that exist on map
 
@@ -313,6 +355,7 @@ class SERVER_DECL MapMgr : public CellHandler <MapCell>, public EventableObject,
 
 		bool _CellActive(uint32 x, uint32 y);
 		void UpdateInRangeSet(Object* obj, Player* plObj, MapCell* cell, ByteBuffer** buf);
+		void CreateForPlayer(Object* obj, Player* plr, ByteBuffer** buf);
 
 	public:
 		// Distance a Player can "see" other objects and receive updates from them (!! ALREADY dist*dist !!)
@@ -323,6 +366,9 @@ class SERVER_DECL MapMgr : public CellHandler <MapCell>, public EventableObject,
 		Mutex m_updateMutex;
 		UpdateQueue _updates;
 		PUpdateQueue _processQueue;
+		PUpdateQueue _statsQueue;
+		PUpdateQueue _visibilityQueue;		// players with creates pending
+		bool m_visibilityBusy;				// the last update took longer than its period
 
 		/* Sessions */
 		SessionSet Sessions;
@@ -505,6 +505,9 @@ bool Master::Run(int argc, char** argv)
 	cs->terminate();
 	cs = NULL;
 
+	Log.Notice("PathfindingMgr", "Stopping workers...");
+	sPathfindingMgr.Shutdown();
+
 	ls->Close();
 
 	CloseConsoleListener();
@@ -526,9 +529,12 @@ bool Master::Run(int argc, char** argv)
 	delete LogonCommHandler::getSingletonPtr();
 
 	sWorld.ShutdownClasses();
+	Arcemu::PacketCompressor::DestroyAll();
 	Log.Notice("World", "~World()");
 	delete World::getSingletonPtr();
 
+	SpellPool::DestroyAll();
+
 	sScriptMgr.UnloadScripts();
 	delete ScriptMgr::getSingletonPtr();
 
@@ -302,6 +302,132 @@ static MovementFlagName MoveFlagsToNames[] =
 
 static const uint32 nmovementflags = sizeof(MoveFlagsToNames) / sizeof(MovementFlagName);
 
+uint32 WorldSession::_GetMovementRelayBand(float distsq)
+{
+	if(distsq < World::m_movementRelayNearRange)
+		return MOVEMENT_RELAY_NEAR;
+	else if(distsq < World::m_movementRelayMidRange)
+		return MOVEMENT_RELAY_MID;
+	else
+		return MOVEMENT_RELAY_FAR;
+}
+
+void WorldSession::_SendMovementTo(Player* p, float distsq, uint16 opcode, uint16 size, uint8* packet, size_t timepos, int32 move_time)
+{
+	*(uint32*)&packet[timepos] = uint32(move_time + p->GetSession()->m_moveDelayTime);
+
+#if defined(ENABLE_COMPRESSED_MOVEMENT) && defined(ENABLE_COMPRESSED_MOVEMENT_FOR_PLAYERS)
+	if(distsq >= World::m_movementCompressThreshold)
+		p->AppendMovementData(opcode, size, packet);
+	else
+		p->GetSession()->OutPacket(opcode, size, packet);
+#else
+	p->GetSession()->OutPacket(opcode, size, packet);
+#endif
+}
+
+void WorldSession::_RelayMovement(uint16 opcode, uint16 size, size_t timepos, int32 move_time)
+{
+	MapMgr* mgr = _player->GetMapMgr();
+	uint32 now = getMSTime();
+
+	// Anything but a heartbeat changes the movement state, every observer needs it.
+	// Heartbeats go to the near band every time, and to the others once per interval.
+	uint8 bands = 0;
+	if(opcode != MSG_MOVE_HEARTBEAT)
+		bands = (1 << NUM_MOVEMENT_RELAY_BANDS) - 1;
+	else
+	{
+		for(uint32 i = 0; i < NUM_MOVEMENT_RELAY_BANDS; ++i)
+		{
+			if((now - m_movementRelayTime[ i ]) >= World::m_movementRelayInterval[ i ])
+				bands |= (1 << i);
+		}
+	}
+
+	for(uint32 i = 0; i < NUM_MOVEMENT_RELAY_BANDS; ++i)
+	{
+		if(bands & (1 << i))
+			m_movementRelayTime[ i ] = now;
+	}
+
+	uint8 skipped = 0;
+	for(set<Object*>::iterator itr = _player->m_inRangePlayers.begin(); itr != _player->m_inRangePlayers.end(); ++itr)
+	{
+		Player* p = TO< Player* >((*itr));
+
+		// the bands use the same 2D distance as the compression threshold
+		float distsq = _player->GetPositionNC().Distance2DSq(p->GetPosition());
+		uint32 band = _GetMovementRelayBand(distsq);
+		if(!(bands & (1 << band)))
+		{
+			skipped |= (1 << band);
+			++mgr->m_movementRelayStats.skipped;
+			continue;
+		}
+
+		_SendMovementTo(p, distsq, opcode, size, movement_packet, timepos, move_time);
+		++mgr->m_movementRelayStats.packets;
+		mgr->m_movementRelayStats.bytes += size + 4;
+	}
+
+	// Keep the latest heartbeat for the bands that missed it, older ones are superseded.
+	m_pendingMovementBands = (m_pendingMovementBands & ~bands) | skipped;
+	if(skipped)
+	{
+		memcpy(m_pendingMovement, movement_packet, size);
+		m_pendingMovementOpcode = opcode;
+		m_pendingMovementSize = size;
+		m_pendingMovementTimePos = timepos;
+		m_pendingMovementTime = move_time;
+		m_pendingMovementStamp = mTimeStamp();
+	}
+}
+
+void WorldSession::FlushPendingMovement()
+{
+	if(m_pendingMovementBands == 0)
+		return;
+
+	if(_player == NULL || !_player->IsInWorld())
+	{
+		m_pendingMovementBands = 0;
+		return;
+	}
+
+	uint32 now = getMSTime();
+	uint8 due = 0;
+	for(uint32 i = 0; i < NUM_MOVEMENT_RELAY_BANDS; ++i)
+	{
+		if((m_pendingMovementBands & (1 << i)) && (now - m_movementRelayTime[ i ]) >= World::m_movementRelayInterval[ i ])
+		{
+			due |= (1 << i);
+			m_movementRelayTime[ i ] = now;
+		}
+	}
+
+	if(due == 0)
+		return;
+
+	// the heartbeat is sent as if it had just arrived, its time moves on by how long it was held
+	int32 move_time = m_pendingMovementTime + int32(mTimeStamp() - m_pendingMovementStamp);
+
+	MapMgr* mgr = _player->GetMapMgr();
+	for(set<Object*>::iterator itr = _player->m_inRangePlayers.begin(); itr != _player->m_inRangePlayers.end(); ++itr)
+	{
+		Player* p = TO< Player* >((*itr));
+		float distsq = _player->GetPositionNC().Distance2DSq(p->GetPosition());
+		if(!(due & (1 << _GetMovementRelayBand(distsq))))
+			continue;
+
+		_SendMovementTo(p, distsq, m_pendingMovementOpcode, m_pendingMovementSize, m_pendingMovement, m_pendingMovementTimePos, move_time);
+		++mgr->m_movementRelayStats.packets;
+		mgr->m_movementRelayStats.bytes += m_pendingMovementSize + 4;
+	}
+
+	m_pendingMovementBands &= ~due;
+}
+
 void WorldSession::HandleMovementOpcodes(WorldPacket & recv_data)
 {
 	CHECK_INWORLD_RETURN
@@ -526,22 +652,7 @@ void WorldSession::HandleMovementOpcodes(WorldPacket & recv_data)
 		/************************************************************************/
 		/* Distribute to all inrange players.                                   */
 		/************************************************************************/
-		for(set<Object*>::iterator itr = _player->m_inRangePlayers.begin(); itr != _player->m_inRangePlayers.end(); ++itr)
-		{
-
-			Player* p = TO< Player* >((*itr));
-
-			*(uint32*)&movement_packet[pos + 6] = uint32(move_time + p->GetSession()->m_moveDelayTime);
-
-#if defined(ENABLE_COMPRESSED_MOVEMENT) && defined(ENABLE_COMPRESSED_MOVEMENT_FOR_PLAYERS)
-			if(_player->GetPositionNC().Distance2DSq(p->GetPosition()) >= World::m_movementCompressThreshold)
-				p->AppendMovementData(recv_data.GetOpcode(), uint16(recv_data.size() + pos), movement_packet);
-			else
-				p->GetSession()->OutPacket(recv_data.GetOpcode(), uint16(recv_data.size() + pos), movement_packet);
-#else
-			p->GetSession()->OutPacket(recv_data.GetOpcode(), uint16(recv_data.size() + pos), movement_packet);
-#endif
-		}
+		_RelayMovement(recv_data.GetOpcode(), uint16(recv_data.size() + pos), pos + 6, move_time);
 	}
 
 	/************************************************************************/
@@ -745,6 +856,62 @@ void WorldSession::HandleMovementOpcodes(WorldPacket & recv_data)
 	}
 }
 
+bool WorldSession::_ValidateMovementBatch(size_t count)
+{
+	// HandleMovementOpcodes would ignore every packet of the batch
+	if(!_player->IsInWorld() || _player->GetCharmedByGUID() || _player->GetPlayerStatus() == TRANSFER_PENDING || _player->GetTaxiState() || _player->getDeathState() == JUST_DIED)
+		return false;
+
+	uint64 mover = m_MoverWoWGuid.GetOldGuid();
+	bool checkTeleport = sWorld.antihack_teleport && !(HasGMPermissions() && sWorld.no_antihack_on_gm) && !_player->GetCharmedUnitGUID() && _player->m_runSpeed < 50.0f;
+	bool trackPosition = (mover == _player->GetGUID() && _player->m_CurrentTransporter == NULL);
+	bool onTransport = (_player->transporter_info.guid != 0);
+	float lastX = _player->GetPositionX();
+	float lastY = _player->GetPositionY();
+
+	for(size_t i = 0; i < count; ++i)
+	{
+		WorldPacket* packet = _stagedPackets[ i ];
+		WoWGuid guid;
+		uint32 flags, time;
+		uint16 unk;
+		float x, y;
+
+		// only the head of the movement block is needed here, the handler reads the packet again
+		*packet >> guid >> flags >> unk >> time >> x >> y;
+		packet->rpos(0);
+
+		if(guid != mover)
+			continue;
+
+		if(!((y >= _minY) && (y <= _maxY)) || !((x >= _minX) && (x <= _maxX)))
+		{
+			Disconnect();
+			return false;
+		}
+
+		// Same check as the anti-teleport in the handler, along the path of the whole batch. A hacked
+		// batch is rejected before any of its steps is relayed.
+		float dx = x - lastX;
+		float dy = y - lastY;
+		if(checkTeleport && !onTransport && (dx * dx + dy * dy) > 3025.0f)
+		{
+			sCheatLog.writefromsession(this, "Disconnected for teleport hacking. Player speed: %f, Distance traveled: %f", _player->m_runSpeed, sqrt(dx * dx + dy * dy));
+			Disconnect();
+			return false;
+		}
+
+		onTransport = ((flags & MOVEFLAG_TRANSPORT) != 0);
+		if(trackPosition)
+		{
+			lastX = x;
+			lastY = y;
+		}
+	}
+
+	return true;
+}
+
 void WorldSession::HandleMoveTimeSkippedOpcode(WorldPacket & recv_data)
 {
 
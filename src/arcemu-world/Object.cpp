@@ -2449,15 +2449,18 @@ bool Object::GetPoint(float angle, float rad, float & outx, float & outy, float
 			dtQueryFilter filter;
 			filter.setIncludeFlags(NAV_GROUND | NAV_WATER | NAV_SLIME | NAV_MAGMA);
 
+			dtNavMeshQuery* query = nav->AcquireQuery();
+			nav->meshlock.AcquireReadLock();
+
 			dtPolyRef startref;
-			nav->query->findNearestPoly(start, extents, &filter, &startref, NULL);
+			query->findNearestPoly(start, extents, &filter, &startref, NULL);
 
 			float point, pointNormal;
 			float result[3];
 			int numvisited;
 			dtPolyRef visited[MAX_PATH_LENGTH];
 
-			dtStatus rayresult = nav->query->raycast(startref, start, end, &filter, &point, &pointNormal, visited, &numvisited, MAX_PATH_LENGTH);
+			dtStatus rayresult = query->raycast(startref, start, end, &filter, &point, &pointNormal, visited, &numvisited, MAX_PATH_LENGTH);
 
 			if (point <= 1.0f)
 			{
@@ -2472,7 +2475,7 @@ bool Object::GetPoint(float angle, float rad, float & outx, float & outy, float
 					result[0] = start[0] + ((end[0] - start[0]) * point);
 					result[1] = start[1] + ((end[1] - start[1]) * point);
 					result[2] = start[2] + ((end[2] - start[2]) * point);
-					nav->query->getPolyHeight(visited[numvisited - 1], result, &result[1]);
+					query->getPolyHeight(visited[numvisited - 1], result, &result[1]);
 				}
 
 				//copy end back to function floats
@@ -2480,6 +2483,9 @@ bool Object::GetPoint(float angle, float rad, float & outx, float & outy, float
 				outz = result[1];
 				outx = result[2];
 			}
+
+			nav->meshlock.ReleaseReadLock();
+			nav->ReleaseQuery(query);
 		}
 	}
 	else //test against vmap if mmap isn't available
@@ -298,7 +298,6 @@ void ObjectMgr::DeletePlayerInfo(uint32 guid)
 {
 	PlayerInfo* pl;
 	HM_NAMESPACE::hash_map<uint32, PlayerInfo*>::iterator i;
-	PlayerNameStringIndexMap::iterator i2;
 	playernamelock.AcquireWriteLock();
 	i = m_playersinfo.find(guid);
 	if(i == m_playersinfo.end())
@@ -321,11 +320,7 @@ void ObjectMgr::DeletePlayerInfo(uint32 guid)
 			pl->guild->RemoveGuildMember(pl, NULL);
 	}
 
-	string pnam = string(pl->name);
-	arcemu_TOLOWER(pnam);
-	i2 = m_playersInfoByName.find(pnam);
-	if(i2 != m_playersInfoByName.end() && i2->second == pl)
-		m_playersInfoByName.erase(i2);
+	m_playerInfoIndex.Remove(pl);
 
 	free(pl->name);
 	delete i->second;
@@ -336,43 +331,31 @@ void ObjectMgr::DeletePlayerInfo(uint32 guid)
 
 PlayerInfo* ObjectMgr::GetPlayerInfo(uint32 guid)
 {
-	HM_NAMESPACE::hash_map<uint32, PlayerInfo*>::iterator i;
-	PlayerInfo* rv;
+	// lockless, playernamelock only serializes the writers
+	return m_playerInfoIndex.GetByGuid(guid);
+}
+
+void ObjectMgr::GetPlayerInfoGuids(std::vector< uint32 > & guids)
+{
 	playernamelock.AcquireReadLock();
-	i = m_playersinfo.find(guid);
-	if(i != m_playersinfo.end())
-		rv = i->second;
-	else
-		rv = NULL;
+	guids.reserve(m_playersinfo.size());
+	for(HM_NAMESPACE::hash_map<uint32, PlayerInfo*>::iterator itr = m_playersinfo.begin(); itr != m_playersinfo.end(); ++itr)
+		guids.push_back(itr->first);
 	playernamelock.ReleaseReadLock();
-	return rv;
 }
 
 void ObjectMgr::AddPlayerInfo(PlayerInfo* pn)
 {
 	playernamelock.AcquireWriteLock();
 	m_playersinfo[pn->guid] =  pn ;
-	string pnam = string(pn->name);
-	arcemu_TOLOWER(pnam);
-	m_playersInfoByName[pnam] = pn;
+	m_playerInfoIndex.Add(pn);
 	playernamelock.ReleaseWriteLock();
 }
 
 void ObjectMgr::RenamePlayerInfo(PlayerInfo* pn, const char* oldname, const char* newname)
 {
 	playernamelock.AcquireWriteLock();
-	string oldn = string(oldname);
-	arcemu_TOLOWER(oldn);
-
-	PlayerNameStringIndexMap::iterator itr = m_playersInfoByName.find(oldn);
-	if(itr != m_playersInfoByName.end() && itr->second == pn)
-	{
-		string newn = string(newname);
-		arcemu_TOLOWER(newn);
-		m_playersInfoByName.erase(itr);
-		m_playersInfoByName[newn] = pn;
-	}
-
+	m_playerInfoIndex.Rename(pn, oldname, newname);
 	playernamelock.ReleaseWriteLock();
 }
 
@@ -494,12 +477,9 @@ void ObjectMgr::LoadPlayersInfo()
 				pn->name = strdup(temp);
 			}
 
-			string lpn = string(pn->name);
-			arcemu_TOLOWER(lpn);
-			m_playersInfoByName[lpn] = pn;
-
 			//this is startup -> no need in lock -> don't use addplayerinfo
 			m_playersinfo[(uint32)pn->guid] = pn;
+			m_playerInfoIndex.Add(pn);
 
 			if(!((++c) % period))
 				Log.Notice("PlayerInfo", "Done %u/%u, %u%% complete.", c, result->GetRowCount(), c * 100 / result->GetRowCount());
@@ -514,18 +494,7 @@ void ObjectMgr::LoadPlayersInfo()
 
 PlayerInfo* ObjectMgr::GetPlayerInfoByName(const char* name)
 {
-	string lpn = string(name);
-	arcemu_TOLOWER(lpn);
-	PlayerNameStringIndexMap::iterator i;
-	PlayerInfo* rv = NULL;
-	playernamelock.AcquireReadLock();
-
-	i = m_playersInfoByName.find(lpn);
-	if(i != m_playersInfoByName.end())
-		rv = i->second;
-
-	playernamelock.ReleaseReadLock();
-	return rv;
+	return m_playerInfoIndex.GetByName(name);
 }
 #ifdef ENABLE_ACHIEVEMENTS
 void ObjectMgr::LoadCompletedAchievements()
@@ -3302,6 +3271,7 @@ void ObjectMgr::ResetDailies()
 		pPlayer->DailyMutex.Acquire();
 		pPlayer->m_finishedDailies.clear();
 		pPlayer->DailyMutex.Release();
+		pPlayer->InvalidateQuestGiverStatus();
 	}
 	_playerslock.ReleaseReadLock();
 }
@@ -348,38 +348,6 @@ typedef std::map<uint32, InstanceBossInfo*>                         InstanceBoss
 typedef std::list<const AchievementCriteriaEntry*>					AchievementCriteriaEntryList;
 #endif
 
-#ifndef WIN32
-#define arcemu_USE_MAP_PLAYER_INDEX
-#ifdef arcemu_USE_MAP_PLAYER_INDEX
-
-// you can use the string map (slower)
-typedef map<string, PlayerInfo*> PlayerNameStringIndexMap;
-
-
-#else			// or
-
-// gcc has no default hash for string type,
-// so we have to make an explicit hash template here
-template<>
-struct __gnu_cxx::hash<string>
-{
-	size_t operator()(string & tbh) const
-	{
-		// simple crc32 hash for now, we may need to change this later however
-		return size_t(crc32((const unsigned char*)tbh.c_str(), tbh.length()));
-	}
-}
-
-typedef HM_NAMESPACE::hash_map<string, PlayerInfo*> PlayerNameStringIndexMap;
-
-#endif
-#else
-
-// vc++ has the type for a string hash already, so we don't need to do anything special
-typedef HM_NAMESPACE::hash_map<string, PlayerInfo*> PlayerNameStringIndexMap;
-
-#endif
-
 class PlayerCache;
 class SERVER_DECL ObjectMgr : public Singleton < ObjectMgr >, public EventableObject
 {
@@ -474,6 +442,7 @@ class SERVER_DECL ObjectMgr : public Singleton < ObjectMgr >, public EventableOb
 		PlayerInfo* GetPlayerInfoByName(const char* name);
 		void RenamePlayerInfo(PlayerInfo* pn, const char* oldname, const char* newname);
 		void DeletePlayerInfo(uint32 guid);
+		void GetPlayerInfoGuids(std::vector< uint32 > & guids);	// every character, for .debug benchplayerinfo
 		PlayerCreateInfo* GetPlayerCreateInfo(uint8 race, uint8 class_) const;
 
 		// Guild
@@ -754,8 +723,8 @@ class SERVER_DECL ObjectMgr : public Singleton < ObjectMgr >, public EventableOb
 		set<uint32> m_disabled_spells;
 
 		uint64 TransportersCount;
-		HM_NAMESPACE::hash_map<uint32, PlayerInfo*> m_playersinfo;
-		PlayerNameStringIndexMap m_playersInfoByName;
+		HM_NAMESPACE::hash_map<uint32, PlayerInfo*> m_playersinfo;	// owns the PlayerInfos, written under playernamelock
+		PlayerInfoIndex m_playerInfoIndex;							// lookups by guid and name
 
 		HM_NAMESPACE::hash_map<uint32, WayPointMap*> m_waypoints; //stored by spawnid
 		HM_NAMESPACE::hash_map<uint32, TimedEmoteList*> m_timedemotes; //stored by spawnid
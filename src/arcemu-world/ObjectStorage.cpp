@@ -536,22 +536,35 @@ void ObjectMgr::LoadExtraGameObjectStuff()
 	new CallbackP2< SQLStorage< itype, storagetype< itype > >, const char *, const char *> \
     (&storage, &SQLStorage< itype, storagetype< itype > >::Load, tablename, format) ) )
 
+// Splits a table with an `entry` primary key into ranges, loaded by separate tasks
+#define make_range_tasks(storage, itype, storagetype, tablename, format) \
+	for(uint32 i = 0, n = storage.PrepareLoad(tablename, format, ranges); i < n; ++i) \
+		tl.AddTask( new Task( new CallbackP1< SQLStorage< itype, storagetype< itype > >, uint32 > \
+		(&storage, &SQLStorage< itype, storagetype< itype > >::LoadRange, i) ) )
+
 void Storage_FillTaskList(TaskList & tl)
 {
-	make_task(ItemPrototypeStorage, ItemPrototype, ArrayStorageContainer, "items", gItemPrototypeFormat);
-	make_task(ItemNameStorage, ItemName, ArrayStorageContainer, "itemnames", gItemNameFormat);
-	make_task(CreatureNameStorage, CreatureInfo, HashMapStorageContainer, "creature_names", gCreatureNameFormat);
-	make_task(GameObjectNameStorage, GameObjectInfo, HashMapStorageContainer, "gameobject_names", gGameObjectNameFormat);
-	make_task(CreatureProtoStorage, CreatureProto, HashMapStorageContainer, "creature_proto", gCreatureProtoFormat);
+	// by default one range per world database connection
+	uint32 ranges = Config.MainConfig.GetIntDefault("Startup", "StorageLoadRanges", 0);
+	if(ranges == 0)
+		ranges = Config.MainConfig.GetIntDefault("WorldDatabase", "ConnectionCount", 3);
+
+	// the big tables first, so their ranges don't end up waiting behind the small ones
+	make_range_tasks(ItemPrototypeStorage, ItemPrototype, ArrayStorageContainer, "items", gItemPrototypeFormat);
+	make_range_tasks(CreatureNameStorage, CreatureInfo, HashMapStorageContainer, "creature_names", gCreatureNameFormat);
+	make_range_tasks(CreatureProtoStorage, CreatureProto, HashMapStorageContainer, "creature_proto", gCreatureProtoFormat);
+	make_range_tasks(QuestStorage, Quest, HashMapStorageContainer, "quests", gQuestFormat);
+	make_range_tasks(GameObjectNameStorage, GameObjectInfo, HashMapStorageContainer, "gameobject_names", gGameObjectNameFormat);
+	make_range_tasks(ItemNameStorage, ItemName, ArrayStorageContainer, "itemnames", gItemNameFormat);
+	make_range_tasks(NpcTextStorage, GossipText, HashMapStorageContainer, "npc_text", gNpcTextFormat);
+	make_range_tasks(ItemPageStorage, ItemPage, HashMapStorageContainer, "itempages", gItemPageFormat);
+
 	make_task(DisplayBoundingStorage, DisplayBounding, HashMapStorageContainer, "display_bounding_boxes", gDisplayBoundingFormat);
 	make_task(VendorRestrictionEntryStorage, VendorRestrictionEntry, ArrayStorageContainer, "vendor_restrictions", gVendorRestrictionEntryFormat);
 	make_task(AreaTriggerStorage, AreaTrigger, HashMapStorageContainer, "areatriggers", gAreaTriggerFormat);
-	make_task(ItemPageStorage, ItemPage, HashMapStorageContainer, "itempages", gItemPageFormat);
-	make_task(QuestStorage, Quest, HashMapStorageContainer, "quests", gQuestFormat);
 	make_task(GraveyardStorage, GraveyardTeleport, HashMapStorageContainer, "graveyards", gGraveyardFormat);
 	make_task(TeleportCoordStorage, TeleportCoords, HashMapStorageContainer, "teleport_coords", gTeleportCoordFormat);
 	make_task(FishingZoneStorage, FishingZoneEntry, HashMapStorageContainer, "fishing", gFishingFormat);
-	make_task(NpcTextStorage, GossipText, HashMapStorageContainer, "npc_text", gNpcTextFormat);
 	make_task(WorldMapInfoStorage, MapInfo, ArrayStorageContainer, "worldmap_info", gWorldMapInfoFormat);
 	make_task(ZoneGuardStorage, ZoneGuardEntry, HashMapStorageContainer, "zoneguards", gZoneGuardsFormat);
 	make_task(UnitModelSizeStorage, UnitModelSizeEntry, HashMapStorageContainer, "unit_display_sizes", gUnitModelSizeFormat);
@@ -562,6 +575,285 @@ void Storage_FillTaskList(TaskList & tl)
 	make_task(TotemDisplayIdStorage, TotemDisplayIdEntry, HashMapStorageContainer, "totemdisplayids", gTotemDisplayIDsFormat);
 }
 
+/** Tables kept in the world data snapshot, in the order they are written.
+ */
+#define SNAPSHOT_TABLES(op) \
+	op(ItemPrototypeStorage, "items", gItemPrototypeFormat) \
+	op(ItemNameStorage, "itemnames", gItemNameFormat) \
+	op(CreatureNameStorage, "creature_names", gCreatureNameFormat) \
+	op(GameObjectNameStorage, "gameobject_names", gGameObjectNameFormat) \
+	op(CreatureProtoStorage, "creature_proto", gCreatureProtoFormat) \
+	op(DisplayBoundingStorage, "display_bounding_boxes", gDisplayBoundingFormat) \
+	op(VendorRestrictionEntryStorage, "vendor_restrictions", gVendorRestrictionEntryFormat) \
+	op(AreaTriggerStorage, "areatriggers", gAreaTriggerFormat) \
+	op(ItemPageStorage, "itempages", gItemPageFormat) \
+	op(QuestStorage, "quests", gQuestFormat) \
+	op(GraveyardStorage, "graveyards", gGraveyardFormat) \
+	op(TeleportCoordStorage, "teleport_coords", gTeleportCoordFormat) \
+	op(FishingZoneStorage, "fishing", gFishingFormat) \
+	op(NpcTextStorage, "npc_text", gNpcTextFormat) \
+	op(WorldMapInfoStorage, "worldmap_info", gWorldMapInfoFormat) \
+	op(ZoneGuardStorage, "zoneguards", gZoneGuardsFormat) \
+	op(UnitModelSizeStorage, "unit_display_sizes", gUnitModelSizeFormat) \
+	op(WorldStringTableStorage, "worldstring_tables", gWorldStringTableFormat) \
+	op(WorldBroadCastStorage, "worldbroadcast", gWorldBroadCastFormat) \
+	op(BGMasterStorage, "battlemasters", gBattleMasterFormat) \
+	op(SpellClickSpellStorage, "spellclickspells", gSpellClickSpellsFormat) \
+	op(TotemDisplayIdStorage, "totemdisplayids", gTotemDisplayIDsFormat)
+
+#define WORLD_SNAPSHOT_MAGIC	0x53535741		// "AWSS"
+#define WORLD_SNAPSHOT_VERSION	1				// bump when the snapshot layout or a storage struct changes
+
+struct WorldSnapshotHeader
+{
+	uint32 magic;
+	uint32 version;
+	uint32 key;			// checksum of the tables the snapshot was made from, see Storage_GetSnapshotKey()
+	uint32 dataSize;
+	uint32 dataCrc;
+};
+
+/** Stamps of the tables in the world database, from information_schema. Cheap, but only as
+ * good as what the server reports: tables without an update time (InnoDB before MySQL 5.7,
+ * or since the last server restart) are left out, the caller has to checksum those.
+ */
+static void Storage_GetTableStamps(map<string, string> & stamps)
+{
+	DatabaseConnection* con = WorldDatabase.GetFreeConnection();
+
+	// MySQL 8 caches these per session for a day by default, read them from the tables instead
+	QueryResult* result = WorldDatabase.FQuery("SHOW VARIABLES LIKE 'information_schema_stats_expiry'", con);
+	if(result != NULL)
+	{
+		delete result;
+		WorldDatabase.FWaitExecute("SET SESSION information_schema_stats_expiry = 0", con);
+	}
+
+	result = WorldDatabase.FQuery("SELECT TABLE_NAME, ENGINE, CREATE_TIME, UPDATE_TIME, TABLE_ROWS, AUTO_INCREMENT FROM information_schema.TABLES WHERE TABLE_SCHEMA = DATABASE()", con);
+	con->Busy.Release();
+
+	if(result == NULL)
+		return;
+
+	do
+	{
+		Field* fields = result->Fetch();
+		if(fields[0].GetString() == NULL || fields[3].GetString() == NULL)
+			continue;
+
+		// InnoDB only estimates the row count, it changes without the table changing
+		string engine = fields[1].GetString() ? fields[1].GetString() : "";
+		string stamp = engine + "," + (fields[2].GetString() ? fields[2].GetString() : "") + "," + fields[3].GetString() + ",";
+		if(engine != "InnoDB")
+			stamp += fields[4].GetString() ? fields[4].GetString() : "";
+		stamp += ",";
+		stamp += fields[5].GetString() ? fields[5].GetString() : "";
+
+		stamps[fields[0].GetString()] = stamp;
+	}
+	while(result->NextRow());
+
+	delete result;
+}
+
+/** Checksums what the snapshotted storages are built from: the format strings, the additional
+ * table bindings and the state of every table. The state is the stamp from Storage_GetTableStamps(),
+ * or what CHECKSUM TABLE reports for tables that have none, and for all of them if checksumTables is set.
+ */
+static uint32 Storage_GetSnapshotKey(bool checksumTables)
+{
+	string key;
+	char buf[64];
+
+	snprintf(buf, 64, "%u:%u;", WORLD_SNAPSHOT_VERSION, (unsigned int)sizeof(void*));
+	key += buf;
+
+	vector<string> tables;
+#define snapshot_key_table(storage, tablename, format) tables.push_back(string(tablename) + ":" + format);
+	SNAPSHOT_TABLES(snapshot_key_table)
+#undef snapshot_key_table
+
+	string strData = Config.MainConfig.GetStringDefault("Startup", "LoadAdditionalTables", "");
+	vector<string> strs = StrSplit(strData, ",");
+	for(vector<string>::iterator itr = strs.begin(); itr != strs.end(); ++itr)
+	{
+		char s1[200];
+		char s2[200];
+		if(sscanf((*itr).c_str(), "%s %s", s1, s2) == 2)
+			tables.push_back(string(s1) + ":" + s2);
+	}
+
+	map<string, string> stamps;
+	if(!checksumTables)
+		Storage_GetTableStamps(stamps);
+
+	uint32 checksummed = 0;
+	for(vector<string>::iterator itr = tables.begin(); itr != tables.end(); ++itr)
+	{
+		string name = itr->substr(0, itr->find(':'));
+		key += *itr;
+
+		map<string, string>::iterator stamp = stamps.find(name);
+		if(stamp != stamps.end())
+		{
+			key += ":" + stamp->second + ";";
+			continue;
+		}
+
+		uint64 checksum = 0;
+		QueryResult* result = WorldDatabase.Query("CHECKSUM TABLE %s", name.c_str());
+		if(result != NULL)
+		{
+			checksum = result->Fetch()[1].GetUInt64();
+			delete result;
+		}
+		++checksummed;
+
+		snprintf(buf, 64, ":" I64FMTD ";", checksum);
+		key += buf;
+	}
+
+	if(!checksumTables && checksummed)
+		Log.Notice("Storage", "%u world tables have no update time, checksummed them to check the snapshot.", checksummed);
+
+	return (uint32)crc32(0, (const Bytef*)key.c_str(), (uInt)key.length());
+}
+
+// Key of the database state the storages were loaded from. Taken before loading,
+// so a snapshot is never tagged with changes made while the server was starting.
+static uint32 s_snapshotKey = 0;
+
+bool Storage_LoadSnapshot()
+{
+	string filename = Config.MainConfig.GetStringDefault("Startup", "WorldSnapshot", "");
+	if(filename.empty())
+		return false;
+
+	// checksumming every table takes a while on a big database, it is only done if asked for
+	s_snapshotKey = Storage_GetSnapshotKey(Config.MainConfig.GetBoolDefault("Startup", "WorldSnapshotVerify", false));
+
+	FILE* f = fopen(filename.c_str(), "rb");
+	if(f == NULL)
+	{
+		Log.Notice("Storage", "No world data snapshot at %s, loading from the database.", filename.c_str());
+		return false;
+	}
+
+	WorldSnapshotHeader header;
+	if(fread(&header, sizeof(WorldSnapshotHeader), 1, f) != 1 || header.magic != WORLD_SNAPSHOT_MAGIC || header.version != WORLD_SNAPSHOT_VERSION)
+	{
+		Log.Notice("Storage", "World data snapshot %s is from another version, loading from the database.", filename.c_str());
+		fclose(f);
+		return false;
+	}
+
+	if(header.key != s_snapshotKey)
+	{
+		Log.Notice("Storage", "World database or settings changed since snapshot %s was made, loading from the database.", filename.c_str());
+		fclose(f);
+		return false;
+	}
+
+	uint8* data = (uint8*)malloc(header.dataSize ? header.dataSize : 1);
+	bool ok = (fread(data, 1, header.dataSize, f) == header.dataSize);
+	fclose(f);
+
+	if(!ok || crc32(0, data, header.dataSize) != header.dataCrc)
+	{
+		Log.Error("Storage", "World data snapshot %s is corrupt, loading from the database.", filename.c_str());
+		free(data);
+		return false;
+	}
+
+	const uint8* p = data;
+	const uint8* end = data + header.dataSize;
+
+	// stop at the first storage that fails, count is the number of storages touched so far
+#define snapshot_load_table(storage, tablename, format) \
+	if(ok) \
+	{ \
+		ok = storage.LoadSnapshot(tablename, format, p, end); \
+		++count; \
+	}
+	uint32 count = 0;
+	SNAPSHOT_TABLES(snapshot_load_table)
+#undef snapshot_load_table
+
+	free(data);
+
+	if(ok && p == end)
+		return true;
+
+	Log.Error("Storage", "World data snapshot %s is corrupt, loading from the database.", filename.c_str());
+
+	// Load() was called on the first count storages, clean them up before loading them again
+#define snapshot_cleanup_table(storage, tablename, format) \
+	if(count > 0) \
+	{ \
+		storage.Cleanup(); \
+		--count; \
+	}
+	SNAPSHOT_TABLES(snapshot_cleanup_table)
+#undef snapshot_cleanup_table
+
+	return false;
+}
+
+void Storage_SaveSnapshot()
+{
+	string filename = Config.MainConfig.GetStringDefault("Startup", "WorldSnapshot", "");
+	if(filename.empty())
+		return;
+
+	// write to a temporary file first, so a crash never leaves a half written snapshot behind
+	string tmpname = filename + ".tmp";
+	FILE* f = fopen(tmpname.c_str(), "w+b");
+	if(f == NULL)
+	{
+		Log.Error("Storage", "Could not create world data snapshot %s.", tmpname.c_str());
+		return;
+	}
+
+	WorldSnapshotHeader header;
+	memset(&header, 0, sizeof(WorldSnapshotHeader));
+	fwrite(&header, sizeof(WorldSnapshotHeader), 1, f);
+
+#define snapshot_save_table(storage, tablename, format) storage.SaveSnapshot(f);
+	SNAPSHOT_TABLES(snapshot_save_table)
+#undef snapshot_save_table
+
+	// read the data back to checksum it
+	header.magic = WORLD_SNAPSHOT_MAGIC;
+	header.version = WORLD_SNAPSHOT_VERSION;
+	header.key = s_snapshotKey;
+	header.dataSize = (uint32)(ftell(f) - sizeof(WorldSnapshotHeader));
+	header.dataCrc = 0;
+
+	fseek(f, sizeof(WorldSnapshotHeader), SEEK_SET);
+	uint8 buf[65536];
+	size_t len;
+	uLong crc = crc32(0, NULL, 0);
+	while((len = fread(buf, 1, sizeof(buf), f)) > 0)
+		crc = crc32(crc, buf, (uInt)len);
+	header.dataCrc = (uint32)crc;
+
+	fseek(f, 0, SEEK_SET);
+	fwrite(&header, sizeof(WorldSnapshotHeader), 1, f);
+
+	bool ok = (ferror(f) == 0);
+	fclose(f);
+
+	remove(filename.c_str());
+	if(!ok || rename(tmpname.c_str(), filename.c_str()) != 0)
+	{
+		Log.Error("Storage", "Could not write world data snapshot %s.", filename.c_str());
+		remove(tmpname.c_str());
+		return;
+	}
+
+	Log.Success("Storage", "Wrote world data snapshot %s (%u bytes).", filename.c_str(), header.dataSize);
+}
+
 void Storage_Cleanup()
 {
 	{
@@ -714,7 +1006,7 @@ bool Storage_ReloadTable(const char* TableName)
 	return true;
 }
 
-void Storage_LoadAdditionalTables()
+void Storage_LoadAdditionalTables(bool loadData)
 {
 	ExtraMapCreatureTables.insert(string("creature_spawns"));
 	ExtraMapGameObjectTables.insert(string("gameobject_spawns"));
@@ -734,6 +1026,13 @@ void Storage_LoadAdditionalTables()
 		if(sscanf((*itr).c_str(), "%s %s", s1, s2) != 2)
 			continue;
 
+		// when the storages came from the snapshot it already has this data, only keep the binding for reloads
+		if(!loadData && stricmp(s2, "creature_spawns") && stricmp(s2, "gameobject_spawns"))
+		{
+			additionalTables.push_back(make_pair(string(s1), string(s2)));
+			continue;
+		}
+
 		if(LoadAdditionalTable(s2, s1, true))
 		{
 			pair<string, string> tmppair;
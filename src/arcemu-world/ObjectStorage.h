@@ -47,7 +47,18 @@ extern SERVER_DECL SQLStorage< TotemDisplayIdEntry, HashMapStorageContainer< Tot
 void Storage_FillTaskList(TaskList & tl);
 void Storage_Cleanup();
 bool Storage_ReloadTable(const char* TableName);
-void Storage_LoadAdditionalTables();
+void Storage_LoadAdditionalTables(bool loadData = true);
+
+/** Loads the storages from the snapshot file set in Startup.WorldSnapshot, if it was made
+ * with the same formats from unchanged tables. Changes are found from the update times in
+ * information_schema, or from CHECKSUM TABLE for tables without one and for all of them if
+ * Startup.WorldSnapshotVerify is set. Returns false if they have to be loaded from the database.
+ */
+bool Storage_LoadSnapshot();
+
+/** Writes the loaded storages to the snapshot file, call after Storage_LoadAdditionalTables().
+ */
+void Storage_SaveSnapshot();
 
 extern SERVER_DECL set<string> ExtraMapCreatureTables;
 extern SERVER_DECL set<string> ExtraMapGameObjectTables;
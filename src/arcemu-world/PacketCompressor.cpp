@@ -0,0 +1,256 @@
+/*
+ * ArcEmu MMORPG Server
+ * Copyright (C) 2008-2012 <http://www.ArcEmu.org/>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "StdAfx.h"
+
+namespace Arcemu
+{
+	typedef std::vector< std::pair< std::string, PacketCompressorFactory > > PacketCompressorFactoryList;
+
+	static Arcemu::Utility::TLSObject< PacketCompressor* > t_packetCompressor;
+	static std::vector< PacketCompressor* > s_compressors;
+	static Mutex s_compressorLock;
+
+	static PacketCompressor* CreateZlibCompressor() { return new ZlibPacketCompressor(); }
+	static PacketCompressor* CreateOneShotCompressor() { return new OneShotPacketCompressor(); }
+
+	// the implementations are only registered at startup, so they are read without the lock
+	static PacketCompressorFactoryList & GetFactories()
+	{
+		static PacketCompressorFactoryList factories;
+		if(factories.empty())
+		{
+			factories.push_back(std::make_pair(std::string("zlib"), &CreateZlibCompressor));
+			factories.push_back(std::make_pair(std::string("oneshot"), &CreateOneShotCompressor));
+		}
+		return factories;
+	}
+
+	static size_t s_selected = 0;		// index in GetFactories(), a rehash may change it
+
+	PacketCompressor* PacketCompressor::GetThreadCompressor()
+	{
+		PacketCompressorFactory factory = GetFactories()[ s_selected ].second;
+
+		PacketCompressor* compressor = t_packetCompressor.get();
+		if(compressor != NULL && compressor->m_factory == factory)
+			return compressor;
+
+		PacketCompressor* created = factory();
+		created->m_factory = factory;
+
+		// the old one was made before a rehash selected another implementation, only this thread used it
+		s_compressorLock.Acquire();
+		if(compressor != NULL)
+		{
+			s_compressors.erase(std::find(s_compressors.begin(), s_compressors.end(), compressor));
+			delete compressor;
+		}
+		s_compressors.push_back(created);
+		s_compressorLock.Release();
+
+		t_packetCompressor.set(created);
+		return created;
+	}
+
+	void PacketCompressor::DestroyAll()
+	{
+		s_compressorLock.Acquire();
+		for(std::vector< PacketCompressor* >::iterator itr = s_compressors.begin(); itr != s_compressors.end(); ++itr)
+			delete *itr;
+		s_compressors.clear();
+		s_compressorLock.Release();
+	}
+
+	void PacketCompressor::Register(const char* name, PacketCompressorFactory factory)
+	{
+		PacketCompressorFactoryList & factories = GetFactories();
+		for(PacketCompressorFactoryList::iterator itr = factories.begin(); itr != factories.end(); ++itr)
+		{
+			if(!stricmp(itr->first.c_str(), name))
+			{
+				itr->second = factory;
+				return;
+			}
+		}
+
+		factories.push_back(std::make_pair(std::string(name), factory));
+	}
+
+	bool PacketCompressor::Select(const char* name)
+	{
+		PacketCompressorFactoryList & factories = GetFactories();
+		for(size_t i = 0; i < factories.size(); ++i)
+		{
+			if(!stricmp(factories[ i ].first.c_str(), name))
+			{
+				s_selected = i;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	const char* PacketCompressor::GetSelected()
+	{
+		return GetFactories()[ s_selected ].first.c_str();
+	}
+
+	PacketCompressor* PacketCompressor::Create(const char* name)
+	{
+		PacketCompressorFactoryList & factories = GetFactories();
+		for(PacketCompressorFactoryList::iterator itr = factories.begin(); itr != factories.end(); ++itr)
+		{
+			if(!stricmp(itr->first.c_str(), name))
+			{
+				PacketCompressor* compressor = itr->second();
+				compressor->m_factory = itr->second;
+				return compressor;
+			}
+		}
+
+		return NULL;
+	}
+
+	void PacketCompressor::GetNames(std::vector< std::string > & names)
+	{
+		PacketCompressorFactoryList & factories = GetFactories();
+		for(PacketCompressorFactoryList::iterator itr = factories.begin(); itr != factories.end(); ++itr)
+			names.push_back(itr->first);
+	}
+
+	uint32 OneShotPacketCompressor::Compress(const uint8* src, uint32 size, uint8* dest, uint32 destsize, int level, int strategy)
+	{
+		// Z_DEFAULT_COMPRESSION is level 6
+		if(level < Z_NO_COMPRESSION || level > Z_BEST_COMPRESSION)
+			level = 6;
+		if(strategy < Z_DEFAULT_STRATEGY || strategy > Z_FIXED)
+			strategy = Z_DEFAULT_STRATEGY;
+
+		z_stream stream;
+		memset(&stream, 0, sizeof(z_stream));
+
+		if(deflateInit2(&stream, level, Z_DEFLATED, MAX_WBITS, 8, strategy) != Z_OK)
+		{
+			LOG_ERROR("deflateInit2 failed.");
+			return 0;
+		}
+
+		stream.next_in   = (Bytef*)src;
+		stream.avail_in  = size;
+		stream.next_out  = (Bytef*)dest;
+		stream.avail_out = destsize;
+
+		uint32 compressed = 0;
+		if(deflate(&stream, Z_FINISH) == Z_STREAM_END)
+			compressed = (uint32)stream.total_out;
+		else
+			LOG_ERROR("deflate failed: did not end stream");
+
+		deflateEnd(&stream);
+		return compressed;
+	}
+
+	ZlibPacketCompressor::ZlibPacketCompressor()
+	{
+		for(uint32 i = 0; i <= Z_BEST_COMPRESSION; ++i)
+		{
+			memset(&m_streams[ i ].stream, 0, sizeof(z_stream));
+			m_streams[ i ].initialized = false;
+			m_streams[ i ].strategy = Z_DEFAULT_STRATEGY;
+		}
+	}
+
+	ZlibPacketCompressor::~ZlibPacketCompressor()
+	{
+		for(uint32 i = 0; i <= Z_BEST_COMPRESSION; ++i)
+			End(m_streams[ i ]);
+	}
+
+	void ZlibPacketCompressor::End(Stream & s)
+	{
+		if(s.initialized)
+		{
+			deflateEnd(&s.stream);
+			s.initialized = false;
+		}
+	}
+
+	uint32 ZlibPacketCompressor::Compress(const uint8* src, uint32 size, uint8* dest, uint32 destsize, int level, int strategy)
+	{
+		// Z_DEFAULT_COMPRESSION is level 6
+		if(level < Z_NO_COMPRESSION || level > Z_BEST_COMPRESSION)
+			level = 6;
+		if(strategy < Z_DEFAULT_STRATEGY || strategy > Z_FIXED)
+			strategy = Z_DEFAULT_STRATEGY;
+
+		Stream & s = m_streams[ level ];
+		z_stream & stream = s.stream;
+
+		if(!s.initialized)
+		{
+			if(deflateInit2(&stream, level, Z_DEFLATED, MAX_WBITS, 8, strategy) != Z_OK)
+			{
+				LOG_ERROR("deflateInit2 failed.");
+				return 0;
+			}
+
+			s.initialized = true;
+			s.strategy = strategy;
+		}
+		else if(deflateReset(&stream) != Z_OK)
+		{
+			LOG_ERROR("deflateReset failed.");
+			End(s);
+			return 0;
+		}
+
+		// set up stream pointers
+		stream.next_in   = NULL;
+		stream.avail_in  = 0;
+		stream.next_out  = (Bytef*)dest;
+		stream.avail_out = destsize;
+
+		// only after a rehash changed it, the stream was just reset and has no input yet
+		if(strategy != s.strategy)
+		{
+			if(deflateParams(&stream, level, strategy) != Z_OK)
+			{
+				LOG_ERROR("deflateParams failed.");
+				End(s);
+				return 0;
+			}
+
+			s.strategy = strategy;
+		}
+
+		stream.next_in  = (Bytef*)src;
+		stream.avail_in = size;
+
+		if(deflate(&stream, Z_FINISH) != Z_STREAM_END)
+		{
+			LOG_ERROR("deflate failed: did not end stream");
+			End(s);
+			return 0;
+		}
+
+		return (uint32)stream.total_out;
+	}
+}
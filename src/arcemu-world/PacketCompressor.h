@@ -0,0 +1,161 @@
+/*
+ * ArcEmu MMORPG Server
+ * Copyright (C) 2008-2012 <http://www.ArcEmu.org/>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef PACKETCOMPRESSOR_H
+#define PACKETCOMPRESSOR_H
+
+namespace Arcemu
+{
+	class PacketCompressor;
+
+	// Creates a new instance of a PacketCompressor implementation
+	typedef PacketCompressor* (*PacketCompressorFactory)();
+
+	//////////////////////////////////////////////////////////////////////
+	//class PacketCompressor
+	// Interface for the compressor used on outgoing update and movement
+	// packets.
+	//
+	//Every thread gets its own instance, so implementations can keep
+	//their state (zlib streams, hash tables) between calls instead of
+	//setting it up for every packet.
+	//
+	//Implementations are registered by name. Rates.Compressor selects the
+	//one the threads use, and .debug benchcompress times all of them.
+	//
+	/////////////////////////////////////////////////////////////////////
+	class SERVER_DECL PacketCompressor
+	{
+		public:
+			PacketCompressor() : m_factory(NULL) {}
+			virtual ~PacketCompressor() {}
+
+			//////////////////////////////////////////////////////////////////////////////////////////
+			//uint32 Compress( const uint8 *src, uint32 size, uint8 *dest, uint32 destsize, int level, int strategy )
+			// Compresses a buffer into a zlib stream, the format the client expects.
+			//
+			//Parameter(s)
+			// const uint8 *src  -  data to compress
+			// uint32 size       -  size of the data
+			// uint8 *dest       -  output buffer
+			// uint32 destsize   -  size of the output buffer, at least GetBound( size )
+			// int level         -  deflate compression level (0-9)
+			// int strategy      -  deflate strategy (Z_DEFAULT_STRATEGY, Z_FILTERED, ...)
+			//
+			//Return values
+			// Returns the size of the compressed data on success.
+			// Returns 0 on failure.
+			//
+			//////////////////////////////////////////////////////////////////////////////////////////
+			virtual uint32 Compress(const uint8* src, uint32 size, uint8* dest, uint32 destsize, int level, int strategy) = 0;
+
+			//Returns the worst case compressed size of size bytes of input.
+			static uint32 GetBound(uint32 size) { return size + size / 10 + 16; }
+
+			//////////////////////////////////////////////////////////////////////////////////////////
+			//static PacketCompressor* GetThreadCompressor()
+			// Returns the compressor of the calling thread, creating it if this thread doesn't
+			// have one yet.
+			//
+			//////////////////////////////////////////////////////////////////////////////////////////
+			static PacketCompressor* GetThreadCompressor();
+
+			//Deletes every compressor created so far. Only call this after all threads using them have exited.
+			static void DestroyAll();
+
+			//////////////////////////////////////////////////////////////////////////////////////////
+			//static void Register( const char *name, PacketCompressorFactory factory )
+			// Makes an implementation available to Select() and Create(). Register them at startup,
+			// before any thread compresses. zlib and oneshot are always there.
+			//
+			//Parameter(s)
+			// const char *name                 -  name used in the config and by the bench
+			// PacketCompressorFactory factory  -  creates an instance
+			//
+			//Return values
+			// None
+			//
+			//////////////////////////////////////////////////////////////////////////////////////////
+			static void Register(const char* name, PacketCompressorFactory factory);
+
+			//Makes GetThreadCompressor() hand out the implementation called name. Returns false and keeps
+			//the current one if there is no such implementation.
+			static bool Select(const char* name);
+
+			//Returns the name of the implementation GetThreadCompressor() hands out.
+			static const char* GetSelected();
+
+			//Returns a new instance of the implementation called name, or NULL. The caller deletes it.
+			static PacketCompressor* Create(const char* name);
+
+			//Returns the names of the registered implementations, in the order they were registered.
+			static void GetNames(std::vector< std::string > & names);
+
+		private:
+			PacketCompressorFactory m_factory;	// the one that created this instance
+	};
+
+	//////////////////////////////////////////////////////////////////////
+	//class OneShotPacketCompressor
+	// Sets up a new deflate stream for every packet and ends it afterwards,
+	// the way the update packets were compressed before the thread
+	// compressors. Kept as a baseline for .debug benchcompress.
+	//
+	/////////////////////////////////////////////////////////////////////
+	class SERVER_DECL OneShotPacketCompressor : public PacketCompressor
+	{
+		public:
+			uint32 Compress(const uint8* src, uint32 size, uint8* dest, uint32 destsize, int level, int strategy);
+	};
+
+	//////////////////////////////////////////////////////////////////////
+	//class ZlibPacketCompressor
+	// Default compressor. Keeps a deflate stream alive for every level it
+	// was asked for and resets it between packets instead of calling
+	// deflateInit/deflateEnd, which would allocate and free zlib's window
+	// and hash tables every time.
+	//
+	//A stream per level, because the movement packets (often level 0) and
+	//the update packets of a thread would otherwise make deflateParams
+	//switch the level of a shared stream on almost every call.
+	//
+	/////////////////////////////////////////////////////////////////////
+	class SERVER_DECL ZlibPacketCompressor : public PacketCompressor
+	{
+		public:
+			ZlibPacketCompressor();
+			~ZlibPacketCompressor();
+
+			uint32 Compress(const uint8* src, uint32 size, uint8* dest, uint32 destsize, int level, int strategy);
+
+		private:
+			struct Stream
+			{
+				z_stream stream;
+				bool initialized;
+				int strategy;
+			};
+
+			void End(Stream & s);
+
+			Stream m_streams[ Z_BEST_COMPRESSION + 1 ];
+	};
+}
+
+#endif
@@ -0,0 +1,703 @@
+/*
+ * ArcEmu MMORPG Server
+ * Copyright (C) 2008-2012 <http://www.ArcEmu.org/>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "StdAfx.h"
+
+initialiseSingleton(PathfindingMgr);
+
+class PathfindingThread : public CThread
+{
+	public:
+		bool run()
+		{
+			sPathfindingMgr.RunWorker();
+			return true;
+		}
+};
+
+// microseconds, getMSTime() is too coarse for single paths
+static uint64 GetPathTimer()
+{
+#ifdef WIN32
+	LARGE_INTEGER freq, now;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&now);
+	return uint64(now.QuadPart / freq.QuadPart) * 1000000 + uint64(now.QuadPart % freq.QuadPart) * 1000000 / freq.QuadPart;
+#else
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return uint64(tv.tv_sec) * 1000000 + tv.tv_usec;
+#endif
+}
+
+static int32 QuantizePathPos(float pos)
+{
+	return float2int32(pos / PATHFINDING_MERGE_DISTANCE);
+}
+
+PathfindingMgr::PathfindingMgr()
+{
+}
+
+PathfindingMgr::~PathfindingMgr()
+{
+	Shutdown();
+}
+
+void PathfindingMgr::Startup(uint32 threads)
+{
+	if(threads == 0)
+	{
+		Log.Notice("PathfindingMgr", "No worker threads, paths are calculated on the map threads.");
+		return;
+	}
+
+	m_running.SetVal(true);
+	for(uint32 i = 0; i < threads; ++i)
+		ThreadPool.ExecuteTask(new PathfindingThread());
+
+	Log.Success("PathfindingMgr", "Started %u worker threads.", threads);
+}
+
+void PathfindingMgr::Shutdown()
+{
+	if(!m_running.GetVal())
+		return;
+
+	m_running.SetVal(false);
+	while(m_workers.GetVal() != 0)
+	{
+		m_cond.Signal();
+		Arcemu::Sleep(10);
+	}
+
+	// nobody is going to calculate these anymore, fail them so the units holding them stop waiting
+	m_requestLock.Acquire();
+	for(std::deque< PathRequest* >::iterator itr = m_queue.begin(); itr != m_queue.end(); ++itr)
+	{
+		(*itr)->m_done.SetVal(true);
+		(*itr)->DecRef();
+	}
+	m_queue.clear();
+	m_pending.clear();
+	m_requestLock.Release();
+}
+
+bool PathfindingMgr::CalculatePath(uint32 mapId, float startx, float starty, float startz, float x, float y, float z, std::vector< G3D::Vector3 >* points)
+{
+	NavMeshData* nav = CollideInterface.AcquireNavMesh(mapId);
+	if(nav == NULL)
+		return false;
+
+	uint64 startTime = GetPathTimer();
+
+	// detour works in y z x
+	float start[VERTEX_SIZE] = { starty, startz, startx };
+	float end[VERTEX_SIZE] = { y, z, x };
+	bool cacheHit = false;
+
+	dtNavMeshQuery* query = nav->AcquireQuery();
+
+	nav->meshlock.AcquireReadLock();
+	bool result = FindPath(mapId, nav, query, start, end, points, cacheHit);
+	nav->meshlock.ReleaseReadLock();
+
+	nav->ReleaseQuery(query);
+	nav->DecRef();
+
+	AddStats(mapId, GetPathTimer() - startTime, result, cacheHit);
+	return result;
+}
+
+bool PathfindingMgr::CalculateChasePath(uint32 mapId, uint64 targetGuid, float targetx, float targety, float targetz, float startx, float starty, float startz, float x, float y, float z, std::vector< G3D::Vector3 >* points)
+{
+	NavMeshData* nav = CollideInterface.AcquireNavMesh(mapId);
+	if(nav == NULL)
+		return false;
+
+	uint64 startTime = GetPathTimer();
+
+	float target[VERTEX_SIZE] = { targety, targetz, targetx };
+	float start[VERTEX_SIZE] = { starty, startz, startx };
+	float end[VERTEX_SIZE] = { y, z, x };
+	bool built = false;
+
+	dtNavMeshQuery* query = nav->AcquireQuery();
+
+	nav->meshlock.AcquireReadLock();
+	bool result = FindChasePath(mapId, targetGuid, nav, query, target, start, end, points, built);
+	nav->meshlock.ReleaseReadLock();
+
+	nav->ReleaseQuery(query);
+	nav->DecRef();
+
+	AddChaseStats(mapId, GetPathTimer() - startTime, result, built);
+	return result;
+}
+
+PathRequest* PathfindingMgr::RequestPath(uint32 mapId, float startx, float starty, float startz, float x, float y, float z)
+{
+	PathRequestKey key;
+	key.mapId = mapId;
+	key.start[ 0 ] = QuantizePathPos(startx);
+	key.start[ 1 ] = QuantizePathPos(starty);
+	key.start[ 2 ] = QuantizePathPos(startz);
+	key.end[ 0 ] = QuantizePathPos(x);
+	key.end[ 1 ] = QuantizePathPos(y);
+	key.end[ 2 ] = QuantizePathPos(z);
+
+	m_requestLock.Acquire();
+
+	PendingRequestMap::iterator itr = m_pending.find(key);
+	if(itr != m_pending.end())
+	{
+		PathRequest* req = itr->second;
+		req->AddRef();
+		m_requestLock.Release();
+
+		m_statsLock.Acquire();
+		PathfindingStats & s = m_stats[ mapId ];
+		++s.merged;
+		m_statsLock.Release();
+		return req;
+	}
+
+	PathRequest* req = new PathRequest();
+	req->m_key = key;
+	req->m_mapId = mapId;
+	req->m_start[ 0 ] = startx;
+	req->m_start[ 1 ] = starty;
+	req->m_start[ 2 ] = startz;
+	req->m_end[ 0 ] = x;
+	req->m_end[ 1 ] = y;
+	req->m_end[ 2 ] = z;
+
+	// the queue's reference, released by the worker
+	req->AddRef();
+	m_pending.insert(std::make_pair(key, req));
+	m_queue.push_back(req);
+
+	m_requestLock.Release();
+
+	m_cond.Signal();
+	return req;
+}
+
+void PathfindingMgr::RunWorker()
+{
+	++m_workers;
+
+	while(m_running.GetVal())
+	{
+		PathRequest* req = NULL;
+
+		m_requestLock.Acquire();
+		if(!m_queue.empty())
+		{
+			req = m_queue.front();
+			m_queue.pop_front();
+		}
+		m_requestLock.Release();
+
+		if(req == NULL)
+			m_cond.Wait(PATHFINDING_WORKER_WAIT);
+		else
+			ProcessRequest(req);
+	}
+
+	--m_workers;
+}
+
+void PathfindingMgr::ProcessRequest(PathRequest* req)
+{
+	// from here on units asking for this path get a new request, so the reference count can only drop
+	m_requestLock.Acquire();
+	m_pending.erase(req->m_key);
+	m_requestLock.Release();
+
+	// if the queue holds the only reference, every unit gave up on this path
+	bool success = false;
+	if(req->m_refs.GetVal() > 1)
+		success = CalculatePath(req->m_mapId, req->m_start[ 0 ], req->m_start[ 1 ], req->m_start[ 2 ], req->m_end[ 0 ], req->m_end[ 1 ], req->m_end[ 2 ], &req->m_points);
+
+	req->m_success = success;
+	req->m_done.SetVal(true);
+	req->DecRef();
+}
+
+void PathfindingMgr::OnMeshChanged(uint32 mapId)
+{
+	CorridorKey first, last;
+	first.mapId = mapId;
+	first.startRef = first.endRef = 0;
+	last.mapId = mapId + 1;
+	last.startRef = last.endRef = 0;
+
+	m_corridorLock.Acquire();
+	m_corridors.erase(m_corridors.lower_bound(first), m_corridors.lower_bound(last));
+	m_corridorLock.Release();
+
+	m_chaseLock.Acquire();
+	for(ChaseFieldMap::iterator itr = m_chaseFields.begin(); itr != m_chaseFields.end();)
+	{
+		if(itr->second.mapId == mapId)
+			m_chaseFields.erase(itr++);
+		else
+			++itr;
+	}
+	m_chaseLock.Release();
+}
+
+void PathfindingMgr::GetStats(std::map< uint32, PathfindingStats > & stats)
+{
+	m_statsLock.Acquire();
+	stats = m_stats;
+	m_statsLock.Release();
+}
+
+bool PathfindingMgr::FindPath(uint32 mapId, NavMeshData* nav, dtNavMeshQuery* query, const float* start, const float* end, std::vector< G3D::Vector3 >* points, bool & cacheHit)
+{
+	float extents[VERTEX_SIZE] = { 3, 5, 3 };
+
+	dtQueryFilter filter;
+	filter.setIncludeFlags(NAV_GROUND | NAV_WATER | NAV_SLIME | NAV_MAGMA);
+
+	CorridorKey key;
+	key.mapId = mapId;
+	key.startRef = 0;
+	key.endRef = 0;
+	query->findNearestPoly(start, extents, &filter, &key.startRef, NULL);
+	query->findNearestPoly(end, extents, &filter, &key.endRef, NULL);
+
+	if(key.startRef == 0 || key.endRef == 0)
+		return false;
+
+	dtPolyRef path[PATHFINDING_MAX_POLYS];
+	int pathcount = 0;
+
+	if(GetCorridor(key, path, &pathcount))
+		cacheHit = true;
+	else
+	{
+		if(query->findPath(key.startRef, key.endRef, start, end, &filter, path, &pathcount, PATHFINDING_MAX_POLYS) != DT_SUCCESS)
+			return false;
+
+		if(pathcount == 0 || path[pathcount - 1] != key.endRef)
+			return false;
+
+		AddCorridor(key, path, pathcount);
+	}
+
+	float smoothPath[MAX_PATH_LENGTH * VERTEX_SIZE];
+	int32 pointcount;
+	bool usedoffmesh;
+
+	if(findSmoothPath(start, end, path, pathcount, smoothPath, &pointcount, usedoffmesh, MAX_PATH_LENGTH, nav->mesh, query, filter) != DT_SUCCESS)
+		return false;
+
+	if(points != NULL)
+	{
+		points->reserve(points->size() + pointcount);
+		for(int32 i = 0; i < pointcount; ++i)
+			points->push_back(G3D::Vector3(smoothPath[i * 3 + 2], smoothPath[i * 3 + 0], smoothPath[i * 3 + 1]));
+	}
+	return true;
+}
+
+bool PathfindingMgr::FindChasePath(uint32 mapId, uint64 targetGuid, NavMeshData* nav, dtNavMeshQuery* query, const float* target, const float* start, const float* end, std::vector< G3D::Vector3 >* points, bool & built)
+{
+	float extents[VERTEX_SIZE] = { 3, 5, 3 };
+
+	dtQueryFilter filter;
+	filter.setIncludeFlags(NAV_GROUND | NAV_WATER | NAV_SLIME | NAV_MAGMA);
+
+	dtPolyRef startRef = 0, targetRef = 0;
+	query->findNearestPoly(start, extents, &filter, &startRef, NULL);
+	query->findNearestPoly(target, extents, &filter, &targetRef, NULL);
+
+	if(startRef == 0 || targetRef == 0)
+		return false;
+
+	dtPolyRef path[PATHFINDING_MAX_POLYS];
+	int pathcount = 0;
+	uint32 now = getMSTime();
+
+	m_chaseLock.Acquire();
+
+	ChaseFieldMap::iterator itr = m_chaseFields.find(targetGuid);
+	if(itr == m_chaseFields.end() || itr->second.mapId != mapId || itr->second.targetRef != targetRef || now - itr->second.created >= PATHFINDING_CHASE_FIELD_TIME)
+	{
+		// built without the lock, another thread chasing the same target may build it too, the last one is kept
+		m_chaseLock.Release();
+
+		ChaseField field;
+		field.mapId = mapId;
+		field.targetRef = targetRef;
+		field.created = now;
+		if(!BuildChaseField(query, filter, target, targetRef, field))
+			return false;
+		built = true;
+
+		m_chaseLock.Acquire();
+
+		if(m_chaseFields.size() >= PATHFINDING_MAX_CHASE_FIELDS)
+		{
+			for(itr = m_chaseFields.begin(); itr != m_chaseFields.end();)
+			{
+				if(now - itr->second.created >= PATHFINDING_CHASE_FIELD_TIME)
+					m_chaseFields.erase(itr++);
+				else
+					++itr;
+			}
+		}
+
+		ChaseField & stored = m_chaseFields[ targetGuid ];
+		stored.mapId = field.mapId;
+		stored.targetRef = field.targetRef;
+		stored.created = field.created;
+		stored.parents.swap(field.parents);
+		pathcount = WalkChaseField(stored, startRef, path);
+	}
+	else
+		pathcount = WalkChaseField(itr->second, startRef, path);
+
+	m_chaseLock.Release();
+
+	// the start is outside of the field or on a part of the mesh not connected to the target
+	if(pathcount == 0)
+		return false;
+
+	float smoothPath[MAX_PATH_LENGTH * VERTEX_SIZE];
+	int32 pointcount;
+	bool usedoffmesh;
+
+	if(findSmoothPath(start, end, path, pathcount, smoothPath, &pointcount, usedoffmesh, MAX_PATH_LENGTH, nav->mesh, query, filter) != DT_SUCCESS)
+		return false;
+
+	if(points != NULL)
+	{
+		points->reserve(points->size() + pointcount);
+		for(int32 i = 0; i < pointcount; ++i)
+			points->push_back(G3D::Vector3(smoothPath[i * 3 + 2], smoothPath[i * 3 + 0], smoothPath[i * 3 + 1]));
+	}
+	return true;
+}
+
+bool PathfindingMgr::BuildChaseField(dtNavMeshQuery* query, dtQueryFilter & filter, const float* target, dtPolyRef targetRef, ChaseField & field)
+{
+	dtPolyRef refs[PATHFINDING_MAX_CHASE_POLYS];
+	dtPolyRef parents[PATHFINDING_MAX_CHASE_POLYS];
+	int count = 0;
+
+	// a dijkstra search from the target, every polygon reached is stored with the polygon it was reached from
+	if(query->findPolysAroundCircle(targetRef, target, PATHFINDING_CHASE_RADIUS, &filter, refs, parents, NULL, &count, PATHFINDING_MAX_CHASE_POLYS) != DT_SUCCESS || count == 0)
+		return false;
+
+	field.parents.reserve(count);
+	for(int i = 0; i < count; ++i)
+		field.parents.push_back(std::make_pair(refs[ i ], parents[ i ]));
+	std::sort(field.parents.begin(), field.parents.end());
+	return true;
+}
+
+int PathfindingMgr::WalkChaseField(const ChaseField & field, dtPolyRef startRef, dtPolyRef* path)
+{
+	int pathcount = 0;
+	dtPolyRef ref = startRef;
+
+	for(;;)
+	{
+		std::vector< std::pair< dtPolyRef, dtPolyRef > >::const_iterator itr = std::lower_bound(field.parents.begin(), field.parents.end(), std::make_pair(ref, dtPolyRef(0)));
+		if(itr == field.parents.end() || itr->first != ref || pathcount == PATHFINDING_MAX_POLYS)
+			return 0;
+
+		path[ pathcount++ ] = ref;
+
+		// the target's polygon has no parent
+		if(itr->second == 0)
+			return pathcount;
+
+		ref = itr->second;
+	}
+}
+
+bool PathfindingMgr::GetCorridor(const CorridorKey & key, dtPolyRef* path, int* pathcount)
+{
+	bool found = false;
+
+	m_corridorLock.Acquire();
+	CorridorMap::iterator itr = m_corridors.find(key);
+	if(itr != m_corridors.end())
+	{
+		*pathcount = int(itr->second.size());
+		memcpy(path, &itr->second[ 0 ], sizeof(dtPolyRef) * itr->second.size());
+		found = true;
+	}
+	m_corridorLock.Release();
+
+	return found;
+}
+
+void PathfindingMgr::AddCorridor(const CorridorKey & key, const dtPolyRef* path, int pathcount)
+{
+	m_corridorLock.Acquire();
+	if(m_corridors.size() >= PATHFINDING_MAX_CACHED_CORRIDORS)
+		m_corridors.clear();
+
+	m_corridors[ key ].assign(path, path + pathcount);
+	m_corridorLock.Release();
+}
+
+void PathfindingMgr::AddStats(uint32 mapId, uint64 time, bool success, bool cacheHit)
+{
+	m_statsLock.Acquire();
+
+	PathfindingStats & s = m_stats[ mapId ];
+	++s.requests;
+	if(cacheHit)
+		++s.cacheHits;
+	if(!success)
+		++s.failures;
+	s.totalTime += time;
+	if(time > s.maxTime)
+		s.maxTime = time;
+
+	m_statsLock.Release();
+}
+
+void PathfindingMgr::AddChaseStats(uint32 mapId, uint64 time, bool success, bool built)
+{
+	m_statsLock.Acquire();
+
+	PathfindingStats & s = m_stats[ mapId ];
+	if(built)
+		++s.chaseFields;
+	if(success)
+	{
+		++s.requests;
+		++s.chasePaths;
+	}
+	s.totalTime += time;
+	if(time > s.maxTime)
+		s.maxTime = time;
+
+	m_statsLock.Release();
+}
+
+dtStatus PathfindingMgr::findSmoothPath(const float* startPos, const float* endPos, const dtPolyRef* polyPath, const uint32 polyPathSize, float* smoothPath, int* smoothPathSize, bool & usedOffmesh, const uint32 maxSmoothPathSize, dtNavMesh* mesh, dtNavMeshQuery* query, dtQueryFilter & filter)
+{
+	*smoothPathSize = 0;
+	uint32 nsmoothPath = 0;
+	usedOffmesh = false;
+
+	dtPolyRef polys[MAX_PATH_LENGTH];
+	memcpy(polys, polyPath, sizeof(dtPolyRef)*polyPathSize);
+	uint32 npolys = polyPathSize;
+
+	float iterPos[VERTEX_SIZE], targetPos[VERTEX_SIZE];
+	if(DT_SUCCESS != query->closestPointOnPolyBoundary(polys[0], startPos, iterPos))
+		return DT_FAILURE;
+
+	if(DT_SUCCESS != query->closestPointOnPolyBoundary(polys[npolys - 1], endPos, targetPos))
+		return DT_FAILURE;
+
+	dtVcopy(&smoothPath[nsmoothPath * VERTEX_SIZE], iterPos);
+	nsmoothPath++;
+
+	// Move towards target a small advancement at a time until target reached or
+	// when ran out of memory to store the path.
+	while(npolys && nsmoothPath < maxSmoothPathSize)
+	{
+		// Find location to steer towards.
+		float steerPos[VERTEX_SIZE];
+		unsigned char steerPosFlag;
+		dtPolyRef steerPosRef = 0;
+
+		if(!getSteerTarget(iterPos, targetPos, SMOOTH_PATH_SLOP, polys, npolys, steerPos, steerPosFlag, steerPosRef, query))
+			break;
+
+		bool endOfPath = (steerPosFlag & DT_STRAIGHTPATH_END) != 0;
+		bool offMeshConnection = (steerPosFlag & DT_STRAIGHTPATH_OFFMESH_CONNECTION) != 0;
+
+		// Find movement delta.
+		float delta[VERTEX_SIZE];
+		dtVsub(delta, steerPos, iterPos);
+		float len = dtSqrt(dtVdot(delta, delta));
+		// If the steer target is end of path or off-mesh link, do not move past the location.
+		if((endOfPath || offMeshConnection) && len < SMOOTH_PATH_STEP_SIZE)
+			len = 1.0f;
+		else
+			len = SMOOTH_PATH_STEP_SIZE / len;
+
+		float moveTgt[VERTEX_SIZE];
+		dtVmad(moveTgt, iterPos, delta, len);
+
+		// Move
+		float result[VERTEX_SIZE];
+		const static uint32 MAX_VISIT_POLY = 16;
+		dtPolyRef visited[MAX_VISIT_POLY];
+
+		uint32 nvisited = 0;
+		query->moveAlongSurface(polys[0], iterPos, moveTgt, &filter, result, visited, (int*)&nvisited, MAX_VISIT_POLY);
+		npolys = fixupCorridor(polys, npolys, MAX_PATH_LENGTH, visited, nvisited);
+
+		query->getPolyHeight(visited[nvisited - 1], result, &result[1]);
+		dtVcopy(iterPos, result);
+
+		// Handle end of path and off-mesh links when close enough.
+		if(endOfPath && inRangeYZX(iterPos, steerPos, SMOOTH_PATH_SLOP, 2.0f))
+		{
+			// Reached end of path.
+			dtVcopy(iterPos, targetPos);
+			if(nsmoothPath < maxSmoothPathSize)
+			{
+				dtVcopy(&smoothPath[nsmoothPath * VERTEX_SIZE], iterPos);
+				nsmoothPath++;
+			}
+			break;
+		}
+		else if(offMeshConnection && inRangeYZX(iterPos, steerPos, SMOOTH_PATH_SLOP, 2.0f))
+		{
+			// Reached off-mesh connection.
+			usedOffmesh = true;
+
+			// Advance the path up to and over the off-mesh connection.
+			dtPolyRef prevRef = 0;
+			dtPolyRef polyRef = polys[0];
+			uint32 npos = 0;
+			while(npos < npolys && polyRef != steerPosRef)
+			{
+				prevRef = polyRef;
+				polyRef = polys[npos];
+				npos++;
+			}
+
+			for(uint32 i = npos; i < npolys; ++i)
+				polys[i - npos] = polys[i];
+
+			npolys -= npos;
+
+			// Handle the connection.
+			float startPos[VERTEX_SIZE], endPos[VERTEX_SIZE];
+			if(DT_SUCCESS == mesh->getOffMeshConnectionPolyEndPoints(prevRef, polyRef, startPos, endPos))
+			{
+				if(nsmoothPath < maxSmoothPathSize)
+				{
+					dtVcopy(&smoothPath[nsmoothPath * VERTEX_SIZE], startPos);
+					nsmoothPath++;
+				}
+				// Move position at the other side of the off-mesh link.
+				dtVcopy(iterPos, endPos);
+				query->getPolyHeight(polys[0], iterPos, &iterPos[1]);
+			}
+		}
+
+		// Store results.
+		if(nsmoothPath < maxSmoothPathSize)
+		{
+			dtVcopy(&smoothPath[nsmoothPath * VERTEX_SIZE], iterPos);
+			nsmoothPath++;
+		}
+	}
+
+	*smoothPathSize = nsmoothPath;
+
+	// this is most likely loop
+	return nsmoothPath < maxSmoothPathSize ? DT_SUCCESS : DT_FAILURE;
+}
+
+bool PathfindingMgr::getSteerTarget(const float* startPos, const float* endPos, const float minTargetDist, const dtPolyRef* path, const uint32 pathSize, float* steerPos, unsigned char & steerPosFlag, dtPolyRef & steerPosRef, dtNavMeshQuery* query)
+{
+	// Find steer target.
+	static const uint32 MAX_STEER_POINTS = 3;
+	float steerPath[MAX_STEER_POINTS * VERTEX_SIZE];
+	unsigned char steerPathFlags[MAX_STEER_POINTS];
+	dtPolyRef steerPathPolys[MAX_STEER_POINTS];
+	uint32 nsteerPath = 0;
+	dtStatus dtResult = query->findStraightPath(startPos, endPos, path, pathSize,
+	                    steerPath, steerPathFlags, steerPathPolys, (int*)&nsteerPath, MAX_STEER_POINTS);
+	if(!nsteerPath || DT_SUCCESS != dtResult)
+		return false;
+
+	// Find vertex far enough to steer to.
+	uint32 ns = 0;
+	while(ns < nsteerPath)
+	{
+		// Stop at Off-Mesh link or when point is further than slop away.
+		if((steerPathFlags[ns] & DT_STRAIGHTPATH_OFFMESH_CONNECTION) ||
+		        !inRangeYZX(&steerPath[ns * VERTEX_SIZE], startPos, minTargetDist, 1000.0f))
+			break;
+		ns++;
+	}
+	// Failed to find good point to steer to.
+	if(ns >= nsteerPath)
+		return false;
+
+	dtVcopy(steerPos, &steerPath[ns * VERTEX_SIZE]);
+	steerPos[1] = startPos[1];  // keep Z value
+	steerPosFlag = steerPathFlags[ns];
+	steerPosRef = steerPathPolys[ns];
+
+	return true;
+}
+
+uint32 PathfindingMgr::fixupCorridor(dtPolyRef* path, const uint32 npath, const uint32 maxPath, const dtPolyRef* visited, const uint32 nvisited)
+{
+	int32 furthestPath = -1;
+	int32 furthestVisited = -1;
+
+	// Find furthest common polygon.
+	for(int32 i = npath - 1; i >= 0; --i)
+	{
+		bool found = false;
+		for(int32 j = nvisited - 1; j >= 0; --j)
+		{
+			if(path[i] == visited[j])
+			{
+				furthestPath = i;
+				furthestVisited = j;
+				found = true;
+			}
+		}
+		if(found)
+			break;
+	}
+
+	// If no intersection found just return current path.
+	if(furthestPath == -1 || furthestVisited == -1)
+		return npath;
+
+	// Concatenate paths.
+
+	// Adjust beginning of the buffer to include the visited.
+	uint32 req = nvisited - furthestVisited;
+	uint32 orig = uint32(furthestPath + 1) < npath ? furthestPath + 1 : npath;
+	uint32 size = npath - orig > 0 ? npath - orig : 0;
+	if(req + size > maxPath)
+		size = maxPath - req;
+
+	if(size)
+		memmove(path + req, path + orig, size * sizeof(dtPolyRef));
+
+	// Store visited
+	for(uint32 i = 0; i < req; ++i)
+		path[i] = visited[(nvisited - 1) - i];
+
+	return req + size;
+}
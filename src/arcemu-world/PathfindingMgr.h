@@ -0,0 +1,294 @@
+/*
+ * ArcEmu MMORPG Server
+ * Copyright (C) 2008-2012 <http://www.ArcEmu.org/>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef PATHFINDINGMGR_H
+#define PATHFINDINGMGR_H
+
+//Pathfinding stuff
+#define VERTEX_SIZE 3
+#define MAX_PATH_LENGTH 512
+#define SMOOTH_PATH_STEP_SIZE   6.0f
+#define SMOOTH_PATH_SLOP        0.4f
+
+// Maximum number of polygons in the corridor between the start and the end of a path
+#define PATHFINDING_MAX_POLYS 256
+
+// Positions are rounded to this many yards when looking for a pending request to merge with
+#define PATHFINDING_MERGE_DISTANCE 1.0f
+
+// Maximum number of corridors kept in the cache, it's emptied when it gets full
+#define PATHFINDING_MAX_CACHED_CORRIDORS 4096
+
+// Time in ms an idle worker sleeps before looking at the queue again
+#define PATHFINDING_WORKER_WAIT 100
+
+// Radius around a chased unit covered by its chase field
+#define PATHFINDING_CHASE_RADIUS 80.0f
+
+// Maximum number of polygons in a chase field
+#define PATHFINDING_MAX_CHASE_POLYS 512
+
+// Time in ms a chase field is reused while its target stays on the same polygon
+#define PATHFINDING_CHASE_FIELD_TIME 1000
+
+// Expired chase fields are only removed once there are this many
+#define PATHFINDING_MAX_CHASE_FIELDS 1024
+
+inline bool inRangeYZX(const float* v1, const float* v2, const float r, const float h)
+{
+	const float dx = v2[0] - v1[0];
+	const float dy = v2[1] - v1[1]; // elevation
+	const float dz = v2[2] - v1[2];
+	return (dx * dx + dz * dz) < r * r && fabsf(dy) < h;
+}
+
+class NavMeshData;
+
+struct PathfindingStats
+{
+	uint64 requests;		// paths calculated, on the map threads or by the workers
+	uint64 merged;			// requests that joined a pending request for the same path
+	uint64 cacheHits;		// paths that reused a cached corridor
+	uint64 failures;		// paths that couldn't be found
+	uint64 chaseFields;		// chase fields built
+	uint64 chasePaths;		// paths walked from a chase field
+	uint64 totalTime;		// microseconds spent calculating paths
+	uint64 maxTime;			// longest path calculation in microseconds
+};
+
+struct PathRequestKey
+{
+	uint32 mapId;
+	int32 start[ 3 ];
+	int32 end[ 3 ];
+
+	bool operator<(const PathRequestKey & other) const
+	{
+		if(mapId != other.mapId)
+			return mapId < other.mapId;
+		int cmp = memcmp(start, other.start, sizeof(start));
+		if(cmp != 0)
+			return cmp < 0;
+		return memcmp(end, other.end, sizeof(end)) < 0;
+	}
+};
+
+//////////////////////////////////////////////////////////////////////
+//class PathRequest
+// A path waiting to be calculated by the pathfinding workers.
+//
+//Units asking for the same path while it's pending share the request.
+//Every holder has a reference and releases it with DecRef() once it
+//has read the result, or when it doesn't need the path anymore.
+//
+/////////////////////////////////////////////////////////////////////
+class SERVER_DECL PathRequest
+{
+	public:
+		uint32 GetMapId() const { return m_mapId; }
+
+		//Returns true once a worker has finished the request, the result can only be read then.
+		bool IsDone() { return m_done.GetVal(); }
+
+		//Returns true if a path was found.
+		bool Succeeded() const { return m_success; }
+
+		//The points of the path, the first one is the start position snapped to the mesh.
+		//The request may be shared, that start is the one of the unit that asked first.
+		const std::vector< G3D::Vector3 > & GetPoints() const { return m_points; }
+
+		void AddRef() { ++m_refs; }
+		void DecRef() { if((--m_refs) == 0) delete this; }
+
+	private:
+		friend class PathfindingMgr;
+
+		PathRequest() : m_success(false) { m_refs.SetVal(1); }
+
+		PathRequestKey m_key;
+		uint32 m_mapId;
+		float m_start[ 3 ];
+		float m_end[ 3 ];
+
+		bool m_success;
+		std::vector< G3D::Vector3 > m_points;
+
+		Arcemu::Threading::AtomicBoolean m_done;
+		Arcemu::Threading::AtomicCounter m_refs;
+};
+
+//////////////////////////////////////////////////////////////////////
+//class PathfindingMgr
+// Calculates paths on the navigation meshes.
+//
+//Paths can be calculated right away on the calling thread, or queued
+//for the worker threads, in which case the AI polls the returned
+//request from its update. Every thread queries the mesh through its
+//own dtNavMeshQuery taken from the mesh's pool.
+//
+//The polygon corridor found between two polygons is cached, so units
+//walking between the same places only have to smooth it.
+//
+/////////////////////////////////////////////////////////////////////
+class SERVER_DECL PathfindingMgr : public Singleton< PathfindingMgr >
+{
+	public:
+		PathfindingMgr();
+		~PathfindingMgr();
+
+		//Starts the worker threads. Without workers every path is calculated on the calling thread.
+		void Startup(uint32 threads);
+
+		//Stops the worker threads and waits for them to exit.
+		void Shutdown();
+
+		//Returns true if paths can be queued for the workers.
+		bool IsAsync() { return m_running.GetVal(); }
+
+		//////////////////////////////////////////////////////////////////////////////////////////
+		//bool CalculatePath( uint32 mapId, float startx, float starty, float startz, float x, float y, float z, std::vector< G3D::Vector3 > *points )
+		// Calculates a path on the calling thread.
+		//
+		//Parameter(s)
+		// uint32 mapId                         -  map of the navigation mesh to use
+		// float startx, starty, startz         -  where the path starts
+		// float x, y, z                        -  where the path ends
+		// std::vector< G3D::Vector3 > *points  -  the points of the path are added here, can be NULL to only test
+		//
+		//Return values
+		// Returns true if a path was found.
+		//
+		//////////////////////////////////////////////////////////////////////////////////////////
+		bool CalculatePath(uint32 mapId, float startx, float starty, float startz, float x, float y, float z, std::vector< G3D::Vector3 >* points);
+
+		//////////////////////////////////////////////////////////////////////////////////////////
+		//bool CalculateChasePath( uint32 mapId, uint64 targetGuid, float targetx, float targety, float targetz, float startx, float starty, float startz, float x, float y, float z, std::vector< G3D::Vector3 > *points )
+		// Calculates a path towards a chased unit on the calling thread, using the chase field
+		// of that unit.
+		//
+		//A chase field is the tree of shortest routes from the target's polygon to every
+		//polygon around it. It's built by the first unit chasing the target and walked by the
+		//others, until the target moves to another polygon or the field gets too old.
+		//
+		//Parameter(s)
+		// uint32 mapId                         -  map of the navigation mesh to use
+		// uint64 targetGuid                    -  the chased unit
+		// float targetx, targety, targetz      -  position of the chased unit
+		// float startx, starty, startz         -  where the path starts
+		// float x, y, z                        -  where the path ends, close to the target
+		// std::vector< G3D::Vector3 > *points  -  the points of the path are added here
+		//
+		//Return values
+		// Returns true if a path was found.
+		// Returns false if the start isn't reachable through the field, the caller should
+		// calculate the path on its own then.
+		//
+		//////////////////////////////////////////////////////////////////////////////////////////
+		bool CalculateChasePath(uint32 mapId, uint64 targetGuid, float targetx, float targety, float targetz, float startx, float starty, float startz, float x, float y, float z, std::vector< G3D::Vector3 >* points);
+
+		//////////////////////////////////////////////////////////////////////////////////////////
+		//PathRequest* RequestPath( uint32 mapId, float startx, float starty, float startz, float x, float y, float z )
+		// Queues a path for the workers. If the same path is already pending, the caller
+		// gets that request instead.
+		//
+		//Return values
+		// Returns the request with a reference for the caller.
+		//
+		//////////////////////////////////////////////////////////////////////////////////////////
+		PathRequest* RequestPath(uint32 mapId, float startx, float starty, float startz, float x, float y, float z);
+
+		//Forgets the cached corridors of a map, called when its tiles change.
+		void OnMeshChanged(uint32 mapId);
+
+		//Copies the counters of every map.
+		void GetStats(std::map< uint32, PathfindingStats > & stats);
+
+		//Loop of a worker thread.
+		void RunWorker();
+
+	private:
+		struct CorridorKey
+		{
+			uint32 mapId;
+			dtPolyRef startRef;
+			dtPolyRef endRef;
+
+			bool operator<(const CorridorKey & other) const
+			{
+				if(mapId != other.mapId)
+					return mapId < other.mapId;
+				if(startRef != other.startRef)
+					return startRef < other.startRef;
+				return endRef < other.endRef;
+			}
+		};
+
+		struct ChaseField
+		{
+			uint32 mapId;
+			dtPolyRef targetRef;
+			uint32 created;
+
+			// polygon and the next polygon towards the target, sorted by polygon
+			std::vector< std::pair< dtPolyRef, dtPolyRef > > parents;
+		};
+
+		typedef std::map< PathRequestKey, PathRequest* > PendingRequestMap;
+		typedef std::map< CorridorKey, std::vector< dtPolyRef > > CorridorMap;
+		typedef std::map< uint64, ChaseField > ChaseFieldMap;
+
+		bool FindPath(uint32 mapId, NavMeshData* nav, dtNavMeshQuery* query, const float* start, const float* end, std::vector< G3D::Vector3 >* points, bool & cacheHit);
+		void ProcessRequest(PathRequest* req);
+
+		bool FindChasePath(uint32 mapId, uint64 targetGuid, NavMeshData* nav, dtNavMeshQuery* query, const float* target, const float* start, const float* end, std::vector< G3D::Vector3 >* points, bool & built);
+		bool BuildChaseField(dtNavMeshQuery* query, dtQueryFilter & filter, const float* target, dtPolyRef targetRef, ChaseField & field);
+		int WalkChaseField(const ChaseField & field, dtPolyRef startRef, dtPolyRef* path);
+
+		bool GetCorridor(const CorridorKey & key, dtPolyRef* path, int* pathcount);
+		void AddCorridor(const CorridorKey & key, const dtPolyRef* path, int pathcount);
+
+		void AddStats(uint32 mapId, uint64 time, bool success, bool cacheHit);
+		void AddChaseStats(uint32 mapId, uint64 time, bool success, bool built);
+
+		dtStatus findSmoothPath(const float* startPos, const float* endPos, const dtPolyRef* polyPath, const uint32 polyPathSize, float* smoothPath, int* smoothPathSize, bool & usedOffmesh, const uint32 maxSmoothPathSize, dtNavMesh* mesh, dtNavMeshQuery* query, dtQueryFilter & filter);
+		bool getSteerTarget(const float* startPos, const float* endPos, const float minTargetDist, const dtPolyRef* path, const uint32 pathSize, float* steerPos, unsigned char & steerPosFlag, dtPolyRef & steerPosRef, dtNavMeshQuery* query);
+		uint32 fixupCorridor(dtPolyRef* path, const uint32 npath, const uint32 maxPath,
+		                     const dtPolyRef* visited, const uint32 nvisited);
+
+		Mutex m_requestLock;
+		PendingRequestMap m_pending;
+		std::deque< PathRequest* > m_queue;
+
+		Arcemu::Threading::ConditionVariable m_cond;
+		Arcemu::Threading::AtomicBoolean m_running;
+		Arcemu::Threading::AtomicCounter m_workers;
+
+		FastMutex m_corridorLock;
+		CorridorMap m_corridors;
+
+		FastMutex m_chaseLock;
+		ChaseFieldMap m_chaseFields;
+
+		FastMutex m_statsLock;
+		std::map< uint32, PathfindingStats > m_stats;
+};
+
+#define sPathfindingMgr PathfindingMgr::getSingleton()
+
+#endif
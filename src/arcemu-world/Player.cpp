@@ -295,6 +295,9 @@ Player::Player(uint32 guid)
 	bProcessPending		 = false;
 	for(i = 0; i < 25; ++i)
 		m_questlog[i] = NULL;
+	m_questGiverStatusGeneration.SetVal(0);
+	m_questGiverStatusLevel = 0;
+	m_dirtyStats = 0;
 
 	m_ItemInterface		 = new ItemInterface(this);
 	CurrentGossipMenu	   = NULL;
@@ -383,6 +386,10 @@ Player::Player(uint32 guid)
 	m_drunkTimer = 0;
 	m_drunk = 0;
 
+	m_groupUpdateFlags = 0;
+	m_groupUpdateChanges = 0;
+	memset(&m_groupSentStats, 0, sizeof(m_groupSentStats));
+
 	ok_to_remove = false;
 	m_modphyscritdmgPCT = 0;
 	m_RootedCritChanceBonus = 0;
@@ -1053,6 +1060,17 @@ void Player::Update(uint32 p_time)
 	}
 #endif
 
+	if(m_groupUpdateFlags != 0)
+	{
+		if(GetGroup() != NULL)
+			GetGroup()->SendPendingUpdate(this);
+		else
+		{
+			m_groupUpdateFlags = 0;
+			m_groupUpdateChanges = 0;
+		}
+	}
+
 	WorldPacket* pending_packet = m_cache->m_pendingPackets.pop();
 	while(pending_packet != NULL)
 	{
@@ -1359,7 +1377,10 @@ void Player::_EventExploration()
 		m_AreaID = AreaId;
 		UpdatePvPArea();
 		if(GetGroup())
-			GetGroup()->UpdateOutOfRangePlayer(this, 128, true, NULL);
+		{
+			m_groupUpdateFlags |= GROUP_UPDATE_FLAG_ZONEID;
+			++m_groupUpdateChanges;
+		}
 	}
 
 	// Zone update, this really should update to a parent zone if one exists.
@@ -3570,6 +3591,7 @@ QuestLogEntry* Player::GetQuestLogForEntry(uint32 quest)
 void Player::SetQuestLogSlot(QuestLogEntry* entry, uint32 slot)
 {
 	m_questlog[slot] = entry;
+	InvalidateQuestGiverStatus();
 }
 
 void Player::AddToWorld()
@@ -4271,7 +4293,7 @@ void Player::_ApplyItemMods(Item* item, int16 slot, bool apply, bool justdrokedo
 	}
 
 	if(!skip_stat_apply)
-		UpdateStats();
+		MarkStatsDirty(PLAYER_STATS_DIRTY_STATS);
 }
 
 
@@ -4972,6 +4994,7 @@ void Player::AddToFinishedQuests(uint32 quest_id)
 		return;
 
 	m_finishedQuests.insert(quest_id);
+	InvalidateQuestGiverStatus();
 }
 
 bool Player::HasFinishedQuest(uint32 quest_id)
@@ -4979,6 +5002,42 @@ bool Player::HasFinishedQuest(uint32 quest_id)
 	return (m_finishedQuests.find(quest_id) != m_finishedQuests.end());
 }
 
+uint32 Player::GetQuestGiverStatus(Creature* giver)
+{
+	if(!giver->HasQuests())
+		return sQuestMgr.CalcStatus(giver, this);
+
+	if(getLevel() != m_questGiverStatusLevel)
+	{
+		m_questGiverStatusLevel = getLevel();
+		InvalidateQuestGiverStatus();
+	}
+
+	uint32 generation = (uint32)m_questGiverStatusGeneration.GetVal();
+	uint32 entry = giver->GetEntry();
+
+	HM_NAMESPACE::hash_map< uint32, QuestGiverStatusCacheEntry >::iterator itr = m_questGiverStatusCache.find(entry);
+	if(itr != m_questGiverStatusCache.end() && itr->second.generation == generation)
+		return itr->second.status;
+
+	uint32 status = sQuestMgr.CalcStatus(giver, this);
+
+	for(std::list<QuestRelation*>::iterator q = giver->QuestsBegin(); q != giver->QuestsEnd(); ++q)
+	{
+		if(GetQuestLogForEntry((*q)->qst->id) != NULL)
+		{
+			if(itr != m_questGiverStatusCache.end())
+				m_questGiverStatusCache.erase(itr);
+			return status;
+		}
+	}
+
+	QuestGiverStatusCacheEntry & e = m_questGiverStatusCache[ entry ];
+	e.status = status;
+	e.generation = generation;
+	return status;
+}
+
 
 bool Player::HasTimedQuest(){
 	for( uint32 i = 0; i < 25; i++ )
@@ -4993,6 +5052,7 @@ void Player::ClearQuest(uint32 id)
 {
 	m_finishedQuests.erase(id);
 	m_finishedDailies.erase(id);
+	InvalidateQuestGiverStatus();
 }
 
 
@@ -5129,6 +5189,8 @@ float Player::GetParryChance()
 
 void Player::UpdateChances()
 {
+	m_dirtyStats &= ~PLAYER_STATS_DIRTY_CHANCES;
+
 	uint32 pClass = (uint32)getClass();
 	uint32 pLevel = (getLevel() > PLAYER_LEVEL_CAP) ? PLAYER_LEVEL_CAP : getLevel();
 
@@ -5218,6 +5280,8 @@ void Player::UpdateChances()
 
 void Player::UpdateChanceFields()
 {
+	m_dirtyStats &= ~PLAYER_STATS_DIRTY_CHANCE_FIELDS;
+
 	// Update spell crit values in fields
 	for(uint32 i = 0; i < 7; ++i)
 	{
@@ -5241,6 +5305,8 @@ void Player::ModAttackSpeed(int32 mod, ModType type)
 
 void Player::UpdateAttackSpeed()
 {
+	m_dirtyStats &= ~PLAYER_STATS_DIRTY_ATTACK_SPEED;
+
 	uint32 speed = 2000;
 	Item* weap ;
 
@@ -5280,6 +5346,8 @@ void Player::UpdateAttackSpeed()
 
 void Player::UpdateStats()
 {
+	m_dirtyStats &= ~PLAYER_STATS_DIRTY_STATS;
+
 	UpdateAttackSpeed();
 
 	// Formulas from wowwiki
@@ -5539,6 +5607,55 @@ void Player::UpdateStats()
 	CalcDamage();
 }
 
+// The recalculations each derived stat runs, besides its own. Follows the calls UpdateStats() and UpdateChances() make.
+static const uint32 PlayerStatDependencies[][ 2 ] =
+{
+	{ PLAYER_STATS_DIRTY_STATS,   PLAYER_STATS_DIRTY_ATTACK_SPEED | PLAYER_STATS_DIRTY_CHANCES | PLAYER_STATS_DIRTY_CHANCE_FIELDS | PLAYER_STATS_DIRTY_DAMAGE },
+	{ PLAYER_STATS_DIRTY_CHANCES, PLAYER_STATS_DIRTY_CHANCE_FIELDS },
+};
+
+void Player::MarkStatsDirty(uint32 stats)
+{
+	for(uint32 i = 0; i < sizeof(PlayerStatDependencies) / sizeof(PlayerStatDependencies[ 0 ]); ++i)
+	{
+		if(stats & PlayerStatDependencies[ i ][ 0 ])
+			stats |= PlayerStatDependencies[ i ][ 1 ];
+	}
+
+	if(!IsInWorld())
+	{
+		// nothing flushes the stats of players being loaded or teleported, so don't wait
+		m_dirtyStats |= stats;
+		UpdateDirtyStats();
+		return;
+	}
+
+	if(m_dirtyStats == 0)
+		m_mapMgr->PlayerStatsDirty(this);
+
+	m_dirtyStats |= stats;
+}
+
+void Player::UpdateDirtyStats()
+{
+	// each update clears its own flag, and UpdateStats() runs all the others too.
+	// The same order as UpdateStats(): attack speed before damage, chances before their fields.
+	if(m_dirtyStats & PLAYER_STATS_DIRTY_STATS)
+		UpdateStats();
+
+	if(m_dirtyStats & PLAYER_STATS_DIRTY_ATTACK_SPEED)
+		UpdateAttackSpeed();
+
+	if(m_dirtyStats & PLAYER_STATS_DIRTY_CHANCES)
+		UpdateChances();
+
+	if(m_dirtyStats & PLAYER_STATS_DIRTY_CHANCE_FIELDS)
+		UpdateChanceFields();
+
+	if(m_dirtyStats & PLAYER_STATS_DIRTY_DAMAGE)
+		CalcDamage();
+}
+
 uint32 Player::SubtractRestXP(uint32 amount)
 {
 	if(getLevel() >= GetMaxLevel())		// Save CPU, don't waste time on this if you've reached max_level
@@ -7523,66 +7640,29 @@ void Player::ProcessPendingUpdates()
 
 bool Player::CompressAndSendUpdateBuffer(uint32 size, const uint8* update_buffer)
 {
-	uint32 destsize = size + size / 10 + 16;
 	int rate = sWorld.getIntRate(INTRATE_COMPRESSION);
 	if(size >= 40000 && rate < 6)
 		rate = 6;
 
-	// set up stream
-	z_stream stream;
-	stream.zalloc = 0;
-	stream.zfree  = 0;
-	stream.opaque = 0;
-
-	if(deflateInit(&stream, rate) != Z_OK)
-	{
-		LOG_ERROR("deflateInit failed.");
-		return false;
-	}
-
-	uint8* buffer = new uint8[destsize];
-	//memset(buffer,0,destsize);	/* fix umr - burlex */
-
-	// set up stream pointers
-	stream.next_out  = (Bytef*)buffer + 4;
-	stream.avail_out = destsize;
-	stream.next_in   = (Bytef*)update_buffer;
-	stream.avail_in  = size;
+	// compress straight into the buffer that the socket will send from
+	uint32 destsize = Arcemu::PacketCompressor::GetBound(size);
+	SharedPacketBuffer* buffer = SharedPacketBuffer::Create(destsize + 4);
 
-	// call the actual process
-	if(deflate(&stream, Z_NO_FLUSH) != Z_OK ||
-	        stream.avail_in != 0)
+	uint32 compressed = Arcemu::PacketCompressor::GetThreadCompressor()->Compress(update_buffer, size, buffer->GetData() + 4, destsize, rate, sWorld.getIntRate(INTRATE_COMPRESSION_STRATEGY));
+	if(compressed == 0)
 	{
-		LOG_ERROR("deflate failed.");
-		delete [] buffer;
-		return false;
-	}
-
-	// finish the deflate
-	if(deflate(&stream, Z_FINISH) != Z_STREAM_END)
-	{
-		LOG_ERROR("deflate failed: did not end stream");
-		delete [] buffer;
-		return false;
-	}
-
-	// finish up
-	if(deflateEnd(&stream) != Z_OK)
-	{
-		LOG_ERROR("deflateEnd failed.");
-		delete [] buffer;
+		buffer->DecRef();
 		return false;
 	}
 
 	// fill in the full size of the compressed stream
 
-	*(uint32*)&buffer[0] = size;
+	*(uint32*)buffer->GetData() = size;
+	buffer->SetSize(compressed + 4);
 
 	// send it
-	m_session->OutPacket(SMSG_COMPRESSED_UPDATE_OBJECT, (uint16)stream.total_out + 4, buffer);
-
-	// cleanup memory
-	delete [] buffer;
+	m_session->OutPacket(SMSG_COMPRESSED_UPDATE_OBJECT, buffer);
+	buffer->DecRef();
 
 	return true;
 }
@@ -9492,12 +9572,13 @@ void Player::SetShapeShift(uint8 ss)
 		}
 	}
 
-	UpdateStats();
-	UpdateChances();
+	MarkStatsDirty(PLAYER_STATS_DIRTY_STATS);
 }
 
 void Player::CalcDamage()
 {
+	m_dirtyStats &= ~PLAYER_STATS_DIRTY_DAMAGE;
+
 	float delta;
 	float r;
 	int ss = GetShapeShift();
@@ -10090,6 +10171,9 @@ void Player::_AddSkillLine(uint32 SkillLine, uint32 Curr_sk, uint32 Max_sk)
 
 void Player::_UpdateSkillFields()
 {
+	// quests can require a skill level
+	InvalidateQuestGiverStatus();
+
 	uint32 f = PLAYER_SKILL_INFO_1_1;
 	/* Set the valid skills */
 	for(SkillMap::iterator itr = m_skills.begin(); itr != m_skills.end();)
@@ -10501,15 +10585,14 @@ void Player::EventTalentHearthOfWildChange(bool apply)
 	{
 		TotalStatModPctPos[STAT_STAMINA] += tval;
 		CalcStat(STAT_STAMINA);
-		UpdateStats();
-		UpdateChances();
+		MarkStatsDirty(PLAYER_STATS_DIRTY_STATS);
 	}
 	//increase attackpower if :
 	else if(SS == FORM_CAT)
 	{
 		SetAttackPowerMultiplier(GetFloatValue(UNIT_FIELD_ATTACK_POWER_MULTIPLIER) + tval / 200.0f);
 		SetRangedAttackPowerMultiplier(GetRangedAttackPowerMultiplier() + tval / 200.0f);
-		UpdateStats();
+		MarkStatsDirty(PLAYER_STATS_DIRTY_STATS);
 
 
 	}
@@ -10706,72 +10789,33 @@ void Player::EventDumpCompressedMovement()
 
 	m_movementBufferLock.Acquire();
 	uint32 size = (uint32)m_movementBuffer.size();
-	uint32 destsize = size + size / 10 + 16;
 	int rate = World::m_movementCompressRate;
 	if(size >= 40000 && rate < 6)
 		rate = 6;
 	if(size <= 100)
 		rate = 0;			// don't bother compressing packet smaller than this, zlib doesn't really handle them well
 
-	// set up stream
-	z_stream stream;
-	stream.zalloc = 0;
-	stream.zfree  = 0;
-	stream.opaque = 0;
-
-	if(deflateInit(&stream, rate) != Z_OK)
-	{
-		LOG_ERROR("deflateInit failed.");
-		m_movementBufferLock.Release();
-		return;
-	}
-
-	uint8* buffer = new uint8[destsize];
-
-	// set up stream pointers
-	stream.next_out  = (Bytef*)buffer + 4;
-	stream.avail_out = destsize;
-	stream.next_in   = (Bytef*)m_movementBuffer.contents();
-	stream.avail_in  = size;
+	uint32 destsize = Arcemu::PacketCompressor::GetBound(size);
+	SharedPacketBuffer* buffer = SharedPacketBuffer::Create(destsize + 4);
 
-	// call the actual process
-	if(deflate(&stream, Z_NO_FLUSH) != Z_OK ||
-	        stream.avail_in != 0)
+	uint32 compressed = Arcemu::PacketCompressor::GetThreadCompressor()->Compress(m_movementBuffer.contents(), size, buffer->GetData() + 4, destsize, rate, sWorld.getIntRate(INTRATE_COMPRESSION_STRATEGY));
+	if(compressed == 0)
 	{
-		LOG_ERROR("deflate failed.");
-		delete [] buffer;
-		m_movementBufferLock.Release();
-		return;
-	}
-
-	// finish the deflate
-	if(deflate(&stream, Z_FINISH) != Z_STREAM_END)
-	{
-		LOG_ERROR("deflate failed: did not end stream");
-		delete [] buffer;
-		m_movementBufferLock.Release();
-		return;
-	}
-
-	// finish up
-	if(deflateEnd(&stream) != Z_OK)
-	{
-		LOG_ERROR("deflateEnd failed.");
-		delete [] buffer;
+		buffer->DecRef();
 		m_movementBufferLock.Release();
 		return;
 	}
 
 	// fill in the full size of the compressed stream
 
-	*(uint32*)&buffer[0] = size;
+	*(uint32*)buffer->GetData() = size;
+	buffer->SetSize(compressed + 4);
 
 	// send it
-	m_session->OutPacket(763, (uint16)stream.total_out + 4, buffer);
-	//printf("Compressed move compressed from %u bytes to %u bytes.\n", m_movementBuffer.size(), stream.total_out + 4);
+	m_session->OutPacket(763, buffer);
+	//printf("Compressed move compressed from %u bytes to %u bytes.\n", m_movementBuffer.size(), compressed + 4);
+	buffer->DecRef();
 
-	// cleanup memory
-	delete [] buffer;
 	m_movementBuffer.clear();
 	m_movementBufferLock.Release();
 }
@@ -11899,7 +11943,7 @@ void Player::CalcExpertise()
 
 	ModUnsigned32Value(PLAYER_EXPERTISE, (int32)CalcRating(PLAYER_RATING_MODIFIER_EXPERTISE) + modifier);
 	ModUnsigned32Value(PLAYER_OFFHAND_EXPERTISE, (int32)CalcRating(PLAYER_RATING_MODIFIER_EXPERTISE) + modifier);
-	UpdateStats();
+	MarkStatsDirty(PLAYER_STATS_DIRTY_STATS);
 }
 
 void Player::UpdateKnownCurrencies(uint32 itemId, bool apply)
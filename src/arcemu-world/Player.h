@@ -369,6 +369,18 @@ enum ModType
     MOD_SPELL	= 2
 };
 
+// Derived stats that Player::MarkStatsDirty() recalculates at the end of the map update.
+// Marking one also marks the ones calculated from it, see PlayerStatDependencies in Player.cpp.
+enum PlayerDirtyStats
+{
+    PLAYER_STATS_DIRTY_ATTACK_SPEED		= 0x01,	// UpdateAttackSpeed()
+    PLAYER_STATS_DIRTY_CHANCE_FIELDS	= 0x02,	// UpdateChanceFields(), spell crit per school
+    PLAYER_STATS_DIRTY_DAMAGE			= 0x04,	// CalcDamage()
+    PLAYER_STATS_DIRTY_CHANCES			= 0x08,	// UpdateChances(), dodge, block, parry and crit
+    PLAYER_STATS_DIRTY_STATS			= 0x10,	// UpdateStats(), attack power, health, mana, regen, spell haste, block value
+    PLAYER_STATS_DIRTY_ALL				= 0x1F
+};
+
 struct spells
 {
 	uint16  spellId;
@@ -1014,7 +1026,7 @@ class SERVER_DECL Player : public Unit
 		void                SetQuestLogSlot(QuestLogEntry* entry, uint32 slot);
 
 		void         PushToRemovedQuests(uint32 questid)	{ m_removequests.insert(questid);}
-		void			PushToFinishedDailies(uint32 questid) { DailyMutex.Acquire(); m_finishedDailies.insert(questid); DailyMutex.Release();}
+		void			PushToFinishedDailies(uint32 questid) { DailyMutex.Acquire(); m_finishedDailies.insert(questid); DailyMutex.Release(); InvalidateQuestGiverStatus(); }
 		bool		HasFinishedDaily(uint32 questid) { return (m_finishedDailies.find(questid) == m_finishedDailies.end() ? false : true); }
 		void                AddToFinishedQuests(uint32 quest_id);
 		void				AreaExploredOrEventHappens(uint32 questId);   // scriptdev2
@@ -1080,6 +1092,29 @@ class SERVER_DECL Player : public Unit
 		////////////////////////////////////////////////////////////
 		void AcceptQuest(uint64 guid, uint32 quest_id);
 
+
+		/////////////////////////////////////////////////////////////
+		//uint32 GetQuestGiverStatus( Creature* giver )
+		//  Returns sQuestMgr.CalcStatus( giver, this ), cached by
+		//  creature entry until InvalidateQuestGiverStatus() is called.
+		//
+		//  The status of givers that start or end a quest that is in
+		//  the quest log follows the objectives, so it's never cached.
+		//
+		//Parameters
+		//  Creature* giver  -  the quest giver
+		//
+		//Return Value
+		//  Returns the QMGR_QUEST_* status of the giver.
+		//
+		////////////////////////////////////////////////////////////
+		uint32 GetQuestGiverStatus(Creature* giver);
+
+		// Marks every cached quest giver status stale. Called when the quest log, the finished quests,
+		// reputation or skills change. Level changes are picked up by GetQuestGiverStatus itself.
+		// Any thread may call this, the world thread does when it resets the dailies.
+		void InvalidateQuestGiverStatus() { ++m_questGiverStatusGeneration; }
+
 		//Quest related variables
 		QuestLogEntry*      m_questlog[ MAX_QUEST_LOG_SIZE ];
 		std::set<uint32>    m_removequests;
@@ -1090,6 +1125,15 @@ class SERVER_DECL Player : public Unit
 		std::set<uint32>    quest_spells;
 		std::set<uint32>    quest_mobs;
 
+		struct QuestGiverStatusCacheEntry
+		{
+			uint32 status;
+			uint32 generation;		// m_questGiverStatusGeneration when it was calculated
+		};
+		HM_NAMESPACE::hash_map< uint32, QuestGiverStatusCacheEntry > m_questGiverStatusCache;
+		Arcemu::Threading::AtomicCounter m_questGiverStatusGeneration;
+		uint32              m_questGiverStatusLevel;
+
 		void EventPortToGM(Player* p);
 		uint32 GetTeam() { return m_team; }
 		uint32 GetTeamInitial() { return myRace->team_id == 7 ? TEAM_ALLIANCE : TEAM_HORDE; }
@@ -1508,6 +1552,30 @@ class SERVER_DECL Player : public Unit
 		float GetParryChance();
 		void UpdateChances();
 		void UpdateStats();
+
+		/////////////////////////////////////////////////////////////
+		//void MarkStatsDirty( uint32 stats )
+		//  Recalculates the given derived stats, and the ones that
+		//  depend on them, once at the end of the current map update
+		//  instead of right away. Buffs, procs, stance changes and
+		//  equipment swaps of the same update share one recalculation.
+		//
+		//  Players that aren't in world are recalculated right away.
+		//
+		//Parameters
+		//  uint32 stats  -  PLAYER_STATS_DIRTY_* flags
+		//
+		//Return Value
+		//  None.
+		//
+		////////////////////////////////////////////////////////////
+		void MarkStatsDirty(uint32 stats);
+
+		// Runs the recalculations marked by MarkStatsDirty(). Called by the MapMgr.
+		void UpdateDirtyStats();
+
+		uint32 GetDirtyStats() { return m_dirtyStats; }
+
 		uint32 GetBlockDamageReduction();
 		void ApplyFeralAttackPower(bool apply, Item* item = NULL);
 
@@ -1590,6 +1658,10 @@ class SERVER_DECL Player : public Unit
 		std::set< uint64 >::iterator FindVisible(uint64 obj) { return m_visibleObjects.find(obj); }
 		void RemoveIfVisible(uint64 obj);
 
+		// Objects in range waiting to be created for this player, see MapMgr::_UpdateVisibility()
+		void QueueCreate(uint64 guid) { m_pendingCreates.insert(guid); }
+		std::set< uint64 > & GetPendingCreates() { return m_pendingCreates; }
+
 		// Misc
 		void EventCannibalize(uint32 amount);
 		bool m_AllowAreaTriggerPort;
@@ -2164,6 +2236,9 @@ class SERVER_DECL Player : public Unit
 		}
 
 		LocationVector m_last_group_position;
+		uint32 m_groupUpdateFlags;				// party stats changed since Group::SendPendingUpdate() last ran
+		uint32 m_groupUpdateChanges;			// how many times they changed, for .server partystats
+		GroupMemberStats m_groupSentStats;		// party stats the group was last told about
 		int32 m_rap_mod_pct;
 		void SummonRequest(uint32 Requestor, uint32 ZoneID, uint32 MapID, uint32 InstanceID, const LocationVector & Position);
 
@@ -2307,6 +2382,7 @@ class SERVER_DECL Player : public Unit
 		uint32 m_manafromspell;
 		uint32 m_healthfromitems;
 		uint32 m_manafromitems;
+		uint32 m_dirtyStats;		// PLAYER_STATS_DIRTY_* recalculations waiting for the end of the map update
 
 		uint32 armor_proficiency;
 		uint32 weapon_proficiency;
@@ -2330,6 +2406,7 @@ class SERVER_DECL Player : public Unit
 		std::set<Channel*> m_channels;
 		// Visible objects
 		std::set< uint64 > m_visibleObjects;
+		std::set< uint64 > m_pendingCreates;
 		// Groups/Raids
 		uint32 m_GroupInviter;
 		uint8 m_StableSlotCount;
@@ -0,0 +1,307 @@
+/*
+ * ArcEmu MMORPG Server
+ * Copyright (C) 2008-2012 <http://www.ArcEmu.org/>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "StdAfx.h"
+
+// marks the slot of a removed entry, lookups have to probe past it
+PlayerInfoIndex::Entry PlayerInfoIndex::s_removed;
+
+template< class T >
+static T* LoadAcquire(T* const volatile* src)
+{
+#ifdef WIN32
+	T* val = *src;		// volatile reads have acquire semantics on MSVC
+	_ReadWriteBarrier();
+	return val;
+#else
+	return __atomic_load_n(src, __ATOMIC_ACQUIRE);
+#endif
+}
+
+template< class T >
+static void StoreRelease(T* volatile* dest, T* value)
+{
+#ifdef WIN32
+	_ReadWriteBarrier();
+	*dest = value;		// volatile writes have release semantics on MSVC
+#else
+	__atomic_store_n(dest, value, __ATOMIC_RELEASE);
+#endif
+}
+
+PlayerInfoIndex::PlayerInfoIndex()
+{
+	m_guidTable = CreateTable(PLAYERINFOINDEX_MIN_SLOTS);
+	m_nameTable = CreateTable(PLAYERINFOINDEX_MIN_SLOTS);
+}
+
+PlayerInfoIndex::~PlayerInfoIndex()
+{
+	FreeRetired(true);
+
+	Table* tables[ 2 ] = { m_guidTable, m_nameTable };
+	for(uint32 t = 0; t < 2; ++t)
+	{
+		for(uint32 i = 0; i <= tables[ t ]->mask; ++i)
+		{
+			Entry* entry = tables[ t ]->slots[ i ];
+			if(entry != NULL && entry != &s_removed)
+				free(entry);
+		}
+		delete [] tables[ t ]->slots;
+		delete tables[ t ];
+	}
+}
+
+uint32 PlayerInfoIndex::HashGuid(uint32 guid)
+{
+	return guid * 2654435761U;
+}
+
+uint32 PlayerInfoIndex::HashName(const char* name)
+{
+	// FNV-1a over the lowercase characters
+	uint32 hash = 2166136261U;
+	for(const char* p = name; *p != 0; ++p)
+	{
+		hash ^= uint8(tolower(uint8(*p)));
+		hash *= 16777619U;
+	}
+	return hash;
+}
+
+bool PlayerInfoIndex::NameEquals(const Entry* entry, const char* name)
+{
+	const char* p = entry->name;
+	for(; *p != 0 && *name != 0; ++p, ++name)
+	{
+		if(*p != char(tolower(uint8(*name))))
+			return false;
+	}
+	return *p == *name;
+}
+
+PlayerInfoIndex::Entry* PlayerInfoIndex::CreateEntry(PlayerInfo* pn, const char* name)
+{
+	size_t len = (name != NULL) ? strlen(name) : 0;
+	Entry* entry = (Entry*)malloc(sizeof(Entry) + len);
+
+	entry->info = pn;
+	entry->guid = pn->guid;
+	for(size_t i = 0; i < len; ++i)
+		entry->name[ i ] = char(tolower(uint8(name[ i ])));
+	entry->name[ len ] = 0;
+	entry->hash = (name != NULL) ? HashName(entry->name) : HashGuid(pn->guid);
+
+	return entry;
+}
+
+PlayerInfoIndex::Table* PlayerInfoIndex::CreateTable(uint32 slots)
+{
+	Table* table = new Table;
+	table->mask = slots - 1;
+	table->used = 0;
+	table->live = 0;
+	table->slots = new Entry* volatile[ slots ];
+	for(uint32 i = 0; i < slots; ++i)
+		table->slots[ i ] = NULL;
+
+	return table;
+}
+
+PlayerInfo* PlayerInfoIndex::GetByGuid(uint32 guid) const
+{
+	Entry* entry = Find(&m_guidTable, false, HashGuid(guid), guid, NULL);
+	return (entry != NULL) ? entry->info : NULL;
+}
+
+PlayerInfo* PlayerInfoIndex::GetByName(const char* name) const
+{
+	Entry* entry = Find(&m_nameTable, true, HashName(name), 0, name);
+	return (entry != NULL) ? entry->info : NULL;
+}
+
+PlayerInfoIndex::Entry* PlayerInfoIndex::Find(Table* const volatile* tableptr, bool byName, uint32 hash, uint32 guid, const char* name) const
+{
+	Table* table = LoadAcquire(tableptr);
+
+	// the writer keeps every table at most half used, there is always an empty slot to stop at
+	for(uint32 i = hash & table->mask; ; i = (i + 1) & table->mask)
+	{
+		Entry* entry = LoadAcquire(&table->slots[ i ]);
+		if(entry == NULL)
+			return NULL;
+
+		if(entry == &s_removed || entry->hash != hash)
+			continue;
+
+		if(byName ? NameEquals(entry, name) : (entry->guid == guid))
+			return entry;
+	}
+}
+
+void PlayerInfoIndex::Insert(Table* volatile* tableptr, bool byName, Entry* entry)
+{
+	Table* table = *tableptr;
+	if((table->used + 1) * 2 > table->mask + 1)
+		table = Rebuild(tableptr);
+
+	uint32 removedSlot = table->mask + 1;
+	for(uint32 i = entry->hash & table->mask; ; i = (i + 1) & table->mask)
+	{
+		Entry* old = table->slots[ i ];
+		if(old == NULL)
+		{
+			// reuse the first removed slot on the way if there was one
+			if(removedSlot > table->mask)
+			{
+				removedSlot = i;
+				++table->used;
+			}
+			++table->live;
+			StoreRelease(&table->slots[ removedSlot ], entry);
+			return;
+		}
+
+		if(old == &s_removed)
+		{
+			if(removedSlot > table->mask)
+				removedSlot = i;
+			continue;
+		}
+
+		if(old->hash == entry->hash && (byName ? NameEquals(old, entry->name) : (old->guid == entry->guid)))
+		{
+			StoreRelease(&table->slots[ i ], entry);
+			Retire(old, NULL);
+			return;
+		}
+	}
+}
+
+void PlayerInfoIndex::Erase(Table* volatile* tableptr, bool byName, uint32 hash, uint32 guid, const char* name, PlayerInfo* pn)
+{
+	Table* table = *tableptr;
+	for(uint32 i = hash & table->mask; ; i = (i + 1) & table->mask)
+	{
+		Entry* old = table->slots[ i ];
+		if(old == NULL)
+			return;
+
+		if(old == &s_removed || old->hash != hash)
+			continue;
+
+		if(byName ? NameEquals(old, name) : (old->guid == guid))
+		{
+			if(old->info != pn)
+				return;
+
+			StoreRelease(&table->slots[ i ], &s_removed);
+			--table->live;
+			Retire(old, NULL);
+			return;
+		}
+	}
+}
+
+PlayerInfoIndex::Table* PlayerInfoIndex::Rebuild(Table* volatile* tableptr)
+{
+	Table* old = *tableptr;
+
+	// a quarter used after the rebuild, removed slots are dropped
+	uint32 slots = PLAYERINFOINDEX_MIN_SLOTS;
+	while(slots < (old->live + 1) * 4)
+		slots <<= 1;
+
+	Table* table = CreateTable(slots);
+	for(uint32 i = 0; i <= old->mask; ++i)
+	{
+		Entry* entry = old->slots[ i ];
+		if(entry == NULL || entry == &s_removed)
+			continue;
+
+		uint32 j = entry->hash & table->mask;
+		while(table->slots[ j ] != NULL)
+			j = (j + 1) & table->mask;
+
+		table->slots[ j ] = entry;
+		++table->used;
+		++table->live;
+	}
+
+	StoreRelease(tableptr, table);
+	Retire(NULL, old);
+	return table;
+}
+
+void PlayerInfoIndex::Retire(Entry* entry, Table* table)
+{
+	Retired r;
+	r.expire = UNIXTIME + PLAYERINFOINDEX_RETIRE_DELAY;
+	r.entry = entry;
+	r.table = table;
+	m_retired.push_back(r);
+}
+
+void PlayerInfoIndex::FreeRetired(bool all)
+{
+	while(!m_retired.empty() && (all || m_retired.front().expire <= UNIXTIME))
+	{
+		Retired & r = m_retired.front();
+		if(r.entry != NULL)
+			free(r.entry);
+
+		if(r.table != NULL)
+		{
+			delete [] r.table->slots;
+			delete r.table;
+		}
+		m_retired.pop_front();
+	}
+}
+
+void PlayerInfoIndex::Add(PlayerInfo* pn)
+{
+	FreeRetired(false);
+
+	Insert(&m_guidTable, false, CreateEntry(pn, NULL));
+	Insert(&m_nameTable, true, CreateEntry(pn, pn->name));
+}
+
+void PlayerInfoIndex::Remove(PlayerInfo* pn)
+{
+	FreeRetired(false);
+
+	Erase(&m_guidTable, false, HashGuid(pn->guid), pn->guid, NULL, pn);
+	Erase(&m_nameTable, true, HashName(pn->name), 0, pn->name, pn);
+}
+
+void PlayerInfoIndex::Rename(PlayerInfo* pn, const char* oldname, const char* newname)
+{
+	FreeRetired(false);
+
+	Entry* entry = Find(&m_nameTable, true, HashName(oldname), 0, oldname);
+	if(entry == NULL || entry->info != pn)
+		return;
+
+	// the new name goes in first, so the character can always be found under one of them
+	Insert(&m_nameTable, true, CreateEntry(pn, newname));
+	if(!NameEquals(entry, newname))
+		Erase(&m_nameTable, true, HashName(oldname), 0, oldname, pn);
+}
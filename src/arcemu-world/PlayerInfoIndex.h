@@ -0,0 +1,114 @@
+/*
+ * ArcEmu MMORPG Server
+ * Copyright (C) 2008-2012 <http://www.ArcEmu.org/>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef PLAYERINFOINDEX_H
+#define PLAYERINFOINDEX_H
+
+// Seconds a replaced entry or table is kept before it's freed, a lookup never holds one nearly as long
+#define PLAYERINFOINDEX_RETIRE_DELAY 60
+
+// Minimum number of slots in a table, always a power of 2
+#define PLAYERINFOINDEX_MIN_SLOTS 1024
+
+class PlayerInfo;
+
+//////////////////////////////////////////////////////////////////////
+//class PlayerInfoIndex
+// Finds the PlayerInfo of a character by guid or by name without
+//taking a lock.
+//
+//Both indexes are open addressing hash tables of immutable entries.
+//The writer only ever publishes a complete entry into a slot, or a
+//complete table into the table pointer, so a lookup on any thread
+//sees either the old or the new state. Replaced entries and tables
+//aren't freed right away but PLAYERINFOINDEX_RETIRE_DELAY seconds
+//later, like sockets are collected, instead of tracking the readers.
+//
+//Names are hashed and compared case insensitively, without making a
+//lowercase copy of the name looked up.
+//
+/////////////////////////////////////////////////////////////////////
+class SERVER_DECL PlayerInfoIndex
+{
+	public:
+		PlayerInfoIndex();
+		~PlayerInfoIndex();
+
+		PlayerInfo* GetByGuid(uint32 guid) const;
+		PlayerInfo* GetByName(const char* name) const;
+
+		//The writers below must not run at the same time, the caller serializes them.
+
+		//Adds pn by guid and name, replacing the entries with the same guid or name.
+		void Add(PlayerInfo* pn);
+
+		//Removes pn by guid, and by name if the name still points to it.
+		void Remove(PlayerInfo* pn);
+
+		//Moves pn from oldname to newname, if oldname still points to it.
+		void Rename(PlayerInfo* pn, const char* oldname, const char* newname);
+
+	private:
+		struct Entry
+		{
+			PlayerInfo* info;
+			uint32 guid;
+			uint32 hash;
+			char name[ 1 ];		// lowercase, allocated with the entry. Empty in the guid table.
+		};
+
+		struct Table
+		{
+			uint32 mask;
+			uint32 used;		// slots that aren't empty, removed ones included
+			uint32 live;		// slots holding an entry
+			Entry* volatile* slots;
+		};
+
+		struct Retired
+		{
+			time_t expire;
+			Entry* entry;
+			Table* table;
+		};
+
+		static uint32 HashGuid(uint32 guid);
+		static uint32 HashName(const char* name);
+		static bool NameEquals(const Entry* entry, const char* name);
+		static Entry* CreateEntry(PlayerInfo* pn, const char* name);	// name is NULL for the guid table
+		static Table* CreateTable(uint32 slots);
+
+		Entry* Find(Table* const volatile* table, bool byName, uint32 hash, uint32 guid, const char* name) const;
+
+		void Insert(Table* volatile* table, bool byName, Entry* entry);
+		void Erase(Table* volatile* table, bool byName, uint32 hash, uint32 guid, const char* name, PlayerInfo* pn);
+		Table* Rebuild(Table* volatile* table);
+
+		void Retire(Entry* entry, Table* table);
+		void FreeRetired(bool all);
+
+		Table* volatile m_guidTable;
+		Table* volatile m_nameTable;
+
+		std::deque< Retired > m_retired;
+
+		static Entry s_removed;
+};
+
+#endif
@@ -371,7 +371,7 @@ void WorldSession::HandleInrangeQuestgiverQuery(WorldPacket & recv_data)
 		if(pCreature->isQuestGiver())
 		{
 			data << pCreature->GetGUID();
-			data << uint8(sQuestMgr.CalcStatus(pCreature, _player));
+			data << uint8(_player->GetQuestGiverStatus(pCreature));
 			++count;
 		}
 	}
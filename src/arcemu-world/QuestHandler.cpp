@@ -73,7 +73,10 @@ void WorldSession::HandleQuestgiverStatusQueryOpcode(WorldPacket & recv_data)
 		return;
 	}
 
-	data << guid << sQuestMgr.CalcStatus(qst_giver, GetPlayer());
+	if(qst_giver->IsCreature())
+		data << guid << _player->GetQuestGiverStatus(TO_CREATURE(qst_giver));
+	else
+		data << guid << sQuestMgr.CalcStatus(qst_giver, GetPlayer());
 	SendPacket(&data);
 }
 
@@ -473,6 +473,9 @@ bool Player::AddNewFaction(FactionDBC* dbc, int32 standing, bool base)    // if
 
 void Player::OnModStanding(FactionDBC* dbc, FactionReputation* rep)
 {
+	// quests can require a reputation
+	InvalidateQuestGiverStatus();
+
 	if(SetFlagVisible(rep->flag, true) && IsInWorld())
 	{
 
@@ -309,11 +309,14 @@ Spell::Spell(Object* Caster, SpellEntry* info, bool triggered, Aura* aur)
 	m_glyphslot = 0;
 	m_charges = info->procCharges;
 
-	UniqueTargets.clear();
-	ModeratedTargets.clear();
-	for(uint32 i = 0; i < 3; ++i)
+	// take target list buffers left behind by finished spells
+	SpellPool* pool = SpellPool::GetThreadPool();
+	if(pool != NULL)
 	{
-		m_targetUnits[i].clear();
+		pool->AcquireTargetList(UniqueTargets);
+		pool->AcquireTargetList(ModeratedTargets);
+		for(uint32 i = 0; i < 3; ++i)
+			pool->AcquireTargetList(m_targetUnits[i]);
 	}
 
 	//create rune avail snapshot
@@ -346,9 +349,13 @@ Spell::~Spell()
 	////////////////////////////////////////////////////////////////////////////////////////
 
 
-	for(uint32 i = 0; i < 3; ++i)
+	SpellPool* pool = SpellPool::GetThreadPool();
+	if(pool != NULL)
 	{
-		m_targetUnits[i].clear();
+		pool->ReleaseTargetList(UniqueTargets);
+		pool->ReleaseTargetList(ModeratedTargets);
+		for(uint32 i = 0; i < 3; ++i)
+			pool->ReleaseTargetList(m_targetUnits[i]);
 	}
 
 	std::map<uint64, Aura*>::iterator itr;
@@ -1613,6 +1613,10 @@ class SERVER_DECL Spell : public EventableObject
 		Spell(Object* Caster, SpellEntry* info, bool triggered, Aura* aur);
 		~Spell();
 
+		// Spells are allocated from the SpellPool of the current thread, see SpellPool.cpp
+		static void* operator new(size_t size);
+		static void operator delete(void* p, size_t size);
+
 		int32 event_GetInstanceID() { return m_caster->GetInstanceID(); }
 
 		bool m_overrideBasePoints;
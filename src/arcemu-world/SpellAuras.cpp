@@ -852,7 +852,7 @@ void Aura::Remove()
 
 	//maybe we are removing it without even assigning it. Example when we are refreshing an aura
 	if(m_auraSlot != 0xFFFF)
-		m_target->m_auras[ m_auraSlot ] = NULL;
+		m_target->SetAuraSlot(m_auraSlot, NULL);
 
 	// reset diminishing return timer if needed
 	::UnapplyDiminishingReturnTimer(m_target, m_spellProto);
@@ -914,7 +914,8 @@ void Aura::Remove()
 
 	// We will delete this on the next update, eluding some spell crashes :|
 	m_target->AddGarbageAura(this);
-	m_target->m_auras[ m_auraSlot ] = NULL;
+	if(m_auraSlot != 0xFFFF)
+		m_target->SetAuraSlot(m_auraSlot, NULL);
 
 	//only remove channel stuff if caster == target, then it's not removed twice, for example, arcane missiles applies a dummy aura to target
 	if(caster != NULL && caster == m_target && m_spellProto->ChannelInterruptFlags != 0)
@@ -2369,7 +2370,7 @@ void Aura::SpellAuraModAttackSpeed(bool apply)
 		{
 			TO< Player* >(m_target)->ModAttackSpeed(-mod->m_amount, MOD_MELEE);
 		}
-		TO< Player* >(m_target)->UpdateStats();
+		TO< Player* >(m_target)->MarkStatsDirty(PLAYER_STATS_DIRTY_STATS);
 	}
 	else
 	{
@@ -3298,8 +3299,7 @@ void Aura::SpellAuraModStat(bool apply)
 				TO< Player* >(m_target)->CalcStat(x);
 			}
 
-			TO< Player* >(m_target)->UpdateStats();
-			TO< Player* >(m_target)->UpdateChances();
+			TO< Player* >(m_target)->MarkStatsDirty(PLAYER_STATS_DIRTY_STATS);
 		}
 		else if(m_target->IsCreature())
 		{
@@ -3322,8 +3322,7 @@ void Aura::SpellAuraModStat(bool apply)
 
 			TO< Player* >(m_target)->CalcStat(mod->m_miscValue);
 
-			TO< Player* >(m_target)->UpdateStats();
-			TO< Player* >(m_target)->UpdateChances();
+			TO< Player* >(m_target)->MarkStatsDirty(PLAYER_STATS_DIRTY_STATS);
 		}
 		else if(m_target->IsCreature())
 		{
@@ -3345,7 +3344,7 @@ void Aura::SpellAuraModSkill(bool apply)
 		else
 			TO< Player* >(m_target)->_ModifySkillBonus(mod->m_miscValue, -mod->m_amount);
 
-		TO< Player* >(m_target)->UpdateStats();
+		TO< Player* >(m_target)->MarkStatsDirty(PLAYER_STATS_DIRTY_STATS);
 	}
 }
 
@@ -3896,8 +3895,7 @@ void Aura::SpellAuraModShapeshift(bool apply)
 
 	if(p_target != NULL)
 	{
-		p_target->UpdateStats();
-		p_target->UpdateAttackSpeed();
+		p_target->MarkStatsDirty(PLAYER_STATS_DIRTY_STATS | PLAYER_STATS_DIRTY_ATTACK_SPEED);
 	}
 }
 
@@ -4144,7 +4142,7 @@ void Aura::SpellAuraModParryPerc(bool apply)
 		m_target->SetParryFromSpell(m_target->GetParryFromSpell() + amt);
 		if(p_target != NULL)
 		{
-			p_target->UpdateChances();
+			p_target->MarkStatsDirty(PLAYER_STATS_DIRTY_CHANCES);
 		}
 	}
 }
@@ -4168,7 +4166,7 @@ void Aura::SpellAuraModDodgePerc(bool apply)
 		m_target->SetDodgeFromSpell(m_target->GetDodgeFromSpell() + amt);
 		if(p_target != NULL)
 		{
-			p_target->UpdateChances();
+			p_target->MarkStatsDirty(PLAYER_STATS_DIRTY_CHANCES);
 		}
 	}
 }
@@ -4192,7 +4190,7 @@ void Aura::SpellAuraModBlockPerc(bool apply)
 		m_target->SetBlockFromSpell(m_target->GetBlockFromSpell() + amt);
 		if(p_target != NULL)
 		{
-			p_target->UpdateStats();
+			p_target->MarkStatsDirty(PLAYER_STATS_DIRTY_STATS);
 		}
 	}
 }
@@ -4223,7 +4221,7 @@ void Aura::SpellAuraModCritPerc(bool apply)
 			}*/
 			p_target->tocritchance.erase(GetSpellId());
 		}
-		p_target->UpdateChances();
+		p_target->MarkStatsDirty(PLAYER_STATS_DIRTY_CHANCES);
 	}
 }
 
@@ -4696,7 +4694,7 @@ void Aura::SpellAuraModSpellCritChance(bool apply)
 
 		p_target->spellcritperc += amt;
 		p_target->SetSpellCritFromSpell(p_target->GetSpellCritFromSpell() + amt);
-		p_target->UpdateChanceFields();
+		p_target->MarkStatsDirty(PLAYER_STATS_DIRTY_CHANCE_FIELDS);
 	}
 }
 
@@ -5059,7 +5057,7 @@ void Aura::SpellAuraModSpellCritChanceSchool(bool apply)
 		}
 	}
 	if(p_target != NULL)
-		p_target->UpdateChanceFields();
+		p_target->MarkStatsDirty(PLAYER_STATS_DIRTY_CHANCE_FIELDS);
 }
 
 void Aura::SpellAuraModPowerCost(bool apply)
@@ -5394,8 +5392,7 @@ void Aura::SpellAuraModPercStat(bool apply)
 				p_target->CalcStat(x);
 			}
 
-			p_target->UpdateStats();
-			p_target->UpdateChances();
+			p_target->MarkStatsDirty(PLAYER_STATS_DIRTY_STATS);
 		}
 		else
 		{
@@ -5418,8 +5415,7 @@ void Aura::SpellAuraModPercStat(bool apply)
 
 			p_target->CalcStat(mod->m_miscValue);
 
-			p_target->UpdateStats();
-			p_target->UpdateChances();
+			p_target->MarkStatsDirty(PLAYER_STATS_DIRTY_STATS);
 		}
 		else if(m_target->IsCreature())
 		{
@@ -5574,7 +5570,7 @@ void Aura::SpellAuraModPowerRegen(bool apply)
 	{
 		int32 val = (apply) ? mod->m_amount : -mod->m_amount;
 		p_target->m_ModInterrMRegen += val;
-		p_target->UpdateStats();
+		p_target->MarkStatsDirty(PLAYER_STATS_DIRTY_STATS);
 	}
 }
 
@@ -5833,7 +5829,7 @@ void Aura::SpellAuraSkillTalent(bool apply)
 		else
 			p_target->_ModifySkillBonus(mod->m_miscValue, -mod->m_amount);
 
-		p_target->UpdateStats();
+		p_target->MarkStatsDirty(PLAYER_STATS_DIRTY_STATS);
 	}
 }
 
@@ -6265,7 +6261,7 @@ void Aura::SpellAuraModPowerRegPerc(bool apply)
 	else
 		m_target->PctPowerRegenModifier[mod->m_miscValue] -= ((float)(mod->m_amount)) / 100.0f;
 	if(p_target != NULL)
-		p_target->UpdateStats();
+		p_target->MarkStatsDirty(PLAYER_STATS_DIRTY_STATS);
 }
 
 void Aura::SpellAuraOverrideClassScripts(bool apply)
@@ -6619,7 +6615,7 @@ void Aura::SpellAuraModManaRegInterrupt(bool apply)
 		else
 			p_target->m_ModInterrMRegenPCT -= mod->m_amount;
 
-		p_target->UpdateStats();
+		p_target->MarkStatsDirty(PLAYER_STATS_DIRTY_STATS);
 	}
 }
 
@@ -6646,8 +6642,7 @@ void Aura::SpellAuraModTotalStatPerc(bool apply)
 				p_target->CalcStat(x);
 			}
 
-			p_target->UpdateStats();
-			p_target->UpdateChances();
+			p_target->MarkStatsDirty(PLAYER_STATS_DIRTY_STATS);
 		}
 		else if(m_target->IsCreature())
 		{
@@ -6683,8 +6678,7 @@ void Aura::SpellAuraModTotalStatPerc(bool apply)
 				p_target->TotalStatModPctNeg[mod->m_miscValue] -= val;
 
 			p_target->CalcStat(mod->m_miscValue);
-			p_target->UpdateStats();
-			p_target->UpdateChances();
+			p_target->MarkStatsDirty(PLAYER_STATS_DIRTY_STATS);
 		}
 		else if(m_target->IsCreature())
 		{
@@ -6721,7 +6715,7 @@ void Aura::SpellAuraModHaste(bool apply)
 			p_target->ModAttackSpeed(-mod->m_amount, MOD_MELEE);
 		}
 
-		p_target->UpdateAttackSpeed();
+		p_target->MarkStatsDirty(PLAYER_STATS_DIRTY_ATTACK_SPEED);
 	}
 	else
 	{
@@ -6802,7 +6796,7 @@ void Aura::SpellAuraModRangedHaste(bool apply)
 		else
 			p_target->ModAttackSpeed(-mod->m_amount, MOD_RANGED);
 
-		p_target->UpdateAttackSpeed();
+		p_target->MarkStatsDirty(PLAYER_STATS_DIRTY_ATTACK_SPEED);
 	}
 	else
 	{
@@ -6826,7 +6820,7 @@ void Aura::SpellAuraModRangedAmmoHaste(bool apply)
 	else
 		p_target->ModAttackSpeed(-mod->m_amount, MOD_RANGED);
 
-	p_target->UpdateAttackSpeed();
+	p_target->MarkStatsDirty(PLAYER_STATS_DIRTY_ATTACK_SPEED);
 }
 
 void Aura::SpellAuraModResistanceExclusive(bool apply)
@@ -6892,7 +6886,7 @@ void Aura::SpellAuraModShieldBlockPCT(bool apply)
 		{
 			p_target->m_modblockabsorbvalue -= (uint32)mod->m_amount;
 		}
-		p_target->UpdateStats();
+		p_target->MarkStatsDirty(PLAYER_STATS_DIRTY_STATS);
 	}
 }
 
@@ -7113,7 +7107,7 @@ void Aura::SpellAuraModPAttackPower(bool apply)
 		}
 		else
 			p_target->ModAttackPowerMultiplier(-(float)mod->m_amount / 100.0f);
-		p_target->CalcDamage();
+		p_target->MarkStatsDirty(PLAYER_STATS_DIRTY_DAMAGE);
 	}
 }
 
@@ -7237,7 +7231,7 @@ void Aura::SpellAuraIncreaseSpellDamageByAttribute(bool apply)
 					p_target->ModPosDamageDoneMod(x, -mod->realamount);
 			}
 		}
-		p_target->UpdateChanceFields();
+		p_target->MarkStatsDirty(PLAYER_STATS_DIRTY_CHANCE_FIELDS);
 	}
 }
 
@@ -7269,7 +7263,7 @@ void Aura::SpellAuraModSpellDamageByAP(bool apply)
 			if(mod->m_miscValue & (((uint32)1) << x))
 				p_target->ModPosDamageDoneMod(x, val);
 
-		p_target->UpdateChanceFields();
+		p_target->MarkStatsDirty(PLAYER_STATS_DIRTY_CHANCE_FIELDS);
 	}
 }
 
@@ -7308,7 +7302,7 @@ void Aura::SpellAuraIncreaseHealingByAttribute(bool apply)
 		{
 			p_target->SpellHealDoneByAttribute[stat][x] += (float)val / 100.0f;
 		}
-		p_target->UpdateChanceFields();
+		p_target->MarkStatsDirty(PLAYER_STATS_DIRTY_CHANCE_FIELDS);
 		if(apply)
 		{
 			mod->realamount = float2int32(((float)val / 100.0f) * p_target->GetStat(stat));
@@ -7354,7 +7348,7 @@ void Aura::SpellAuraModHealingByAP(bool apply)
 	if(p_target != NULL)
 	{
 		p_target->ModHealingDoneMod(val);
-		p_target->UpdateChanceFields();
+		p_target->MarkStatsDirty(PLAYER_STATS_DIRTY_CHANCE_FIELDS);
 	}
 }
 
@@ -7537,7 +7531,7 @@ void Aura::SpellAuraModHealingDone(bool apply)
 	}
 	if(p_target != NULL)
 	{
-		p_target->UpdateChanceFields();
+		p_target->MarkStatsDirty(PLAYER_STATS_DIRTY_CHANCE_FIELDS);
 		p_target->ModHealingDoneMod(val);
 	}
 }
@@ -7593,7 +7587,7 @@ void Aura::SpellAuraModOffhandDamagePCT(bool apply)
 		else
 			p_target->offhand_dmg_mod /= (100 + mod->m_amount) / 100.0f;
 
-		p_target->CalcDamage();
+		p_target->MarkStatsDirty(PLAYER_STATS_DIRTY_DAMAGE);
 	}
 }
 
@@ -7781,7 +7775,7 @@ void Aura::SpellAuraMeleeHaste(bool apply)
 		else
 			TO< Player* >(m_target)->ModAttackSpeed(-mod->m_amount, MOD_MELEE);
 
-		TO< Player* >(m_target)->UpdateAttackSpeed();
+		TO< Player* >(m_target)->MarkStatsDirty(PLAYER_STATS_DIRTY_ATTACK_SPEED);
 	}
 	else
 	{
@@ -7906,7 +7900,7 @@ void Aura::SpellAuraIncreaseAllWeaponSkill(bool apply)
 			TO< Player* >(m_target)->_ModifySkillBonus(SKILL_POLEARMS, -mod->m_amount);
 		}
 
-		TO< Player* >(m_target)->UpdateStats();
+		TO< Player* >(m_target)->MarkStatsDirty(PLAYER_STATS_DIRTY_STATS);
 	}
 }
 
@@ -7916,7 +7910,7 @@ void Aura::SpellAuraIncreaseHitRate(bool apply)
 		return;
 
 	TO< Player* >(m_target)->ModifyBonuses(SPELL_HIT_RATING, mod->m_amount, apply);
-	TO< Player* >(m_target)->UpdateStats();
+	TO< Player* >(m_target)->MarkStatsDirty(PLAYER_STATS_DIRTY_STATS);
 }
 
 void Aura::SpellAuraIncreaseRageFromDamageDealtPCT(bool apply)
@@ -8068,7 +8062,7 @@ void Aura::SpellAuraIncreaseRating(bool apply)
 			}
 	}
 
-	plr->UpdateStats();
+	plr->MarkStatsDirty(PLAYER_STATS_DIRTY_STATS);
 }
 
 void Aura::EventPeriodicRegenManaStatPct(uint32 perc, uint32 stat)
@@ -8109,7 +8103,7 @@ void Aura::SpellAuraSpellHealingStatPCT(bool apply)
 		mod->realamount = ((m_target->GetUInt32Value(UNIT_FIELD_SPIRIT) * mod->m_amount) / 100);
 
 		TO_PLAYER(m_target)->ModifyBonuses(CRITICAL_STRIKE_RATING, mod->realamount, true);
-		TO_PLAYER(m_target)->UpdateChances();
+		TO_PLAYER(m_target)->MarkStatsDirty(PLAYER_STATS_DIRTY_CHANCES);
 	}
 	else
 	{
@@ -8117,7 +8111,7 @@ void Aura::SpellAuraSpellHealingStatPCT(bool apply)
 			m_target->HealDoneMod[x] -= mod->realamount;*/
 
 		TO_PLAYER(m_target)->ModifyBonuses(CRITICAL_STRIKE_RATING, mod->realamount, false);
-		TO_PLAYER(m_target)->UpdateChances();
+		TO_PLAYER(m_target)->MarkStatsDirty(PLAYER_STATS_DIRTY_CHANCES);
 	}
 }
 
@@ -8188,7 +8182,7 @@ void Aura::SpellAuraIncreaseMaxHealth(bool apply)
 		amount = -mod->m_amount;
 
 	TO< Player* >(m_target)->SetHealthFromSpell(TO< Player* >(m_target)->GetHealthFromSpell() + amount);
-	TO< Player* >(m_target)->UpdateStats();
+	TO< Player* >(m_target)->MarkStatsDirty(PLAYER_STATS_DIRTY_STATS);
 }
 
 void Aura::SpellAuraSpiritOfRedemption(bool apply)
@@ -8292,7 +8286,7 @@ void Aura::SpellAuraModBlockValue(bool apply)
 			amt = -mod->m_amount;
 		}
 		p_target->m_modblockvaluefromspells += amt;
-		p_target->UpdateStats();
+		p_target->MarkStatsDirty(PLAYER_STATS_DIRTY_STATS);
 	}
 }
 
@@ -8667,7 +8661,7 @@ void Aura::SpellAuraModBaseHealth(bool apply)
 		amt *= -1;
 
 	p_target->SetHealthFromSpell(p_target->GetHealthFromSpell() + amt);
-	p_target->UpdateStats();
+	p_target->MarkStatsDirty(PLAYER_STATS_DIRTY_STATS);
 }
 
 void Aura::SpellAuraModAttackPowerOfArmor(bool apply)
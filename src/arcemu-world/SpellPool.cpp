@@ -0,0 +1,211 @@
+/*
+ * ArcEmu MMORPG Server
+ * Copyright (C) 2008-2012 <http://www.ArcEmu.org/>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "StdAfx.h"
+
+static Arcemu::Utility::TLSObject< SpellPool* > t_spellPool;
+static std::vector< SpellPool* > s_spellPools;		// every pool, for the statistics and DestroyAll()
+static std::vector< SpellPool* > s_idleSpellPools;	// pools handed back by threads, waiting for a new one
+static Mutex s_spellPoolLock;
+static Arcemu::Threading::AtomicBoolean s_spellPoolsDestroyed(false);
+
+SpellPool* SpellPool::GetThreadPool()
+{
+	if(s_spellPoolsDestroyed.GetVal())
+		return NULL;
+
+	SpellPool* pool = t_spellPool.get();
+	if(pool != NULL)
+		return pool;
+
+	s_spellPoolLock.Acquire();
+	if(s_spellPoolsDestroyed.GetVal())
+	{
+		s_spellPoolLock.Release();
+		return NULL;
+	}
+
+	if(!s_idleSpellPools.empty())
+	{
+		pool = s_idleSpellPools.back();
+		s_idleSpellPools.pop_back();
+	}
+	else
+	{
+		pool = new SpellPool();
+		s_spellPools.push_back(pool);
+	}
+	s_spellPoolLock.Release();
+
+	t_spellPool.set(pool);
+	return pool;
+}
+
+void SpellPool::ReleaseThreadPool()
+{
+	SpellPool* pool = t_spellPool.get();
+	if(pool == NULL)
+		return;
+
+	t_spellPool.set(NULL);
+
+	s_spellPoolLock.Acquire();
+	if(!s_spellPoolsDestroyed.GetVal())
+		s_idleSpellPools.push_back(pool);
+	s_spellPoolLock.Release();
+}
+
+void SpellPool::DestroyAll()
+{
+	s_spellPoolLock.Acquire();
+	s_spellPoolsDestroyed.SetVal(true);
+	for(std::vector< SpellPool* >::iterator itr = s_spellPools.begin(); itr != s_spellPools.end(); ++itr)
+		delete *itr;
+	s_spellPools.clear();
+	s_idleSpellPools.clear();
+	s_spellPoolLock.Release();
+}
+
+void SpellPool::GetStats(SpellPoolStats & stats)
+{
+	memset(&stats, 0, sizeof(SpellPoolStats));
+
+	s_spellPoolLock.Acquire();
+	for(std::vector< SpellPool* >::iterator itr = s_spellPools.begin(); itr != s_spellPools.end(); ++itr)
+	{
+		// the counters are written by the owning thread without locking, this is only for statistics
+		SpellPoolStats & s = (*itr)->m_stats;
+		stats.spellsCreated += s.spellsCreated;
+		stats.spellsReused += s.spellsReused;
+		stats.listsAcquired += s.listsAcquired;
+		stats.listsReused += s.listsReused;
+		stats.listsFilled += s.listsFilled;
+	}
+	s_spellPoolLock.Release();
+}
+
+SpellPool::SpellPool()
+{
+	memset(&m_stats, 0, sizeof(SpellPoolStats));
+
+	// reserved up front, growing a vector of lists would copy every buffer in it
+	m_freeSpells.reserve(SPELLPOOL_MAX_FREE_SPELLS);
+	m_freeTargetLists.reserve(SPELLPOOL_MAX_FREE_LISTS);
+	m_freeModeratedLists.reserve(SPELLPOOL_MAX_FREE_LISTS);
+}
+
+SpellPool::~SpellPool()
+{
+	for(std::vector< void* >::iterator itr = m_freeSpells.begin(); itr != m_freeSpells.end(); ++itr)
+		::operator delete(*itr);
+}
+
+void* SpellPool::AllocateSpell(size_t size)
+{
+	++m_stats.spellsCreated;
+
+	// the factory spells don't add members, so practically every spell has the same size
+	if(size == sizeof(Spell) && !m_freeSpells.empty())
+	{
+		void* p = m_freeSpells.back();
+		m_freeSpells.pop_back();
+		++m_stats.spellsReused;
+		return p;
+	}
+
+	return ::operator new(size);
+}
+
+void SpellPool::FreeSpell(void* p, size_t size)
+{
+	if(size == sizeof(Spell) && m_freeSpells.size() < SPELLPOOL_MAX_FREE_SPELLS)
+		m_freeSpells.push_back(p);
+	else
+		::operator delete(p);
+}
+
+template< class L >
+void SpellPool::Acquire(std::vector< L > & freeLists, L & list)
+{
+	++m_stats.listsAcquired;
+
+	if(freeLists.empty())
+		return;
+
+	list.swap(freeLists.back());
+	freeLists.pop_back();
+	++m_stats.listsReused;
+}
+
+template< class L >
+void SpellPool::Release(std::vector< L > & freeLists, L & list)
+{
+	if(list.capacity() == 0)
+		return;
+
+	++m_stats.listsFilled;
+
+	if(list.capacity() > SPELLPOOL_MAX_LIST_CAPACITY || freeLists.size() >= SPELLPOOL_MAX_FREE_LISTS)
+		return;
+
+	list.clear();
+	freeLists.push_back(L());
+	freeLists.back().swap(list);
+}
+
+void SpellPool::AcquireTargetList(TargetsList & list)
+{
+	Acquire(m_freeTargetLists, list);
+}
+
+void SpellPool::AcquireTargetList(SpellTargetsList & list)
+{
+	Acquire(m_freeModeratedLists, list);
+}
+
+void SpellPool::ReleaseTargetList(TargetsList & list)
+{
+	Release(m_freeTargetLists, list);
+}
+
+void SpellPool::ReleaseTargetList(SpellTargetsList & list)
+{
+	Release(m_freeModeratedLists, list);
+}
+
+void* Spell::operator new(size_t size)
+{
+	SpellPool* pool = SpellPool::GetThreadPool();
+	if(pool == NULL)
+		return ::operator new(size);
+
+	return pool->AllocateSpell(size);
+}
+
+void Spell::operator delete(void* p, size_t size)
+{
+	if(p == NULL)
+		return;
+
+	SpellPool* pool = SpellPool::GetThreadPool();
+	if(pool == NULL)
+		::operator delete(p);
+	else
+		pool->FreeSpell(p, size);
+}
@@ -0,0 +1,108 @@
+/*
+ * ArcEmu MMORPG Server
+ * Copyright (C) 2008-2012 <http://www.ArcEmu.org/>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SPELLPOOL_H
+#define SPELLPOOL_H
+
+// Maximum number of freed Spell blocks a thread keeps around for the next casts
+#define SPELLPOOL_MAX_FREE_SPELLS 256
+
+// Maximum number of target list buffers a thread keeps around for the next casts
+#define SPELLPOOL_MAX_FREE_LISTS 1024
+
+// Target list buffers that grew bigger than this (large AoE) are freed instead of kept
+#define SPELLPOOL_MAX_LIST_CAPACITY 64
+
+struct SpellPoolStats
+{
+	uint64 spellsCreated;		// Spell objects allocated
+	uint64 spellsReused;		// of those, the ones placed in a recycled block
+	uint64 listsAcquired;		// target lists handed to new spells
+	uint64 listsReused;			// of those, the ones that came with a recycled buffer
+	uint64 listsFilled;			// target lists handed back with a buffer, recycled or allocated
+};
+
+//////////////////////////////////////////////////////////////////////
+//class SpellPool
+// Recycles the memory of finished spells.
+//
+//Every thread (so every map) has its own pool. Spell::operator new
+//takes its block from the pool of the creating thread, and the blocks
+//of deleted spells go back to the pool of the deleting thread.
+//
+//A thread that is done casting, like a map thread whose map was
+//unloaded, hands its pool back with ReleaseThreadPool(). The next
+//thread that needs one takes it over, so there are never more pools
+//than threads casting at the same time.
+//
+//The target lists of a spell are handed back to the pool too when the
+//spell is deleted, emptied but with their buffer, and the next spell
+//cast on that thread fills them without allocating.
+//
+/////////////////////////////////////////////////////////////////////
+class SERVER_DECL SpellPool
+{
+	public:
+		//////////////////////////////////////////////////////////////////////////////////////////
+		//static SpellPool* GetThreadPool()
+		// Returns the pool of the calling thread, creating it if this thread doesn't have one yet.
+		//
+		//Return values
+		// Returns NULL once DestroyAll() was called.
+		//
+		//////////////////////////////////////////////////////////////////////////////////////////
+		static SpellPool* GetThreadPool();
+
+		//Detaches the pool of the calling thread and keeps it for the next thread that needs one.
+		static void ReleaseThreadPool();
+
+		//Deletes every pool created so far. Spells created or deleted afterwards use the heap directly.
+		static void DestroyAll();
+
+		//Adds up the counters of every pool.
+		static void GetStats(SpellPoolStats & stats);
+
+		void* AllocateSpell(size_t size);
+		void FreeSpell(void* p, size_t size);
+
+		//Swaps an empty list with a recycled buffer into list.
+		void AcquireTargetList(TargetsList & list);
+		void AcquireTargetList(SpellTargetsList & list);
+
+		//Takes the buffer of list for the next spell, leaving list empty.
+		void ReleaseTargetList(TargetsList & list);
+		void ReleaseTargetList(SpellTargetsList & list);
+
+	private:
+		SpellPool();
+		~SpellPool();
+
+		template< class L >
+		void Acquire(std::vector< L > & freeLists, L & list);
+
+		template< class L >
+		void Release(std::vector< L > & freeLists, L & list);
+
+		std::vector< void* > m_freeSpells;
+		std::vector< TargetsList > m_freeTargetLists;
+		std::vector< SpellTargetsList > m_freeModeratedLists;
+		SpellPoolStats m_stats;
+};
+
+#endif
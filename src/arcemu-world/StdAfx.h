@@ -184,6 +184,7 @@ extern SERVER_DECL SessionLogWriter* Player_Log;
 #include "NameTables.h"
 #include "NPCHandler.h"
 #include "Pet.h"
+#include "PacketCompressor.h"
 #include "WorldSocket.h"
 #include "WorldSession.h"
 #include "WorldStatesHandler.h"
@@ -196,6 +197,7 @@ extern SERVER_DECL SessionLogWriter* Player_Log;
 #include "SpellNameHashes.h"
 #include "Spell.h"
 #include "SpellMgr.h"
+#include "SpellPool.h"
 #include "SpellAuras.h"
 #include "TaxiMgr.h"
 #include "TransporterHandler.h"
@@ -205,6 +207,7 @@ extern SERVER_DECL SessionLogWriter* Player_Log;
 #include "ItemInterface.h"
 #include "Stats.h"
 #include "WorldCreator.h"
+#include "PlayerInfoIndex.h"
 #include "ObjectMgr.h"
 #include "CThreads.h"
 #include "ScriptMgr.h"
@@ -223,6 +226,7 @@ extern SERVER_DECL SessionLogWriter* Player_Log;
 #include "CommonScheduleThread.h"
 #include "LocalizationMgr.h"
 #include "CollideInterface.h"
+#include "PathfindingMgr.h"
 #include "Master.h"
 #include "BaseConsole.h"
 #include "CConsole.h"
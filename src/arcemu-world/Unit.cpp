@@ -384,6 +384,9 @@ Unit::Unit()
 	m_damageShields.clear();
 	m_reflectSpellSchool.clear();
 	m_procSpells.clear();
+	m_procBucketMask = 0;
+	m_procSequence = 0;
+	m_procSpellsDirty = false;
 	m_chargeSpells.clear();
 	m_chargeSpellRemoveQueue.clear();
 	tmpAura.clear();
@@ -719,6 +722,9 @@ Unit::~Unit()
 	for(std::list<SpellProc*>::iterator itr = m_procSpells.begin(); itr != m_procSpells.end(); ++itr)
 		delete *itr;
 	m_procSpells.clear();
+	for(uint32 i = 0; i < 32; ++i)
+		m_procBuckets[ i ].clear();
+	m_procBucketMask = 0;
 
 	m_singleTargetAura.clear();
 
@@ -990,22 +996,52 @@ uint32 Unit::HandleProc(uint32 flag, Unit* victim, SpellEntry* CastingSpell, boo
 		return 0;
 	}
 
-	std::list<SpellProc*>::iterator itr, itr2;
-	for(itr = m_procSpells.begin(); itr != m_procSpells.end();)    // Proc Trigger Spells for Victim
+	// only the buckets of the bits set in flag can hold procs that pass CheckProcFlags()
+	uint32 procBuckets[32];
+	uint32 procCursors[32];
+	uint32 procBucketCount = 0;
+	uint32 procMask = flag & m_procBucketMask;
+	for(uint32 i = 0; procMask != 0; ++i, procMask >>= 1)
 	{
-		itr2 = itr;
-		++itr;
-
-		SpellProc* spell_proc = *itr2;
+		if(procMask & 1)
+		{
+			procBuckets[ procBucketCount ] = i;
+			procCursors[ procBucketCount ] = 0;
+			++procBucketCount;
+		}
+	}
 
-		// Check if list item was deleted elsewhere, so here it's removed and freed
-		if(spell_proc->mDeleted)
+	for(;;)    // Proc Trigger Spells for Victim
+	{
+		// Merge the buckets by seq, so procs are still checked in the order they were added,
+		// and a proc that is in more than one of them only once. The buckets are indexed
+		// instead of iterated, procs added by nested procs are appended and visited too.
+		SpellProc* spell_proc = NULL;
+		uint32 seq = 0;
+		for(uint32 i = 0; i < procBucketCount; ++i)
 		{
-			if(can_delete)
+			std::vector< ProcBucketEntry > & bucket = m_procBuckets[ procBuckets[ i ] ];
+			if(procCursors[ i ] < bucket.size() && (spell_proc == NULL || bucket[ procCursors[ i ] ].seq < seq))
 			{
-				m_procSpells.erase(itr2);
-				delete spell_proc;
+				seq = bucket[ procCursors[ i ] ].seq;
+				spell_proc = bucket[ procCursors[ i ] ].proc;
 			}
+		}
+
+		if(spell_proc == NULL)
+			break;
+
+		for(uint32 i = 0; i < procBucketCount; ++i)
+		{
+			std::vector< ProcBucketEntry > & bucket = m_procBuckets[ procBuckets[ i ] ];
+			if(procCursors[ i ] < bucket.size() && bucket[ procCursors[ i ] ].seq == seq)
+				++procCursors[ i ];
+		}
+
+		// Check if list item was deleted elsewhere, it's freed once the top level proc is done
+		if(spell_proc->mDeleted)
+		{
+			m_procSpellsDirty = true;
 			continue;
 		}
 
@@ -1480,6 +1516,7 @@ uint32 Unit::HandleProc(uint32 flag, Unit* victim, SpellEntry* CastingSpell, boo
 							spell->prepare(&targets);
 						}
 						spell_proc->mDeleted = true;
+						m_procSpellsDirty = true;
 						continue;
 					}
 					break;
@@ -2448,6 +2485,9 @@ uint32 Unit::HandleProc(uint32 flag, Unit* victim, SpellEntry* CastingSpell, boo
 		}
 	}
 
+	if(can_delete && m_procSpellsDirty)
+		_SweepDeletedProcs();
+
 	m_chargeSpellsInUse = true;
 	std::map<uint32, struct SpellCharge>::iterator iter, iter2;
 	iter = m_chargeSpells.begin();
@@ -4022,7 +4062,7 @@ void Unit::Strike(Unit* pVictim, uint32 weapon_damage_type, SpellEntry* ability,
 			if(Rand(pr->GetSkillUpChance(SKILL_DEFENSE) * sWorld.getRate(RATE_SKILLCHANCE)))
 			{
 				pr->_AdvanceSkillLine(SKILL_DEFENSE, float2int32(1.0f * sWorld.getRate(RATE_SKILLRATE)));
-				pr->UpdateChances();
+				pr->MarkStatsDirty(PLAYER_STATS_DIRTY_CHANCES);
 			}
 		}
 		else
@@ -4603,11 +4643,11 @@ void Unit::AddAura(Aura* aur)
 
 	// Zack : No idea how a new aura can already have a slot. Leaving it for compatibility
 	if(aur->m_auraSlot != 0xffff)
-		m_auras[ aur->m_auraSlot ] = NULL;
+		SetAuraSlot(aur->m_auraSlot, NULL);
 
 	aur->m_auraSlot = AuraSlot;
 
-	m_auras[ AuraSlot ] = aur;
+	SetAuraSlot(AuraSlot, aur);
 
 	ModVisualAuraStackCount(aur, 1);
 
@@ -5025,52 +5065,91 @@ bool Unit::SetAurDuration(uint32 spellId, uint32 duration)
 }
 
 
+std::vector< Unit::AuraIndexEntry >::iterator Unit::_FindAuraIndexSlot(uint32 slot)
+{
+	std::vector< AuraIndexEntry >::iterator itr = m_auraIndex.begin();
+	while(itr != m_auraIndex.end() && itr->slot < slot)
+		++itr;
+	return itr;
+}
+
+void Unit::SetAuraSlot(uint32 slot, Aura* aur)
+{
+	ARCEMU_ASSERT(slot < MAX_TOTAL_AURAS_END);
+
+	m_auras[ slot ] = aur;
+
+	std::vector< AuraIndexEntry >::iterator itr = _FindAuraIndexSlot(slot);
+	if(itr != m_auraIndex.end() && itr->slot == slot)
+	{
+		if(aur == NULL)
+		{
+			m_auraIndex.erase(itr);
+			return;
+		}
+	}
+	else
+	{
+		if(aur == NULL)
+			return;
+
+		itr = m_auraIndex.insert(itr, AuraIndexEntry());
+	}
+
+	SpellEntry* sp = aur->GetSpellProto();
+	itr->aura = aur;
+	itr->spellId = aur->GetSpellId();
+	itr->nameHash = sp->NameHash;
+	itr->slot = static_cast< uint16 >(slot);
+	itr->appliesAuraMask = 0;
+	itr->applyAuraMask = 0;
+	for(uint32 i = 0; i < MAX_SPELL_EFFECTS; ++i)
+	{
+		itr->auraNames[ i ] = static_cast< uint16 >(sp->EffectApplyAuraName[ i ]);
+		if(sp->EffectAppliesAura(i))
+			itr->appliesAuraMask |= (1 << i);
+		if(sp->Effect[ i ] == SPELL_EFFECT_APPLY_AURA)
+			itr->applyAuraMask |= (1 << i);
+	}
+}
+
 Aura* Unit::FindAuraByNameHash(uint32 namehash, uint64 guid)
 {
-	Aura* aura;
-	for(uint32 x = MAX_TOTAL_AURAS_START; x < MAX_TOTAL_AURAS_END; x++)
+	for(std::vector< AuraIndexEntry >::iterator itr = m_auraIndex.begin(); itr != m_auraIndex.end(); ++itr)
 	{
-		aura = m_auras[x];
-		if(aura != NULL && aura->GetSpellProto()->NameHash == namehash && aura->m_casterGuid == guid)
-			return aura;
+		if(itr->nameHash == namehash && itr->aura->m_casterGuid == guid)
+			return itr->aura;
 	}
 	return NULL;
 }
 
 Aura* Unit::FindAuraByNameHash(uint32 namehash)
 {
-	for(uint32 x = MAX_TOTAL_AURAS_START; x < MAX_TOTAL_AURAS_END; x++)
-		if(m_auras[x] && m_auras[x]->GetSpellProto()->NameHash == namehash)
-			return m_auras[x];
+	for(std::vector< AuraIndexEntry >::iterator itr = m_auraIndex.begin(); itr != m_auraIndex.end(); ++itr)
+		if(itr->nameHash == namehash)
+			return itr->aura;
 	return NULL;
 }
 
 Aura* Unit::FindAura(uint32 spellId)
 {
-	for(uint32 x = MAX_TOTAL_AURAS_START; x < MAX_TOTAL_AURAS_END; x++)
-		if(m_auras[x])
-			if(m_auras[x]->GetSpellId() == spellId)
-				return m_auras[x];
+	for(std::vector< AuraIndexEntry >::iterator itr = m_auraIndex.begin(); itr != m_auraIndex.end(); ++itr)
+		if(itr->spellId == spellId)
+			return itr->aura;
 	return NULL;
 }
 
 Aura* Unit::FindAura(uint32* spellId)
 {
-	Aura* aura;
-	for(uint32 x = MAX_TOTAL_AURAS_START; x < MAX_TOTAL_AURAS_END; x++)
+	for(std::vector< AuraIndexEntry >::iterator itr = m_auraIndex.begin(); itr != m_auraIndex.end(); ++itr)
 	{
-		aura = m_auras[x];
-
-		if(aura == NULL)
-			continue;
-
 		for(uint8 j = 0; ; j ++)
 		{
 			if(! spellId[j])
 				break;
 
-			if(aura->GetSpellId() == spellId[j])
-				return aura;
+			if(itr->spellId == spellId[j])
+				return itr->aura;
 		}
 	}
 
@@ -5079,26 +5158,27 @@ Aura* Unit::FindAura(uint32* spellId)
 
 Aura* Unit::FindAura(uint32 spellId, uint64 guid)
 {
-	for(uint32 x = MAX_TOTAL_AURAS_START; x < MAX_TOTAL_AURAS_END; x++)
-		if(m_auras[x])
-			if(m_auras[x]->GetSpellId() == spellId && m_auras[x]->m_casterGuid == guid)
-				return m_auras[x];
+	for(std::vector< AuraIndexEntry >::iterator itr = m_auraIndex.begin(); itr != m_auraIndex.end(); ++itr)
+		if(itr->spellId == spellId && itr->aura->m_casterGuid == guid)
+			return itr->aura;
 	return NULL;
 }
 
 Aura* Unit::FindAuraWithAuraEffect(uint32 effect, uint32* x)
 {
-	Aura* aura;
-	for(; *x < MAX_TOTAL_AURAS_END ; (*x)++)
+	for(std::vector< AuraIndexEntry >::iterator itr = _FindAuraIndexSlot(*x); itr != m_auraIndex.end(); ++itr)
 	{
-		aura = m_auras[*x];
-		if(aura != NULL &&
-		        ((aura->GetSpellProto()->Effect[0] == SPELL_EFFECT_APPLY_AURA && aura->GetSpellProto()->EffectApplyAuraName[0] == effect) ||
-		         (aura->GetSpellProto()->Effect[1] == SPELL_EFFECT_APPLY_AURA && aura->GetSpellProto()->EffectApplyAuraName[1] == effect) ||
-		         (aura->GetSpellProto()->Effect[2] == SPELL_EFFECT_APPLY_AURA && aura->GetSpellProto()->EffectApplyAuraName[2] == effect)))
-			return aura;
+		for(uint32 i = 0; i < MAX_SPELL_EFFECTS; ++i)
+		{
+			if((itr->applyAuraMask & (1 << i)) && itr->auraNames[ i ] == effect)
+			{
+				*x = itr->slot;
+				return itr->aura;
+			}
+		}
 	}
 
+	*x = MAX_TOTAL_AURAS_END;
 	return NULL;
 }
 
@@ -5115,6 +5195,10 @@ void Unit::_UpdateSpells(uint32 time)
 
 void Unit::castSpell(Spell* pSpell)
 {
+	// the AI of a sleeping creature has to follow the cast
+	if(m_aiInterface != NULL)
+		m_aiInterface->Wake();
+
 	// check if we have a spell already casting etc
 	if(m_currentSpell && pSpell != m_currentSpell)
 	{
@@ -5368,7 +5452,7 @@ void Unit::MoveToWaypoint(uint32 wp_id)
 void Unit::CalcDamage()
 {
 	if(IsPlayer())
-		TO< Player* >(this)->CalcDamage();
+		TO< Player* >(this)->MarkStatsDirty(PLAYER_STATS_DIRTY_DAMAGE);
 	else
 	{
 		if(IsPet())
@@ -5525,7 +5609,7 @@ void Unit::RemoveAurasByInterruptFlag(uint32 flag)
 		if((a->m_spellProto->AuraInterruptFlags & flag) && !(a->m_spellProto->procFlags & PROC_REMOVEONUSE))
 		{
 			a->Remove();
-			m_auras[x] = NULL;
+			SetAuraSlot(x, NULL);
 		}
 	}
 }
@@ -5541,11 +5625,9 @@ bool Unit::HasAuraVisual(uint32 visualid)
 
 bool Unit::HasAura(uint32 spellid)
 {
-	for(uint32 x = MAX_TOTAL_AURAS_START; x < MAX_TOTAL_AURAS_END; x++)
-		if(m_auras[x] && m_auras[x]->GetSpellId() == spellid)
-		{
+	for(std::vector< AuraIndexEntry >::iterator itr = m_auraIndex.begin(); itr != m_auraIndex.end(); ++itr)
+		if(itr->spellId == spellid)
 			return true;
-		}
 
 	return false;
 }
@@ -5553,8 +5635,8 @@ bool Unit::HasAura(uint32 spellid)
 uint16 Unit::GetAuraStackCount(uint32 spellid)
 {
 	uint16 count = 0;
-	for(uint32 x = MAX_TOTAL_AURAS_START; x < MAX_TOTAL_AURAS_END; x++)
-		if(m_auras[x] && m_auras[x]->GetSpellId() == spellid)
+	for(std::vector< AuraIndexEntry >::iterator itr = m_auraIndex.begin(); itr != m_auraIndex.end(); ++itr)
+		if(itr->spellId == spellid)
 			count++;
 	return count;
 }
@@ -5603,8 +5685,8 @@ void Unit::UpdateSpeed()
 
 bool Unit::HasBuff(uint32 spellid) // cebernic:it does not check passive auras & must be visible auras
 {
-	for(uint32 x = MAX_POSITIVE_AURAS_EXTEDED_START; x < MAX_POSITIVE_AURAS_EXTEDED_END; x++)
-		if(m_auras[x] && m_auras[x]->GetSpellId() == spellid)
+	for(std::vector< AuraIndexEntry >::iterator itr = _FindAuraIndexSlot(MAX_POSITIVE_AURAS_EXTEDED_START); itr != m_auraIndex.end() && itr->slot < MAX_POSITIVE_AURAS_EXTEDED_END; ++itr)
+		if(itr->spellId == spellid)
 			return true;
 
 	return false;
@@ -5612,8 +5694,8 @@ bool Unit::HasBuff(uint32 spellid) // cebernic:it does not check passive auras &
 
 bool Unit::HasBuff(uint32 spellid, uint64 guid)
 {
-	for(uint32 x = MAX_POSITIVE_AURAS_EXTEDED_START; x < MAX_POSITIVE_AURAS_EXTEDED_END; x++)
-		if(m_auras[x] && m_auras[x]->GetSpellId() == spellid && m_auras[x]->m_casterGuid == guid)
+	for(std::vector< AuraIndexEntry >::iterator itr = _FindAuraIndexSlot(MAX_POSITIVE_AURAS_EXTEDED_START); itr != m_auraIndex.end() && itr->slot < MAX_POSITIVE_AURAS_EXTEDED_END; ++itr)
+		if(itr->spellId == spellid && itr->aura->m_casterGuid == guid)
 			return true;
 
 	return false;
@@ -5813,9 +5895,9 @@ uint32 Unit::FindAuraCountByHash(uint32 HashName, uint32 maxcount)
 {
 	uint32 count = 0;
 
-	for(uint32 x = MAX_TOTAL_AURAS_START; x < MAX_TOTAL_AURAS_END; ++x)
+	for(std::vector< AuraIndexEntry >::iterator itr = m_auraIndex.begin(); itr != m_auraIndex.end(); ++itr)
 	{
-		if(m_auras[x] && (m_auras[x]->GetSpellProto()->NameHash == HashName))
+		if(itr->nameHash == HashName)
 		{
 			count++;
 			if(count == maxcount)
@@ -5977,7 +6059,7 @@ void Unit::RemoveFromWorld(bool free_guid)
 		{
 			if(m_auras[x]->m_deleted)
 			{
-				m_auras[x] = NULL;
+				SetAuraSlot(x, NULL);
 				continue;
 			}
 			m_auras[x]->RelocateEvents();
@@ -6074,10 +6156,10 @@ void Unit::RemoveAurasByInterruptFlagButSkip(uint32 flag, uint32 skip)
 
 int Unit::HasAurasWithNameHash(uint32 name_hash)
 {
-	for(uint32 x = MAX_TOTAL_AURAS_START; x < MAX_TOTAL_AURAS_END; ++x)
+	for(std::vector< AuraIndexEntry >::iterator itr = m_auraIndex.begin(); itr != m_auraIndex.end(); ++itr)
 	{
-		if(m_auras[x] && m_auras[x]->GetSpellProto()->NameHash == name_hash)
-			return m_auras[x]->m_spellProto->Id;
+		if(itr->nameHash == name_hash)
+			return itr->spellId;
 	}
 
 	return 0;
@@ -6085,11 +6167,11 @@ int Unit::HasAurasWithNameHash(uint32 name_hash)
 
 bool Unit::HasAuraWithName(uint32 name)
 {
-
-	for(uint32 i = MAX_TOTAL_AURAS_START; i < MAX_TOTAL_AURAS_END; ++i)
+	for(std::vector< AuraIndexEntry >::iterator itr = m_auraIndex.begin(); itr != m_auraIndex.end(); ++itr)
 	{
-		if(m_auras[ i ] != NULL && m_auras[ i ]->GetSpellProto()->AppliesAura(name))
-			return true;
+		for(uint32 i = 0; i < MAX_SPELL_EFFECTS; ++i)
+			if((itr->appliesAuraMask & (1 << i)) && itr->auraNames[ i ] == name)
+				return true;
 	}
 
 	return false;
@@ -6099,10 +6181,16 @@ uint32 Unit::GetAuraCountWithName(uint32 name)
 {
 	uint32 count = 0;
 
-	for(uint32 i = MAX_TOTAL_AURAS_START; i < MAX_TOTAL_AURAS_END; ++i)
+	for(std::vector< AuraIndexEntry >::iterator itr = m_auraIndex.begin(); itr != m_auraIndex.end(); ++itr)
 	{
-		if(m_auras[ i ] != NULL && m_auras[ i ]->GetSpellProto()->AppliesAura(name))
-			++count;
+		for(uint32 i = 0; i < MAX_SPELL_EFFECTS; ++i)
+		{
+			if((itr->appliesAuraMask & (1 << i)) && itr->auraNames[ i ] == name)
+			{
+				++count;
+				break;
+			}
+		}
 	}
 
 	return count;
@@ -7838,10 +7926,63 @@ SpellProc* Unit::AddProcTriggerSpell(SpellEntry* spell, SpellEntry* orig_spell,
 		return NULL;
 	}
 	m_procSpells.push_back(sp);
+	_AddProcToBuckets(sp);
 
 	return sp;
 }
 
+void Unit::_AddProcToBuckets(SpellProc* sp)
+{
+	// some procs flag themselves deleted in Init()
+	if(sp->mDeleted)
+		m_procSpellsDirty = true;
+
+	ProcBucketEntry e;
+	e.seq = m_procSequence++;
+	e.proc = sp;
+
+	for(uint32 i = 0; i < 32; ++i)
+	{
+		if(sp->mProcFlags & (uint32(1) << i))
+			m_procBuckets[ i ].push_back(e);
+	}
+	m_procBucketMask |= sp->mProcFlags;
+}
+
+void Unit::_SweepDeletedProcs()
+{
+	for(uint32 i = 0; i < 32; ++i)
+	{
+		std::vector< ProcBucketEntry > & bucket = m_procBuckets[ i ];
+		std::vector< ProcBucketEntry >::iterator out = bucket.begin();
+		for(std::vector< ProcBucketEntry >::iterator itr = bucket.begin(); itr != bucket.end(); ++itr)
+		{
+			if(!itr->proc->mDeleted)
+				*out++ = *itr;
+		}
+		bucket.erase(out, bucket.end());
+
+		if(bucket.empty())
+			m_procBucketMask &= ~(uint32(1) << i);
+	}
+
+	for(std::list<SpellProc*>::iterator itr = m_procSpells.begin(); itr != m_procSpells.end();)
+	{
+		if((*itr)->mDeleted)
+		{
+			delete *itr;
+			itr = m_procSpells.erase(itr);
+		}
+		else
+			++itr;
+	}
+
+	if(m_procSpells.empty())
+		m_procSequence = 0;
+
+	m_procSpellsDirty = false;
+}
+
 SpellProc* Unit::AddProcTriggerSpell(uint32 spell_id, uint32 orig_spell_id, uint64 caster, uint32 procChance, uint32 procFlags, uint32 procCharges, uint32* groupRelation, uint32* procClassMask, Object* obj)
 {
 	return AddProcTriggerSpell(dbcSpell.LookupEntryForced(spell_id), dbcSpell.LookupEntryForced(orig_spell_id), caster, procChance, procFlags, procCharges, groupRelation, procClassMask, obj);
@@ -7872,6 +8013,7 @@ void Unit::RemoveProcTriggerSpell(uint32 spellId, uint64 casterGuid, uint64 misc
 		if(sp->CanDelete(spellId, casterGuid, misc))
 		{
 			sp->mDeleted = true;
+			m_procSpellsDirty = true;
 			return;
 		}
 	}
@@ -1597,7 +1597,7 @@ class SERVER_DECL Unit : public Object
 		uint32 m_stealth;
 		bool m_can_stealth;
 
-		Aura* m_auras[MAX_TOTAL_AURAS_END];
+		Aura* m_auras[MAX_TOTAL_AURAS_END];	// read only, use SetAuraSlot() to change it so m_auraIndex stays in sync
 
 		int32 m_modlanguage;
 
@@ -1911,6 +1911,42 @@ class SERVER_DECL Unit : public Object
 		Unit();
 		void RemoveGarbage();
 		void AddGarbageAura(Aura* aur);
+
+		// One entry per occupied aura slot, kept in slot order. Holds the keys the aura lookups
+		// search on, so they scan the few auras the unit has instead of all MAX_TOTAL_AURAS_END
+		// slots, without dereferencing each aura's spell entry.
+		struct AuraIndexEntry
+		{
+			Aura* aura;
+			uint32 spellId;
+			uint32 nameHash;
+			uint16 slot;
+			uint16 auraNames[MAX_SPELL_EFFECTS];	// EffectApplyAuraName
+			uint8 appliesAuraMask;					// bit i is set if effect i applies an aura, see SpellEntry::EffectAppliesAura
+			uint8 applyAuraMask;					// bit i is set if effect i is SPELL_EFFECT_APPLY_AURA
+		};
+		std::vector< AuraIndexEntry > m_auraIndex;
+
+		// Puts aur (or NULL) in m_auras[ slot ] and updates m_auraIndex.
+		void SetAuraSlot(uint32 slot, Aura* aur);
+		std::vector< AuraIndexEntry >::iterator _FindAuraIndexSlot(uint32 slot);
+
+		// m_procSpells owns the procs, these hold them again once for every bit set in their
+		// mProcFlags, so HandleProc only walks the procs that can react to the flags it got.
+		// seq is the order the proc was added in, every bucket is sorted by it.
+		struct ProcBucketEntry
+		{
+			uint32 seq;
+			SpellProc* proc;
+		};
+		std::vector< ProcBucketEntry > m_procBuckets[32];
+		uint32 m_procBucketMask;	// bit i is set if m_procBuckets[ i ] isn't empty
+		uint32 m_procSequence;
+		bool m_procSpellsDirty;		// a proc was flagged mDeleted and has to be swept
+
+		void _AddProcToBuckets(SpellProc* sp);
+		// Frees the procs flagged mDeleted. Only call this while the proc buckets aren't being walked.
+		void _SweepDeletedProcs();
 		void AddGarbageSpell(Spell* sp);
 
 		uint32 m_meleespell;
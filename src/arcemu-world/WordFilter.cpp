@@ -26,9 +26,175 @@ extern "C" {
 #define REPLACE_FILTER 1
 #define SEARCH_FILTER 0
 
+// PCRE 8.20 and later can compile the expressions to machine code
+#ifdef PCRE_STUDY_JIT_COMPILE
+#define WORDFILTER_STUDY_OPTIONS PCRE_STUDY_JIT_COMPILE
+#else
+#define WORDFILTER_STUDY_OPTIONS 0
+#endif
+
 WordFilter* g_characterNameFilter;
 WordFilter* g_chatFilter;
 
+static void FreeExpression(void* pExpression, void* pExtra)
+{
+	if(pExtra != NULL)
+	{
+#ifdef PCRE_STUDY_JIT_COMPILE
+		pcre_free_study((pcre_extra*)pExtra);
+#else
+		pcre_free(pExtra);
+#endif
+	}
+	pcre_free(pExpression);
+}
+
+static bool FirstLess(const std::pair< uint32, size_t > & a, const std::pair< uint32, size_t > & b)
+{
+	return a.first < b.first;
+}
+
+static bool FirstEqual(const std::pair< uint32, size_t > & a, const std::pair< uint32, size_t > & b)
+{
+	return a.first == b.first;
+}
+
+// Returns true if the expression only matches one fixed word, and that word
+static bool GetPlainWord(const char* szExpression, std::string & word)
+{
+	word.clear();
+	for(const char* p = szExpression; *p != 0; ++p)
+	{
+		if(*p == '\\')
+		{
+			// escaped punctuation stands for itself, escaped letters and digits are classes or references
+			++p;
+			if(*p == 0 || isalnum((unsigned char)*p) || (unsigned char)*p >= 0x80)
+				return false;
+		}
+		else if(strchr("^$.[]|()?*+{}", *p) != NULL)
+			return false;
+
+		word += *p;
+	}
+	return !word.empty();
+}
+
+// Returns true and the longest run of characters every match of the expression contains, so the
+// expression only has to run on messages containing it. Only characters outside of groups are
+// looked at, alternations and option settings give up.
+static bool GetRequiredWord(const char* szExpression, std::string & word)
+{
+	std::string run;
+	int depth = 0;
+
+	word.clear();
+	for(const char* p = szExpression; *p != 0; ++p)
+	{
+		char c = *p;
+		bool literal = false;
+
+		switch(c)
+		{
+			case '|':
+				return false;
+
+			case '(':
+				// plain, named and assertion groups, but not options, comments and the like
+				if(p[1] == '?' && (p[2] == 0 || strchr(":=!<>P'", p[2]) == NULL))
+					return false;
+				++depth;
+				break;
+
+			case ')':
+				--depth;
+				break;
+
+			case '[':
+				// a ] right after [ or [^ is part of the class
+				++p;
+				if(*p == '^')
+					++p;
+				if(*p == ']')
+					++p;
+				while(*p != 0 && *p != ']')
+				{
+					if(*p == '\\' && p[1] != 0)
+						++p;
+					else if(*p == '[' && p[1] != 0 && strchr(":.=", p[1]) != NULL)
+					{
+						// posix classes like [:alpha:] end with their own ], not the one of the class
+						const char* end = p + 2;
+						while(*end != 0 && (*end != p[1] || end[1] != ']'))
+							++end;
+						if(*end == 0)
+							return false;
+						p = end + 1;
+					}
+					++p;
+				}
+				if(*p == 0)
+					return false;
+				break;
+
+			case '\\':
+				if(p[1] == 0 || p[1] == 'Q' || p[1] == 'E')
+					return false;
+				c = *(++p);
+				literal = !isalnum((unsigned char)c) && (unsigned char)c < 0x80;
+
+				// character types and assertions are one character, codes like \x41 aren't worth parsing
+				if(!literal && strchr("dDwWsSbBAzZG", c) == NULL)
+					return false;
+				break;
+
+			case '{':
+				while(*p != 0 && *p != '}')
+					++p;
+				if(*p == 0)
+					return false;
+				break;
+
+			case '.':
+			case '^':
+			case '$':
+			case '?':
+			case '*':
+			case '+':
+				break;
+
+			default:
+				literal = true;
+				break;
+		}
+
+		bool optional = (p[1] == '?' || p[1] == '*' || (p[1] == '{' && p[2] == '0'));
+		if(literal && depth == 0 && !optional)
+		{
+			run += c;
+
+			// x+y always contains xy, any other repeat ends the run after the character
+			if(p[1] == '+')
+			{
+				++p;
+				if(p[1] == '?' || p[1] == '+')
+					++p;
+				continue;
+			}
+			if(p[1] != '{')
+				continue;
+		}
+
+		if(run.length() > word.length())
+			word = run;
+		run.clear();
+	}
+
+	if(run.length() > word.length())
+		word = run;
+	return !word.empty();
+}
+
 WordFilter::~WordFilter()
 {
 	size_t i;
@@ -46,17 +212,12 @@ WordFilter::~WordFilter()
 		if(p->szMatch)
 		{
 			free(p->szMatch);
-			pcre_free(p->pCompiledExpression);
-			if(p->pCompiledExpressionOptions)
-				pcre_free(p->pCompiledExpressionOptions);
+			FreeExpression(p->pCompiledExpression, p->pCompiledExpressionOptions);
 		}
 
 		if(p->szIgnoreMatch)
 		{
-			pcre_free(p->pCompiledIgnoreExpression);
-			if(p->pCompiledIgnoreExpressionOptions)
-				pcre_free(p->pCompiledIgnoreExpressionOptions);
-
+			FreeExpression(p->pCompiledIgnoreExpression, p->pCompiledIgnoreExpressionOptions);
 			free(p->szIgnoreMatch);
 		}
 
@@ -76,7 +237,7 @@ bool WordFilter::CompileExpression(const char* szExpression, void** pOutput, voi
 
 	re = pcre_compile(szExpression, 0, &error, &erroffset, NULL);
 	if(re != NULL)
-		ee = pcre_study(re, 0, &error2);
+		ee = pcre_study(re, WORDFILTER_STUDY_OPTIONS, &error2);
 
 	if(re == NULL || error2 != NULL)
 	{
@@ -160,60 +321,221 @@ void WordFilter::Load(const char* szTableName)
 		m_filters[i++] = (*itr);
 
 	m_filterCount = i;
+
+	BuildMatcher();
 }
 
-bool WordFilter::Parse(string & sMessage, bool bAllowReplace /* = true */)
+void WordFilter::BuildMatcher()
+{
+	std::vector< std::pair< std::string, uint32 > > words;
+	std::string word;
+
+	memset(m_byteClass, 0, sizeof(m_byteClass));
+	m_classCount = 1;
+
+	for(uint32 i = 0; i < m_filterCount; ++i)
+	{
+		WordFilterMatch* pFilter = m_filters[i];
+
+		pFilter->bPlainWord = GetPlainWord(pFilter->szMatch, word);
+		pFilter->iWordLength = 0;
+		if(pFilter->bPlainWord || GetRequiredWord(pFilter->szMatch, word))
+		{
+			pFilter->iWordLength = word.length();
+			for(size_t j = 0; j < word.length(); ++j)
+			{
+				if(m_byteClass[(uint8)word[j]] == 0)
+					m_byteClass[(uint8)word[j]] = uint8(m_classCount++);
+			}
+			words.push_back(std::make_pair(word, i));
+		}
+		else
+			m_separateFilters.push_back(i);
+	}
+
+	if(words.empty())
+		return;
+
+	// the trie of the words, node 0 is the root
+	m_transitions.assign(m_classCount, -1);
+	m_wordMatches.resize(1);
+
+	for(std::vector< std::pair< std::string, uint32 > >::iterator itr = words.begin(); itr != words.end(); ++itr)
+	{
+		size_t node = 0;
+		for(size_t j = 0; j < itr->first.length(); ++j)
+		{
+			size_t slot = node * m_classCount + m_byteClass[(uint8)itr->first[j]];
+			if(m_transitions[slot] < 0)
+			{
+				m_transitions[slot] = int32(m_wordMatches.size());
+				m_wordMatches.resize(m_wordMatches.size() + 1);
+				m_transitions.resize(m_transitions.size() + m_classCount, -1);
+			}
+			node = m_transitions[slot];
+		}
+		m_wordMatches[node].push_back(itr->second);
+	}
+
+	// Breadth first, so the fail node (the longest suffix that's also in the trie) of a node is done
+	// before the node. Missing transitions are taken from the fail node, and a node also reports the
+	// words ending at its fail node.
+	std::vector< int32 > fail(m_wordMatches.size(), 0);
+	std::deque< int32 > queue;
+
+	for(uint32 c = 0; c < m_classCount; ++c)
+	{
+		if(m_transitions[c] < 0)
+			m_transitions[c] = 0;
+		else
+			queue.push_back(m_transitions[c]);
+	}
+
+	while(!queue.empty())
+	{
+		int32 node = queue.front();
+		queue.pop_front();
+
+		const std::vector< uint32 > & inherited = m_wordMatches[fail[node]];
+		m_wordMatches[node].insert(m_wordMatches[node].end(), inherited.begin(), inherited.end());
+
+		for(uint32 c = 0; c < m_classCount; ++c)
+		{
+			size_t slot = node * m_classCount + c;
+			int32 failNext = m_transitions[fail[node] * m_classCount + c];
+			if(m_transitions[slot] < 0)
+				m_transitions[slot] = failNext;
+			else
+			{
+				fail[m_transitions[slot]] = failNext;
+				queue.push_back(m_transitions[slot]);
+			}
+		}
+	}
+}
+
+bool WordFilter::Parse(string & sMessage, bool bAllowReplace /* = true */, WordFilterSpan* pSpan /* = NULL */)
 {
 #define N 10
 #define NC (N*3)
-	size_t i;
-	int ovec[N * 3];
-	int n;
+	int result;
 	WordFilterMatch* pFilter;
 	const char* szInput = sMessage.c_str();
 	size_t iLen = sMessage.length();
-	//char
+	std::vector< std::pair< uint32, size_t > > candidates;	// filter, end of the first occurrence of its word
 
-	for(i = 0; i < m_filterCount; ++i)
+	// the words, all of them in one pass over the message
+	if(!m_transitions.empty())
+	{
+		int32 node = 0;
+		for(size_t i = 0; i < iLen; ++i)
+		{
+			node = m_transitions[node * m_classCount + m_byteClass[(uint8)szInput[i]]];
+
+			std::vector< uint32 > & matches = m_wordMatches[node];
+			for(std::vector< uint32 >::iterator itr = matches.begin(); itr != matches.end(); ++itr)
+			{
+				pFilter = m_filters[*itr];
+				if(pFilter->bPlainWord && pFilter->szIgnoreMatch == NULL)
+				{
+					if(pSpan != NULL)
+					{
+						pSpan->iStart = i + 1 - pFilter->iWordLength;
+						pSpan->iEnd = i + 1;
+					}
+					return true;
+				}
+
+				candidates.push_back(std::make_pair(*itr, i + 1));
+			}
+		}
+	}
+
+	// the expressions whose required word was found, and the words with an ignore expression
+	if(!candidates.empty())
+	{
+		// stable, so the first occurrence of a word stays in front of the later ones
+		std::stable_sort(candidates.begin(), candidates.end(), FirstLess);
+		candidates.erase(std::unique(candidates.begin(), candidates.end(), FirstEqual), candidates.end());
+
+		for(std::vector< std::pair< uint32, size_t > >::iterator itr = candidates.begin(); itr != candidates.end(); ++itr)
+		{
+			pFilter = m_filters[itr->first];
+			if(pSpan != NULL && pFilter->bPlainWord)
+			{
+				pSpan->iStart = itr->second - pFilter->iWordLength;
+				pSpan->iEnd = itr->second;
+			}
+
+			if((result = MatchFilter(pFilter, szInput, iLen, !pFilter->bPlainWord, pSpan)) != 0)
+				return result > 0;
+		}
+	}
+
+	// the expressions without a required word
+	for(std::vector< uint32 >::iterator itr = m_separateFilters.begin(); itr != m_separateFilters.end(); ++itr)
+	{
+		if((result = MatchFilter(m_filters[*itr], szInput, iLen, true, pSpan)) != 0)
+			return result > 0;
+	}
+
+	return false;
+}
+
+bool WordFilter::ParseSequential(string & sMessage)
+{
+	int result;
+
+	for(size_t i = 0; i < m_filterCount; ++i)
+	{
+		if((result = MatchFilter(m_filters[i], sMessage.c_str(), sMessage.length(), true, NULL)) != 0)
+			return result > 0;
+	}
+
+	return false;
+}
+
+int WordFilter::MatchFilter(WordFilterMatch* pFilter, const char* szInput, size_t iLen, bool bRunExpression, WordFilterSpan* pSpan)
+{
+	int ovec[N * 3];
+	int n;
+
+	if(bRunExpression)
 	{
-		pFilter = m_filters[i];
 		if((n = pcre_exec((const pcre*)pFilter->pCompiledExpression,
 		                  (const pcre_extra*)pFilter->pCompiledExpressionOptions, szInput, (int)iLen, 0, 0, ovec, NC)) < 0)
 		{
 			if(n == PCRE_ERROR_NOMATCH)
-				continue;
+				return 0;
 
 			Log.Error("WordFilter", "::Parse -> pcre_exec returned %d.", n);
-			return false;
+			return -1;
 		}
-		else
-		{
-			// one or more matches found
-			if(pFilter->szIgnoreMatch)
-			{
-				// ignore case
-				if((n = pcre_exec((const pcre*)pFilter->pCompiledIgnoreExpression,
-				                  (const pcre_extra*)pFilter->pCompiledIgnoreExpressionOptions, szInput, (int)iLen, 0, 0, ovec, NC)) < 0)
-				{
-					// our string didn't match any of the excludes, so it passes
-					if(n == PCRE_ERROR_NOMATCH)
-						return true;
 
-					Log.Error("WordFilter", "::Parse -> pcre_exec returned %d.", n);
-					return false;
-				}
-				else
-				{
-					// our string passed this filter.
-					continue;
-				}
-			}
-			else
-				return true;
+		if(pSpan != NULL)
+		{
+			pSpan->iStart = ovec[0];
+			pSpan->iEnd = ovec[1];
 		}
 	}
 
-	return false;
+	// one or more matches found
+	if(pFilter->szIgnoreMatch == NULL)
+		return 1;
+
+	if((n = pcre_exec((const pcre*)pFilter->pCompiledIgnoreExpression,
+	                  (const pcre_extra*)pFilter->pCompiledIgnoreExpressionOptions, szInput, (int)iLen, 0, 0, ovec, NC)) < 0)
+	{
+		// our string didn't match any of the excludes, so it doesn't pass
+		if(n == PCRE_ERROR_NOMATCH)
+			return 1;
+
+		Log.Error("WordFilter", "::Parse -> pcre_exec returned %d.", n);
+		return -1;
+	}
+
+	// our string passed this filter.
+	return 0;
 }
 
 /*
@@ -30,21 +30,66 @@ struct WordFilterMatch
 	void* pCompiledExpressionOptions;
 	void* pCompiledIgnoreExpressionOptions;
 	int iType;
+	bool bPlainWord;		// the expression is a single word, finding it is a match
+	size_t iWordLength;		// length of the word the automaton looks for, 0 if there is none
 };
 
+// Where a filter matched a message, in bytes from the start of the message
+struct WordFilterSpan
+{
+	size_t iStart;
+	size_t iEnd;
+};
+
+//////////////////////////////////////////////////////////////////////
+//class WordFilter
+// Checks chat messages and character names against the expressions of
+//a wordfilter table.
+//
+//Plain words, and the word every match of an expression has to
+//contain, are searched all at once with an Aho-Corasick automaton built
+//when the table is loaded. A message is scanned once, and an expression
+//only runs when its word was found in it. Only the expressions without
+//such a word (alternations, option settings) are still run on every
+//message.
+//
+/////////////////////////////////////////////////////////////////////
 class WordFilter
 {
 		WordFilterMatch** m_filters;
 		size_t m_filterCount;
 
+		// Aho-Corasick automaton of the filter words. Bytes are mapped to classes
+		// first, bytes that don't appear in any word share class 0.
+		uint8 m_byteClass[ 256 ];
+		uint32 m_classCount;
+		std::vector< int32 > m_transitions;					// node * m_classCount + class -> node
+		std::vector< std::vector< uint32 > > m_wordMatches;	// filters ending at a node, following the fail links too
+
+		// expressions without a required word, run on every message
+		std::vector< uint32 > m_separateFilters;
+
 		bool CompileExpression(const char* szExpression, void** pOutput, void** pExtraOutput);
+		void BuildMatcher();
+
+		// Returns 1 if the filter blocks the message, 0 if it doesn't match or its ignore expression
+		// lets the message pass, -1 on error. The expression itself is only run if bRunExpression is set,
+		// it stores where it matched in pSpan if that isn't NULL.
+		int MatchFilter(WordFilterMatch* pFilter, const char* szInput, size_t iLen, bool bRunExpression, WordFilterSpan* pSpan);
 
 	public:
-		WordFilter() : m_filters(NULL), m_filterCount(0) {}
+		WordFilter() : m_filters(NULL), m_filterCount(0), m_classCount(0) {}
 		~WordFilter();
 
 		void Load(const char* szTableName);
-		bool Parse(string & sMessage, bool bAllowReplace = true);
+
+		// Returns true if a filter blocks the message, and where that filter matched in pSpan if it isn't NULL.
+		bool Parse(string & sMessage, bool bAllowReplace = true, WordFilterSpan* pSpan = NULL);
+
+		// Runs every expression on the message one after the other, the way Parse() did before the
+		// automaton. Only used to compare the two with .debug benchfilter.
+		bool ParseSequential(string & sMessage);
+
 		bool ParseEscapeCodes(char* sMessage, bool bAllowLinks);
 };
 
@@ -30,6 +30,13 @@ float World::m_movementCompressThreshold;
 float World::m_movementCompressThresholdCreatures;
 uint32 World::m_movementCompressRate;
 uint32 World::m_movementCompressInterval;
+float World::m_movementRelayNearRange;
+float World::m_movementRelayMidRange;
+uint32 World::m_movementRelayInterval[NUM_MOVEMENT_RELAY_BANDS];
+uint32 World::m_visibilityCreateBudget;
+float World::m_visibilityBusyRange;
+uint32 World::m_sendQueueLimit;
+uint32 World::m_recvQueueLimit;
 
 World::World()
 {
@@ -141,6 +148,9 @@ World::~World()
 	Log.Notice("InstanceMgr", "~InstanceMgr()");
 	sInstanceMgr.Shutdown();
 
+	Log.Notice("PathfindingMgr", "~PathfindingMgr()");
+	delete PathfindingMgr::getSingletonPtr();
+
 	//sLog.outString("Deleting Thread Manager..");
 	//delete ThreadMgr::getSingletonPtr();
 	Log.Notice("WordFilter", "~WordFilter()");
@@ -283,7 +293,7 @@ bool BasicTaskExecutor::run()
 	return true;
 }
 
-void ApplyNormalFixes();
+void ApplyNormalFixes(TaskList & tl);
 
 bool World::SetInitialWorldSettings()
 {
@@ -373,22 +383,26 @@ bool World::SetInitialWorldSettings()
 	new ChatHandler;
 	new SpellProcMgr;
 
-	ApplyNormalFixes();
+	// spawn worker threads (2 * number of cpus), the spell fixes already use them
+	TaskList tl;
+	tl.spawn();
+
+	ApplyNormalFixes(tl);
 
 	new SpellFactoryMgr;
 
 #define MAKE_TASK(sp, ptr) tl.AddTask(new Task(new CallbackP0<sp>(sp::getSingletonPtr(), &sp::ptr)))
 	// Fill the task list with jobs to do.
-	TaskList tl;
-	Storage_FillTaskList(tl);
-
-	// spawn worker threads (2 * number of cpus)
-	tl.spawn();
+	bool snapshotLoaded = Storage_LoadSnapshot();
+	if(!snapshotLoaded)
+		Storage_FillTaskList(tl);
 
 	/* storage stuff has to be loaded first */
 	tl.wait();
 
-	Storage_LoadAdditionalTables();
+	Storage_LoadAdditionalTables(!snapshotLoaded);
+	if(!snapshotLoaded)
+		Storage_SaveSnapshot();
 
 	MAKE_TASK(ObjectMgr, LoadPlayerCreateInfo);
 	MAKE_TASK(ObjectMgr, LoadPlayersInfo);
@@ -446,6 +460,8 @@ bool World::SetInitialWorldSettings()
 
 	Log.Success("World", "Database loaded in %ums.", getMSTime() - start_time);
 
+	new PathfindingMgr;
+
 	if(Collision)
 	{
 		CollideInterface.Init();
@@ -512,6 +528,10 @@ bool World::SetInitialWorldSettings()
 	cs = new CommonScheduleThread();
 	ThreadPool.ExecuteTask(cs);
 
+#ifdef TEST_PATHFINDING
+	sPathfindingMgr.Startup(Config.MainConfig.GetIntDefault("Terrain", "PathfindingThreads", 2));
+#endif
+
 
 	ThreadPool.ExecuteTask(new CharacterLoaderThread());
 
@@ -602,6 +622,8 @@ void World::Update(time_t diff)
 
 void World::SendGlobalMessage(WorldPacket* packet, WorldSession* self)
 {
+	BroadcastPacket broadcast(packet);
+
 	m_sessionlock.AcquireReadLock();
 
 	SessionMap::iterator itr;
@@ -611,7 +633,7 @@ void World::SendGlobalMessage(WorldPacket* packet, WorldSession* self)
 		        itr->second->GetPlayer()->IsInWorld()
 		        && itr->second != self)  // don't send to self!
 		{
-			itr->second->SendPacket(packet);
+			broadcast.SendTo(itr->second);
 		}
 	}
 
@@ -640,6 +662,8 @@ void World::PlaySoundToAll(uint32 soundid)
 
 void World::SendFactionMessage(WorldPacket* packet, uint8 teamId)
 {
+	BroadcastPacket broadcast(packet);
+
 	m_sessionlock.AcquireReadLock();
 	SessionMap::iterator itr;
 	Player* plr;
@@ -650,13 +674,15 @@ void World::SendFactionMessage(WorldPacket* packet, uint8 teamId)
 			continue;
 
 		if(plr->GetTeam() == teamId)
-			itr->second->SendPacket(packet);
+			broadcast.SendTo(itr->second);
 	}
 	m_sessionlock.ReleaseReadLock();
 }
 
 void World::SendGamemasterMessage(WorldPacket* packet, WorldSession* self)
 {
+	BroadcastPacket broadcast(packet);
+
 	m_sessionlock.AcquireReadLock();
 	SessionMap::iterator itr;
 	for(itr = m_sessions.begin(); itr != m_sessions.end(); itr++)
@@ -666,7 +692,7 @@ void World::SendGamemasterMessage(WorldPacket* packet, WorldSession* self)
 		        && itr->second != self)  // don't send to self!
 		{
 			if(itr->second->CanUseCommand('u'))
-				itr->second->SendPacket(packet);
+				broadcast.SendTo(itr->second);
 		}
 	}
 	m_sessionlock.ReleaseReadLock();
@@ -674,6 +700,8 @@ void World::SendGamemasterMessage(WorldPacket* packet, WorldSession* self)
 
 void World::SendZoneMessage(WorldPacket* packet, uint32 zoneid, WorldSession* self)
 {
+	BroadcastPacket broadcast(packet);
+
 	m_sessionlock.AcquireReadLock();
 
 	SessionMap::iterator itr;
@@ -684,7 +712,7 @@ void World::SendZoneMessage(WorldPacket* packet, uint32 zoneid, WorldSession* se
 		        && itr->second != self)  // don't send to self!
 		{
 			if(itr->second->GetPlayer()->GetZoneId() == zoneid)
-				itr->second->SendPacket(packet);
+				broadcast.SendTo(itr->second);
 		}
 	}
 
@@ -693,6 +721,8 @@ void World::SendZoneMessage(WorldPacket* packet, uint32 zoneid, WorldSession* se
 
 void World::SendInstanceMessage(WorldPacket* packet, uint32 instanceid, WorldSession* self)
 {
+	BroadcastPacket broadcast(packet);
+
 	m_sessionlock.AcquireReadLock();
 
 	SessionMap::iterator itr;
@@ -703,7 +733,7 @@ void World::SendInstanceMessage(WorldPacket* packet, uint32 instanceid, WorldSes
 		        && itr->second != self)  // don't send to self!
 		{
 			if(itr->second->GetPlayer()->GetInstanceID() == (int32)instanceid)
-				itr->second->SendPacket(packet);
+				broadcast.SendTo(itr->second);
 		}
 	}
 
@@ -1074,7 +1104,7 @@ void World::GetStats(uint32* GMCount, float* AverageLatency)
 void TaskList::AddTask(Task* task)
 {
 	queueLock.Acquire();
-	tasks.insert(task);
+	tasks.push_back(task);
 	queueLock.Release();
 }
 
@@ -1084,7 +1114,7 @@ Task* TaskList::GetTask()
 
 	Task* t = 0;
 
-	for(set<Task*>::iterator itr = tasks.begin(); itr != tasks.end(); ++itr)
+	for(list<Task*>::iterator itr = tasks.begin(); itr != tasks.end(); ++itr)
 	{
 		if(!(*itr)->in_progress)
 		{
@@ -1146,7 +1176,7 @@ void TaskList::wait()
 	{
 		queueLock.Acquire();
 		has_tasks = false;
-		for(set<Task*>::iterator itr = tasks.begin(); itr != tasks.end(); ++itr)
+		for(list<Task*>::iterator itr = tasks.begin(); itr != tasks.end(); ++itr)
 		{
 			if(!(*itr)->completed)
 			{
@@ -1255,6 +1285,10 @@ void World::Rehash(bool load)
 	setRate(RATE_SKILLCHANCE, Config.MainConfig.GetFloatDefault("Rates", "SkillChance", 1.0f));
 	setRate(RATE_SKILLRATE, Config.MainConfig.GetFloatDefault("Rates", "SkillRate", 1.0f));
 	setIntRate(INTRATE_COMPRESSION, Config.MainConfig.GetIntDefault("Rates", "Compression", 1));
+	setIntRate(INTRATE_COMPRESSION_STRATEGY, Config.MainConfig.GetIntDefault("Rates", "CompressionStrategy", 0));
+	std::string compressor = Config.MainConfig.GetStringDefault("Rates", "Compressor", "zlib");
+	if(!Arcemu::PacketCompressor::Select(compressor.c_str()))
+		Log.Error("World", "Unknown packet compressor %s, using %s.", compressor.c_str(), Arcemu::PacketCompressor::GetSelected());
 	setIntRate(INTRATE_PVPTIMER, Config.MainConfig.GetIntDefault("Rates", "PvPTimer", 300000));
 	ArenaQueueDiff = Config.MainConfig.GetIntDefault("Rates", "ArenaQueueDiff", 150);
 	setRate(RATE_ARENAPOINTMULTIPLIER2X, Config.MainConfig.GetFloatDefault("Rates", "ArenaMultiplier2x", 1.0f));
@@ -1327,6 +1361,8 @@ void World::Rehash(bool load)
 
 	realmtype = Config.MainConfig.GetBoolDefault("Server", "RealmType", false);
 	TimeOut = uint32(1000 * Config.MainConfig.GetIntDefault("Server", "ConnectionTimeout", 180));
+	m_sendQueueLimit = Config.MainConfig.GetIntDefault("Server", "SendQueueLimit", 0);
+	m_recvQueueLimit = Config.MainConfig.GetIntDefault("Server", "RecvQueueLimit", 0);
 	GMTTimeZone = Config.MainConfig.GetIntDefault("Server", "TimeZone", 0);
 
 	uint32 config_flags = 0;
@@ -1493,6 +1529,21 @@ void World::Rehash(bool load)
 
 	m_movementCompressThreshold = Config.MainConfig.GetFloatDefault("Movement", "CompressThreshold", 25.0f);
 	m_movementCompressThreshold *= m_movementCompressThreshold;		// square it to avoid sqrt() on checks
+
+	m_movementRelayNearRange = Config.MainConfig.GetFloatDefault("Movement", "RelayNearRange", 40.0f);
+	m_movementRelayNearRange *= m_movementRelayNearRange;
+	m_movementRelayMidRange = Config.MainConfig.GetFloatDefault("Movement", "RelayMidRange", 80.0f);
+	m_movementRelayMidRange *= m_movementRelayMidRange;
+	if(m_movementRelayMidRange < m_movementRelayNearRange)
+		m_movementRelayMidRange = m_movementRelayNearRange;
+
+	m_movementRelayInterval[ MOVEMENT_RELAY_NEAR ] = 0;
+	m_movementRelayInterval[ MOVEMENT_RELAY_MID ] = Config.MainConfig.GetIntDefault("Movement", "RelayMidInterval", 1000);
+	m_movementRelayInterval[ MOVEMENT_RELAY_FAR ] = Config.MainConfig.GetIntDefault("Movement", "RelayFarInterval", 2000);
+
+	m_visibilityCreateBudget = Config.MainConfig.GetIntDefault("Visibility", "CreateBudget", 12000);
+	m_visibilityBusyRange = Config.MainConfig.GetFloatDefault("Visibility", "BusyRange", 50.0f);
+	m_visibilityBusyRange *= m_visibilityBusyRange;
 	// ======================================
 
 	if(m_banTable != NULL)
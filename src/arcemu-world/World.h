@@ -74,6 +74,7 @@ enum IntRates
     INTRATE_SAVE = 0,
     INTRATE_COMPRESSION,
     INTRATE_PVPTIMER,
+    INTRATE_COMPRESSION_STRATEGY,
     MAX_INTRATES
 };
 
@@ -234,9 +235,10 @@ struct CharacterLoaderThread : public ThreadBase
 		bool run();
 };
 
+// Hands the tasks out in the order they were added.
 class TaskList
 {
-		set<Task*> tasks;
+		list<Task*> tasks;
 		Mutex queueLock;
 	public:
 		TaskList() : thread_count(0) {};
@@ -245,7 +247,7 @@ class TaskList
 		void RemoveTask(Task* task)
 		{
 			queueLock.Acquire();
-			tasks.erase(task);
+			tasks.remove(task);
 			queueLock.Release();
 		}
 
@@ -734,6 +736,13 @@ class SERVER_DECL World : public Singleton<World>, public EventableObject
 		static float m_movementCompressThresholdCreatures;
 		static uint32 m_movementCompressRate;
 		static uint32 m_movementCompressInterval;
+		static float m_movementRelayNearRange;
+		static float m_movementRelayMidRange;
+		static uint32 m_movementRelayInterval[NUM_MOVEMENT_RELAY_BANDS];
+		static uint32 m_visibilityCreateBudget;
+		static float m_visibilityBusyRange;
+		static uint32 m_sendQueueLimit;		// 0 lets the queues grow as needed
+		static uint32 m_recvQueueLimit;
 		/*
 		 * Traffic meter stuff
 		 */
@@ -33,6 +33,7 @@ InstanceMgr::InstanceMgr()
 	memset(m_instances, 0, sizeof(InstanceMap*) * NUM_MAPS);
 	memset(m_singleMaps, 0, sizeof(MapMgr*) * NUM_MAPS);
 	memset(&m_nextInstanceReset, 0, sizeof(time_t) * NUM_MAPS);
+	m_spawnLoader = NULL;
 }
 
 void InstanceMgr::Load(TaskList* l)
@@ -49,50 +50,38 @@ void InstanceMgr::Load(TaskList* l)
 	else
 		m_InstanceHigh = 1;
 
-	// load each map we have in the database.
-	result = WorldDatabase.Query("SELECT DISTINCT Map FROM creature_spawns");
-	if(result)
-	{
-		do
-		{
-			if(WorldMapInfoStorage.LookupEntry(result->Fetch()[0].GetUInt32()) == NULL)
-				continue;
-
-			if(result->Fetch()[0].GetUInt32() >= NUM_MAPS)
-			{
-				Log.Error("InstanceMgr", "One or more of your creature_spawns rows specifies an invalid map: %u", result->Fetch()[0].GetUInt32());
-				continue;
-			}
-
-			//_CreateMap(result->Fetch()[0].GetUInt32());
-			l->AddTask(new Task(new CallbackP1<InstanceMgr, uint32>(this, &InstanceMgr::_CreateMap, result->Fetch()[0].GetUInt32())));
-		}
-		while(result->NextRow());
-		delete result;
-	}
-
+	// read the spawn tables, all at once
+	uint32 start = getMSTime();
+	SpawnTableLoader loader;
+	loader.FillTaskList(*l);
 	l->wait();
+	loader.LogTimes();
 
-	// create maps for any we don't have yet.
+	// create the maps, the ones with the most spawns first so they don't hold up the end;
+	// the task list hands the tasks out in the order they are added
+	std::vector< std::pair< uint32, uint32 > > maps;
 	StorageContainerIterator<MapInfo> * itr = WorldMapInfoStorage.MakeIterator();
 	while(!itr->AtEnd())
 	{
 		if(itr->Get()->mapid >= NUM_MAPS)
-		{
 			Log.Error("InstanceMgr", "One or more of your worldmap_info rows specifies an invalid map: %u", itr->Get()->mapid);
-			continue;
-		}
-
-		if(m_maps[itr->Get()->mapid] == NULL)
-		{
-			l->AddTask(new Task(new CallbackP1<InstanceMgr, uint32>(this, &InstanceMgr::_CreateMap, itr->Get()->mapid)));
-		}
-		//_CreateMap(itr->Get()->mapid);
+		else if(m_maps[itr->Get()->mapid] == NULL)
+			maps.push_back(std::make_pair(loader.GetSpawnCount(itr->Get()->mapid), itr->Get()->mapid));
 
-		itr->Inc();
+		if(!itr->Inc())
+			break;
 	}
 	itr->Destruct();
+
+	std::sort(maps.begin(), maps.end(), std::greater< std::pair< uint32, uint32 > >());
+
+	m_spawnLoader = &loader;
+	for(std::vector< std::pair< uint32, uint32 > >::iterator i = maps.begin(); i != maps.end(); ++i)
+		l->AddTask(new Task(new CallbackP1<InstanceMgr, uint32>(this, &InstanceMgr::_CreateMap, i->second)));
 	l->wait();
+	m_spawnLoader = NULL;
+
+	Log.Success("InstanceMgr", "%u maps created in %u ms.", (uint32)maps.size(), getMSTime() - start);
 
 	// load reset times
 	result = CharacterDatabase.Query("SELECT setting_id, setting_value FROM server_settings WHERE setting_id LIKE 'next_instance_reset_%%'");
@@ -693,7 +682,7 @@ void InstanceMgr::_CreateMap(uint32 mapid)
 	if(m_maps[mapid] != NULL)
 		return;
 
-	m_maps[mapid] = new Map(mapid, inf);
+	m_maps[mapid] = new Map(mapid, inf, m_spawnLoader);
 	if(inf->type == INSTANCE_NULL)
 	{
 		// we're a continent, create the instance.
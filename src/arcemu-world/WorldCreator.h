@@ -231,6 +231,9 @@ class SERVER_DECL InstanceMgr
 		InstanceMap* m_instances[NUM_MAPS];
 		MapMgr* m_singleMaps[NUM_MAPS];
 		time_t m_nextInstanceReset[NUM_MAPS];
+
+		// spawn tables read at startup, only set while the maps are created in Load()
+		SpawnTableLoader* m_spawnLoader;
 };
 
 extern SERVER_DECL InstanceMgr sInstanceMgr;
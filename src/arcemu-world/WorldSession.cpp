@@ -40,6 +40,7 @@ WorldSession::WorldSession(uint32 id, string Name, WorldSocket* sock):
 	has_level_55_char(false),
 	_side(-1),
 	_logoutTime(0),
+	_recvQueue(World::m_recvQueueLimit ? World::m_recvQueueLimit : WORLDSESSION_RECVQUEUE_SIZE, World::m_recvQueueLimit == 0),
 	permissions(NULL),
 	permissioncount(0),
 	_loggingOut(false),
@@ -48,6 +49,13 @@ WorldSession::WorldSession(uint32 id, string Name, WorldSocket* sock):
 	_updatecount(0), floodLines(0), floodTime(UNIXTIME), language(0), m_muted(0)
 {
 	memset(movement_packet, 0, sizeof(movement_packet));
+	memset(m_movementRelayTime, 0, sizeof(m_movementRelayTime));
+	m_pendingMovementOpcode = 0;
+	m_pendingMovementSize = 0;
+	m_pendingMovementTimePos = 0;
+	m_pendingMovementTime = 0;
+	m_pendingMovementStamp = 0;
+	m_pendingMovementBands = 0;
 
 	movement_info.redirectVelocity = 0;
 
@@ -77,6 +85,9 @@ WorldSession::~WorldSession()
 	while((packet = _recvQueue.Pop()) != 0)
 		delete packet;
 
+	for(std::deque<WorldPacket*>::iterator itr = _stagedPackets.begin(); itr != _stagedPackets.end(); ++itr)
+		delete *itr;
+
 	for(uint32 x = 0; x < 8; x++)
 	{
 		if(sAccountData[x].data)
@@ -100,7 +111,6 @@ int WorldSession::Update(uint32 InstanceID)
 		_socket->UpdateQueuedPackets();
 
 	WorldPacket* packet;
-	OpcodeHandler* Handler;
 
 	if(InstanceID != instanceId)
 	{
@@ -133,41 +143,15 @@ int WorldSession::Update(uint32 InstanceID)
 
 	}
 
-	while((packet = _recvQueue.Pop()) != 0)
+	// pick up whatever arrived since the map staged our packets
+	_recvQueue.PopAll(_stagedPackets);
+
+	while(!_stagedPackets.empty())
 	{
-		ARCEMU_ASSERT(packet != NULL);
+		packet = _stagedPackets.front();
+		_stagedPackets.pop_front();
 
-		if(packet->GetOpcode() >= NUM_MSG_TYPES)
-			LOG_DETAIL
-			("[Session] Received out of range packet with opcode 0x%.4X",
-			 packet->GetOpcode());
-		else
-		{
-			Handler = &WorldPacketHandlers[packet->GetOpcode()];
-			if(Handler->status == STATUS_LOGGEDIN && !_player
-			        && Handler->handler != 0)
-			{
-				LOG_DETAIL
-				("[Session] Received unexpected/wrong state packet with opcode %s (0x%.4X)",
-				 LookupName(packet->GetOpcode(), g_worldOpcodeNames),
-				 packet->GetOpcode());
-			}
-			else
-			{
-				// Valid Packet :>
-				if(Handler->handler == 0)
-				{
-					LOG_DETAIL
-					("[Session] Received unhandled packet with opcode %s (0x%.4X)",
-					 LookupName(packet->GetOpcode(), g_worldOpcodeNames),
-					 packet->GetOpcode());
-				}
-				else
-				{
-					(this->*Handler->handler)(*packet);
-				}
-			}
-		}
+		_HandlePacket(packet);
 
 		delete packet;
 
@@ -239,6 +223,84 @@ int WorldSession::Update(uint32 InstanceID)
 }
 
 
+void WorldSession::_HandlePacket(WorldPacket* packet)
+{
+	ARCEMU_ASSERT(packet != NULL);
+
+	if(packet->GetOpcode() >= NUM_MSG_TYPES)
+	{
+		LOG_DETAIL("[Session] Received out of range packet with opcode 0x%.4X", packet->GetOpcode());
+		return;
+	}
+
+	OpcodeHandler* Handler = &WorldPacketHandlers[packet->GetOpcode()];
+	if(Handler->status == STATUS_LOGGEDIN && !_player && Handler->handler != 0)
+	{
+		LOG_DETAIL("[Session] Received unexpected/wrong state packet with opcode %s (0x%.4X)",
+		           LookupName(packet->GetOpcode(), g_worldOpcodeNames), packet->GetOpcode());
+	}
+	else if(Handler->handler == 0)
+	{
+		LOG_DETAIL("[Session] Received unhandled packet with opcode %s (0x%.4X)",
+		           LookupName(packet->GetOpcode(), g_worldOpcodeNames), packet->GetOpcode());
+	}
+	else
+	{
+		// Valid Packet :>
+		(this->*Handler->handler)(*packet);
+	}
+}
+
+bool WorldSession::IsMovementOpcode(uint16 opcode)
+{
+	return (opcode < NUM_MSG_TYPES && WorldPacketHandlers[opcode].handler == &WorldSession::HandleMovementOpcodes);
+}
+
+void WorldSession::ProcessStagedMovement(uint32 InstanceID)
+{
+	// Only sessions that pass the checks Update() makes take part. One without a socket, due to be
+	// logged out or timing out leaves its packets to Update(), which handles them in its own order.
+	if(InstanceID != instanceId || _player == NULL || _socket == NULL)
+		return;
+
+	m_currMsTime = getMSTime();
+
+	if(_logoutTime && m_currMsTime >= _logoutTime)
+		return;
+
+	if(m_lastPing + WORLDSOCKET_TIMEOUT < (uint32) UNIXTIME)
+		return;
+
+	// keep the order of this session's packets, the batch ends at the first one that isn't movement
+	size_t count = 0;
+	while(count < _stagedPackets.size() && IsMovementOpcode(_stagedPackets[ count ]->GetOpcode()))
+		++count;
+
+	if(count == 0)
+		return;
+
+	if(!_ValidateMovementBatch(count))
+	{
+		for(size_t i = 0; i < count; ++i)
+			delete _stagedPackets[ i ];
+
+		_stagedPackets.erase(_stagedPackets.begin(), _stagedPackets.begin() + count);
+		return;
+	}
+
+	while(count-- > 0)
+	{
+		WorldPacket* packet = _stagedPackets.front();
+		_stagedPackets.pop_front();
+		_HandlePacket(packet);
+		delete packet;
+
+		// a map change is reported back to the map by Update()
+		if(InstanceID != instanceId)
+			break;
+	}
+}
+
 void WorldSession::LogoutPlayer(bool Save)
 {
 	Player* pPlayer = GetPlayer();
@@ -2023,3 +2085,33 @@ void WorldSession::HandleDismissCritter(WorldPacket & recv_data)
 
 	_player->SetSummonedCritterGUID(0);
 }
+
+BroadcastPacket::BroadcastPacket(WorldPacket* packet)
+{
+	m_opcode = packet->GetOpcode();
+	m_payload = packet->size() ? SharedPacketBuffer::Create(packet->contents(), packet->size()) : NULL;
+}
+
+BroadcastPacket::~BroadcastPacket()
+{
+	if(m_payload != NULL)
+		m_payload->DecRef();
+}
+
+void BroadcastPacket::SendTo(WorldSession* session)
+{
+	WorldSocket* socket = session->GetSocket();
+	if(socket != NULL)
+		SendTo(socket);
+}
+
+void BroadcastPacket::SendTo(WorldSocket* socket)
+{
+	if(!socket->IsConnected())
+		return;
+
+	if(m_payload != NULL)
+		socket->OutPacket(m_opcode, m_payload);
+	else
+		socket->OutPacket(m_opcode, 0, NULL);
+}
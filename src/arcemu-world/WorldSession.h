@@ -54,12 +54,23 @@ struct TrainerSpell;
 * Worldsocket related
 **********************************************************************************/
 #define WORLDSOCKET_TIMEOUT		 120
+#define WORLDSESSION_RECVQUEUE_SIZE 1024	// lockless part of the queue of packets received but not handled yet
 #define PLAYER_LOGOUT_DELAY (20*1000) // 20 seconds should be more than enough to gank ya.
 
 #define NOTIFICATION_MESSAGE_NO_PERMISSION "You do not have permission to perform that function."
 //#define CHECK_PACKET_SIZE(x, y) if(y > 0 && x.size() < y) { _socket->Disconnect(); return; }
 
 // MovementFlags Contribution by Tenshi
+// Observers of a moving player are split into distance bands. The near band gets every
+// movement packet, the others only get a heartbeat every World::m_movementRelayInterval[ band ] ms.
+enum MovementRelayBand
+{
+    MOVEMENT_RELAY_NEAR		= 0,
+    MOVEMENT_RELAY_MID		= 1,
+    MOVEMENT_RELAY_FAR		= 2,
+    NUM_MOVEMENT_RELAY_BANDS	= 3
+};
+
 enum MovementFlags
 {
     // Byte 1 (Resets on Movement Key Press)
@@ -297,18 +308,42 @@ class SERVER_DECL WorldSession
 
 		void LogoutPlayer(bool Save);
 
-		void QueuePacket(WorldPacket* packet)
+		// Returns false if the receive queue is limited and full, the caller still owns the packet then.
+		bool QueuePacket(WorldPacket* packet)
 		{
 			m_lastPing = (uint32)UNIXTIME;
-			_recvQueue.Push(packet);
+			return _recvQueue.Push(packet);
+		}
+
+		// Moves everything received so far into the staging list, locking the receive queue once.
+		// Like Update(), only the thread updating the session's instance may call this.
+		void StagePackets(uint32 InstanceID)
+		{
+			if(InstanceID == instanceId)
+				_recvQueue.PopAll(_stagedPackets);
 		}
 
+		// Validates the movement packets at the front of the staging list as one batch and handles them.
+		// The rest is left for Update().
+		void ProcessStagedMovement(uint32 InstanceID);
+
+		static bool IsMovementOpcode(uint16 opcode);
+
+		// Sends the heartbeat held back from distant observers once their interval has passed.
+		void FlushPendingMovement();
+
 		void OutPacket(uint16 opcode, uint16 len, const void* data)
 		{
 			if(_socket && _socket->IsConnected())
 				_socket->OutPacket(opcode, len, data);
 		}
 
+		void OutPacket(uint16 opcode, SharedPacketBuffer* payload)
+		{
+			if(_socket && _socket->IsConnected())
+				_socket->OutPacket(opcode, payload);
+		}
+
 		WorldSocket* GetSocket() { return _socket; }
 
 		void Disconnect()
@@ -799,10 +834,30 @@ class SERVER_DECL WorldSession
 		// Used to know race on login
 		void LoadPlayerFromDBProc(QueryResultVector & results);
 
+		void _HandlePacket(WorldPacket* packet);
+
+		// Checks the first count staged packets, all movement, before any of them is handled. Returns
+		// false if the batch is to be dropped, the session is disconnected already if it was cheating.
+		bool _ValidateMovementBatch(size_t count);
+
 		/* Preallocated buffers for movement handlers */
 		MovementInfo movement_info;
 		uint8 movement_packet[90];
 
+		/* Movement relay to in range players */
+		void _RelayMovement(uint16 opcode, uint16 size, size_t timepos, int32 move_time);
+		void _SendMovementTo(Player* p, float distsq, uint16 opcode, uint16 size, uint8* packet, size_t timepos, int32 move_time);
+		static uint32 _GetMovementRelayBand(float distsq);
+
+		uint32 m_movementRelayTime[NUM_MOVEMENT_RELAY_BANDS];	// last time each band got a heartbeat
+		uint8 m_pendingMovement[90];							// latest heartbeat held back from the distant bands
+		uint16 m_pendingMovementOpcode;
+		uint16 m_pendingMovementSize;
+		size_t m_pendingMovementTimePos;
+		int32 m_pendingMovementTime;
+		uint32 m_pendingMovementStamp;							// mTimeStamp() when m_pendingMovement was held back
+		uint8 m_pendingMovementBands;							// bands that haven't seen m_pendingMovement yet
+
 		uint32 _accountId;
 		uint32 _accountFlags;
 		string _accountName;
@@ -817,7 +872,8 @@ class SERVER_DECL WorldSession
 
 		AccountDataEntry sAccountData[8];
 
-		FastQueue<WorldPacket*, Mutex> _recvQueue;
+		Arcemu::Threading::MPSCQueue<WorldPacket*> _recvQueue;	// pushed by the socket thread, popped by the thread updating this session
+		std::deque<WorldPacket*> _stagedPackets;	// owned by the thread updating this session: the map's while instanceId matches it, the world's while it is 0
 		char* permissions;
 		int permissioncount;
 
@@ -841,5 +897,22 @@ class SERVER_DECL WorldSession
 
 typedef std::set<WorldSession*> SessionSet;
 
+// A packet sent to many sessions. The payload is copied once into a shared buffer
+// that the send queue of every recipient references, only the encrypted header is
+// written per socket.
+class SERVER_DECL BroadcastPacket
+{
+	public:
+		BroadcastPacket(WorldPacket* packet);
+		~BroadcastPacket();
+
+		void SendTo(WorldSession* session);
+		void SendTo(WorldSocket* socket);
+
+	private:
+		uint16 m_opcode;
+		SharedPacketBuffer* m_payload;		// NULL if the packet has no payload
+};
+
 
 #endif
@@ -51,6 +51,7 @@ WorldSocket::WorldSocket(SOCKET fd)
 	mRequestID(0),
 	mSession(NULL),
 	pAuthenticationPacket(NULL),
+	_queue(World::m_sendQueueLimit ? World::m_sendQueueLimit : WORLDSOCKET_SENDQUEUE_SIZE, World::m_sendQueueLimit == 0),
 	_latency(0),
 	mQueued(false),
 	m_nagleEanbled(false),
@@ -107,6 +108,16 @@ void WorldSocket::OnDisconnect()
 }
 
 void WorldSocket::OutPacket(uint16 opcode, size_t len, const void* data)
+{
+	OutPacket(opcode, len, data, NULL);
+}
+
+void WorldSocket::OutPacket(uint16 opcode, SharedPacketBuffer* payload)
+{
+	OutPacket(opcode, payload->GetSize(), payload->GetData(), payload);
+}
+
+void WorldSocket::OutPacket(uint16 opcode, size_t len, const void* data, SharedPacketBuffer* payload)
 {
 	OUTPACKET_RESULT res;
 	if((len + 10) > WORLDSOCKET_SENDBUF_SIZE)
@@ -115,21 +126,29 @@ void WorldSocket::OutPacket(uint16 opcode, size_t len, const void* data)
 		return;
 	}
 
-	res = _OutPacket(opcode, len, data);
+	res = _OutPacket(opcode, len, data, payload);
 	if(res == OUTPACKET_RESULT_SUCCESS)
 		return;
 
 	if(res == OUTPACKET_RESULT_NO_ROOM_IN_BUFFER)
 	{
 		/* queue the packet */
-		queueLock.Acquire();
 		WorldPacket* pck = new WorldPacket(opcode, len);
 		if(len) pck->append((const uint8*)data, len);
-		_queue.Push(pck);
-		queueLock.Release();
+		_QueuePacket(pck);
 	}
 }
 
+void WorldSocket::_QueuePacket(WorldPacket* pck)
+{
+	if(_queue.Push(pck))
+		return;
+
+	LOG_ERROR("Send queue of %s is full (%u packets), disconnecting.", GetRemoteIP().c_str(), _queue.GetCapacity());
+	delete pck;
+	Disconnect();
+}
+
 void WorldSocket::UpdateQueuedPackets()
 {
 	queueLock.Acquire();
@@ -163,7 +182,7 @@ void WorldSocket::UpdateQueuedPackets()
 			default:
 				{
 					/* kill everything in the buffer */
-					while((pck == _queue.Pop()) != 0)
+					while((pck = _queue.Pop()) != 0)
 					{
 						delete pck;
 					}
@@ -177,14 +196,22 @@ void WorldSocket::UpdateQueuedPackets()
 }
 
 OUTPACKET_RESULT WorldSocket::_OutPacket(uint16 opcode, size_t len, const void* data)
+{
+	return _OutPacket(opcode, len, data, NULL);
+}
+
+OUTPACKET_RESULT WorldSocket::_OutPacket(uint16 opcode, size_t len, const void* data, SharedPacketBuffer* payload)
 {
 	bool rv;
 	if(!IsConnected())
 		return OUTPACKET_RESULT_NOT_CONNECTED;
 
 	BurstBegin();
-	//if((m_writeByteCount + len + 4) >= m_writeBufferSize)
-	if(writeBuffer.GetSpace() < (len + 4))
+
+	// Shared payloads are referenced from the send queue. Once anything is in there, BurstSend
+	// copies behind it as well to keep the stream in order.
+	bool queued = (payload != NULL || !m_sendQueue.IsEmpty());
+	if((queued ? GetSharedSendSpace() : writeBuffer.GetSpace()) < (len + 4))
 	{
 		BurstEnd();
 		return OUTPACKET_RESULT_NO_ROOM_IN_BUFFER;
@@ -202,13 +229,18 @@ OUTPACKET_RESULT WorldSocket::_OutPacket(uint16 opcode, size_t len, const void*
 
 	_crypt.EncryptSend((uint8*)&Header, sizeof(ServerPktHeader));
 
-	// Pass the header to our send buffer
-	rv = BurstSend((const uint8*)&Header, 4);
-
-	// Pass the rest of the packet to our send buffer (if there is any)
-	if(len > 0 && rv)
+	if(payload != NULL)
+		rv = BurstSendShared((const uint8*)&Header, 4, payload);
+	else
 	{
-		rv = BurstSend((const uint8*)data, (uint32)len);
+		// Pass the header to our send buffer
+		rv = BurstSend((const uint8*)&Header, 4);
+
+		// Pass the rest of the packet to our send buffer (if there is any)
+		if(len > 0 && rv)
+		{
+			rv = BurstSend((const uint8*)data, (uint32)len);
+		}
 	}
 
 	if(rv) BurstPush();
@@ -603,8 +635,15 @@ void WorldSocket::OnRead()
 				break;
 			default:
 				{
-					if(mSession) mSession->QueuePacket(Packet);
-					else delete Packet;
+					if(mSession == NULL)
+						delete Packet;
+					else if(!mSession->QueuePacket(Packet))
+					{
+						LOG_ERROR("Receive queue of %s is full (%u packets), disconnecting.", GetRemoteIP().c_str(), World::m_recvQueueLimit);
+						delete Packet;
+						Disconnect();
+						return;
+					}
 				}
 				break;
 		}
@@ -26,6 +26,7 @@
 
 #define WORLDSOCKET_SENDBUF_SIZE 131078
 #define WORLDSOCKET_RECVBUF_SIZE 16384
+#define WORLDSOCKET_SENDQUEUE_SIZE 4096	// lockless part of the queue of packets waiting for room in the send buffer
 
 class WorldPacket;
 class SocketHandler;
@@ -52,6 +53,9 @@ class SERVER_DECL WorldSocket : public Socket
 		void  OutPacket(uint16 opcode, size_t len, const void* data);
 		OUTPACKET_RESULT  _OutPacket(uint16 opcode, size_t len, const void* data);
 
+		// Sends a packet whose payload lives in a shared buffer. The payload is referenced by the send queue instead of being copied.
+		void  OutPacket(uint16 opcode, SharedPacketBuffer* payload);
+
 		ARCEMU_INLINE uint32 GetLatency() { return _latency; }
 
 		void Authenticate();
@@ -71,6 +75,12 @@ class SERVER_DECL WorldSocket : public Socket
 
 	protected:
 
+		void OutPacket(uint16 opcode, size_t len, const void* data, SharedPacketBuffer* payload);
+		OUTPACKET_RESULT _OutPacket(uint16 opcode, size_t len, const void* data, SharedPacketBuffer* payload);
+
+		// Queues a packet that didn't fit in the send buffer, kicks the client if the queue is full.
+		void _QueuePacket(WorldPacket* pck);
+
 		void _HandleAuthSession(WorldPacket* recvPacket);
 		void _HandlePing(WorldPacket* recvPacket);
 
@@ -86,8 +96,8 @@ class SERVER_DECL WorldSocket : public Socket
 
 		WorldSession* mSession;
 		WorldPacket* pAuthenticationPacket;
-		FastQueue<WorldPacket*, DummyLock> _queue;
-		Mutex queueLock;
+		Arcemu::Threading::MPSCQueue<WorldPacket*> _queue;	// any thread can push, UpdateQueuedPackets() pops
+		Mutex queueLock;										// serializes the consumers of _queue
 
 		WowCrypt _crypt;
 		uint32 _latency;
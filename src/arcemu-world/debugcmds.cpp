@@ -1153,3 +1153,370 @@ bool ChatHandler::HandleClearWorldStatesCommand( const char *args, WorldSession
 
 	return true;
 }
+
+bool ChatHandler::HandleDebugCheckStatsCommand(const char* args, WorldSession* m_session)
+{
+	Player* plr = getSelectedChar(m_session, true);
+	if(plr == NULL)
+		return true;
+
+	// apply what's still pending, then see if a full recalculation comes to the same values
+	plr->UpdateDirtyStats();
+
+	uint32 count = plr->GetValuesCount();
+	std::vector< uint32 > before(count);
+	for(uint32 i = 0; i < count; ++i)
+		before[ i ] = plr->GetUInt32Value(i);
+
+	plr->UpdateStats();
+
+	uint32 mismatches = 0;
+	for(uint32 i = 0; i < count; ++i)
+	{
+		uint32 after = plr->GetUInt32Value(i);
+		if(after == before[ i ])
+			continue;
+
+		++mismatches;
+		RedSystemMessage(m_session, "Field %u: %u (%f) after a full recalculation, was %u (%f).", i, after, plr->GetFloatValue(i), before[ i ], *reinterpret_cast< float* >(&before[ i ]));
+	}
+
+	if(mismatches == 0)
+		GreenSystemMessage(m_session, "%s: the marked recalculations match a full one.", plr->GetName());
+	else
+		RedSystemMessage(m_session, "%s: %u fields differ from a full recalculation.", plr->GetName(), mismatches);
+
+	return true;
+}
+
+bool ChatHandler::HandleDebugBenchCompressCommand(const char* args, WorldSession* m_session)
+{
+	uint32 iterations = atoi(args);
+	if(iterations == 0)
+		iterations = 100;
+
+	Player* plr = m_session->GetPlayer();
+
+	// The create blocks of everything around us, cut into packets the way a login in this
+	// spot would send them: one create budget per update, or up to the creation buffer limit.
+	uint32 packetSize = World::m_visibilityCreateBudget != 0 ? World::m_visibilityCreateBudget : 63000;
+	std::vector< ByteBuffer > packets;
+	ByteBuffer block(2500);
+	uint32 blockCount = 0;
+
+	for(Object::InRangeSet::iterator itr = plr->GetInRangeSetBegin(); itr != plr->GetInRangeSetEnd(); ++itr)
+	{
+		ByteBuffer created(500);
+		uint32 count = (*itr)->BuildCreateUpdateBlockForPlayer(&created, plr);
+		if(count == 0)
+			continue;
+
+		if(block.size() != 0 && block.size() + created.size() > packetSize)
+		{
+			packets.push_back(ByteBuffer(block.size() + 4));
+			packets.back() << blockCount;
+			packets.back().append(block);
+			block.clear();
+			blockCount = 0;
+		}
+
+		block.append(created);
+		blockCount += count;
+	}
+
+	if(block.size() != 0)
+	{
+		packets.push_back(ByteBuffer(block.size() + 4));
+		packets.back() << blockCount;
+		packets.back().append(block);
+	}
+
+	if(packets.empty())
+	{
+		RedSystemMessage(m_session, "There is nothing in range to build update packets from.");
+		return true;
+	}
+
+	int strategy = sWorld.getIntRate(INTRATE_COMPRESSION_STRATEGY);
+	uint64 rawBytes = 0;
+	std::vector< uint8 > dest;
+
+	// same level as Player::CompressAndSendUpdateBuffer
+	std::vector< int > levels(packets.size());
+	for(size_t i = 0; i < packets.size(); ++i)
+	{
+		levels[ i ] = sWorld.getIntRate(INTRATE_COMPRESSION);
+		if(packets[ i ].size() >= 40000 && levels[ i ] < 6)
+			levels[ i ] = 6;
+
+		rawBytes += packets[ i ].size();
+		if(Arcemu::PacketCompressor::GetBound((uint32)packets[ i ].size()) > dest.size())
+			dest.resize(Arcemu::PacketCompressor::GetBound((uint32)packets[ i ].size()));
+	}
+
+	float calls = float(packets.size()) * iterations;
+	GreenSystemMessage(m_session, "%u update packets of the objects around you, " I64FMTD " bytes. The server uses %s.",
+	                   uint32(packets.size()), rawBytes, Arcemu::PacketCompressor::GetSelected());
+
+	// every implementation on the same packets, each with an instance of its own like a new thread would get
+	std::vector< std::string > names;
+	Arcemu::PacketCompressor::GetNames(names);
+	for(std::vector< std::string >::iterator itr = names.begin(); itr != names.end(); ++itr)
+	{
+		Arcemu::PacketCompressor* compressor = Arcemu::PacketCompressor::Create(itr->c_str());
+		if(compressor == NULL)
+			continue;
+
+		uint64 compressedBytes = 0;
+		uint32 start = getMSTime();
+		for(uint32 n = 0; n < iterations; ++n)
+		{
+			for(size_t i = 0; i < packets.size(); ++i)
+				compressedBytes += compressor->Compress(packets[ i ].contents(), (uint32)packets[ i ].size(), &dest[ 0 ], (uint32)dest.size(), levels[ i ], strategy);
+		}
+		uint32 time = getMSTime() - start;
+		delete compressor;
+
+		GreenSystemMessage(m_session, "%s: |r%.1f us per packet, " I64FMTD " bytes", itr->c_str(), time * 1000.0f / calls, compressedBytes / iterations);
+	}
+	return true;
+}
+
+// a few lines like the ones the chat filter sees in a crowded city
+static const char* s_benchFilterLines[] =
+{
+	"LFM ICC 25 need 2 heals and a tank, whisper me your gs",
+	"WTS [Titanium Ore] 20g a stack, cod ok",
+	"anyone up for some arena 2v2? 1800 rating",
+	"lol that was close",
+	"can someone link the quest for the frozen orb vendor please",
+	"|cffa335ee|Hitem:49623:0:0:0:0:0:0:0:80|h[Shadowmourne]|h|r finally!!!",
+	"LF guild, casual raiding 3 nights a week, EU evening times",
+	"where is the trainer for cooking in dalaran?",
+};
+
+bool ChatHandler::HandleDebugBenchFilterCommand(const char* args, WorldSession* m_session)
+{
+	if(g_chatFilter == NULL)
+	{
+		RedSystemMessage(m_session, "The chat filter isn't loaded.");
+		return true;
+	}
+
+	char message[256];
+	uint32 iterations = 0;
+	int read = sscanf(args, "%u %255[^\n]", &iterations, message);
+	if(iterations == 0)
+		iterations = 10000;
+
+	std::vector< std::string > lines;
+	if(read == 2)
+		lines.push_back(message);
+	else
+		lines.assign(s_benchFilterLines, s_benchFilterLines + sizeof(s_benchFilterLines) / sizeof(s_benchFilterLines[ 0 ]));
+
+	uint32 blocked = 0;
+	uint32 blockedSequential = 0;
+
+	uint32 start = getMSTime();
+	for(uint32 n = 0; n < iterations; ++n)
+	{
+		for(size_t i = 0; i < lines.size(); ++i)
+		{
+			if(g_chatFilter->ParseSequential(lines[ i ]))
+				++blockedSequential;
+		}
+	}
+	uint32 sequentialTime = getMSTime() - start;
+
+	start = getMSTime();
+	for(uint32 n = 0; n < iterations; ++n)
+	{
+		for(size_t i = 0; i < lines.size(); ++i)
+		{
+			if(g_chatFilter->Parse(lines[ i ]))
+				++blocked;
+		}
+	}
+	uint32 parseTime = getMSTime() - start;
+
+	float calls = float(lines.size()) * iterations;
+	GreenSystemMessage(m_session, "%u chat lines, %u of them blocked.", uint32(lines.size()), blocked / iterations);
+	if(blocked != blockedSequential)
+		RedSystemMessage(m_session, "Every expression one after the other blocked %u of them.", blockedSequential / iterations);
+
+	GreenSystemMessage(m_session, "Every expression one after the other: |r%.2f us per line", sequentialTime * 1000.0f / calls);
+	GreenSystemMessage(m_session, "Word automaton: |r%.2f us per line", parseTime * 1000.0f / calls);
+
+	if(read == 2)
+	{
+		WordFilterSpan span;
+		if(g_chatFilter->Parse(lines[ 0 ], true, &span))
+			SystemMessage(m_session, "Blocked by \"%s\".", lines[ 0 ].substr(span.iStart, span.iEnd - span.iStart).c_str());
+	}
+	return true;
+}
+
+// The lookups by name and guid as they were before PlayerInfoIndex: a lock, a lowercase copy of the name and two maps.
+#ifdef WIN32
+typedef HM_NAMESPACE::hash_map< string, PlayerInfo* > BenchPlayerNameMap;
+#else
+typedef std::map< string, PlayerInfo* > BenchPlayerNameMap;
+#endif
+
+class LockedPlayerInfoMaps
+{
+	public:
+		PlayerInfo* GetByGuid(uint32 guid)
+		{
+			PlayerInfo* rv = NULL;
+			lock.AcquireReadLock();
+			HM_NAMESPACE::hash_map< uint32, PlayerInfo* >::iterator itr = byGuid.find(guid);
+			if(itr != byGuid.end())
+				rv = itr->second;
+			lock.ReleaseReadLock();
+			return rv;
+		}
+
+		PlayerInfo* GetByName(const char* name)
+		{
+			string lpn = string(name);
+			arcemu_TOLOWER(lpn);
+			PlayerInfo* rv = NULL;
+			lock.AcquireReadLock();
+			BenchPlayerNameMap::iterator itr = byName.find(lpn);
+			if(itr != byName.end())
+				rv = itr->second;
+			lock.ReleaseReadLock();
+			return rv;
+		}
+
+		RWLock lock;
+		HM_NAMESPACE::hash_map< uint32, PlayerInfo* > byGuid;
+		BenchPlayerNameMap byName;
+};
+
+// what a lookup asks for, copied so a character deleted meanwhile doesn't pull the name away
+struct BenchPlayerInfoKey
+{
+	uint32 guid;
+	string name;
+	PlayerInfo* info;
+};
+
+class PlayerInfoLookupThread : public ThreadBase
+{
+	public:
+		PlayerInfoLookupThread(LockedPlayerInfoMaps* maps, const std::vector< BenchPlayerInfoKey >* infos, uint32 count, uint32 seed,
+		                       Arcemu::Threading::AtomicCounter* done, Arcemu::Threading::AtomicCounter* mismatches) :
+			m_maps(maps), m_infos(infos), m_count(count), m_seed(seed), m_done(done), m_mismatches(mismatches) {}
+
+		bool run()
+		{
+			for(uint32 i = 0; i < m_count; ++i)
+			{
+				m_seed = m_seed * 1103515245 + 12345;
+				const BenchPlayerInfoKey & key = (*m_infos)[(m_seed >> 8) % m_infos->size() ];
+
+				PlayerInfo* found;
+				if(m_maps != NULL)
+					found = (i & 1) ? m_maps->GetByName(key.name.c_str()) : m_maps->GetByGuid(key.guid);
+				else
+					found = (i & 1) ? objmgr.GetPlayerInfoByName(key.name.c_str()) : objmgr.GetPlayerInfo(key.guid);
+
+				if(found != key.info)
+					++(*m_mismatches);
+			}
+
+			++(*m_done);
+			return true;
+		}
+
+	private:
+		LockedPlayerInfoMaps* m_maps;
+		const std::vector< BenchPlayerInfoKey >* m_infos;
+		uint32 m_count;
+		uint32 m_seed;
+		Arcemu::Threading::AtomicCounter* m_done;
+		Arcemu::Threading::AtomicCounter* m_mismatches;
+};
+
+// Returns the milliseconds threads threads took to do count lookups each, on maps or on objmgr if maps is NULL.
+static uint32 RunPlayerInfoLookups(LockedPlayerInfoMaps* maps, const std::vector< BenchPlayerInfoKey > & infos, uint32 threads, uint32 count, Arcemu::Threading::AtomicCounter & mismatches)
+{
+	Arcemu::Threading::AtomicCounter done;
+
+	uint32 start = getMSTime();
+	for(uint32 i = 0; i < threads; ++i)
+		ThreadPool.ExecuteTask(new PlayerInfoLookupThread(maps, &infos, count, i + 1, &done, &mismatches));
+
+	while(done.GetVal() < threads)
+		Arcemu::Sleep(1);
+
+	return getMSTime() - start;
+}
+
+bool ChatHandler::HandleDebugBenchPlayerInfoCommand(const char* args, WorldSession* m_session)
+{
+	uint32 threads = 0;
+	uint32 count = 0;
+	sscanf(args, "%u %u", &threads, &count);
+	if(threads == 0)
+		threads = 4;
+	if(count == 0)
+		count = 1000000;
+
+	std::vector< uint32 > guids;
+	objmgr.GetPlayerInfoGuids(guids);
+
+	std::vector< BenchPlayerInfoKey > infos;
+	LockedPlayerInfoMaps* maps = new LockedPlayerInfoMaps;
+	for(std::vector< uint32 >::iterator itr = guids.begin(); itr != guids.end(); ++itr)
+	{
+		PlayerInfo* pn = objmgr.GetPlayerInfo(*itr);
+		if(pn == NULL)
+			continue;
+
+		BenchPlayerInfoKey key;
+		key.guid = *itr;
+		key.name = pn->name;
+		key.info = pn;
+		infos.push_back(key);
+		maps->byGuid[ key.guid ] = pn;
+
+		string lpn = key.name;
+		arcemu_TOLOWER(lpn);
+		maps->byName[ lpn ] = pn;
+	}
+
+	if(infos.empty())
+	{
+		delete maps;
+		RedSystemMessage(m_session, "There are no characters to look up.");
+		return true;
+	}
+
+	Arcemu::Threading::AtomicCounter mismatches;
+	GreenSystemMessage(m_session, "%u characters, %u lookups per thread, half by guid and half by name.", uint32(infos.size()), count);
+
+	uint32 threadCounts[ 2 ] = { 1, threads };
+	for(uint32 i = 0; i < (threads > 1 ? 2u : 1u); ++i)
+	{
+		float lookups = float(count) * threadCounts[ i ];
+		uint32 lockedTime = RunPlayerInfoLookups(maps, infos, threadCounts[ i ], count, mismatches);
+		uint32 indexTime = RunPlayerInfoLookups(NULL, infos, threadCounts[ i ], count, mismatches);
+		if(lockedTime == 0)
+			lockedTime = 1;
+		if(indexTime == 0)
+			indexTime = 1;
+
+		GreenSystemMessage(m_session, "%u threads: |rlock and maps %.0f lookups/ms, PlayerInfoIndex %.0f lookups/ms",
+		                   threadCounts[ i ], lookups / lockedTime, lookups / indexTime);
+	}
+
+	if(mismatches.GetVal() != 0)
+		RedSystemMessage(m_session, "%u lookups found the wrong character, or one that was deleted meanwhile.", mismatches.GetVal());
+
+	delete maps;
+	return true;
+}
@@ -0,0 +1,212 @@
+/*
+ * ArcEmu MMORPG Server
+ * Copyright (C) 2008-2012 <http://www.ArcEmu.org/>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+//////////////////////////////////////////////////////////////////////
+// Micro benchmarks for code of the shared library.
+//
+// bench queue [producers] [packets]
+//  Some threads push into one queue while a single thread pops, like the
+//  socket threads and the map thread do with a session's receive queue.
+//  Compares the FastQueue the sessions used with the MPSCQueue they use now.
+//
+// bench srp6 [logins]
+//  The SRP6 math of a logon on one thread, with the powers of g taken from
+//  BigNumber::ModExp like the logon server used to and from the table of
+//  FixedBaseModExp like the crypto threads do now.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include "Common.h"
+#include "FastQueue.h"
+#include "Auth/BigNumber.h"
+
+static volatile bool s_start = false;
+
+template< class Q >
+class QueueProducer : public ThreadBase
+{
+	public:
+		QueueProducer(Q* queue, uint32* items, uint32 count, Arcemu::Threading::AtomicCounter* done) :
+			m_queue(queue), m_items(items), m_count(count), m_done(done) {}
+
+		bool run()
+		{
+			while(!s_start)
+				Arcemu::Sleep(0);
+
+			for(uint32 i = 0; i < m_count; ++i)
+				m_queue->Push(&m_items[ i ]);
+
+			++(*m_done);
+			return true;
+		}
+
+	private:
+		Q* m_queue;
+		uint32* m_items;
+		uint32 m_count;
+		Arcemu::Threading::AtomicCounter* m_done;
+};
+
+// Returns the milliseconds it took the consumer to pop producers * count elements.
+template< class Q >
+static uint32 RunQueue(Q* queue, uint32 producers, uint32 count)
+{
+	uint32* items = new uint32[ count ];
+	Arcemu::Threading::AtomicCounter done;
+
+	s_start = false;
+	for(uint32 i = 0; i < producers; ++i)
+		ThreadPool.ExecuteTask(new QueueProducer< Q >(queue, items, count, &done));
+
+	uint32 total = producers * count;
+	uint32 popped = 0;
+
+	uint32 start = getMSTime();
+	s_start = true;
+	while(popped < total)
+	{
+		if(queue->Pop() != NULL)
+			++popped;
+	}
+	uint32 time = getMSTime() - start;
+
+	// the producers are done when their last element was popped, wait for them to return to the pool
+	while(done.GetVal() < producers)
+		Arcemu::Sleep(1);
+
+	delete[] items;
+	return time;
+}
+
+static void PrintQueueResult(const char* name, uint32 time, uint32 total)
+{
+	if(time == 0)
+		time = 1;
+
+	printf("%-28s %6u ms %12.0f packets/s\n", name, time, total * 1000.0 / time);
+}
+
+static void BenchQueue(uint32 producers, uint32 count)
+{
+	uint32 total = producers * count;
+	printf("%u producers pushing %u packets each into one consumer\n", producers, count);
+
+	FastQueue< uint32*, Mutex >* fast = new FastQueue< uint32*, Mutex >;
+	PrintQueueResult("FastQueue", RunQueue(fast, producers, count), total);
+	delete fast;
+
+	// the ring the world uses, with room to spare
+	Arcemu::Threading::MPSCQueue< uint32* >* ring = new Arcemu::Threading::MPSCQueue< uint32* >(total, false);
+	PrintQueueResult("MPSCQueue", RunQueue(ring, producers, count), total);
+	delete ring;
+
+	// a small ring, so the queue keeps overflowing into its locked list
+	Arcemu::Threading::MPSCQueue< uint32* >* overflow = new Arcemu::Threading::MPSCQueue< uint32* >(64, true);
+	PrintQueueResult("MPSCQueue, overflowing", RunQueue(overflow, producers, count), total);
+	delete overflow;
+}
+
+// The values of arcemu-logonserver/AuthCryptoPool.h
+#define BENCH_SRP6_N "894B645E89E1535BBDAD5B8B290650530801B18EBFBF5E8FAB3C82872A3E9BB7"
+#define BENCH_SRP6_G 7
+#define BENCH_SRP6_MAX_G_EXPONENT_BITS 160
+
+// Returns the milliseconds it took to do the math of count logons, the powers of g come from gPow if it isn't NULL.
+static uint32 RunSrp6(uint32 count, const FixedBaseModExp* gPow)
+{
+	BigNumber N, g;
+	N.SetHexStr(BENCH_SRP6_N);
+	g.SetDword(BENCH_SRP6_G);
+
+	uint32 start = getMSTime();
+	for(uint32 i = 0; i < count; ++i)
+	{
+		// challenge: v = g ^ x, B = k * v + g ^ b
+		BigNumber x, b;
+		x.SetRand(160);
+		b.SetRand(152);
+
+		BigNumber v = gPow ? gPow->ModExp(x) : g.ModExp(x, N);
+		BigNumber gmod = gPow ? gPow->ModExp(b) : g.ModExp(b, N);
+		BigNumber B = ((v * 3) + gmod) % N;
+
+		// proof: S = (A * v ^ u) ^ b, A comes from the client and u from a digest
+		BigNumber A, u;
+		A.SetRand(256);
+		u.SetRand(160);
+		BigNumber S = (A * (v.ModExp(u, N))).ModExp(b, N);
+	}
+
+	return getMSTime() - start;
+}
+
+static void BenchSrp6(uint32 count)
+{
+	printf("SRP6 math of %u logons on one thread\n", count);
+
+	uint32 plain = RunSrp6(count, NULL);
+
+	BigNumber N, g;
+	N.SetHexStr(BENCH_SRP6_N);
+	g.SetDword(BENCH_SRP6_G);
+	FixedBaseModExp* gPow = new FixedBaseModExp(g, N, BENCH_SRP6_MAX_G_EXPONENT_BITS);
+	uint32 table = RunSrp6(count, gPow);
+	delete gPow;
+
+	if(plain == 0)
+		plain = 1;
+	if(table == 0)
+		table = 1;
+
+	printf("%-28s %6u ms %12.0f logons/s\n", "BigNumber::ModExp", plain, count * 1000.0 / plain);
+	printf("%-28s %6u ms %12.0f logons/s\n", "FixedBaseModExp", table, count * 1000.0 / table);
+}
+
+int main(int argc, char* argv[])
+{
+	if(argc < 2)
+	{
+		printf("Usage: %s queue [producers] [packets]\n", argv[ 0 ]);
+		printf("       %s srp6 [logins]\n", argv[ 0 ]);
+		return 1;
+	}
+
+	ThreadPool.Startup();
+
+	if(!strcmp(argv[ 1 ], "queue"))
+	{
+		uint32 producers = (argc > 2) ? atoi(argv[ 2 ]) : 4;
+		uint32 count = (argc > 3) ? atoi(argv[ 3 ]) : 1000000;
+		if(producers == 0)
+			producers = 1;
+
+		BenchQueue(producers, count);
+	}
+	else if(!strcmp(argv[ 1 ], "srp6"))
+	{
+		uint32 count = (argc > 2) ? atoi(argv[ 2 ]) : 20000;
+		BenchSrp6(count);
+	}
+	else
+		printf("Unknown benchmark %s\n", argv[ 1 ]);
+
+	ThreadPool.Shutdown();
+	return 0;
+}